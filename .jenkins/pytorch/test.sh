@@ -36,11 +36,17 @@ fi
 
 export ATEN_DISABLE_AVX=
 export ATEN_DISABLE_AVX2=
+export ATEN_DISABLE_AVX512=
 if [[ "${JOB_BASE_NAME}" == *-NO_AVX-* ]]; then
   export ATEN_DISABLE_AVX=1
+  export ATEN_DISABLE_AVX512=1
 fi
 if [[ "${JOB_BASE_NAME}" == *-NO_AVX2-* ]]; then
   export ATEN_DISABLE_AVX2=1
+  export ATEN_DISABLE_AVX512=1
+fi
+if [[ "${JOB_BASE_NAME}" == *-NO_AVX512-* ]]; then
+  export ATEN_DISABLE_AVX512=1
 fi
 
 test_python_nn() {
@@ -27,6 +27,7 @@ struct Device {
     switch (backend) {
       case kCPU:
       case kSparseCPU:
+      case kSparseCsrCPU:
         return Type::CPU;
       case kCUDA:
       case kSparseCUDA:
@@ -3,16 +3,19 @@
 #include <ATen/ScalarType.h>
 
 namespace at {
-enum class Layout { Strided, Sparse };
+enum class Layout { Strided, Sparse, SparseCsr };
 
 constexpr auto kStrided = Layout::Strided;
 constexpr auto kSparse = Layout::Sparse;
+constexpr auto kSparseCsr = Layout::SparseCsr;
 
 inline Layout layout_from_backend(Backend backend) {
   switch (backend) {
     case Backend::SparseCPU:
     case Backend::SparseCUDA:
       return Layout::Sparse;
+    case Backend::SparseCsrCPU:
+      return Layout::SparseCsr;
     default:
       return Layout::Strided;
   }
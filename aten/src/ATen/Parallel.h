@@ -1,5 +1,6 @@
 #pragma once
 #include <ATen/ATen.h>
+#include <ATen/ThreadPool.h>
 #include <cstddef>
 
 #ifdef _OPENMP
@@ -27,17 +28,19 @@ inline void parallel_for(
     const int64_t grain_size,
     const F f) {
 #ifdef _OPENMP
+  if (!internal::use_thread_pool()) {
 #pragma omp parallel if ((end - begin) >= grain_size)
-  {
-    int64_t num_threads = omp_get_num_threads();
-    int64_t tid = omp_get_thread_num();
-    int64_t chunk_size = divup((end - begin), num_threads);
-    int64_t begin_tid = begin + tid * chunk_size;
-    f(begin_tid, std::min(end, chunk_size + begin_tid));
+    {
+      int64_t num_threads = omp_get_num_threads();
+      int64_t tid = omp_get_thread_num();
+      int64_t chunk_size = divup((end - begin), num_threads);
+      int64_t begin_tid = begin + tid * chunk_size;
+      f(begin_tid, std::min(end, chunk_size + begin_tid));
+    }
+    return;
   }
-#else
-  f(begin, end);
 #endif
+  internal::parallel_for_thread_pool(begin, end, grain_size, f);
 }
 
 template <class scalar_t, class F, class SF>
@@ -54,10 +57,22 @@ inline scalar_t parallel_reduce(
     const int64_t num_results = divup((end - begin), grain_size);
     std::vector<scalar_t> results(num_results);
     scalar_t* results_data = results.data();
+    if (internal::use_thread_pool()) {
+      // One partial result per grain, so the result does not depend on how
+      // the pool happens to schedule the chunks.
+      internal::parallel_for_thread_pool(
+          0, num_results, 1, [&](int64_t id_begin, int64_t id_end) {
+            for (int64_t id = id_begin; id < id_end; id++) {
+              int64_t i = begin + id * grain_size;
+              results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+            }
+          });
+    } else {
 #pragma omp parallel for if ((end - begin) >= grain_size)
-    for (int64_t id = 0; id < num_results; id++) {
-      int64_t i = begin + id * grain_size;
-      results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+      for (int64_t id = 0; id < num_results; id++) {
+        int64_t i = begin + id * grain_size;
+        results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+      }
     }
     return std::accumulate(
         results_data, results_data + results.size(), ident, sf);
@@ -43,6 +43,7 @@ enum class Backend {
   CUDA,
   SparseCPU,
   SparseCUDA,
+  SparseCsrCPU,
   Undefined,
   NumOptions
 };
@@ -51,6 +52,7 @@ constexpr Backend kCPU = Backend::CPU;
 constexpr Backend kCUDA = Backend::CUDA;
 constexpr Backend kSparseCPU = Backend::SparseCPU;
 constexpr Backend kSparseCUDA = Backend::SparseCUDA;
+constexpr Backend kSparseCsrCPU = Backend::SparseCsrCPU;
 
 static inline Backend toSparse(Backend b) {
   switch (b) {
@@ -58,6 +60,7 @@ static inline Backend toSparse(Backend b) {
     case Backend::CUDA: return Backend::SparseCUDA;
     case Backend::SparseCPU: return Backend::SparseCPU;
     case Backend::SparseCUDA: return Backend::SparseCUDA;
+    case Backend::SparseCsrCPU: return Backend::SparseCsrCPU;
     default: throw std::runtime_error("Unknown backend");
   }
 }
@@ -68,6 +71,7 @@ static inline Backend toDense(Backend b) {
     case Backend::CUDA: return Backend::CUDA;
     case Backend::SparseCPU: return Backend::CPU;
     case Backend::SparseCUDA: return Backend::CUDA;
+    case Backend::SparseCsrCPU: return Backend::CPU;
     default: throw std::runtime_error("Unknown backend");
   }
 }
@@ -78,6 +82,7 @@ static inline const char * toString(Backend b) {
     case Backend::CUDA: return "CUDA";
     case Backend::SparseCPU: return "SparseCPU";
     case Backend::SparseCUDA: return "SparseCUDA";
+    case Backend::SparseCsrCPU: return "SparseCsrCPU";
     default: return "UNKNOWN_BACKEND";
   }
 }
@@ -0,0 +1,67 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+
+namespace at {
+
+// An empty CSR matrix has no rows and no columns. Like empty COO tensors, its
+// index and value tensors are zero-size tensors, except for crow_indices,
+// which always holds the offset of the end of the last row.
+SparseCsrTensorImpl::SparseCsrTensorImpl(Type * type)
+    : TensorImpl(type)
+    , size_{0, 0}
+    , crow_indices_(type->toDense().toScalarType(ScalarType::Long).tensor({1}).zero_())
+    , col_indices_(type->toDense().toScalarType(ScalarType::Long).tensor())
+    , values_(type->toDense().tensor()) {
+      AT_ASSERT(type->layout() == kSparseCsr);
+    }
+
+const char * SparseCsrTensorImpl::toString() const {
+  return "SparseCsrTensor";
+}
+IntList SparseCsrTensorImpl::sizes() const {
+  return size_;
+}
+IntList SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+int64_t SparseCsrTensorImpl::dim() const {
+  return 2;
+}
+Scalar SparseCsrTensorImpl::localScalar() {
+  int64_t n = numel();
+  AT_CHECK(n == 1, "localScalar() called on a Tensor with ", n, " elements");
+  if (nnz() == 0) return Scalar(0);
+  return values_.pImpl->localScalar();
+}
+void * SparseCsrTensorImpl::unsafeGetTH(bool retain) {
+  AT_ERROR("unsafeGetTH not supported for new style TensorImpl");
+}
+std::unique_ptr<Storage> SparseCsrTensorImpl::storage() {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+void SparseCsrTensorImpl::set_member_tensors(
+    const Tensor& crow_indices, const Tensor& col_indices,
+    const Tensor& values, IntList size) {
+  AT_CHECK(size.size() == 2, "sparse CSR tensors must have 2 dimensions, but got size ", size);
+  AT_CHECK(values.type().toBackend(kSparseCsrCPU) == type(), "values type must match sparse CSR tensor type");
+  AT_CHECK(crow_indices.type().scalarType() == kLong && col_indices.type().scalarType() == kLong,
+           "crow_indices and col_indices must be LongTensors");
+  AT_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) == size[0] + 1,
+           "crow_indices must have rows + 1 = ", size[0] + 1, " elements, but got ", crow_indices.sizes());
+  // TODO: Explicit empty test is needed because we don't handle size zero
+  // dimensions at the moment
+  if (values.numel() != 0) {
+    AT_CHECK(values.dim() == 1, "values must be a 1-D tensor, but got ", values.dim(), " dimensions");
+    AT_CHECK(col_indices.dim() == 1 && col_indices.size(0) == values.size(0),
+             "col_indices and values must have the same number of elements");
+  } else {
+    AT_CHECK(col_indices.numel() == 0, "if values is empty, col_indices must be empty too");
+  }
+  size_ = size;
+  crow_indices_ = crow_indices;
+  col_indices_ = col_indices;
+  values_ = values;
+}
+
+} // namespace at
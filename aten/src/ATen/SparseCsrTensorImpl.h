@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ATen/Tensor.h"
+#include "ATen/TensorImpl.h"
+#include "ATen/Error.h"
+
+namespace at {
+struct SparseCsrTensorImpl : public TensorImpl {
+  // A 2-D sparse matrix stored in compressed sparse row (CSR) format.
+
+  // INVARIANTS:
+  // size_: (rows, cols)
+  // crow_indices_: shape (rows + 1,), nondecreasing, crow_indices_[0] == 0
+  //                and crow_indices_[rows] == nnz
+  // col_indices_, values_: shape (nnz,); the nonzeros of row i are
+  //                values_[crow_indices_[i]:crow_indices_[i + 1]], in the
+  //                strictly increasing columns of the same range of
+  //                col_indices_.
+  //
+  // Unlike the COO layout, a CSR matrix is always coalesced and the rows can
+  // be found without a search, so matrix products read it sequentially.
+  // When nnz == 0, col_indices_ and values_ are empty tensors.
+
+  std::vector<int64_t> size_;
+
+  Tensor crow_indices_; // always a LongTensor
+  Tensor col_indices_; // always a LongTensor
+  Tensor values_;
+
+public:
+  explicit SparseCsrTensorImpl(Type * type);
+
+  int64_t nnz() const { return values_.numel(); }
+  Tensor crow_indices() const { return crow_indices_; }
+  Tensor col_indices() const { return col_indices_; }
+  Tensor values() const { return values_; }
+
+  const char * toString() const override;
+  IntList sizes() const override;
+  IntList strides() const override;
+  int64_t dim() const override;
+  Scalar localScalar() override;
+  void * unsafeGetTH(bool retain) override;
+  std::unique_ptr<Storage> storage() override;
+
+  // Takes crow_indices, col_indices and values without copying them. Only the
+  // shapes and types are checked here; see sparse_csr_tensor for the checks
+  // of the indices.
+  void set_member_tensors(const Tensor& crow_indices, const Tensor& col_indices,
+                          const Tensor& values, IntList size);
+};
+
+} // namespace at
@@ -182,11 +182,16 @@ struct TensorOptions {
   }
 
   // Resolves the ATen backend specified by the current construction axes.
-  Backend backend() const noexcept {
+  Backend backend() const {
     Backend backend;
     if (device_.type() == Device::Type::CPU) {
-      backend = (layout_ == kStrided) ? kCPU : kSparseCPU;
+      if (layout_ == kSparseCsr) {
+        backend = kSparseCsrCPU;
+      } else {
+        backend = (layout_ == kStrided) ? kCPU : kSparseCPU;
+      }
     } else {
+      AT_CHECK(layout_ != kSparseCsr, "sparse CSR tensors are only supported on the CPU");
       backend = (layout_ == kStrided) ? kCUDA : kSparseCUDA;
     }
     return backend;
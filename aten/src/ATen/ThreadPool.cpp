@@ -0,0 +1,249 @@
+#include "ATen/ThreadPool.h"
+#include "ATen/CPUGeneral.h"
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace at {
+
+namespace {
+
+// Each thread gets this many chunks on average, so that threads which finish
+// early have something left to steal.
+constexpr int64_t kTasksPerThread = 4;
+
+thread_local bool in_parallel_region_ = false;
+
+} // namespace
+
+ThreadPool::ThreadPool(int num_threads) : queued_(0), stop_(false) {
+  num_threads = std::max(num_threads, 1);
+  queues_.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  threads_.reserve(num_threads - 1);
+  for (int i = 1; i < num_threads; i++) {
+    threads_.emplace_back(&ThreadPool::worker_main, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool ThreadPool::in_parallel_region() {
+  return in_parallel_region_;
+}
+
+void ThreadPool::run(
+    int64_t begin,
+    int64_t end,
+    int64_t chunk_size,
+    const RangeFn& fn) {
+  if (begin >= end) {
+    return;
+  }
+  chunk_size = std::max<int64_t>(chunk_size, 1);
+  const int64_t num_tasks = divup(end - begin, chunk_size);
+  const size_t num_queues = queues_.size();
+  Job job(fn, num_tasks);
+
+  // Count the tasks before publishing them, so that a worker which pops one
+  // never observes a negative count.
+  queued_ += num_tasks;
+  for (size_t q = 0; q < num_queues && static_cast<int64_t>(q) < num_tasks; q++) {
+    std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+    for (int64_t t = q; t < num_tasks; t += num_queues) {
+      int64_t task_begin = begin + t * chunk_size;
+      queues_[q]->tasks.push_back(
+          Task{&job, task_begin, std::min(end, task_begin + chunk_size)});
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wakeup_.notify_all();
+
+  Task task;
+  while (job.pending.load() > 0) {
+    if (pop(0, task) || steal(0, task)) {
+      execute(task);
+      continue;
+    }
+    // Everything left is already running on other threads.
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.done.wait(lock, [&job] { return job.pending.load() == 0; });
+  }
+  // The last task decrements pending while holding job.mutex; taking it here
+  // guarantees that no other thread touches the job after we return.
+  std::lock_guard<std::mutex> lock(job.mutex);
+  if (job.error) {
+    std::rethrow_exception(job.error);
+  }
+}
+
+bool ThreadPool::pop(size_t self, Task& task) {
+  auto& queue = *queues_[self];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = queue.tasks.back();
+  queue.tasks.pop_back();
+  queued_--;
+  return true;
+}
+
+bool ThreadPool::steal(size_t self, Task& task) {
+  const size_t num_queues = queues_.size();
+  for (size_t i = 1; i < num_queues; i++) {
+    auto& queue = *queues_[(self + i) % num_queues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::execute(const Task& task) {
+  Job* job = task.job;
+  bool was_in_parallel_region = in_parallel_region_;
+  in_parallel_region_ = true;
+  try {
+    job->fn(task.begin, task.end);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->error) {
+      job->error = std::current_exception();
+    }
+  }
+  in_parallel_region_ = was_in_parallel_region;
+
+  std::lock_guard<std::mutex> lock(job->mutex);
+  if (--job->pending == 0) {
+    job->done.notify_all();
+  }
+}
+
+void ThreadPool::worker_main(size_t self) {
+  Task task;
+  while (true) {
+    if (pop(self, task) || steal(self, task)) {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wakeup_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+    if (stop_ && queued_.load() == 0) {
+      return;
+    }
+  }
+}
+
+namespace internal {
+
+namespace {
+
+bool default_use_thread_pool() {
+  if (const char* env = std::getenv("ATEN_THREAD_POOL")) {
+    return std::strcmp(env, "0") != 0;
+  }
+#ifdef _OPENMP
+  return false;
+#else
+  return true;
+#endif
+}
+
+// at::get_num_threads() is -1 until a thread count is set, in which case the
+// pool has a thread per hardware thread
+int pool_num_threads() {
+  int num_threads = get_num_threads();
+  if (num_threads <= 0) {
+    num_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+  }
+  return num_threads;
+}
+
+std::atomic<bool>& use_thread_pool_flag() {
+  static std::atomic<bool> flag(default_use_thread_pool());
+  return flag;
+}
+
+} // namespace
+
+std::shared_ptr<ThreadPool> intraop_pool() {
+  // Intentionally leaked: joining worker threads from a static destructor
+  // can deadlock at process exit.
+  static std::mutex* mutex = new std::mutex();
+  static std::shared_ptr<ThreadPool>* pool = new std::shared_ptr<ThreadPool>();
+
+  int num_threads = pool_num_threads();
+  std::lock_guard<std::mutex> lock(*mutex);
+  if (!*pool || (*pool)->size() != num_threads) {
+    // Regions still running on the old pool keep it alive until they finish.
+    *pool = std::make_shared<ThreadPool>(num_threads);
+  }
+  return *pool;
+}
+
+int get_intraop_num_threads() {
+#ifdef _OPENMP
+  if (!use_thread_pool()) {
+    return omp_in_parallel() ? 1 : omp_get_max_threads();
+  }
+#endif
+  if (ThreadPool::in_parallel_region()) {
+    return 1;
+  }
+  return pool_num_threads();
+}
+
+bool use_thread_pool() {
+  return use_thread_pool_flag().load(std::memory_order_relaxed);
+}
+
+void set_use_thread_pool(bool enabled) {
+  use_thread_pool_flag().store(enabled);
+}
+
+void parallel_for_thread_pool(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const ThreadPool::RangeFn& f) {
+  if (begin >= end) {
+    return;
+  }
+  const int64_t numel = end - begin;
+  if (numel < grain_size || ThreadPool::in_parallel_region()) {
+    f(begin, end);
+    return;
+  }
+  auto pool = intraop_pool();
+  if (pool->size() == 1) {
+    f(begin, end);
+    return;
+  }
+  int64_t chunk_size = std::max<int64_t>(
+      std::max<int64_t>(grain_size, 1),
+      divup(numel, pool->size() * kTasksPerThread));
+  pool->run(begin, end, chunk_size, f);
+}
+
+} // namespace internal
+} // namespace at
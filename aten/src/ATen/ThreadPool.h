@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ATen/ATenGeneral.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A native intra-op thread pool used by at::parallel_for and
+// at::parallel_reduce as an alternative to OpenMP.
+//
+// Every thread owns a deque of tasks. A parallel region is split into chunks
+// which are distributed round-robin over all deques. Threads pop work from
+// the back of their own deque and, once it runs dry, steal from the front of
+// the other deques, so uneven chunks do not leave threads idle while a single
+// thread finishes its static share of the range.
+//
+// The thread calling run() acts as a member of the pool: it owns deque 0 and
+// executes tasks until its parallel region has completed. Parallel regions
+// started from inside a task are executed inline by the calling thread.
+
+namespace at {
+
+class AT_API ThreadPool {
+ public:
+  using RangeFn = std::function<void(int64_t, int64_t)>;
+
+  // num_threads counts the calling thread, i.e. num_threads - 1 worker
+  // threads are spawned.
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int size() const {
+    return static_cast<int>(queues_.size());
+  }
+
+  // Calls fn on consecutive subranges of [begin, end), each of at most
+  // chunk_size elements, and blocks until all of them have returned. If any
+  // call throws, the first exception is rethrown here once the region has
+  // finished.
+  void run(int64_t begin, int64_t end, int64_t chunk_size, const RangeFn& fn);
+
+  // True while the current thread is executing a task of some pool.
+  static bool in_parallel_region();
+
+ private:
+  struct Job {
+    explicit Job(const RangeFn& fn, int64_t pending) : fn(fn), pending(pending) {}
+    const RangeFn& fn;
+    std::atomic<int64_t> pending;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+
+  struct Task {
+    Job* job;
+    int64_t begin;
+    int64_t end;
+  };
+
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool pop(size_t self, Task& task);
+  bool steal(size_t self, Task& task);
+  void execute(const Task& task);
+  void worker_main(size_t self);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  // Number of tasks sitting in some queue; idle workers sleep while it is 0.
+  std::atomic<int64_t> queued_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wakeup_;
+  bool stop_;
+};
+
+namespace internal {
+
+// Returns the shared intra-op pool, sized by at::get_num_threads() (or the
+// hardware concurrency if no thread count has been set). The pool is rebuilt
+// when the requested thread count changes.
+AT_API std::shared_ptr<ThreadPool> intraop_pool();
+
+// Number of threads parallel_for splits work between when called from the
+// current thread: the size of the intra-op pool (or of an OpenMP team), and 1
+// inside a parallel region. Unlike at::get_num_threads(), which is -1 until a
+// thread count is set, this is always at least 1; kernels that split work
+// into a chunk per thread should use it.
+AT_API int get_intraop_num_threads();
+
+// Whether parallel_for / parallel_reduce run on the native pool rather than
+// on OpenMP. Defaults to the native pool in builds without OpenMP; the
+// ATEN_THREAD_POOL environment variable (0 or 1) overrides the default.
+AT_API bool use_thread_pool();
+AT_API void set_use_thread_pool(bool enabled);
+
+// Runs f over [begin, end) on the intra-op pool. Chunks are never smaller
+// than grain_size, and ranges smaller than grain_size run inline.
+AT_API void parallel_for_thread_pool(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const ThreadPool::RangeFn& f);
+
+} // namespace internal
+} // namespace at
@@ -110,7 +110,7 @@ def create_one_copy(dst_type, all_types):
     copy_body = []
 
     for src_type in all_types:
-        if dst_type['Density'] == 'Sparse' or src_type['Density'] == 'Sparse':
+        if dst_type['Density'] != 'Dense' or src_type['Density'] != 'Dense':
             # skip sparse copies, which are not yet implemented
             continue
         cuda = ''
@@ -163,7 +163,7 @@ def create_one_copy_from(src_type, all_types):
     copy_body = []
 
     for dst_type in all_types:
-        if dst_type['Density'] == 'Sparse' or src_type['Density'] == 'Sparse':
+        if dst_type['Density'] != 'Dense' or src_type['Density'] != 'Dense':
             # skip sparse copies, which are not yet implemented
             continue
         cuda = ''
@@ -0,0 +1,46 @@
+#pragma once
+
+// Vectorized<T> is the widest vector type of the CPU capability that the
+// including file is compiled for: Vec512<T> in the AVX512 builds of the
+// kernels in native/cpu and Vec256<T> everywhere else. Kernels written
+// against Vectorized<T> and the functions below therefore use the full
+// register width of every capability they are compiled for.
+
+#if defined(CPU_CAPABILITY_AVX512)
+#include "ATen/cpu/vec512/functional.h"
+#include "ATen/cpu/vec512/vec512.h"
+#else
+#include "ATen/cpu/vec256/functional.h"
+#include "ATen/cpu/vec256/vec256.h"
+#endif
+
+namespace at {
+namespace vec {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <typename T>
+using Vectorized = vec512::Vec512<T>;
+
+using vec512::max;
+using vec512::reduce_all;
+using vec512::map_reduce_all;
+using vec512::map2_reduce_all;
+using vec512::map;
+using vec512::map2;
+
+#else
+
+template <typename T>
+using Vectorized = vec256::Vec256<T>;
+
+using vec256::max;
+using vec256::reduce_all;
+using vec256::map_reduce_all;
+using vec256::map2_reduce_all;
+using vec256::map;
+using vec256::map2;
+
+#endif
+
+}} // namespace at::vec
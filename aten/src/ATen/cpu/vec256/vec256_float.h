@@ -109,16 +109,16 @@ public:
     return Vec256<float>(Sleef_log1pf8_u10(values));
   }
   Vec256<float> sin() const {
-    return map(std::sin);
+    return Vec256<float>(Sleef_sinf8_u10(values));
   }
   Vec256<float> sinh() const {
-    return map(std::sinh);
+    return Vec256<float>(Sleef_sinhf8_u10(values));
   }
   Vec256<float> cos() const {
-    return map(std::cos);
+    return Vec256<float>(Sleef_cosf8_u10(values));
   }
   Vec256<float> cosh() const {
-    return map(std::cosh);
+    return Vec256<float>(Sleef_coshf8_u10(values));
   }
   Vec256<float> ceil() const {
     return _mm256_ceil_ps(values);
@@ -130,7 +130,7 @@ public:
     return _mm256_round_ps(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
   }
   Vec256<float> tan() const {
-    return map(std::tan);
+    return Vec256<float>(Sleef_tanf8_u10(values));
   }
   Vec256<float> tanh() const {
     return Vec256<float>(Sleef_tanhf8_u10(values));
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "ATen/cpu/vec256/intrinsics.h"
+#include "vec512_base.h"
+
+namespace at {
+namespace vec512 {
+namespace {
+
+// 16-bit integers need AVX512BW and the 64-bit multiply needs AVX512DQ.
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__)
+
+struct Vec512i {
+  __m512i values;
+  Vec512i() {}
+  Vec512i(__m512i v) : values(v) {}
+  operator __m512i() const {
+    return values;
+  }
+};
+
+template <>
+struct Vec512<int64_t> : public Vec512i {
+  static constexpr int size = 8;
+  using Vec512i::Vec512i;
+  Vec512() {}
+  Vec512(int64_t v) { values = _mm512_set1_epi64(v); }
+  template <int64_t mask>
+  static Vec512<int64_t> blend(Vec512<int64_t> a, Vec512<int64_t> b) {
+    return _mm512_mask_blend_epi64(mask, a.values, b.values);
+  }
+  static Vec512<int64_t>
+  set(Vec512<int64_t> a, Vec512<int64_t> b, int64_t count = size) {
+    if (count >= size)
+      return b;
+    return _mm512_mask_blend_epi64(static_cast<__mmask8>((1 << count) - 1), a.values, b.values);
+  }
+  static Vec512<int64_t> loadu(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static Vec512<int64_t> loadu(const void* ptr, int64_t count) {
+    return _mm512_maskz_loadu_epi64(static_cast<__mmask8>((1 << count) - 1), ptr);
+  }
+  void store(void* ptr, int count = size) const {
+    if (count == size) {
+      _mm512_storeu_si512(ptr, values);
+    } else {
+      _mm512_mask_storeu_epi64(ptr, static_cast<__mmask8>((1 << count) - 1), values);
+    }
+  }
+  Vec512<int64_t> abs() const {
+    return _mm512_abs_epi64(values);
+  }
+};
+
+template <>
+struct Vec512<int32_t> : public Vec512i {
+  static constexpr int size = 16;
+  using Vec512i::Vec512i;
+  Vec512() {}
+  Vec512(int32_t v) { values = _mm512_set1_epi32(v); }
+  template <int64_t mask>
+  static Vec512<int32_t> blend(Vec512<int32_t> a, Vec512<int32_t> b) {
+    return _mm512_mask_blend_epi32(mask, a.values, b.values);
+  }
+  static Vec512<int32_t>
+  set(Vec512<int32_t> a, Vec512<int32_t> b, int64_t count = size) {
+    if (count >= size)
+      return b;
+    return _mm512_mask_blend_epi32(static_cast<__mmask16>((1 << count) - 1), a.values, b.values);
+  }
+  static Vec512<int32_t> loadu(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static Vec512<int32_t> loadu(const void* ptr, int64_t count) {
+    return _mm512_maskz_loadu_epi32(static_cast<__mmask16>((1 << count) - 1), ptr);
+  }
+  void store(void* ptr, int count = size) const {
+    if (count == size) {
+      _mm512_storeu_si512(ptr, values);
+    } else {
+      _mm512_mask_storeu_epi32(ptr, static_cast<__mmask16>((1 << count) - 1), values);
+    }
+  }
+  Vec512<int32_t> abs() const {
+    return _mm512_abs_epi32(values);
+  }
+};
+
+template <>
+struct Vec512<int16_t> : public Vec512i {
+  static constexpr int size = 32;
+  using Vec512i::Vec512i;
+  Vec512() {}
+  Vec512(int16_t v) { values = _mm512_set1_epi16(v); }
+  template <int64_t mask>
+  static Vec512<int16_t> blend(Vec512<int16_t> a, Vec512<int16_t> b) {
+    return _mm512_mask_blend_epi16(mask, a.values, b.values);
+  }
+  static Vec512<int16_t>
+  set(Vec512<int16_t> a, Vec512<int16_t> b, int64_t count = size) {
+    if (count >= size)
+      return b;
+    return _mm512_mask_blend_epi16(static_cast<__mmask32>((1ULL << count) - 1), a.values, b.values);
+  }
+  static Vec512<int16_t> loadu(const void* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  static Vec512<int16_t> loadu(const void* ptr, int64_t count) {
+    return _mm512_maskz_loadu_epi16(static_cast<__mmask32>((1ULL << count) - 1), ptr);
+  }
+  void store(void* ptr, int count = size) const {
+    if (count == size) {
+      _mm512_storeu_si512(ptr, values);
+    } else {
+      _mm512_mask_storeu_epi16(ptr, static_cast<__mmask32>((1ULL << count) - 1), values);
+    }
+  }
+  Vec512<int16_t> abs() const {
+    return _mm512_abs_epi16(values);
+  }
+};
+
+template <>
+Vec512<int64_t> inline operator+(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  return _mm512_add_epi64(a, b);
+}
+
+template <>
+Vec512<int32_t> inline operator+(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_add_epi32(a, b);
+}
+
+template <>
+Vec512<int16_t> inline operator+(const Vec512<int16_t>& a, const Vec512<int16_t>& b) {
+  return _mm512_add_epi16(a, b);
+}
+
+template <>
+Vec512<int64_t> inline operator*(const Vec512<int64_t>& a, const Vec512<int64_t>& b) {
+  return _mm512_mullo_epi64(a, b);
+}
+
+template <>
+Vec512<int32_t> inline operator*(const Vec512<int32_t>& a, const Vec512<int32_t>& b) {
+  return _mm512_mullo_epi32(a, b);
+}
+
+template <>
+Vec512<int16_t> inline operator*(const Vec512<int16_t>& a, const Vec512<int16_t>& b) {
+  return _mm512_mullo_epi16(a, b);
+}
+
+#endif
+
+}}}
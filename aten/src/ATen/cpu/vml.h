@@ -2,11 +2,18 @@
 
 #include "ATen/Config.h"
 #include "ATen/Parallel.h"
-#include "ATen/cpu/vec256/functional.h"
-#include "ATen/cpu/vec256/vec256.h"
+#include "ATen/cpu/vec.h"
 
 // This header implements various unary operations using a MKL VML style
 // interface.
+//
+// Without MKL (and for the functions MKL does not provide) the operations run
+// on Vectorized<scalar_t>. In the AVX, AVX2 and AVX512 builds its
+// transcendental functions call the SLEEF vector implementations with a
+// maximum error of 1.0 ULP (the _u10 variants); vsigmoid adds up to one more
+// ULP for the final add and division, for results in the normal range. The
+// DEFAULT build calls libm for every element. ATen/test/unary_ops_test.cpp
+// checks these bounds.
 
 #include <algorithm>
 #include <cstddef>
@@ -23,14 +30,29 @@ namespace at {
 namespace vml {
 namespace {
 
-using namespace vec256;
+using namespace vec;
 
 template <typename scalar_t>
 inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {
     map(
-        [](const Vec256<scalar_t>& x) {
-          return Vec256<scalar_t>((scalar_t)(1)) / x.sqrt();
+        [](const Vectorized<scalar_t>& x) {
+          return Vectorized<scalar_t>((scalar_t)(1)) / x.sqrt();
+        },
+        out + begin,
+        in + begin,
+        end - begin);
+  });
+}
+
+template <typename scalar_t>
+inline void vsigmoid(scalar_t* out, scalar_t* in, int64_t size) {
+  parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {
+    map(
+        [](const Vectorized<scalar_t>& x) {
+          // exp(-x) overflows to inf for very negative x, which gives 0
+          auto one = Vectorized<scalar_t>((scalar_t)(1));
+          return one / (one + (Vectorized<scalar_t>((scalar_t)(0)) - x).exp());
         },
         out + begin,
         in + begin,
@@ -44,7 +66,7 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   template <typename scalar_t>                                          \
   inline void v##op(scalar_t* out, scalar_t* in, int64_t size) {        \
     parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) { \
-      map([](const Vec256<scalar_t>& x) { return x.op(); },             \
+      map([](const Vectorized<scalar_t>& x) { return x.op(); },         \
           out + begin,                                                  \
           in + begin,                                                   \
           end - begin);                                                 \
@@ -155,7 +155,7 @@ generators = {
 }
 
 backends = ['CPU', 'CUDA']
-densities = ['Dense', 'Sparse']
+densities = ['Dense', 'Sparse', 'SparseCsr']
 
 # scalar_name, c_type, accreal, th_scalar_type, is_floating_type
 scalar_types = [
@@ -230,7 +230,7 @@ def format_yaml(data):
 def generate_storage_type_and_tensor(backend, density, scalar_type, declarations):
     scalar_name, c_type, accreal, th_scalar_type, is_floating_type = scalar_type
     env = {}
-    density_tag = 'Sparse' if density == 'Sparse' else ''
+    density_tag = density if density != 'Dense' else ''
     th_density_tag = 'S' if density == 'Sparse' else ''
     env['Density'] = density
     env['ScalarName'] = scalar_name
@@ -295,6 +295,16 @@ def generate_storage_type_and_tensor(backend, density, scalar_type, declarations
         env['isCUDA'] = 'false'
         env['storage_device'] = 'throw std::runtime_error("CPU storage has no device");'
         env['Generator'] = 'CPUGenerator'
+    env['tensor_from_th'] = [
+        'if (retain)',
+        '  {}_retain({}({}*) th_pointer);'.format(
+            env['THTensor'], ''.join(s + ', ' for s in env['state']), env['THTensor']),
+        'return Tensor(new {}(context,({}*)(th_pointer)), false);'.format(env['Tensor'], env['THTensor']),
+    ]
+    if density == 'SparseCsr':
+        # CSR tensors are SparseCsrTensorImpls that only have native functions
+        env['Tensor'] = 'SparseCsrTensorImpl'
+        env['tensor_from_th'] = ['AT_ERROR("unsafeTensorFromTH is not supported for ", toString());']
     env['AS_REAL'] = env['ScalarType']
     if scalar_name == "Half":
         env['SparseTensor'] = 'Tensor'
@@ -313,6 +323,13 @@ def generate_storage_type_and_tensor(backend, density, scalar_type, declarations
         env['to_th_type'] = ''
         env['to_at_type'] = ''
 
+    if density == 'SparseCsr':
+        env['tensor_headers'] = []
+    else:
+        env['tensor_headers'] = [
+            '#include "ATen/{}{}Tensor.h"'.format(env['Backend'], s) for s in ['Byte', 'Int', 'Long']]
+        env['tensor_headers'].append('#include "ATen/{}.h"'.format(env['SparseTensor']))
+
     declarations, definitions = function_wrapper.create_derived(
         env, declarations)
     env['type_derived_method_declarations'] = declarations
@@ -322,7 +339,7 @@ def generate_storage_type_and_tensor(backend, density, scalar_type, declarations
     if env['DenseBackend'] == 'CUDA':
         fm = cuda_file_manager
 
-    if density != 'Sparse':
+    if density == 'Dense':
         # there are no special storage types for Sparse, they are composed
         # of Dense tensors
         fm.write(env['Storage'] + ".cpp", STORAGE_DERIVED_CPP, env)
@@ -334,11 +351,12 @@ def generate_storage_type_and_tensor(backend, density, scalar_type, declarations
     fm.write(env['Type'] + ".cpp", TYPE_DERIVED_CPP, env)
     fm.write(env['Type'] + ".h", TYPE_DERIVED_H, env)
 
-    fm.write(env['Tensor'] + ".cpp", TENSOR_DERIVED_CPP, env)
-    if density != 'SPARSE':
-        fm.write(env['Tensor'] + ".h", TENSOR_DERIVED_H, env)
-    else:
-        fm.write(env['Tensor'] + ".h", SPARSE_TENSOR_DERIVED_H, env)
+    if density != 'SparseCsr':
+        fm.write(env['Tensor'] + ".cpp", TENSOR_DERIVED_CPP, env)
+        if density != 'SPARSE':
+            fm.write(env['Tensor'] + ".h", TENSOR_DERIVED_H, env)
+        else:
+            fm.write(env['Tensor'] + ".h", SPARSE_TENSOR_DERIVED_H, env)
 
     type_register = TYPE_REGISTER.substitute(backend=env['Backend'], scalar_type=scalar_name, type_name=env['Type'])
     if env['DenseBackend'] == 'CPU':
@@ -357,8 +375,11 @@ def generate_storage_type_and_tensor(backend, density, scalar_type, declarations
 def iterate_types():
     for backend in backends:
         for density in densities:
+            if density == 'SparseCsr' and backend != 'CPU':
+                # CSR tensors are only implemented natively on the CPU
+                continue
             for scalar_type in scalar_types:
-                if density == 'Sparse' and scalar_type[0] == 'Half':
+                if density != 'Dense' and scalar_type[0] == 'Half':
                     # THS does not do half type yet.
                     continue
                 yield (backend, density, scalar_type)
@@ -384,9 +405,11 @@ def declare_outputs():
         fm.will_write(fname)
     for backend, density, scalar_types in iterate_types():
         scalar_name = scalar_types[0]
-        full_backend = "Sparse" + backend if density == "Sparse" else backend
+        full_backend = density + backend if density != "Dense" else backend
         for kind in ["Storage", "Type", "Tensor"]:
-            if kind == 'Storage' and density == "Sparse":
+            if kind == 'Storage' and density != "Dense":
+                continue
+            if kind == 'Tensor' and density == "SparseCsr":
                 continue
             fm = file_manager
             if backend == 'CUDA':
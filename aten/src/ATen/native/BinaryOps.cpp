@@ -0,0 +1,67 @@
+#include "ATen/ATen.h"
+#include "ATen/NativeFunctions.h"
+#include "ATen/native/TensorIterator.h"
+#include "ATen/native/cpu/BinaryOpsKernel.h"
+
+// Dense CPU implementations of the s_native_* pointwise functions. Their
+// operands have already been broadcast with expand (see LegacyBridge.cpp),
+// which only sets strides to 0; TensorIterator turns those strides into inner
+// loops without copying, and the kernels in cpu/BinaryOpsKernel.cpp are
+// dispatched on the CPU's capabilities.
+
+namespace at { namespace native {
+
+#define IMPLEMENT_BINARY_OP_ALPHA(op)                                          \
+  Tensor& s_##op##_out_cpu(Tensor& result, const Tensor& self,                 \
+                           const Tensor& other, Scalar alpha) {                \
+    TensorIterator iter(result, {self, other});                                \
+    op##_kernel(iter, alpha);                                                  \
+    return result;                                                             \
+  }                                                                            \
+  Tensor s_##op##_cpu(const Tensor& self, const Tensor& other, Scalar alpha) { \
+    Tensor result = self.type().tensor();                                      \
+    return s_##op##_out_cpu(result, self, other, alpha);                       \
+  }                                                                            \
+  Tensor& s_##op##_cpu_(Tensor& self, const Tensor& other, Scalar alpha) {     \
+    return s_##op##_out_cpu(self, self, other, alpha);                         \
+  }
+
+#define IMPLEMENT_BINARY_OP(op)                                                \
+  Tensor& s_##op##_out_cpu(Tensor& result, const Tensor& self,                 \
+                           const Tensor& other) {                              \
+    TensorIterator iter(result, {self, other});                                \
+    op##_kernel(iter);                                                         \
+    return result;                                                             \
+  }                                                                            \
+  Tensor s_##op##_cpu(const Tensor& self, const Tensor& other) {               \
+    Tensor result = self.type().tensor();                                      \
+    return s_##op##_out_cpu(result, self, other);                              \
+  }                                                                            \
+  Tensor& s_##op##_cpu_(Tensor& self, const Tensor& other) {                   \
+    return s_##op##_out_cpu(self, self, other);                                \
+  }
+
+IMPLEMENT_BINARY_OP_ALPHA(add)
+IMPLEMENT_BINARY_OP_ALPHA(sub)
+IMPLEMENT_BINARY_OP(mul)
+IMPLEMENT_BINARY_OP(div)
+
+Tensor& s_addcmul_out_cpu(Tensor& result, const Tensor& self, const Tensor& tensor1,
+                          const Tensor& tensor2, Scalar value) {
+  TensorIterator iter(result, {self, tensor1, tensor2});
+  addcmul_kernel(iter, value);
+  return result;
+}
+
+Tensor s_addcmul_cpu(const Tensor& self, const Tensor& tensor1, const Tensor& tensor2,
+                     Scalar value) {
+  Tensor result = self.type().tensor();
+  return s_addcmul_out_cpu(result, self, tensor1, tensor2, value);
+}
+
+Tensor& s_addcmul_cpu_(Tensor& self, const Tensor& tensor1, const Tensor& tensor2,
+                       Scalar value) {
+  return s_addcmul_out_cpu(self, self, tensor1, tensor2, value);
+}
+
+}} // namespace at::native
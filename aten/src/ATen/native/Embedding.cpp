@@ -1,6 +1,8 @@
 #include "ATen/ATen.h"
 #include "ATen/TensorUtils.h"
 #include "ATen/NativeFunctions.h"
+#include "ATen/Parallel.h"
+#include "ATen/native/IndexGrouping.h"
 
 #include <cstring>
 #include <memory>
@@ -52,10 +54,24 @@ Tensor embedding_sparse_backward(
   checkScalarType("embedding_backward", indices_arg, kLong);
   checkContiguous("embedding_backward", indices_arg);
 
+  int64_t num_features = grad_.size(-1);
+  auto weight_size = std::array<int64_t, 2>{{ num_weights, num_features }};
+  auto& dense_type = grad_.type();
+  auto& sparse_type = dense_type.toBackend(grad_.is_cuda() ? kSparseCUDA : kSparseCPU);
+
+  if (!grad_.is_cuda()) {
+    // sum the gradients of equal indices here, so that the result is coalesced
+    Tensor index, values;
+    std::tie(index, values) = at::embedding_grad_coalesce(
+        grad_.contiguous().view({-1, num_features}), indices_.view(-1), num_weights,
+        padding_idx, scale_grad_by_freq);
+    return sparse_type._sparse_coo_tensor_unsafe(index, values, weight_size)._coalesced_(true);
+  }
+
   // TODO: implement scale_grad_by_freq
   if (scale_grad_by_freq) {
     AT_ERROR(
-        "embedding_backward: scale_grad_by_freq not supported with sparse gradients");
+        "embedding_backward: scale_grad_by_freq not supported with sparse CUDA gradients");
   }
 
   Tensor indices = indices_;
@@ -66,11 +82,6 @@ Tensor embedding_sparse_backward(
     grad = grad.index(c);
   }
 
-  int64_t num_features = grad_.size(-1);
-  auto weight_size = std::array<int64_t, 2>{{ num_weights, num_features }};
-  auto& dense_type = grad.type();
-  auto& sparse_type = dense_type.toBackend(grad.is_cuda() ? kSparseCUDA : kSparseCPU);
-
   // check if all our grad come from padding_idx
   if (grad.numel() == 0) {
     return sparse_type._sparse_coo_tensor_unsafe(indices_.type().tensor(),
@@ -82,6 +93,32 @@ Tensor embedding_sparse_backward(
   return sparse_type._sparse_coo_tensor_unsafe(index, values, weight_size);
 }
 
+// Adds the rows of grad of every group, divided by the size of the group if
+// scale_grad_by_freq, into row out_row(g) of out. Groups are summed in
+// parallel and write disjoint rows.
+template <typename scalar_t, typename OutRow>
+static void sum_groups(const IndexGroups& groups, const Tensor& grad,
+                       bool scale_grad_by_freq, scalar_t* out, const OutRow& out_row) {
+  const scalar_t* grad_data = grad.data<scalar_t>();
+  int64_t dim = grad.size(1);
+  int64_t num_groups = groups.size();
+  int64_t group_work = std::max<int64_t>(1, grad.size(0) / std::max<int64_t>(num_groups, 1)) * dim;
+  parallel_for(0, num_groups, divup(internal::GRAIN_SIZE, std::max<int64_t>(group_work, 1)), [&](int64_t begin, int64_t end) {
+    for (int64_t g = begin; g < end; g++) {
+      scalar_t* row = out + out_row(g) * dim;
+      int64_t first = groups.offsets[g];
+      int64_t last = groups.offsets[g + 1];
+      scalar_t scale = scale_grad_by_freq ? scalar_t(1) / (last - first) : scalar_t(1);
+      for (int64_t i = first; i < last; i++) {
+        const scalar_t* src = grad_data + groups.positions[i] * dim;
+        for (int64_t j = 0; j < dim; j++) {
+          row[j] += src[j] * scale;
+        }
+      }
+    }
+  });
+}
+
 Tensor embedding_backward_cpu(
     const Tensor & grad_, const Tensor & indices, int64_t num_weights,
     int64_t padding_idx, bool scale_grad_by_freq) {
@@ -90,64 +127,44 @@ Tensor embedding_backward_cpu(
   checkScalarType("embedding_backward", indices_arg, kLong);
   checkContiguous("embedding_backward", indices_arg);
 
-  auto indices_data = indices.data<int64_t>();
   int64_t numel = indices.numel();
-
-  std::unique_ptr<int64_t[]> counts;
-  if (scale_grad_by_freq) {
-    counts.reset(new int64_t[num_weights]);
-    for (int i = 0; i < numel; i++) {
-      counts[indices_data[i]] = 0;
-    }
-    for (int i = 0; i < numel; i++) {
-      counts[indices_data[i]]++;
-    }
-  }
-
   auto grad = grad_.contiguous().view({numel, grad_.size(-1)});
   auto grad_weight = at::zeros({num_weights, grad_.size(-1)}, grad_.type());
 
-#ifdef _OPENMP
-  if (numel > 1000) {
-    // The strategy is to parallelize over sections of the vocabulary, so that
-    // thread 1 handles updates to gradWeight[0..nVocab/nThreads]. Every thread
-    // has to traverse the entire input, but the dominating factor is the axpy
-    // BLAS call.
-    #pragma omp parallel
-    {
-      int tid = omp_get_thread_num();
-      int nthreads = omp_get_num_threads();
-      int64_t start = tid * (num_weights/nthreads + 1);
-      int64_t end = start + (num_weights/nthreads + 1);
-      for (int64_t i = 0; i < numel; i++) {
-        if (indices_data[i] != padding_idx) {
-          int64_t k = indices_data[i];
-          if (k >= start && k < end) {
-            double scale = 1.0;
-            if (scale_grad_by_freq) {
-              scale /= counts[k];
-            }
-            grad_weight[k].add_(grad[i], scale);
-          }
-        }
-      }
-    }
-    return grad_weight;
-  }
-#endif
+  // Every distinct index is summed by one thread into its own row of
+  // grad_weight.
+  auto groups = group_indices(indices.data<int64_t>(), numel, num_weights, padding_idx);
+  AT_DISPATCH_FLOATING_TYPES(grad.type(), "embedding_backward", [&] {
+    sum_groups(groups, grad, scale_grad_by_freq, grad_weight.data<scalar_t>(),
+               [&](int64_t g) { return groups.keys[g]; });
+  });
+  return grad_weight;
+}
 
-  for (int64_t i = 0; i < numel; i++) {
-    if (indices_data[i] != padding_idx) {
-      int64_t k = indices_data[i];
-      double scale = 1.0;
-      if (scale_grad_by_freq) {
-        scale /= counts[k];
-      }
-      grad_weight[k].add_(grad[i], scale);
-    }
-  }
+std::tuple<Tensor, Tensor> embedding_grad_coalesce_cpu(
+    const Tensor & grad_, const Tensor & indices, int64_t num_weights,
+    int64_t padding_idx, bool scale_grad_by_freq) {
 
-  return grad_weight;
+  auto indices_arg = TensorArg(indices, "indices", 2);
+  checkScalarType("embedding_backward", indices_arg, kLong);
+  checkContiguous("embedding_backward", indices_arg);
+
+  int64_t numel = indices.numel();
+  auto grad = grad_.contiguous().view({numel, grad_.size(-1)});
+
+  auto groups = group_indices(indices.data<int64_t>(), numel, num_weights, padding_idx);
+  if (groups.size() == 0) {
+    // all the gradients come from padding_idx
+    return std::make_tuple(indices.type().tensor(), grad.type().tensor());
+  }
+  auto index = indices.type().tensor({1, groups.size()});
+  std::copy(groups.keys.begin(), groups.keys.end(), index.data<int64_t>());
+  auto values = at::zeros({groups.size(), grad.size(1)}, grad.type());
+  AT_DISPATCH_FLOATING_TYPES(grad.type(), "embedding_backward", [&] {
+    sum_groups(groups, grad, scale_grad_by_freq, values.data<scalar_t>(),
+               [](int64_t g) { return g; });
+  });
+  return std::make_tuple(index, values);
 }
 
 Tensor & embedding_renorm_cpu_(
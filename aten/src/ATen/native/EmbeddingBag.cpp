@@ -1,9 +1,13 @@
 #include "ATen/ATen.h"
 #include "ATen/TensorUtils.h"
 #include "ATen/NativeFunctions.h"
+#include "ATen/Parallel.h"
+#include "ATen/native/cpu/EmbeddingBagKernel.h"
 
 #include "TH/THBlasUtils.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -31,26 +35,32 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices,
   offset2bag = offset2bag.cumsum(0);     // offset2bag = [0 0 1 1 2]
 }
 
-// This function combines index_select (using select_indices as the index) and
-// index_add (using add_indices as the index), without creating an intermediary
-// tensor to hold the selected embeddings
-template<typename T>
-static void index_select_add(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output) {
-  auto add_indices_data = add_indices.data<int64_t>();
-  auto select_indices_data = select_indices.data<int64_t>();
-  auto src_data = src.data<T>();
-  auto output_data = output.data<T>();
-  auto numel = add_indices.numel();
-  int64_t ddim = src.size(1);
-  for (int64_t i = 0; i < numel; i++) {
-    THBlas_axpy<T>(ddim, 1, src_data + ddim * select_indices_data[i], 1,
-            output_data + ddim * add_indices_data[i], 1);
+// The kernels read rows without bounds checks
+static void check_indices(const Tensor &indices, int64_t num_weights) {
+  auto indices_data = indices.data<int64_t>();
+  for (int64_t i = 0; i < indices.numel(); i++) {
+    AT_CHECK(indices_data[i] >= 0 && indices_data[i] < num_weights,
+             "embedding_bag: index ", indices_data[i], " is out of range for ",
+             num_weights, " embeddings");
   }
 }
 
+// The kernel reads indices[offsets[i] .. offsets[i + 1]) for bag i, so the
+// offsets must be increasing and within indices.
+static void check_offsets(const Tensor &offsets, const Tensor &indices) {
+  auto offsets_data = offsets.data<int64_t>();
+  int64_t num_bags = offsets.numel();
+  int64_t num_indices = indices.numel();
+  for (int64_t i = 0; i < num_bags; i++) {
+    AT_CHECK(offsets_data[i] >= (i == 0 ? 0 : offsets_data[i - 1]),
+             "embedding_bag: offsets must be non-negative and non-decreasing, got ",
+             offsets_data[i], " at position ", i);
+  }
+  AT_CHECK(num_bags == 0 || offsets_data[num_bags - 1] <= num_indices,
+           "embedding_bag: offset ", offsets_data[num_bags - 1],
+           " is out of range for ", num_indices, " indices");
+}
+
 static void make_bag_size(const Tensor &offsets, const Tensor &indices,
                           const int64_t mode, Tensor &bag_size) {
   if (mode == 1 || mode == 2) {
@@ -64,26 +74,6 @@ static void make_bag_size(const Tensor &offsets, const Tensor &indices,
   }
 }
 
-static Tensor apply_bag_size(const Tensor &offsets, const Tensor &indices,
-                             const int64_t mode, Tensor &output,
-                             const Tensor &bag_size) {
-  if (mode == 1) { // MODE_MEAN
-    if (offsets.size(0) == 1) {
-      auto bag_size_ = indices.size(0);
-      output /= bag_size_;
-    } else {
-      // Avoid dividing by 0 for empty bags.
-      // Instead we want empty bags to return all 0s
-      auto bag_size_ = at::max(bag_size, at::ones_like(bag_size))
-                           .toType(output.type())
-                           .unsqueeze(1)
-                           .expand_as(output);
-      output /= bag_size_;
-    }
-  }
-  return output;
-}
-
 static Tensor apply_bag_size_backward(const Tensor &offsets,
                                       const Tensor &indices, const int64_t mode,
                                       Tensor &output, const Tensor &offset2bag,
@@ -155,6 +145,7 @@ embedding_bag_cpu(const Tensor &weight, const Tensor &indices__,
   Tensor offsets = offsets__.contiguous();
   auto weight_arg = TensorArg(weight, "weight", 1);
   checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
+  check_offsets(offsets, indices);
 
   auto bag_size = at::zeros(offsets.sizes(), indices.type());
   make_bag_size(offsets, indices, mode, bag_size);
@@ -170,17 +161,14 @@ embedding_bag_cpu(const Tensor &weight, const Tensor &indices__,
 
   offset2bag.resize_({indices.sizes()[0]});
 
-  auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.type());
+  check_indices(indices, weight.size(0));
 
   if (mode == MODE_MEAN || mode == MODE_SUM) {
-    if (weight.type().scalarType() == kFloat) {
-      index_select_add<float>(indices, offset2bag, weight, output);
-    } else if (weight.type().scalarType() == kDouble) {
-      index_select_add<double>(indices, offset2bag, weight, output);
-    }
-    auto ret = apply_bag_size(offsets, indices, mode, output, bag_size);
-    return std::tuple<Tensor, Tensor, Tensor, Tensor>(ret, offset2bag, bag_size, bag_size);
+    auto output = weight.type().tensor({offsets.size(0), weight.size(1)});
+    embedding_bag_kernel(weight.contiguous(), indices, offsets, mode == MODE_MEAN, output);
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, bag_size);
   } else { // MODE_MAX
+    auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.type());
     return AT_DISPATCH_FLOATING_TYPES_AND_HALF(
       weight.type(), "embedding_bag_cpu_max", [&]() {
         return embedding_bag_cpu_max<scalar_t>(weight, indices, offset2bag, output, bag_size, offsets);
@@ -341,5 +329,83 @@ Tensor embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+Tensor quantized_embedding_bag_cpu(const Tensor &weight, const Tensor &indices__,
+                                   const Tensor &offsets__, int64_t mode) {
+  auto indices_arg = TensorArg(indices__, "indices__", 1);
+  checkScalarType("quantized_embedding_bag", indices_arg, kLong);
+  auto offsets_arg = TensorArg(offsets__, "offsets__", 1);
+  checkScalarType("quantized_embedding_bag", offsets_arg, kLong);
+  auto weight_arg = TensorArg(weight, "weight", 1);
+  checkScalarTypes("quantized_embedding_bag", weight_arg, {kHalf, kByte});
+  checkDim("quantized_embedding_bag", weight_arg, 2);
+  AT_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+           "quantized_embedding_bag: only the sum and mean modes are supported");
+  AT_CHECK(weight.type().scalarType() != kByte || weight.size(1) >= 8,
+           "quantized_embedding_bag: 8-bit rows must end with a float scale and bias");
+  AT_CHECK(offsets__.numel() > 0, "quantized_embedding_bag: offsets must not be empty");
+  Tensor indices = indices__.contiguous();
+  Tensor offsets = offsets__.contiguous();
+  check_indices(indices, weight.size(0));
+  check_offsets(offsets, indices);
+
+  int64_t dim = weight.type().scalarType() == kByte ? weight.size(1) - 8 : weight.size(1);
+  auto output = weight.type().toScalarType(kFloat).tensor({offsets.size(0), dim});
+  embedding_bag_kernel(weight.contiguous(), indices, offsets, mode == MODE_MEAN, output);
+  return output;
+}
+
+// Each row is quantized to 255 steps between its minimum and maximum, the
+// format of Caffe2's FloatToFused8BitRowwiseQuantized.
+Tensor fused8bit_rowwise_quantize_cpu(const Tensor &self) {
+  auto self_arg = TensorArg(self, "self", 1);
+  checkScalarType("fused8bit_rowwise_quantize", self_arg, kFloat);
+  checkDim("fused8bit_rowwise_quantize", self_arg, 2);
+  auto input = self.contiguous();
+  int64_t rows = input.size(0);
+  int64_t dim = input.size(1);
+  auto output = input.type().toScalarType(kByte).tensor({rows, dim + 8});
+  auto input_data = input.data<float>();
+  auto output_data = output.data<uint8_t>();
+  parallel_for(0, rows, divup(internal::GRAIN_SIZE, std::max<int64_t>(dim, 1)), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const float* in = input_data + i * dim;
+      uint8_t* out = output_data + i * (dim + 8);
+      float minimum = dim > 0 ? *std::min_element(in, in + dim) : 0;
+      float maximum = dim > 0 ? *std::max_element(in, in + dim) : 0;
+      float range = maximum - minimum;
+      float inverse_scale = 255.0f / (range + 1e-8f);
+      for (int64_t j = 0; j < dim; j++) {
+        out[j] = static_cast<uint8_t>(std::lrint((in[j] - minimum) * inverse_scale));
+      }
+      float scale_bias[2] = {range / 255.0f, minimum};
+      std::memcpy(out + dim, scale_bias, sizeof(scale_bias));
+    }
+  });
+  return output;
+}
+
+Tensor fused8bit_rowwise_dequantize_cpu(const Tensor &self) {
+  auto self_arg = TensorArg(self, "self", 1);
+  checkScalarType("fused8bit_rowwise_dequantize", self_arg, kByte);
+  checkDim("fused8bit_rowwise_dequantize", self_arg, 2);
+  AT_CHECK(self.size(1) >= 8,
+           "fused8bit_rowwise_dequantize: rows must end with a float scale and bias");
+  auto input = self.contiguous();
+  int64_t rows = input.size(0);
+  int64_t dim = input.size(1) - 8;
+  auto output = input.type().toScalarType(kFloat).tensor({rows, dim});
+  auto input_data = input.data<uint8_t>();
+  auto output_data = output.data<float>();
+  for (int64_t i = 0; i < rows; i++) {
+    const uint8_t* in = input_data + i * (dim + 8);
+    float scale_bias[2];
+    std::memcpy(scale_bias, in + dim, sizeof(scale_bias));
+    for (int64_t j = 0; j < dim; j++) {
+      output_data[i * dim + j] = in[j] * scale_bias[0] + scale_bias[1];
+    }
+  }
+  return output;
+}
 }
 } // namespace at::native
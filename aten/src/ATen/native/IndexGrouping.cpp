@@ -0,0 +1,117 @@
+#include "ATen/native/IndexGrouping.h"
+
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+namespace {
+
+// An LSD radix sort with 8-bit digits. Every pass counts the digits of each
+// chunk of the keys, turns the counts into the output offset of every
+// (digit, chunk) pair, and scatters the chunks in parallel. Chunks keep their
+// order within a digit, so every pass is stable.
+constexpr int kRadixBits = 8;
+constexpr int64_t kRadix = 1 << kRadixBits;
+
+// keys per chunk below which the sort runs on one thread
+constexpr int64_t kMinChunkSize = 1 << 14;
+
+template <typename F>
+void for_each_chunk(int64_t nchunks, const F& f) {
+  if (nchunks == 1) {
+    f(0);
+    return;
+  }
+  parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      f(chunk);
+    }
+  });
+}
+
+// Sorts the (keys[i], positions[i]) pairs by the low bits of the keys.
+void radix_sort(std::vector<int64_t>& keys, std::vector<int64_t>& positions, int bits) {
+  int64_t n = keys.size();
+  int64_t nchunks = std::max<int64_t>(
+      1, std::min<int64_t>(internal::get_intraop_num_threads(), n / kMinChunkSize));
+  auto chunk_begin = [&](int64_t chunk) { return chunk * n / nchunks; };
+
+  std::vector<int64_t> keys_out(n);
+  std::vector<int64_t> positions_out(n);
+  std::vector<int64_t> offsets(nchunks * kRadix);
+
+  for (int shift = 0; shift < bits; shift += kRadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for_each_chunk(nchunks, [&](int64_t chunk) {
+      int64_t* count = offsets.data() + chunk * kRadix;
+      for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++) {
+        count[(keys[i] >> shift) & (kRadix - 1)]++;
+      }
+    });
+
+    int64_t offset = 0;
+    bool one_digit = false;
+    for (int64_t digit = 0; digit < kRadix; digit++) {
+      int64_t digit_begin = offset;
+      for (int64_t chunk = 0; chunk < nchunks; chunk++) {
+        int64_t count = offsets[chunk * kRadix + digit];
+        offsets[chunk * kRadix + digit] = offset;
+        offset += count;
+      }
+      one_digit |= offset - digit_begin == n;
+    }
+    if (one_digit) {
+      // every key has this digit, so the pass would not move anything
+      continue;
+    }
+
+    for_each_chunk(nchunks, [&](int64_t chunk) {
+      int64_t* next = offsets.data() + chunk * kRadix;
+      for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++) {
+        int64_t dst = next[(keys[i] >> shift) & (kRadix - 1)]++;
+        keys_out[dst] = keys[i];
+        positions_out[dst] = positions[i];
+      }
+    });
+    keys.swap(keys_out);
+    positions.swap(positions_out);
+  }
+}
+
+} // anonymous namespace
+
+IndexGroups group_indices(const int64_t* indices, int64_t n, int64_t bound, int64_t skip) {
+  std::vector<int64_t> keys;
+  std::vector<int64_t> positions;
+  keys.reserve(n);
+  positions.reserve(n);
+  for (int64_t i = 0; i < n; i++) {
+    int64_t index = indices[i];
+    AT_CHECK(index >= 0 && index < bound, "index ", index, " is out of range for ", bound, " rows");
+    if (index != skip) {
+      keys.push_back(index);
+      positions.push_back(i);
+    }
+  }
+
+  int bits = 0;
+  while (bits < 63 && (int64_t(1) << bits) < bound) {
+    bits++;
+  }
+  radix_sort(keys, positions, bits);
+
+  IndexGroups groups;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i == 0 || keys[i] != keys[i - 1]) {
+      groups.keys.push_back(keys[i]);
+      groups.offsets.push_back(i);
+    }
+  }
+  groups.offsets.push_back(keys.size());
+  groups.positions = std::move(positions);
+  return groups;
+}
+
+}} // namespace at::native
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ATen/ATen.h"
+
+#include <vector>
+
+namespace at { namespace native {
+
+// The positions of the equal values of an index array, grouped by value.
+// Group g holds the positions of keys[g] in
+// positions[offsets[g]:offsets[g + 1]], in increasing order, and keys are in
+// increasing order.
+struct IndexGroups {
+  std::vector<int64_t> keys;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> positions;
+
+  int64_t size() const {
+    return keys.size();
+  }
+};
+
+// Groups the positions of indices[0:n], which must be in [0, bound), with a
+// parallel radix sort, so that every distinct index is handled once. Positions
+// holding the value skip (e.g. a padding_idx) are left out.
+IndexGroups group_indices(const int64_t* indices, int64_t n, int64_t bound, int64_t skip = -1);
+
+}} // namespace at::native
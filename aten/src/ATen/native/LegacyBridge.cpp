@@ -3,6 +3,9 @@
 #include <ATen/SparseTensorRef.h>
 #include <ATen/ExpandUtils.h>
 
+#include <initializer_list>
+#include <vector>
+
 namespace at { namespace native {
 
 namespace {
@@ -11,12 +14,70 @@ namespace {
   // an all or nothing affair, because the internal representation
   // is different
   static bool _type_has_native(const Type& dtype) {
-    return dtype.is_sparse() && !dtype.is_cuda();
+    return (dtype.is_sparse() && !dtype.is_cuda()) || dtype.layout() == kSparseCsr;
   }
 
   static bool _has_native(const Tensor& self) {
     return _type_has_native(self.type());
   }
+
+  // Dense CPU pointwise ops run on TensorIterator (see BinaryOps.cpp) when
+  // all operands have the same type and can be broadcast together. Other
+  // cases, including the deprecated pointwise fallback for tensors with the
+  // same number of elements but incompatible shapes, still go to TH.
+  static bool _dense_cpu_native(const Type& type, std::initializer_list<Tensor> tensors) {
+    if (type.layout() != kStrided || type.is_cuda() || type.scalarType() == ScalarType::Half) {
+      return false;
+    }
+    std::vector<int64_t> sizes;
+    for (auto& t : tensors) {
+      if (t.type() != type) {
+        return false;
+      }
+      auto t_sizes = t.sizes();
+      if (t_sizes.size() > sizes.size()) {
+        sizes.insert(sizes.begin(), t_sizes.size() - sizes.size(), 1);
+      }
+      size_t offset = sizes.size() - t_sizes.size();
+      for (size_t i = 0; i < t_sizes.size(); i++) {
+        auto& size = sizes[offset + i];
+        if (size == 1) {
+          size = t_sizes[i];
+        } else if (t_sizes[i] != 1 && t_sizes[i] != size) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static bool _dense_cpu_native(std::initializer_list<Tensor> tensors) {
+    return _dense_cpu_native(tensors.begin()->type(), tensors);
+  }
+
+  // The result of an out= op is resized, so only its type matters.
+  static bool _dense_cpu_native_out(const Tensor& result, std::initializer_list<Tensor> inputs) {
+    return _dense_cpu_native(result.type(), inputs);
+  }
+
+  // In-place ops can only broadcast their other operands to self's shape.
+  static bool _dense_cpu_native_inplace(const Tensor& self, std::initializer_list<Tensor> others) {
+    if (!_dense_cpu_native(self.type(), others)) {
+      return false;
+    }
+    for (auto& t : others) {
+      if (t.dim() > self.dim()) {
+        return false;
+      }
+      int64_t offset = self.dim() - t.dim();
+      for (int64_t i = 0; i < t.dim(); i++) {
+        if (t.size(i) != 1 && t.size(i) != self.size(offset + i)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
 }
 
 // These native operations are not "really" native; they're actually just bridge
@@ -26,8 +87,9 @@ namespace {
 
 // TODO: Maybe the foo_ variants should call th_foo_
 
+// Dense CPU norms use the reduction kernels (see norm_cpu in ReduceOps.cpp)
 Tensor norm(const Tensor & self, Scalar p) {
-  if (_has_native(self)) {
+  if (_has_native(self) || self.type().backend() == Backend::CPU) {
     return native_norm(self, p);
   } else {
     return th_norm(self, p);
@@ -130,6 +192,10 @@ Tensor& add_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar
       // For now, we do it this way for consistency with the TH bindings
       // (not that it is terribly consistent anyway).
       return native_add_out(result, self, SparseTensorRef(other), alpha);
+    } else if (_dense_cpu_native_out(result, {self, other})) {
+      Tensor b_self, b_other;
+      std::tie(b_self, b_other) = expand_outplace(self, other, "add_out");
+      return s_native_add_out(result, b_self, b_other, alpha);
     } else {
       return th_add_out(result, self, other, alpha);
     }
@@ -157,6 +223,10 @@ Tensor add(const Tensor& self, const Tensor& other, Scalar alpha) {
       return s_native_add(b_self, b_other, alpha);
     } else if (!self_sparse && other_sparse) {
       return native_add(self, SparseTensorRef(other), alpha);
+    } else if (_dense_cpu_native({self, other})) {
+      Tensor b_self, b_other;
+      std::tie(b_self, b_other) = expand_outplace(self, other, "add");
+      return s_native_add(b_self, b_other, alpha);
     } else {
       return th_add(self, other, alpha);
     }
@@ -176,6 +246,10 @@ Tensor& add_(Tensor& self, const Tensor& other, Scalar alpha) {
       return s_native_add_(self, b_other, alpha);
     } else if (!self_sparse && other_sparse) {
       return native_add_(self, SparseTensorRef(other), alpha);
+    } else if (_dense_cpu_native_inplace(self, {other})) {
+      Tensor b_other;
+      std::tie(b_other) = expand_inplace(self, other, "add_");
+      return s_native_add_(self, b_other, alpha);
     } else {
       return th_add_(self, other, alpha);
     }
@@ -186,7 +260,11 @@ Tensor& add_(Tensor& self, const Tensor& other, Scalar alpha) {
 
 
 Tensor& sub_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar alpha) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native_out(result, {self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "sub_out");
+    return s_native_sub_out(result, b_self, b_other, alpha);
+  } else if (_has_native(self)) {
     Tensor b_self, b_other;
     std::tie(b_self, b_other) = expand_outplace(self, other, "sub_out");
     return s_native_sub_out(result, b_self, b_other, alpha);
@@ -196,7 +274,11 @@ Tensor& sub_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar
 }
 
 Tensor sub(const Tensor& self, const Tensor& other, Scalar alpha) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native({self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "sub");
+    return s_native_sub(b_self, b_other, alpha);
+  } else if (_has_native(self)) {
     Tensor b_self, b_other;
     std::tie(b_self, b_other) = expand_outplace(self, other, "sub");
     return s_native_sub(b_self, b_other, alpha);
@@ -206,7 +288,11 @@ Tensor sub(const Tensor& self, const Tensor& other, Scalar alpha) {
 }
 
 Tensor& sub_(Tensor& self, const Tensor& other, Scalar alpha) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native_inplace(self, {other})) {
+    Tensor b_other;
+    std::tie(b_other) = expand_inplace(self, other, "sub_");
+    return s_native_sub_(self, b_other, alpha);
+  } else if (_has_native(self)) {
     Tensor b_other;
     std::tie(b_other) = expand_inplace(self, other, "sub_");
     return s_native_sub_(self, b_other, alpha);
@@ -217,7 +303,11 @@ Tensor& sub_(Tensor& self, const Tensor& other, Scalar alpha) {
 
 
 Tensor& mul_out(Tensor& result, const Tensor& self, const Tensor& other) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native_out(result, {self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "mul_out");
+    return s_native_mul_out(result, b_self, b_other);
+  } else if (_has_native(self)) {
     Tensor b_self, b_other;
     std::tie(b_self, b_other) = expand_outplace(self, other, "mul_out");
     return s_native_mul_out(result, self, other);
@@ -227,7 +317,11 @@ Tensor& mul_out(Tensor& result, const Tensor& self, const Tensor& other) {
 }
 
 Tensor mul(const Tensor& self, const Tensor& other) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native({self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "mul");
+    return s_native_mul(b_self, b_other);
+  } else if (_has_native(self)) {
     Tensor b_self, b_other;
     std::tie(b_self, b_other) = expand_outplace(self, other, "mul");
     return s_native_mul(self, other);
@@ -237,7 +331,11 @@ Tensor mul(const Tensor& self, const Tensor& other) {
 }
 
 Tensor& mul_(Tensor& self, const Tensor& other) {
-  if (_has_native(self)) {
+  if (_dense_cpu_native_inplace(self, {other})) {
+    Tensor b_other;
+    std::tie(b_other) = expand_inplace(self, other, "mul_");
+    return s_native_mul_(self, b_other);
+  } else if (_has_native(self)) {
     Tensor b_other;
     std::tie(b_other) = expand_inplace(self, other, "mul_");
     return s_native_mul_(self, b_other);
@@ -271,6 +369,36 @@ Tensor& mul_(Tensor& self, Scalar other) {
 }
 
 
+Tensor& div_out(Tensor& result, const Tensor& self, const Tensor& other) {
+  if (_dense_cpu_native_out(result, {self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "div_out");
+    return s_native_div_out(result, b_self, b_other);
+  } else {
+    return th_div_out(result, self, other);
+  }
+}
+
+Tensor div(const Tensor& self, const Tensor& other) {
+  if (_dense_cpu_native({self, other})) {
+    Tensor b_self, b_other;
+    std::tie(b_self, b_other) = expand_outplace(self, other, "div");
+    return s_native_div(b_self, b_other);
+  } else {
+    return th_div(self, other);
+  }
+}
+
+Tensor& div_(Tensor& self, const Tensor& other) {
+  if (_dense_cpu_native_inplace(self, {other})) {
+    Tensor b_other;
+    std::tie(b_other) = expand_inplace(self, other, "div_");
+    return s_native_div_(self, b_other);
+  } else {
+    return th_div_(self, other);
+  }
+}
+
 Tensor& div_out(Tensor& result, const Tensor& self, Scalar other) {
   if (_has_native(self)) {
     return native_div_out(result, self, other);
@@ -295,11 +423,45 @@ Tensor& div_(Tensor& self, Scalar other) {
   }
 }
 
+Tensor& addcmul_out(Tensor& result, const Tensor& self, const Tensor& tensor1, const Tensor& tensor2, Scalar value) {
+  if (_dense_cpu_native_out(result, {self, tensor1, tensor2})) {
+    Tensor b_self, b_tensor1, b_tensor2;
+    std::tie(b_self, b_tensor1, b_tensor2) = expand_outplace(self, tensor1, tensor2, "addcmul_out");
+    return s_native_addcmul_out(result, b_self, b_tensor1, b_tensor2, value);
+  } else {
+    return th_addcmul_out(result, self, tensor1, tensor2, value);
+  }
+}
+
+Tensor addcmul(const Tensor& self, const Tensor& tensor1, const Tensor& tensor2, Scalar value) {
+  if (_dense_cpu_native({self, tensor1, tensor2})) {
+    Tensor b_self, b_tensor1, b_tensor2;
+    std::tie(b_self, b_tensor1, b_tensor2) = expand_outplace(self, tensor1, tensor2, "addcmul");
+    return s_native_addcmul(b_self, b_tensor1, b_tensor2, value);
+  } else {
+    return th_addcmul(self, tensor1, tensor2, value);
+  }
+}
+
+Tensor& addcmul_(Tensor& self, const Tensor& tensor1, const Tensor& tensor2, Scalar value) {
+  if (_dense_cpu_native_inplace(self, {tensor1, tensor2})) {
+    Tensor b_tensor1, b_tensor2;
+    std::tie(b_tensor1, b_tensor2) = expand_inplace(self, tensor1, tensor2, "addcmul_");
+    return s_native_addcmul_(self, b_tensor1, b_tensor2, value);
+  } else {
+    return th_addcmul_(self, tensor1, tensor2, value);
+  }
+}
+
 Tensor& addmm_out(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
   if (!self.is_cuda()) {
     // See Note [CPU sparse is globally native] and Note [Multiple dispatch to sparse]
     auto mat1_sparse = mat1.is_sparse();
-    if (mat1_sparse) {
+    if (mat1.layout() == kSparseCsr) {
+      Tensor b_self;
+      std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+      return _sparse_csr_addmm_out(result, b_self, mat1, mat2, beta, alpha);
+    } else if (mat1_sparse) {
       Tensor b_self;
       std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
       return s_native_addmm_out(result, b_self, mat1, mat2, beta, alpha);
@@ -315,7 +477,11 @@ Tensor addmm(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
   if (!self.is_cuda()) {
     // See Note [CPU sparse is globally native] and Note [Multiple dispatch to sparse]
     auto mat1_sparse = mat1.is_sparse();
-    if (mat1_sparse) {
+    if (mat1.layout() == kSparseCsr) {
+      Tensor b_self;
+      std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
+      return _sparse_csr_addmm(b_self, mat1, mat2, beta, alpha);
+    } else if (mat1_sparse) {
       Tensor b_self;
       std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
       return s_native_addmm(b_self, mat1, mat2, beta, alpha);
@@ -331,7 +497,10 @@ Tensor& addmm_(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta
   if (!self.is_cuda()) {
     // See Note [CPU sparse is globally native] and Note [Multiple dispatch to sparse]
     auto mat1_sparse = mat1.is_sparse();
-    if (mat1_sparse) {
+    if (mat1.layout() == kSparseCsr) {
+      // inplace is not broadcasting
+      return _sparse_csr_addmm_(self, mat1, mat2, beta, alpha);
+    } else if (mat1_sparse) {
       // inplace is not broadcasting
       return s_native_addmm_(self, mat1, mat2, beta, alpha);
     } else {
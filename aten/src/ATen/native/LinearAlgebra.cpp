@@ -1,6 +1,7 @@
 #include "ATen/ATen.h"
 #include "ATen/ExpandUtils.h"
 #include "ATen/NativeFunctions.h"
+#include "ATen/native/cpu/SmallGemmKernel.h"
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -115,14 +116,17 @@ Tensor& ger_out(Tensor& result, const Tensor& self, const Tensor& vec2) {
 }
 
 Tensor mm(const Tensor& self, const Tensor& mat2) {
-  if (self.is_sparse()) {
+  if (self.is_sparse() && mat2.is_sparse()) {
+    return at::_sparse_sparse_matmul(self, mat2);
+  }
+  if (self.is_sparse() || self.layout() == kSparseCsr) {
     return mat2.type().addmm(at::zeros({}, mat2.type()), self, mat2, 0, 1);
   }
   return self.type()._mm(self, mat2);
 }
 
 Tensor& mm_out(Tensor& result, const Tensor& self, const Tensor& mat2) {
-  if (self.is_sparse()) {
+  if (self.is_sparse() || self.layout() == kSparseCsr) {
     return mat2.type().addmm_out(result, at::zeros({}, mat2.type()), self, mat2, 0, 1);
   }
   return self.type()._mm_out(result, self, mat2);
@@ -130,6 +134,9 @@ Tensor& mm_out(Tensor& result, const Tensor& self, const Tensor& mat2) {
 
 Tensor mv(const Tensor& self, const Tensor& vec) {
   check_1d(vec, "vec", "mv");
+  if (self.layout() == kSparseCsr) {
+    return at::_sparse_csr_mv(self, vec);
+  }
   return at::_mv(self, vec);
 }
 
@@ -171,6 +178,119 @@ Tensor& addr_out(Tensor &result, const Tensor& self, const Tensor& vec1, const T
   return at::_addr_out(result, self, vec1, vec2, beta, alpha);
 }
 
+// bmm and baddbmm of float and double CPU matrices whose sizes are all at
+// most kSmallGemmMaxSize run on small_gemm_kernel, which multiplies the
+// matrices of the batch in parallel without a BLAS call per matrix. All other
+// inputs go to TH, which also reports their errors.
+static bool use_small_gemm(const Tensor& batch1, const Tensor& batch2) {
+  if (batch1.is_cuda() || batch1.type().layout() != kStrided || batch2.type() != batch1.type()) {
+    return false;
+  }
+  auto scalar_type = batch1.type().scalarType();
+  if (scalar_type != kFloat && scalar_type != kDouble) {
+    return false;
+  }
+  if (batch1.dim() != 3 || batch2.dim() != 3 || batch1.size(0) != batch2.size(0) ||
+      batch1.size(2) != batch2.size(1) || batch1.size(0) == 0) {
+    return false;
+  }
+  for (int64_t size : {batch1.size(1), batch1.size(2), batch2.size(2)}) {
+    if (size < 1 || size > kSmallGemmMaxSize) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Tensor bmm(const Tensor& self, const Tensor& mat2) {
+  if (use_small_gemm(self, mat2)) {
+    return at::s_native_bmm(self, mat2);
+  }
+  return at::th_bmm(self, mat2);
+}
+
+Tensor& bmm_out(Tensor& result, const Tensor& self, const Tensor& mat2) {
+  if (use_small_gemm(self, mat2) && result.type() == self.type()) {
+    return at::s_native_bmm_out(result, self, mat2);
+  }
+  return at::th_bmm_out(result, self, mat2);
+}
+
+Tensor baddbmm(const Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  if (use_small_gemm(batch1, batch2) && self.type() == batch1.type()) {
+    Tensor b_self;
+    std::tie(b_self) = expand_size(self, {batch1.size(0), batch1.size(1), batch2.size(2)}, "baddbmm");
+    return at::s_native_baddbmm(b_self, batch1, batch2, beta, alpha);
+  }
+  return at::th_baddbmm(self, batch1, batch2, beta, alpha);
+}
+
+Tensor& baddbmm_(Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  // inplace is not broadcasting
+  if (use_small_gemm(batch1, batch2) && self.type() == batch1.type() &&
+      self.sizes().equals({batch1.size(0), batch1.size(1), batch2.size(2)})) {
+    return at::s_native_baddbmm_(self, batch1, batch2, beta, alpha);
+  }
+  return at::th_baddbmm_(self, batch1, batch2, beta, alpha);
+}
+
+Tensor& baddbmm_out(Tensor& result, const Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  if (use_small_gemm(batch1, batch2) && self.type() == batch1.type() && result.type() == batch1.type()) {
+    Tensor b_self;
+    std::tie(b_self) = expand_size(self, {batch1.size(0), batch1.size(1), batch2.size(2)}, "baddbmm_out");
+    return at::s_native_baddbmm_out(result, b_self, batch1, batch2, beta, alpha);
+  }
+  return at::th_baddbmm_out(result, self, batch1, batch2, beta, alpha);
+}
+
+Tensor& s_baddbmm_out_small_cpu(Tensor& result, const Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  AT_CHECK(batch1.dim() == 3, "expected 3D tensor, got ", batch1.dim(), "D tensor for argument #1 'batch1'");
+  AT_CHECK(batch2.dim() == 3, "expected 3D tensor, got ", batch2.dim(), "D tensor for argument #2 'batch2'");
+  int64_t batch = batch1.size(0);
+  int64_t m = batch1.size(1);
+  int64_t k = batch1.size(2);
+  int64_t n = batch2.size(2);
+  AT_CHECK(batch2.size(0) == batch && batch2.size(1) == k,
+           "size mismatch, got ", batch1.sizes(), " and ", batch2.sizes());
+  AT_CHECK(self.sizes().equals({batch, m, n}),
+           "expected self of size ", IntList({batch, m, n}), ", got ", self.sizes());
+  AT_CHECK(batch1.type() == result.type() && batch2.type() == result.type() && self.type() == result.type(),
+           "expected ", result.type().toString(), " arguments, got ", self.type().toString(), ", ",
+           batch1.type().toString(), " and ", batch2.type().toString());
+
+  bool same = result.unsafeGetTensorImpl() == self.unsafeGetTensorImpl();
+  result.resize_({batch, m, n});
+  if (beta.toDouble() != 0 && !same) {
+    result.copy_(self);
+  }
+  Tensor out = result.is_contiguous() ? result : result.contiguous();
+  small_gemm_kernel(out, batch1, batch2, beta, alpha);
+  if (out.unsafeGetTensorImpl() != result.unsafeGetTensorImpl()) {
+    result.copy_(out);
+  }
+  return result;
+}
+
+Tensor s_baddbmm_small_cpu(const Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  Tensor result = self.type().tensor();
+  return s_baddbmm_out_small_cpu(result, self, batch1, batch2, beta, alpha);
+}
+
+Tensor& s_baddbmm_small_cpu_(Tensor& self, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha) {
+  return s_baddbmm_out_small_cpu(self, self, batch1, batch2, beta, alpha);
+}
+
+Tensor& s_bmm_out_small_cpu(Tensor& result, const Tensor& self, const Tensor& mat2) {
+  AT_CHECK(self.dim() == 3 && mat2.dim() == 3, "expected 3D tensors, got ", self.dim(), "D and ", mat2.dim(), "D tensors");
+  result.resize_({self.size(0), self.size(1), mat2.size(2)});
+  return s_baddbmm_out_small_cpu(result, result, self, mat2, 0, 1);
+}
+
+Tensor s_bmm_small_cpu(const Tensor& self, const Tensor& mat2) {
+  Tensor result = self.type().tensor();
+  return s_bmm_out_small_cpu(result, self, mat2);
+}
+
 Tensor dot(const Tensor& self, const Tensor& tensor) {
   check_1d(self, "self", "dot");
   check_1d(tensor, "tensor", "dot");
@@ -4,6 +4,7 @@
 #include "ATen/Config.h"
 
 #include "ATen/detail/CUDAHooksInterface.h"
+#include "ATen/native/cpu/NormalizationKernel.h"
 
 #include <vector>
 
@@ -115,6 +116,15 @@ Tensor layer_norm(const Tensor& input, IntList normalized_shape,
       n *= input_shape[i];
     }
 
+    if (input.type().backend() == Backend::CPU) {
+      // the kernels take weight and bias of N elements
+      auto flat_weight = weight.defined() ? weight.contiguous().view(-1) : weight;
+      auto flat_bias = bias.defined() ? bias.contiguous().view(-1) : bias;
+      auto out = std::get<0>(at::native_layer_norm(
+          input, flat_weight, flat_bias, n, input.numel() / std::max<int64_t>(n, 1), eps));
+      return out.view(input_shape);
+    }
+
     // Apply layer norm
     auto input_reshaped = input.contiguous().view({1, n, -1});
 
@@ -165,6 +175,13 @@ Tensor group_norm(const Tensor& input, int64_t num_groups,
       throw std::runtime_error(ss.str());
     }
 
+    if (input.type().backend() == Backend::CPU) {
+      auto out = std::get<0>(at::native_group_norm(
+          input, weight, bias, b, c, input.numel() / std::max<int64_t>(b * c, 1),
+          num_groups, eps));
+      return out.view(input_shape);
+    }
+
     // Apply group norm
     auto input_reshaped = input.contiguous().view({1, b * num_groups, -1});
 
@@ -188,4 +205,82 @@ Tensor group_norm(const Tensor& input, int64_t num_groups,
     }
 }
 
+std::tuple<Tensor, Tensor, Tensor> layer_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t M, int64_t N, double eps) {
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  auto beta = bias.defined() ? bias.contiguous() : bias;
+  auto Y = at::empty_like(X);
+  auto mean = X.type().tensor({M});
+  auto rstd = X.type().tensor({M});
+  if (M > 0) {
+    layer_norm_kernel(X, gamma, beta, M, N, eps, Y, mean, rstd);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t M, int64_t N,
+    std::array<bool,3> output_mask) {
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::empty_like(X);
+  }
+  if (output_mask[1]) {
+    dgamma = gamma.defined() ? at::zeros_like(gamma) : at::zeros({N}, X.type());
+  }
+  if (output_mask[2]) {
+    dbeta = gamma.defined() ? at::zeros_like(gamma) : at::zeros({N}, X.type());
+  }
+  if (M > 0) {
+    layer_norm_backward_kernel(
+        grad_out.contiguous(), X, mean.contiguous(), rstd.contiguous(), gamma,
+        M, N, dX, dgamma, dbeta);
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps) {
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  auto beta = bias.defined() ? bias.contiguous() : bias;
+  auto Y = at::empty_like(X);
+  auto mean = X.type().tensor({N, group});
+  auto rstd = X.type().tensor({N, group});
+  if (N > 0) {
+    group_norm_kernel(X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t N, int64_t C, int64_t HxW, int64_t group,
+    std::array<bool,3> output_mask) {
+  auto X = input.contiguous();
+  auto gamma = weight.defined() ? weight.contiguous() : weight;
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::empty_like(X);
+  }
+  if (output_mask[1]) {
+    dgamma = gamma.defined() ? at::zeros_like(gamma) : at::zeros({C}, X.type());
+  }
+  if (output_mask[2]) {
+    dbeta = gamma.defined() ? at::zeros_like(gamma) : at::zeros({C}, X.type());
+  }
+  if (N > 0) {
+    group_norm_backward_kernel(
+        grad_out.contiguous(), X, mean.contiguous(), rstd.contiguous(), gamma,
+        N, C, HxW, group, dX, dgamma, dbeta);
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
 }} // at::native
@@ -4,6 +4,7 @@
 #include "ATen/NativeFunctions.h"
 #include "ATen/WrapDimUtils.h"
 #include "ATen/WrapDimUtilsMulti.h"
+#include "ATen/native/TensorIterator.h"
 #include "cpu/ReduceOpsKernel.h"
 
 #include <algorithm>
@@ -86,6 +87,32 @@ Tensor& cumprod_out(Tensor& result, const Tensor& self, int64_t dim) {
   return at::native::cumprod_out(result, self, dim, nullopt);
 }
 
+// Whether the kernels in cpu/ReduceOpsKernel.h can reduce self into result.
+// They take dense CPU tensors of any layout; Half tensors, CUDA tensors and
+// results of a different type go to TH.
+static bool _reduce_cpu_native(const Tensor& result, const Tensor& self) {
+  return self.type().backend() == Backend::CPU &&
+         self.type().scalarType() != ScalarType::Half &&
+         result.type() == self.type();
+}
+
+static std::vector<int64_t> _all_dims(const Tensor& self) {
+  std::vector<int64_t> dims(self.dim());
+  std::iota(dims.begin(), dims.end(), 0);
+  return dims;
+}
+
+// Removes the (size 1) dimensions dims of a keepdim=true result
+static Tensor& _squeeze_dims(Tensor& result, IntList dims) {
+  auto mask = dim_list_to_bitset(dims, result.dim());
+  for (int64_t dim = result.dim() - 1; dim >= 0; dim--) {
+    if (mask[dim]) {
+      result.squeeze_(dim);
+    }
+  }
+  return result;
+}
+
 // ALL REDUCE #################################################################
 
 static inline Tensor mean(const Tensor &self, optional<ScalarType> dtype) {
@@ -122,10 +149,11 @@ Tensor sum(const Tensor &self) {
 }
 
 Tensor _sum_cpu(const Tensor& self) {
-  if (self.is_contiguous()) {
-    Tensor result = at::empty({}, self.type());
-    sum_kernel(result, self, at::nullopt);
-    return result;
+  Tensor result = self.type().tensor();
+  if (_reduce_cpu_native(result, self)) {
+    auto iter = TensorIterator::reduce_op(result, self, _all_dims(self));
+    sum_kernel(iter);
+    return result.resize_({});
   }
   return self._sumall();
 }
@@ -143,14 +171,61 @@ Tensor prod(const Tensor &self) {
 }
 
 Tensor _prod_cpu(const Tensor &self) {
-  if (self.is_contiguous()) {
-    Tensor result = at::empty({}, self.type());
-    prod_kernel(result, self, at::nullopt);
-    return result;
+  Tensor result = self.type().tensor();
+  if (_reduce_cpu_native(result, self)) {
+    auto iter = TensorIterator::reduce_op(result, self, _all_dims(self));
+    prod_kernel(iter);
+    return result.resize_({});
   }
   return self._prodall();
 }
 
+Tensor norm_cpu(const Tensor& self, Scalar p) {
+  Tensor result = self.type().tensor();
+  if (_reduce_cpu_native(result, self) && at::isFloatingType(self.type().scalarType())) {
+    auto iter = TensorIterator::reduce_op(result, self, _all_dims(self));
+    norm_kernel(iter, p);
+    return result.resize_({});
+  }
+  return at::th_norm(self, p);
+}
+
+static Tensor std_var(const Tensor& self, bool unbiased, bool take_sqrt) {
+  Tensor result = self.type().tensor();
+  if (_reduce_cpu_native(result, self) && self.numel() > 0) {
+    auto iter = TensorIterator::reduce_op(result, self, _all_dims(self));
+    std_var_kernel(iter, unbiased, take_sqrt);
+    return result.resize_({});
+  }
+  return take_sqrt ? at::_th_std(self, unbiased) : at::_th_var(self, unbiased);
+}
+
+Tensor var(const Tensor& self, bool unbiased) {
+  return at::native::std_var(self, unbiased, /*take_sqrt=*/false);
+}
+
+Tensor std(const Tensor& self, bool unbiased) {
+  return at::native::std_var(self, unbiased, /*take_sqrt=*/true);
+}
+
+static Tensor max_min(const Tensor& self, bool is_max) {
+  Tensor result = self.type().tensor();
+  if (_reduce_cpu_native(result, self) && self.numel() > 0) {
+    auto iter = TensorIterator::reduce_op(result, self, _all_dims(self));
+    is_max ? max_kernel(iter) : min_kernel(iter);
+    return result.resize_({});
+  }
+  return is_max ? at::_th_max(self) : at::_th_min(self);
+}
+
+Tensor max(const Tensor& self) {
+  return at::native::max_min(self, /*is_max=*/true);
+}
+
+Tensor min(const Tensor& self) {
+  return at::native::max_min(self, /*is_max=*/false);
+}
+
 // \ALL REDUCE ################################################################
 
 // DIM REDUCE #################################################################
@@ -171,16 +246,6 @@ static bool _dimreduce_return_trivial(Tensor &result, const Tensor &self,
   return false;
 }
 
-static Tensor &_dimreduce_setup(Tensor &result, const Tensor &self,
-                                int64_t dim) {
-  IntList self_sizes = self.sizes();
-  std::vector<int64_t> result_sizes;
-  result_sizes.insert(result_sizes.end(), self_sizes.begin(), self_sizes.end());
-  result_sizes[dim] = 1;
-  result.resize_(result_sizes);
-  return result;
-}
-
 static inline Tensor &mean_out(Tensor &result, const Tensor &self, int64_t dim,
                  bool keepdim, optional<ScalarType> dtype) {
   ScalarType scalarType = result.type().scalarType();
@@ -238,9 +303,9 @@ Tensor &_sum_out_cpu(Tensor &result, const Tensor &self, int64_t dim_,
   int64_t dim = maybe_wrap_dim(dim_, self.dim());
   if (_dimreduce_return_trivial(result, self, 0))
     return result;
-  if (self.is_contiguous() && result.is_contiguous()) {
-    _dimreduce_setup(result, self, dim);
-    sum_kernel(result, self, dim);
+  if (_reduce_cpu_native(result, self)) {
+    auto iter = TensorIterator::reduce_op(result, self, dim);
+    sum_kernel(iter);
     if (!keepdim) result.squeeze_(dim);
     return result;
   }
@@ -276,9 +341,9 @@ Tensor &_prod_out_cpu(Tensor &result, const Tensor &self, int64_t dim_,
   int64_t dim = maybe_wrap_dim(dim_, self.dim());
   if (_dimreduce_return_trivial(result, self, 1))
     return result;
-  if (self.is_contiguous() && result.is_contiguous()) {
-    _dimreduce_setup(result, self, dim);
-    prod_kernel(result, self, dim);
+  if (_reduce_cpu_native(result, self)) {
+    auto iter = TensorIterator::reduce_op(result, self, dim);
+    prod_kernel(iter);
     if (!keepdim) result.squeeze_(dim);
     return result;
   }
@@ -373,6 +438,95 @@ Tensor logsumexp(const Tensor &self, int64_t dim_, bool keepdim) {
   return at::native::logsumexp_out(result, self, dim, keepdim);
 }
 
+Tensor& norm_out(Tensor& result, const Tensor& self, Scalar p, int64_t dim_, bool keepdim) {
+  if (_reduce_cpu_native(result, self) && at::isFloatingType(self.type().scalarType()) &&
+      self.numel() > 0 && self.dim() > 0) {
+    int64_t dim = maybe_wrap_dim(dim_, self.dim());
+    auto iter = TensorIterator::reduce_op(result, self, dim);
+    norm_kernel(iter, p);
+    if (!keepdim) result.squeeze_(dim);
+    return result;
+  }
+  return at::_th_norm_out(result, self, p, dim_, keepdim);
+}
+
+Tensor norm(const Tensor& self, Scalar p, int64_t dim, bool keepdim) {
+  Tensor result = self.type().tensor();
+  return at::native::norm_out(result, self, p, dim, keepdim);
+}
+
+static Tensor& std_var_out(Tensor& result, const Tensor& self, int64_t dim_, bool unbiased,
+                           bool keepdim, bool take_sqrt) {
+  if (_reduce_cpu_native(result, self) && self.numel() > 0 && self.dim() > 0) {
+    int64_t dim = maybe_wrap_dim(dim_, self.dim());
+    auto iter = TensorIterator::reduce_op(result, self, dim);
+    std_var_kernel(iter, unbiased, take_sqrt);
+    if (!keepdim) result.squeeze_(dim);
+    return result;
+  }
+  return take_sqrt ? at::_th_std_out(result, self, dim_, unbiased, keepdim)
+                   : at::_th_var_out(result, self, dim_, unbiased, keepdim);
+}
+
+Tensor& var_out(Tensor& result, const Tensor& self, int64_t dim, bool unbiased, bool keepdim) {
+  return at::native::std_var_out(result, self, dim, unbiased, keepdim, /*take_sqrt=*/false);
+}
+
+Tensor var(const Tensor& self, int64_t dim, bool unbiased, bool keepdim) {
+  Tensor result = self.type().tensor();
+  return at::native::var_out(result, self, dim, unbiased, keepdim);
+}
+
+Tensor& std_out(Tensor& result, const Tensor& self, int64_t dim, bool unbiased, bool keepdim) {
+  return at::native::std_var_out(result, self, dim, unbiased, keepdim, /*take_sqrt=*/true);
+}
+
+Tensor std(const Tensor& self, int64_t dim, bool unbiased, bool keepdim) {
+  Tensor result = self.type().tensor();
+  return at::native::std_out(result, self, dim, unbiased, keepdim);
+}
+
+static std::tuple<Tensor&, Tensor&> max_min_out(Tensor& values, Tensor& indices, const Tensor& self,
+                                                int64_t dim_, bool keepdim, bool is_max) {
+  if (_reduce_cpu_native(values, self) && indices.type() == self.type().toScalarType(kLong) &&
+      self.numel() > 0 && self.dim() > 0) {
+    int64_t dim = maybe_wrap_dim(dim_, self.dim());
+    auto iter = TensorIterator::reduce_op(values, indices, self, dim);
+    is_max ? max_kernel(iter) : min_kernel(iter);
+    if (!keepdim) {
+      values.squeeze_(dim);
+      indices.squeeze_(dim);
+    }
+    return std::tuple<Tensor&, Tensor&>(values, indices);
+  }
+  return is_max ? at::_th_max_out(values, indices, self, dim_, keepdim)
+                : at::_th_min_out(values, indices, self, dim_, keepdim);
+}
+
+std::tuple<Tensor&, Tensor&> max_out(Tensor& max, Tensor& max_indices, const Tensor& self,
+                                     int64_t dim, bool keepdim) {
+  return at::native::max_min_out(max, max_indices, self, dim, keepdim, /*is_max=*/true);
+}
+
+std::tuple<Tensor, Tensor> max(const Tensor& self, int64_t dim, bool keepdim) {
+  Tensor max = self.type().tensor();
+  Tensor max_indices = self.type().toScalarType(kLong).tensor();
+  at::native::max_out(max, max_indices, self, dim, keepdim);
+  return std::make_tuple(max, max_indices);
+}
+
+std::tuple<Tensor&, Tensor&> min_out(Tensor& min, Tensor& min_indices, const Tensor& self,
+                                     int64_t dim, bool keepdim) {
+  return at::native::max_min_out(min, min_indices, self, dim, keepdim, /*is_max=*/false);
+}
+
+std::tuple<Tensor, Tensor> min(const Tensor& self, int64_t dim, bool keepdim) {
+  Tensor min = self.type().tensor();
+  Tensor min_indices = self.type().toScalarType(kLong).tensor();
+  at::native::min_out(min, min_indices, self, dim, keepdim);
+  return std::make_tuple(min, min_indices);
+}
+
 // \DIM REDUCE ################################################################
 
 // MULTI DIM REDUCE ###########################################################
@@ -429,12 +583,22 @@ Tensor& _sum_out(Tensor &result, const Tensor &self, int64_t dim, bool keepdim)
   }
 }
 
+// Dense CPU sums over several dimensions are done in a single pass over self
 Tensor _sum(const Tensor &self, IntList dims, bool keepdim) {
+  Tensor result = self.type().tensor();
+  if (dims.size() > 1 && _reduce_cpu_native(result, self)) {
+    return at::native::_sum_out(result, self, dims, keepdim);
+  }
   return reduce_multi_associative<_sum>(self, dims, keepdim);
 }
 
 Tensor& _sum_out(Tensor &result, const Tensor &self, IntList dims, bool keepdim)
 {
+  if (dims.size() > 1 && _reduce_cpu_native(result, self)) {
+    auto iter = TensorIterator::reduce_op(result, self, dims);
+    sum_kernel(iter);
+    return keepdim ? result : _squeeze_dims(result, dims);
+  }
   return reduce_multi_associative_out<_sum, _sum_out>(result, self, dims, keepdim);
 }
 
@@ -1,30 +1,9 @@
 #include "ATen/ATen.h"
-#include "ATen/CPUApplyUtils.h"
-#include "ATen/Dispatch.h"
 #include "ATen/Error.h"
 #include "ATen/ExpandUtils.h"
 #include "ATen/NativeFunctions.h"
-
-namespace {
-template <typename scalar_t>
-void where_cpu(
-    at::Tensor& ret,
-    const at::Tensor& condition,
-    const at::Tensor& self,
-    const at::Tensor& other) {
-  at::CPU_tensor_apply4<scalar_t, uint8_t, scalar_t, scalar_t>(
-      ret,
-      condition,
-      self,
-      other,
-      [](scalar_t& ret_val,
-         const uint8_t& cond_val,
-         const scalar_t& self_val,
-         const scalar_t& other_val) {
-        ret_val = cond_val ? self_val : other_val;
-      });
-}
-} // namespace
+#include "ATen/native/TensorIterator.h"
+#include "ATen/native/cpu/BinaryOpsKernel.h"
 
 namespace at { namespace native {
 
@@ -78,10 +57,11 @@ Tensor where(const Tensor& condition, const Tensor& self, const Tensor& other) {
 }
 
 Tensor _s_where_cpu(const Tensor& condition, const Tensor& self, const Tensor& other) {
-  Tensor ret = self.type().tensor(self.sizes());
-  AT_DISPATCH_ALL_TYPES(ret.type(), "where", [&] {
-    where_cpu<scalar_t>(ret, condition, self, other);
-  });
+  AT_CHECK(self.type() == other.type(), "expected other to have type ", self.type().toString(),
+           " but got ", other.type().toString());
+  Tensor ret = self.type().tensor();
+  TensorIterator iter(ret, {condition, self, other});
+  where_kernel(iter);
   return ret;
 }
 
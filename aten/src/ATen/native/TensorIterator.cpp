@@ -0,0 +1,183 @@
+#include "ATen/native/TensorIterator.h"
+
+#include "ATen/ExpandUtils.h"
+#include "ATen/WrapDimUtilsMulti.h"
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+constexpr int TensorIterator::MAX_OPERANDS;
+
+TensorIterator::TensorIterator(Tensor& output, ArrayRef<Tensor> inputs)
+  : ntensors_(static_cast<int>(inputs.size()) + 1) {
+  AT_CHECK(ntensors_ <= MAX_OPERANDS, "TensorIterator: too many operands (", ntensors_, ")");
+  std::vector<int64_t> sizes;
+  for (auto& input : inputs) {
+    sizes = infer_size(sizes, input.sizes());
+  }
+  output.resize_(sizes);
+  operands_[0] = output;
+  for (int arg = 1; arg < ntensors_; arg++) {
+    operands_[arg] = inputs[arg - 1];
+  }
+  build(sizes);
+}
+
+static std::vector<int64_t> reduced_sizes(const Tensor& self, IntList dims) {
+  auto mask = dim_list_to_bitset(dims, self.dim());
+  auto sizes = self.sizes().vec();
+  for (int64_t dim = 0; dim < self.dim(); dim++) {
+    if (mask[dim]) {
+      sizes[dim] = 1;
+    }
+  }
+  return sizes;
+}
+
+TensorIterator TensorIterator::reduce_op(Tensor& out, const Tensor& self, IntList dims) {
+  out.resize_(reduced_sizes(self, dims));
+  TensorIterator iter;
+  iter.ntensors_ = 2;
+  iter.noutputs_ = 1;
+  // expanding gives the output stride 0 in the reduced dimensions
+  iter.operands_[0] = out.expand(self.sizes());
+  iter.operands_[1] = self;
+  iter.build(self.sizes());
+  return iter;
+}
+
+TensorIterator TensorIterator::reduce_op(Tensor& out1, Tensor& out2, const Tensor& self, IntList dims) {
+  auto sizes = reduced_sizes(self, dims);
+  out1.resize_(sizes);
+  out2.resize_(sizes);
+  TensorIterator iter;
+  iter.ntensors_ = 3;
+  iter.noutputs_ = 2;
+  iter.operands_[0] = out1.expand(self.sizes());
+  iter.operands_[1] = out2.expand(self.sizes());
+  iter.operands_[2] = self;
+  iter.build(self.sizes());
+  return iter;
+}
+
+void TensorIterator::build(IntList sizes) {
+  for (int arg = 0; arg < ntensors_; arg++) {
+    data_[arg] = static_cast<char*>(operands_[arg].data_ptr());
+  }
+  // iterate innermost dimension first
+  shape_.assign(sizes.rbegin(), sizes.rend());
+  compute_strides();
+  reorder_dimensions();
+  coalesce_dimensions();
+  if (shape_.empty()) {
+    // zero-dim tensors are iterated as a single element
+    shape_.push_back(1);
+    strides_.assign(ntensors_, 0);
+  }
+}
+
+int64_t TensorIterator::numel() const {
+  int64_t numel = 1;
+  for (auto size : shape_) {
+    numel *= size;
+  }
+  return numel;
+}
+
+void TensorIterator::compute_strides() {
+  int ndim = this->ndim();
+  strides_.assign(ndim * ntensors_, 0);
+  for (int arg = 0; arg < ntensors_; arg++) {
+    auto& t = operands_[arg];
+    int64_t element_size = t.type().elementSizeInBytes();
+    int offset = ndim - static_cast<int>(t.dim());
+    for (int dim = 0; dim < ndim; dim++) {
+      // dim counts from the innermost dimension, tensor dims from the outermost
+      int tdim = ndim - 1 - dim - offset;
+      if (tdim >= 0 && t.size(tdim) != 1) {
+        strides_[dim * ntensors_ + arg] = t.stride(tdim) * element_size;
+      }
+    }
+  }
+}
+
+// Sorts the dimensions so that the output's strides increase, falling back to
+// the inputs' strides where the output's are equal or zero. Outputs of
+// out-of-place ops are contiguous, so this only changes in-place ops on
+// transposed or otherwise permuted tensors, and places the reduced
+// dimensions of a reduction according to the input's strides.
+void TensorIterator::reorder_dimensions() {
+  int ndim = this->ndim();
+  if (ndim <= 1) {
+    return;
+  }
+  auto should_swap = [&](int dim0, int dim1) {
+    for (int arg = 0; arg < ntensors_; arg++) {
+      int64_t stride0 = stride(dim0, arg);
+      int64_t stride1 = stride(dim1, arg);
+      if (stride0 == 0 || stride1 == 0) {
+        continue;
+      }
+      return stride0 > stride1;
+    }
+    return false;
+  };
+  auto swap_dims = [&](int dim0, int dim1) {
+    std::swap(shape_[dim0], shape_[dim1]);
+    for (int arg = 0; arg < ntensors_; arg++) {
+      std::swap(strides_[dim0 * ntensors_ + arg], strides_[dim1 * ntensors_ + arg]);
+    }
+  };
+  // insertion sort, which keeps the original order of dimensions that compare
+  // equal
+  for (int i = 1; i < ndim; i++) {
+    for (int dim = i; dim > 0 && should_swap(dim - 1, dim); dim--) {
+      swap_dims(dim - 1, dim);
+    }
+  }
+}
+
+void TensorIterator::coalesce_dimensions() {
+  int ndim = this->ndim();
+  if (ndim <= 1) {
+    return;
+  }
+  // two adjacent dimensions can be coalesced if one of them has size 1, or if
+  // stepping over the whole inner one is a single step of the outer one in
+  // every operand
+  auto can_coalesce = [&](int dim0, int dim1) {
+    if (shape_[dim0] == 1 || shape_[dim1] == 1) {
+      return true;
+    }
+    for (int arg = 0; arg < ntensors_; arg++) {
+      if (stride(dim0, arg) * shape_[dim0] != stride(dim1, arg)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  int prev_dim = 0;
+  for (int dim = 1; dim < ndim; dim++) {
+    if (can_coalesce(prev_dim, dim)) {
+      if (shape_[prev_dim] == 1) {
+        for (int arg = 0; arg < ntensors_; arg++) {
+          strides_[prev_dim * ntensors_ + arg] = stride(dim, arg);
+        }
+      }
+      shape_[prev_dim] *= shape_[dim];
+    } else {
+      prev_dim++;
+      if (prev_dim != dim) {
+        shape_[prev_dim] = shape_[dim];
+        for (int arg = 0; arg < ntensors_; arg++) {
+          strides_[prev_dim * ntensors_ + arg] = stride(dim, arg);
+        }
+      }
+    }
+  }
+  shape_.resize(prev_dim + 1);
+  strides_.resize((prev_dim + 1) * ntensors_);
+}
+
+}} // namespace at::native
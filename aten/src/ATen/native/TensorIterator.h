@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// TensorIterator walks over the elements of an output tensor and a few input
+// tensors that broadcast to the output's shape, without materializing the
+// broadcast.
+//
+// When it is built, the iterator
+//  - resizes the output (operand 0) to the broadcast shape of the inputs,
+//  - gives broadcast dimensions of the inputs a stride of 0,
+//  - reorders the dimensions so that the output's strides increase, and
+//  - coalesces adjacent dimensions that are contiguous in every operand.
+// Contiguous tensors and common broadcasts (e.g. adding a bias to every row)
+// therefore end up with one or two dimensions and long inner loops.
+//
+// Kernels are written as a loop over the innermost dimension:
+//
+//   iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+//     for (int64_t i = 0; i < n; i++) {
+//       auto out = (float*)(data[0] + i * strides[0]);
+//       ...
+//     }
+//   });
+//
+// Strides are in bytes, so the operands may have different scalar types (like
+// the uint8 condition of where). native/cpu/Loops.h has vectorized loops for
+// the common cases.
+//
+// Reductions use reduce_op, which iterates over the input and outputs that
+// have size 1 in the reduced dimensions. The outputs come first and have
+// stride 0 in the reduced dimensions, which is how the reduction loops in
+// native/cpu/Reduce.h tell them apart.
+
+namespace at { namespace native {
+
+struct AT_API TensorIterator {
+  static constexpr int MAX_OPERANDS = 4;
+
+  TensorIterator(Tensor& output, ArrayRef<Tensor> inputs);
+
+  // Resizes the output(s) to self's sizes with size 1 in the dimensions dims
+  // (i.e. keepdim=true) and iterates over the reduction of self into them.
+  static TensorIterator reduce_op(Tensor& out, const Tensor& self, IntList dims);
+  static TensorIterator reduce_op(Tensor& out1, Tensor& out2, const Tensor& self, IntList dims);
+
+  int ntensors() const { return ntensors_; }
+  int noutputs() const { return noutputs_; }
+  int ndim() const { return static_cast<int>(shape_.size()); }
+  int64_t numel() const;
+  IntList shape() const { return shape_; }
+  // byte stride of operand arg in (reordered, coalesced) dimension dim
+  int64_t stride(int dim, int arg) const { return strides_[dim * ntensors_ + arg]; }
+  // address of the first element of operand arg
+  char* data_ptr(int arg) const { return data_[arg]; }
+  // type of the output
+  const Type& type() const { return operands_[0].type(); }
+
+  // Calls loop(data, strides, n) for every run of the innermost dimension,
+  // in parallel for large tensors.
+  template <typename loop_t>
+  void for_each(loop_t loop) const {
+    int64_t numel = this->numel();
+    if (numel == 0) {
+      return;
+    } else if (numel < internal::GRAIN_SIZE) {
+      serial_for_each(loop, 0, numel);
+    } else {
+      parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        serial_for_each(loop, begin, end);
+      });
+    }
+  }
+
+  // Calls loop for the elements with linear indices [begin, end) of the
+  // (reordered) iteration space.
+  template <typename loop_t>
+  void serial_for_each(loop_t loop, int64_t begin, int64_t end) const {
+    if (begin >= end) {
+      return;
+    }
+    int ndim = this->ndim();
+    std::vector<int64_t> counter(ndim);
+    int64_t linear = begin;
+    for (int dim = 0; dim < ndim; dim++) {
+      counter[dim] = linear % shape_[dim];
+      linear /= shape_[dim];
+    }
+    std::array<char*, MAX_OPERANDS> ptrs;
+    for (int64_t pos = begin; pos < end;) {
+      for (int arg = 0; arg < ntensors_; arg++) {
+        char* ptr = data_[arg];
+        for (int dim = 0; dim < ndim; dim++) {
+          ptr += counter[dim] * stride(dim, arg);
+        }
+        ptrs[arg] = ptr;
+      }
+      int64_t n = std::min(shape_[0] - counter[0], end - pos);
+      loop(ptrs.data(), strides_.data(), n);
+      pos += n;
+      counter[0] += n;
+      for (int dim = 0; dim < ndim - 1 && counter[dim] == shape_[dim]; dim++) {
+        counter[dim] = 0;
+        counter[dim + 1]++;
+      }
+    }
+  }
+
+private:
+  TensorIterator() {}
+
+  void build(IntList sizes);
+  void compute_strides();
+  void reorder_dimensions();
+  void coalesce_dimensions();
+
+  int ntensors_;
+  int noutputs_ = 1;
+  std::array<Tensor, MAX_OPERANDS> operands_;
+  std::array<char*, MAX_OPERANDS> data_;
+  // sizes of the iteration space, innermost dimension first
+  std::vector<int64_t> shape_;
+  // byte strides, indexed by [dim * ntensors_ + arg]
+  std::vector<int64_t> strides_;
+};
+
+}} // namespace at::native
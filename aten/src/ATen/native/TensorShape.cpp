@@ -295,7 +295,6 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
   AT_CHECK(ndim > 0, "slice() cannot be applied to a 0-dim tensor.");
   dim = maybe_wrap_dim(dim, ndim);
   auto sizes = std::vector<int64_t>(self.sizes());
-  auto strides = std::vector<int64_t>(self.strides());
   if (step <= 0) {
     // TODO: support negative strides
     throw std::runtime_error("slice step must be positive");
@@ -316,6 +315,11 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
   } else if (end >= sizes[dim]) {
     end = sizes[dim];
   }
+  if (self.layout() == kSparseCsr) {
+    AT_CHECK(dim == 0 && step == 1, "sparse CSR tensors can only be sliced along dim 0 with step 1");
+    return at::_sparse_csr_slice_rows(self, start, end);
+  }
+  auto strides = std::vector<int64_t>(self.strides());
   auto storage_offset = self.storage_offset() + start * strides[dim];
   auto len = end - start;
 #ifndef USE_TH_SIZE_ZERO_DIM
@@ -0,0 +1,117 @@
+#include "ATen/native/cpu/BinaryOpsKernel.h"
+
+#include "ATen/Dispatch.h"
+#include "ATen/native/cpu/Loops.h"
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec;
+
+// Floating point types are vectorized with Vectorized<scalar_t>. The integral
+// specializations do not implement every operator, so integral
+// types use plain loops, which the compiler vectorizes where it can.
+
+static void add_kernel_impl(TensorIterator& iter, Scalar alpha_scalar) {
+  if (isIntegralType(iter.type().scalarType())) {
+    AT_DISPATCH_INTEGRAL_TYPES(iter.type(), "add", [&]() {
+      auto alpha = alpha_scalar.to<scalar_t>();
+      binary_kernel<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a + alpha * b; });
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.type(), "add", [&]() {
+      auto alpha = alpha_scalar.to<scalar_t>();
+      auto alpha_vec = Vectorized<scalar_t>(alpha);
+      binary_kernel_vec<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a + alpha * b; },
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a + alpha_vec * b; });
+    });
+  }
+}
+
+static void sub_kernel_impl(TensorIterator& iter, Scalar alpha_scalar) {
+  if (isIntegralType(iter.type().scalarType())) {
+    AT_DISPATCH_INTEGRAL_TYPES(iter.type(), "sub", [&]() {
+      auto alpha = alpha_scalar.to<scalar_t>();
+      binary_kernel<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a - alpha * b; });
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.type(), "sub", [&]() {
+      auto alpha = alpha_scalar.to<scalar_t>();
+      auto alpha_vec = Vectorized<scalar_t>(alpha);
+      binary_kernel_vec<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a - alpha * b; },
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a - alpha_vec * b; });
+    });
+  }
+}
+
+static void mul_kernel_impl(TensorIterator& iter) {
+  if (isIntegralType(iter.type().scalarType())) {
+    AT_DISPATCH_INTEGRAL_TYPES(iter.type(), "mul", [&]() {
+      binary_kernel<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; });
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.type(), "mul", [&]() {
+      binary_kernel_vec<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a * b; });
+    });
+  }
+}
+
+static void div_kernel_impl(TensorIterator& iter) {
+  if (isIntegralType(iter.type().scalarType())) {
+    AT_DISPATCH_INTEGRAL_TYPES(iter.type(), "div", [&]() {
+      binary_kernel<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a / b; });
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.type(), "div", [&]() {
+      binary_kernel_vec<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b) -> scalar_t { return a / b; },
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a / b; });
+    });
+  }
+}
+
+static void addcmul_kernel_impl(TensorIterator& iter, Scalar value_scalar) {
+  if (isIntegralType(iter.type().scalarType())) {
+    AT_DISPATCH_INTEGRAL_TYPES(iter.type(), "addcmul", [&]() {
+      auto value = value_scalar.to<scalar_t>();
+      ternary_kernel<scalar_t, scalar_t, scalar_t, scalar_t>(iter,
+        [=](scalar_t a, scalar_t b, scalar_t c) -> scalar_t { return a + value * b * c; });
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.type(), "addcmul", [&]() {
+      auto value = value_scalar.to<scalar_t>();
+      auto value_vec = Vectorized<scalar_t>(value);
+      ternary_kernel_vec<scalar_t>(iter,
+        [=](scalar_t a, scalar_t b, scalar_t c) -> scalar_t { return a + value * b * c; },
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b, Vectorized<scalar_t> c) {
+          return a + value_vec * b * c;
+        });
+    });
+  }
+}
+
+static void where_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.type(), "where", [&]() {
+    ternary_kernel<scalar_t, uint8_t, scalar_t, scalar_t>(iter,
+      [=](uint8_t cond, scalar_t a, scalar_t b) -> scalar_t { return cond ? a : b; });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(add_kernel, &add_kernel_impl);
+REGISTER_DISPATCH(sub_kernel, &sub_kernel_impl);
+REGISTER_DISPATCH(mul_kernel, &mul_kernel_impl);
+REGISTER_DISPATCH(div_kernel, &div_kernel_impl);
+REGISTER_DISPATCH(addcmul_kernel, &addcmul_kernel_impl);
+REGISTER_DISPATCH(where_kernel, &where_kernel_impl);
+
+}} // namespace at::native
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "ATen/native/TensorIterator.h"
+#include "CapabilityDispatch.h"
+
+namespace at { namespace native {
+
+using binary_fn_alpha = void(*)(TensorIterator&, Scalar alpha);
+using binary_fn = void(*)(TensorIterator&);
+using ternary_fn_alpha = void(*)(TensorIterator&, Scalar alpha);
+
+// out = a + alpha * b
+extern DispatchStub<binary_fn_alpha> add_kernel;
+// out = a - alpha * b
+extern DispatchStub<binary_fn_alpha> sub_kernel;
+extern DispatchStub<binary_fn> mul_kernel;
+extern DispatchStub<binary_fn> div_kernel;
+// out = a + value * b * c
+extern DispatchStub<ternary_fn_alpha> addcmul_kernel;
+// out = condition ? a : b, for a uint8 condition
+extern DispatchStub<binary_fn> where_kernel;
+
+}} // namespace at::native
@@ -10,7 +10,11 @@
 // compiled multiple times with different compiler flags (e.g. -mavx). A
 // DispatchStub contains a table of function pointers for a kernel. At runtime,
 // the fastest available kernel is chosen based on the features reported by
-// cpuinfo.
+// cpuinfo. Setting ATEN_DISABLE_AVX512, ATEN_DISABLE_AVX2 or ATEN_DISABLE_AVX
+// in the environment skips the corresponding kernels.
+//
+// The AVX512 kernels need AVX512F, AVX512DQ, AVX512VL and AVX512BW, which every
+// AVX512 server CPU has.
 //
 // Example:
 //
@@ -29,7 +33,7 @@
 namespace at {
 namespace native {
 
-enum class CPUCapability { DEFAULT, AVX, AVX2, NUM_OPTIONS };
+enum class CPUCapability { DEFAULT, AVX, AVX2, AVX512, NUM_OPTIONS };
 
 template <typename FnPtr>
 struct DispatchStub {
@@ -47,6 +51,12 @@ struct DispatchStub {
 // Do not use cpuinfo on PowerPC as it shows confusing errors when run on ppc
 #ifndef __powerpc__
     if (cpuinfo_initialize()) {
+      int avx512 = static_cast<int>(CPUCapability::AVX512);
+      if (!std::getenv("ATEN_DISABLE_AVX512") && cpuinfo_has_x86_avx512f() &&
+          cpuinfo_has_x86_avx512dq() && cpuinfo_has_x86_avx512vl() &&
+          cpuinfo_has_x86_avx512bw() && table[avx512]) {
+        return table[avx512];
+      }
       int avx2 = static_cast<int>(CPUCapability::AVX2);
       if (!std::getenv("ATEN_DISABLE_AVX2") && cpuinfo_has_x86_avx2() && table[avx2]) {
         return table[avx2];
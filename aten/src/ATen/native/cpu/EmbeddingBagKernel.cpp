@@ -0,0 +1,139 @@
+#include "ATen/native/cpu/EmbeddingBagKernel.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec.h"
+
+// Every bag is reduced by one thread, which accumulates the rows of the bag
+// directly into its output row. Half and 8-bit rows are converted to float in
+// blocks small enough to stay in L1 and accumulated with vector instructions.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec;
+
+// number of elements of a Half or Byte row converted to float at a time
+constexpr int64_t kBlockSize = 256;
+
+// out += row * alpha + beta
+template <typename scalar_t>
+void axpby(scalar_t* out, const scalar_t* row, int64_t n, scalar_t alpha, scalar_t beta) {
+  using Vec = Vectorized<scalar_t>;
+  Vec alpha_vec(alpha);
+  Vec beta_vec(beta);
+  int64_t i = 0;
+  for (; i <= n - Vec::size; i += Vec::size) {
+    (Vec::loadu(out + i) + Vec::loadu(row + i) * alpha_vec + beta_vec).store(out + i);
+  }
+  for (; i < n; i++) {
+    out[i] += row[i] * alpha + beta;
+  }
+}
+
+template <typename scalar_t>
+void scale_row(scalar_t* out, int64_t n, scalar_t scale) {
+  using Vec = Vectorized<scalar_t>;
+  Vec scale_vec(scale);
+  int64_t i = 0;
+  for (; i <= n - Vec::size; i += Vec::size) {
+    (Vec::loadu(out + i) * scale_vec).store(out + i);
+  }
+  for (; i < n; i++) {
+    out[i] *= scale;
+  }
+}
+
+static void half_to_float(float* out, const Half* in, int64_t n) {
+  int64_t i = 0;
+#if defined(__F16C__)
+  for (; i <= n - 8; i += 8) {
+    auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = static_cast<float>(in[i]);
+  }
+}
+
+// Calls add_row(out, index) for every index of every bag, in parallel over
+// the bags, with out the zeroed output row of the bag.
+template <typename acc_t, typename AddRow>
+void reduce_bags(
+    const Tensor& indices, const Tensor& offsets, bool mean, int64_t dim,
+    acc_t* output_data, const AddRow& add_row) {
+  const int64_t* indices_data = indices.data<int64_t>();
+  const int64_t* offsets_data = offsets.data<int64_t>();
+  int64_t num_bags = offsets.size(0);
+  int64_t num_indices = indices.size(0);
+  // elements read per bag on average
+  int64_t bag_work = std::max<int64_t>(1, num_indices / std::max<int64_t>(num_bags, 1)) * dim;
+  parallel_for(0, num_bags, divup(internal::GRAIN_SIZE, std::max<int64_t>(bag_work, 1)), [&](int64_t begin, int64_t end) {
+    for (int64_t bag = begin; bag < end; bag++) {
+      acc_t* out = output_data + bag * dim;
+      std::fill(out, out + dim, acc_t(0));
+      // indices before offsets[0] belong to the first bag, as in offset2bag
+      int64_t first = bag == 0 ? 0 : offsets_data[bag];
+      int64_t last = bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices;
+      for (int64_t i = first; i < last; i++) {
+        add_row(out, indices_data[i]);
+      }
+      if (mean && last > first) {
+        scale_row(out, dim, acc_t(1) / (last - first));
+      }
+    }
+  });
+}
+
+static void embedding_bag_kernel_impl(
+    const Tensor& weight, const Tensor& indices, const Tensor& offsets,
+    bool mean, Tensor& output) {
+  if (weight.type().scalarType() == kHalf) {
+    int64_t dim = weight.size(1);
+    const Half* weight_data = weight.data<Half>();
+    reduce_bags(indices, offsets, mean, dim, output.data<float>(), [&](float* out, int64_t index) {
+      const Half* row = weight_data + index * dim;
+      float buf[kBlockSize];
+      for (int64_t i = 0; i < dim; i += kBlockSize) {
+        int64_t n = std::min(kBlockSize, dim - i);
+        half_to_float(buf, row + i, n);
+        axpby(out + i, buf, n, 1.f, 0.f);
+      }
+    });
+  } else if (weight.type().scalarType() == kByte) {
+    int64_t row_size = weight.size(1);
+    int64_t dim = row_size - 2 * sizeof(float);
+    const uint8_t* weight_data = weight.data<uint8_t>();
+    reduce_bags(indices, offsets, mean, dim, output.data<float>(), [&](float* out, int64_t index) {
+      const uint8_t* row = weight_data + index * row_size;
+      float scale_bias[2];
+      std::memcpy(scale_bias, row + dim, sizeof(scale_bias));
+      float buf[kBlockSize];
+      for (int64_t i = 0; i < dim; i += kBlockSize) {
+        int64_t n = std::min(kBlockSize, dim - i);
+        for (int64_t j = 0; j < n; j++) {
+          buf[j] = row[i + j];
+        }
+        axpby(out + i, buf, n, scale_bias[0], scale_bias[1]);
+      }
+    });
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(weight.type(), "embedding_bag", [&] {
+      int64_t dim = weight.size(1);
+      const scalar_t* weight_data = weight.data<scalar_t>();
+      reduce_bags(indices, offsets, mean, dim, output.data<scalar_t>(), [&](scalar_t* out, int64_t index) {
+        axpby(out, weight_data + index * dim, dim, scalar_t(1), scalar_t(0));
+      });
+    });
+  }
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(embedding_bag_kernel, &embedding_bag_kernel_impl);
+
+}} // namespace at::native
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// Sums the rows of weight selected by indices[offsets[b]:offsets[b + 1]] (the
+// last bag ends at the end of indices) into row b of output, and divides them
+// by the size of the bag if mean is true. Empty bags are zero. indices and
+// offsets are contiguous int64 and every index is a valid row.
+//
+// weight is a contiguous 2-D table of one of:
+//   float or double rows; output has the same type,
+//   Half rows; output is float,
+//   Byte rows in the fused 8-bit row-wise format: dim quantized values
+//   followed by the float scale and bias of the row, so that the value is
+//   scale * q + bias; output is float.
+using embedding_bag_fn = void(*)(
+    const Tensor& weight, const Tensor& indices, const Tensor& offsets,
+    bool mean, Tensor& output);
+
+extern DispatchStub<embedding_bag_fn> embedding_bag_kernel;
+
+}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+// Inner loops for TensorIterator kernels.
+//
+// The operands of the op are passed to the loop as byte pointers with byte
+// strides. Each loop checks whether the strides describe a contiguous or a
+// broadcast (stride 0) operand and picks a specialized loop for that case,
+// which the compiler (or Vectorized) can vectorize. Everything else takes the
+// basic strided loop.
+//
+// These templates are compiled once for every CPU_CAPABILITY, like the
+// kernels that include them.
+
+#include "ATen/native/TensorIterator.h"
+#include "ATen/cpu/vec.h"
+
+namespace at { namespace native { namespace {
+
+using namespace vec;
+
+template <typename scalar_t, typename op_t>
+inline void basic_binary_loop(char** data, const int64_t* strides, int64_t n, op_t op) {
+  char* out = data[0];
+  const char* a = data[1];
+  const char* b = data[2];
+  for (int64_t i = 0; i < n; i++) {
+    *(scalar_t*)out = op(*(const scalar_t*)a, *(const scalar_t*)b);
+    out += strides[0];
+    a += strides[1];
+    b += strides[2];
+  }
+}
+
+// out, a and b are contiguous, except that a (or b) is a single broadcast
+// scalar if a_scalar (or b_scalar) is set.
+template <bool a_scalar, bool b_scalar, typename scalar_t, typename op_t, typename vop_t>
+inline void vectorized_binary_loop(
+    scalar_t* out, const scalar_t* a, const scalar_t* b, int64_t n, op_t op, vop_t vop) {
+  using Vec = Vectorized<scalar_t>;
+  Vec a_vec = a_scalar ? Vec(*a) : Vec();
+  Vec b_vec = b_scalar ? Vec(*b) : Vec();
+  int64_t i = 0;
+  for (; i <= n - 2 * Vec::size; i += 2 * Vec::size) {
+    Vec a0 = a_scalar ? a_vec : Vec::loadu(a + i);
+    Vec a1 = a_scalar ? a_vec : Vec::loadu(a + i + Vec::size);
+    Vec b0 = b_scalar ? b_vec : Vec::loadu(b + i);
+    Vec b1 = b_scalar ? b_vec : Vec::loadu(b + i + Vec::size);
+    vop(a0, b0).store(out + i);
+    vop(a1, b1).store(out + i + Vec::size);
+  }
+  for (; i < n; i++) {
+    out[i] = op(a_scalar ? *a : a[i], b_scalar ? *b : b[i]);
+  }
+}
+
+// out = op(a, b) for all elements of a TensorIterator with one output and two
+// inputs, all of type scalar_t.
+template <typename scalar_t, typename op_t>
+void binary_kernel(TensorIterator& iter, op_t op) {
+  constexpr int64_t s = sizeof(scalar_t);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == s && strides[1] == s && strides[2] == s) {
+      // written out separately so the compiler can vectorize it
+      auto out = (scalar_t*)data[0];
+      auto a = (const scalar_t*)data[1];
+      auto b = (const scalar_t*)data[2];
+      for (int64_t i = 0; i < n; i++) {
+        out[i] = op(a[i], b[i]);
+      }
+    } else {
+      basic_binary_loop<scalar_t>(data, strides, n, op);
+    }
+  });
+}
+
+// Like binary_kernel, but uses vop on Vectorized<scalar_t> for contiguous and
+// broadcast operands.
+template <typename scalar_t, typename op_t, typename vop_t>
+void binary_kernel_vec(TensorIterator& iter, op_t op, vop_t vop) {
+  constexpr int64_t s = sizeof(scalar_t);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    auto out = (scalar_t*)data[0];
+    auto a = (const scalar_t*)data[1];
+    auto b = (const scalar_t*)data[2];
+    if (strides[0] != s) {
+      basic_binary_loop<scalar_t>(data, strides, n, op);
+    } else if (strides[1] == s && strides[2] == s) {
+      vectorized_binary_loop<false, false>(out, a, b, n, op, vop);
+    } else if (strides[1] == 0 && strides[2] == s) {
+      vectorized_binary_loop<true, false>(out, a, b, n, op, vop);
+    } else if (strides[1] == s && strides[2] == 0) {
+      vectorized_binary_loop<false, true>(out, a, b, n, op, vop);
+    } else {
+      basic_binary_loop<scalar_t>(data, strides, n, op);
+    }
+  });
+}
+
+// out = op(a, b, c) for all elements of a TensorIterator with one output and
+// three inputs. The inputs may have different types (e.g. where's condition).
+template <typename out_t, typename a_t, typename b_t, typename c_t, typename op_t>
+void ternary_kernel(TensorIterator& iter, op_t op) {
+  constexpr int64_t s_out = sizeof(out_t);
+  constexpr int64_t s_a = sizeof(a_t);
+  constexpr int64_t s_b = sizeof(b_t);
+  constexpr int64_t s_c = sizeof(c_t);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == s_out && strides[1] == s_a && strides[2] == s_b && strides[3] == s_c) {
+      auto out = (out_t*)data[0];
+      auto a = (const a_t*)data[1];
+      auto b = (const b_t*)data[2];
+      auto c = (const c_t*)data[3];
+      for (int64_t i = 0; i < n; i++) {
+        out[i] = op(a[i], b[i], c[i]);
+      }
+    } else {
+      char* out = data[0];
+      const char* a = data[1];
+      const char* b = data[2];
+      const char* c = data[3];
+      for (int64_t i = 0; i < n; i++) {
+        *(out_t*)out = op(*(const a_t*)a, *(const b_t*)b, *(const c_t*)c);
+        out += strides[0];
+        a += strides[1];
+        b += strides[2];
+        c += strides[3];
+      }
+    }
+  });
+}
+
+// Like ternary_kernel for operands of a single type, but uses vop on
+// Vectorized<scalar_t> when all operands are contiguous.
+template <typename scalar_t, typename op_t, typename vop_t>
+void ternary_kernel_vec(TensorIterator& iter, op_t op, vop_t vop) {
+  using Vec = Vectorized<scalar_t>;
+  constexpr int64_t s = sizeof(scalar_t);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == s && strides[1] == s && strides[2] == s && strides[3] == s) {
+      auto out = (scalar_t*)data[0];
+      auto a = (const scalar_t*)data[1];
+      auto b = (const scalar_t*)data[2];
+      auto c = (const scalar_t*)data[3];
+      int64_t i = 0;
+      for (; i <= n - Vec::size; i += Vec::size) {
+        vop(Vec::loadu(a + i), Vec::loadu(b + i), Vec::loadu(c + i)).store(out + i);
+      }
+      for (; i < n; i++) {
+        out[i] = op(a[i], b[i], c[i]);
+      }
+    } else {
+      char* out = data[0];
+      const char* a = data[1];
+      const char* b = data[2];
+      const char* c = data[3];
+      for (int64_t i = 0; i < n; i++) {
+        *(scalar_t*)out = op(*(const scalar_t*)a, *(const scalar_t*)b, *(const scalar_t*)c);
+        out += strides[0];
+        a += strides[1];
+        b += strides[2];
+        c += strides[3];
+      }
+    }
+  });
+}
+
+}}} // namespace at::native::<anonymous>
@@ -0,0 +1,414 @@
+#include "ATen/native/cpu/NormalizationKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec.h"
+
+// Every row (layer_norm) or group (group_norm) is normalized by one thread.
+// The statistics are computed in a single pass with Welford's algorithm, and
+// the normalization and the affine transform are a single multiply-add per
+// element, so the forward reads the input twice and writes the output once.
+// The backward reads dY and X of a row twice, the second time from cache.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec;
+
+// Welford's count, mean and sum of squared deviations from the mean.
+template <typename scalar_t>
+struct Moments {
+  int64_t n = 0;
+  scalar_t mean = 0;
+  scalar_t m2 = 0;
+
+  // merges the moments of another set of values (Chan et al.)
+  void combine(int64_t n_b, scalar_t mean_b, scalar_t m2_b) {
+    if (n_b == 0) {
+      return;
+    }
+    int64_t n_ab = n + n_b;
+    scalar_t delta = mean_b - mean;
+    scalar_t ratio = scalar_t(n_b) / n_ab;
+    mean += delta * ratio;
+    m2 += m2_b + delta * delta * n * ratio;
+    n = n_ab;
+  }
+};
+
+// Returns the mean and 1 / sqrt(biased variance + eps) of n contiguous values.
+// Welford's update runs independently in every vector lane; the lanes are
+// merged at the end.
+template <typename scalar_t>
+std::pair<scalar_t, scalar_t> moments(const scalar_t* data, int64_t n, double eps) {
+  using Vec = Vectorized<scalar_t>;
+  Moments<scalar_t> m;
+  int64_t nvec = n / Vec::size;
+  if (nvec > 0) {
+    Vec mean_vec(scalar_t(0));
+    Vec m2_vec(scalar_t(0));
+    for (int64_t i = 0; i < nvec; i++) {
+      Vec x = Vec::loadu(data + i * Vec::size);
+      Vec delta = x - mean_vec;
+      mean_vec = mean_vec + delta * Vec(scalar_t(1) / (i + 1));
+      m2_vec = m2_vec + delta * (x - mean_vec);
+    }
+    scalar_t means[Vec::size];
+    scalar_t m2s[Vec::size];
+    mean_vec.store(means);
+    m2_vec.store(m2s);
+    for (int j = 0; j != Vec::size; j++) {
+      m.combine(nvec, means[j], m2s[j]);
+    }
+  }
+  for (int64_t i = nvec * Vec::size; i < n; i++) {
+    m.combine(1, data[i], 0);
+  }
+  scalar_t var = n > 0 ? std::max(m.m2 / n, scalar_t(0)) : scalar_t(0);
+  return {m.mean, scalar_t(1) / std::sqrt(var + static_cast<scalar_t>(eps))};
+}
+
+// y = x * scale + shift for n contiguous values
+template <typename scalar_t>
+void scale_shift(scalar_t* y, const scalar_t* x, int64_t n, scalar_t scale, scalar_t shift) {
+  using Vec = Vectorized<scalar_t>;
+  Vec scale_vec(scale);
+  Vec shift_vec(shift);
+  int64_t i = 0;
+  for (; i <= n - Vec::size; i += Vec::size) {
+    (Vec::loadu(x + i) * scale_vec + shift_vec).store(y + i);
+  }
+  for (; i < n; i++) {
+    y[i] = x[i] * scale + shift;
+  }
+}
+
+template <typename F>
+static void for_each_chunk(int64_t nchunks, const F& f) {
+  if (nchunks == 1) {
+    f(0);
+    return;
+  }
+  parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      f(chunk);
+    }
+  });
+}
+
+template <typename scalar_t>
+void layer_norm_row(
+    scalar_t* y, const scalar_t* x, const scalar_t* gamma, const scalar_t* beta,
+    int64_t n, scalar_t mean, scalar_t rstd) {
+  using Vec = Vectorized<scalar_t>;
+  if (!gamma && !beta) {
+    scale_shift(y, x, n, rstd, -mean * rstd);
+    return;
+  }
+  Vec mean_vec(mean);
+  Vec rstd_vec(rstd);
+  int64_t i = 0;
+  for (; i <= n - Vec::size; i += Vec::size) {
+    Vec out = (Vec::loadu(x + i) - mean_vec) * rstd_vec;
+    if (gamma) {
+      out = out * Vec::loadu(gamma + i);
+    }
+    if (beta) {
+      out = out + Vec::loadu(beta + i);
+    }
+    out.store(y + i);
+  }
+  for (; i < n; i++) {
+    scalar_t out = (x[i] - mean) * rstd;
+    y[i] = (gamma ? out * gamma[i] : out) + (beta ? beta[i] : scalar_t(0));
+  }
+}
+
+static void layer_norm_kernel_impl(
+    const Tensor& X, const Tensor& gamma, const Tensor& beta,
+    int64_t M, int64_t N, double eps, Tensor& Y, Tensor& mean, Tensor& rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "layer_norm", [&] {
+    const scalar_t* X_data = X.data<scalar_t>();
+    const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+    const scalar_t* beta_data = beta.defined() ? beta.data<scalar_t>() : nullptr;
+    scalar_t* Y_data = Y.data<scalar_t>();
+    scalar_t* mean_data = mean.data<scalar_t>();
+    scalar_t* rstd_data = rstd.data<scalar_t>();
+    parallel_for(0, M, divup(internal::GRAIN_SIZE, std::max<int64_t>(N, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const scalar_t* x = X_data + i * N;
+        auto stats = moments(x, N, eps);
+        layer_norm_row(Y_data + i * N, x, gamma_data, beta_data, N, stats.first, stats.second);
+        mean_data[i] = stats.first;
+        rstd_data[i] = stats.second;
+      }
+    });
+  });
+}
+
+// With g = dY * gamma and x_hat = (X - mean) * rstd,
+//   dX = rstd * (g - mean(g) - x_hat * mean(g * x_hat))
+//   dgamma = sum over rows of dY * x_hat
+//   dbeta = sum over rows of dY
+static void layer_norm_backward_kernel_impl(
+    const Tensor& dY, const Tensor& X, const Tensor& mean, const Tensor& rstd,
+    const Tensor& gamma, int64_t M, int64_t N,
+    Tensor& dX, Tensor& dgamma, Tensor& dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "layer_norm_backward", [&] {
+    using Vec = Vectorized<scalar_t>;
+    const scalar_t* dY_data = dY.data<scalar_t>();
+    const scalar_t* X_data = X.data<scalar_t>();
+    const scalar_t* mean_data = mean.data<scalar_t>();
+    const scalar_t* rstd_data = rstd.data<scalar_t>();
+    const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+    scalar_t* dX_data = dX.defined() ? dX.data<scalar_t>() : nullptr;
+    bool compute_params = dgamma.defined() || dbeta.defined();
+
+    int64_t nchunks = normalization_row_chunks(M, N);
+    // dgamma and dbeta partial sums of every chunk
+    std::vector<scalar_t> partial(compute_params ? nchunks * 2 * N : 0, 0);
+
+    for_each_chunk(nchunks, [&](int64_t chunk) {
+      scalar_t* dgamma_acc = compute_params ? partial.data() + chunk * 2 * N : nullptr;
+      scalar_t* dbeta_acc = compute_params ? dgamma_acc + N : nullptr;
+      for (int64_t i = chunk * M / nchunks; i < (chunk + 1) * M / nchunks; i++) {
+        const scalar_t* dy = dY_data + i * N;
+        const scalar_t* x = X_data + i * N;
+        scalar_t mu = mean_data[i];
+        scalar_t rs = rstd_data[i];
+        Vec mu_vec(mu);
+        Vec rs_vec(rs);
+
+        // sums of g and g * (x - mean), and the parameter gradients
+        Vec sum_g_vec(scalar_t(0));
+        Vec sum_gx_vec(scalar_t(0));
+        int64_t j = 0;
+        for (; j <= N - Vec::size; j += Vec::size) {
+          Vec dy_vec = Vec::loadu(dy + j);
+          Vec xm_vec = Vec::loadu(x + j) - mu_vec;
+          Vec g_vec = gamma_data ? dy_vec * Vec::loadu(gamma_data + j) : dy_vec;
+          sum_g_vec = sum_g_vec + g_vec;
+          sum_gx_vec = sum_gx_vec + g_vec * xm_vec;
+          if (compute_params) {
+            (Vec::loadu(dgamma_acc + j) + dy_vec * xm_vec * rs_vec).store(dgamma_acc + j);
+            (Vec::loadu(dbeta_acc + j) + dy_vec).store(dbeta_acc + j);
+          }
+        }
+        scalar_t buf_g[Vec::size];
+        scalar_t buf_gx[Vec::size];
+        sum_g_vec.store(buf_g);
+        sum_gx_vec.store(buf_gx);
+        scalar_t sum_g = 0;
+        scalar_t sum_gx = 0;
+        for (int k = 0; k != Vec::size; k++) {
+          sum_g += buf_g[k];
+          sum_gx += buf_gx[k];
+        }
+        for (; j < N; j++) {
+          scalar_t g = gamma_data ? dy[j] * gamma_data[j] : dy[j];
+          sum_g += g;
+          sum_gx += g * (x[j] - mu);
+          if (compute_params) {
+            dgamma_acc[j] += dy[j] * (x[j] - mu) * rs;
+            dbeta_acc[j] += dy[j];
+          }
+        }
+
+        if (dX_data) {
+          // dX = rstd * g + c1 * x + c2
+          scalar_t c1 = -rs * rs * rs * sum_gx / N;
+          scalar_t c2 = -c1 * mu - rs * sum_g / N;
+          scalar_t* dx = dX_data + i * N;
+          Vec c1_vec(c1);
+          Vec c2_vec(c2);
+          j = 0;
+          for (; j <= N - Vec::size; j += Vec::size) {
+            Vec g_vec = Vec::loadu(dy + j);
+            if (gamma_data) {
+              g_vec = g_vec * Vec::loadu(gamma_data + j);
+            }
+            (rs_vec * g_vec + c1_vec * Vec::loadu(x + j) + c2_vec).store(dx + j);
+          }
+          for (; j < N; j++) {
+            scalar_t g = gamma_data ? dy[j] * gamma_data[j] : dy[j];
+            dx[j] = rs * g + c1 * x[j] + c2;
+          }
+        }
+      }
+    });
+
+    if (compute_params) {
+      scalar_t* dgamma_data = dgamma.defined() ? dgamma.data<scalar_t>() : nullptr;
+      scalar_t* dbeta_data = dbeta.defined() ? dbeta.data<scalar_t>() : nullptr;
+      for (int64_t j = 0; j < N; j++) {
+        scalar_t dg = 0;
+        scalar_t db = 0;
+        for (int64_t chunk = 0; chunk < nchunks; chunk++) {
+          dg += partial[chunk * 2 * N + j];
+          db += partial[chunk * 2 * N + N + j];
+        }
+        if (dgamma_data) {
+          dgamma_data[j] = dg;
+        }
+        if (dbeta_data) {
+          dbeta_data[j] = db;
+        }
+      }
+    }
+  });
+}
+
+static void group_norm_kernel_impl(
+    const Tensor& X, const Tensor& gamma, const Tensor& beta,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps,
+    Tensor& Y, Tensor& mean, Tensor& rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "group_norm", [&] {
+    const scalar_t* X_data = X.data<scalar_t>();
+    const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+    const scalar_t* beta_data = beta.defined() ? beta.data<scalar_t>() : nullptr;
+    scalar_t* Y_data = Y.data<scalar_t>();
+    scalar_t* mean_data = mean.data<scalar_t>();
+    scalar_t* rstd_data = rstd.data<scalar_t>();
+    int64_t D = C / group;
+    int64_t group_size = D * HxW;
+    parallel_for(0, N * group, divup(internal::GRAIN_SIZE, std::max<int64_t>(group_size, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const scalar_t* x = X_data + i * group_size;
+        scalar_t* y = Y_data + i * group_size;
+        auto stats = moments(x, group_size, eps);
+        scalar_t mu = stats.first;
+        scalar_t rs = stats.second;
+        int64_t c0 = (i % group) * D;
+        for (int64_t d = 0; d < D; d++) {
+          scalar_t scale = gamma_data ? rs * gamma_data[c0 + d] : rs;
+          scalar_t shift = (beta_data ? beta_data[c0 + d] : scalar_t(0)) - mu * scale;
+          scale_shift(y + d * HxW, x + d * HxW, HxW, scale, shift);
+        }
+        mean_data[i] = mu;
+        rstd_data[i] = rs;
+      }
+    });
+  });
+}
+
+// Like layer_norm_backward, with the sums over a row replaced by sums over a
+// group, and gamma constant over the HxW elements of a channel.
+static void group_norm_backward_kernel_impl(
+    const Tensor& dY, const Tensor& X, const Tensor& mean, const Tensor& rstd,
+    const Tensor& gamma, int64_t N, int64_t C, int64_t HxW, int64_t group,
+    Tensor& dX, Tensor& dgamma, Tensor& dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(X.type(), "group_norm_backward", [&] {
+    using Vec = Vectorized<scalar_t>;
+    const scalar_t* dY_data = dY.data<scalar_t>();
+    const scalar_t* X_data = X.data<scalar_t>();
+    const scalar_t* mean_data = mean.data<scalar_t>();
+    const scalar_t* rstd_data = rstd.data<scalar_t>();
+    const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+    scalar_t* dX_data = dX.defined() ? dX.data<scalar_t>() : nullptr;
+    int64_t D = C / group;
+    int64_t group_size = D * HxW;
+
+    // per sample and channel: sum of dY * (X - mean) and of dY
+    std::vector<scalar_t> ds(N * C);
+    std::vector<scalar_t> db(N * C);
+
+    parallel_for(0, N * group, divup(internal::GRAIN_SIZE, std::max<int64_t>(group_size, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        scalar_t mu = mean_data[i];
+        scalar_t rs = rstd_data[i];
+        int64_t c0 = (i % group) * D;
+        Vec mu_vec(mu);
+        scalar_t sum_g = 0;
+        scalar_t sum_gx = 0;
+        for (int64_t d = 0; d < D; d++) {
+          const scalar_t* dy = dY_data + i * group_size + d * HxW;
+          const scalar_t* x = X_data + i * group_size + d * HxW;
+          Vec ds_vec(scalar_t(0));
+          Vec db_vec(scalar_t(0));
+          int64_t j = 0;
+          for (; j <= HxW - Vec::size; j += Vec::size) {
+            Vec dy_vec = Vec::loadu(dy + j);
+            ds_vec = ds_vec + dy_vec * (Vec::loadu(x + j) - mu_vec);
+            db_vec = db_vec + dy_vec;
+          }
+          scalar_t buf_ds[Vec::size];
+          scalar_t buf_db[Vec::size];
+          ds_vec.store(buf_ds);
+          db_vec.store(buf_db);
+          scalar_t ds_c = 0;
+          scalar_t db_c = 0;
+          for (int k = 0; k != Vec::size; k++) {
+            ds_c += buf_ds[k];
+            db_c += buf_db[k];
+          }
+          for (; j < HxW; j++) {
+            ds_c += dy[j] * (x[j] - mu);
+            db_c += dy[j];
+          }
+          int64_t nc = (i / group) * C + c0 + d;
+          ds[nc] = ds_c;
+          db[nc] = db_c;
+          scalar_t gamma_c = gamma_data ? gamma_data[c0 + d] : scalar_t(1);
+          sum_g += gamma_c * db_c;
+          sum_gx += gamma_c * ds_c;
+        }
+
+        if (dX_data) {
+          scalar_t c1 = -rs * rs * rs * sum_gx / group_size;
+          scalar_t c2 = -c1 * mu - rs * sum_g / group_size;
+          for (int64_t d = 0; d < D; d++) {
+            const scalar_t* dy = dY_data + i * group_size + d * HxW;
+            const scalar_t* x = X_data + i * group_size + d * HxW;
+            scalar_t* dx = dX_data + i * group_size + d * HxW;
+            scalar_t a = rs * (gamma_data ? gamma_data[c0 + d] : scalar_t(1));
+            Vec a_vec(a);
+            Vec c1_vec(c1);
+            Vec c2_vec(c2);
+            int64_t j = 0;
+            for (; j <= HxW - Vec::size; j += Vec::size) {
+              (a_vec * Vec::loadu(dy + j) + c1_vec * Vec::loadu(x + j) + c2_vec).store(dx + j);
+            }
+            for (; j < HxW; j++) {
+              dx[j] = a * dy[j] + c1 * x[j] + c2;
+            }
+          }
+        }
+      }
+    });
+
+    if (dgamma.defined()) {
+      scalar_t* dgamma_data = dgamma.data<scalar_t>();
+      for (int64_t c = 0; c < C; c++) {
+        scalar_t sum = 0;
+        for (int64_t n = 0; n < N; n++) {
+          sum += ds[n * C + c] * rstd_data[n * group + c / D];
+        }
+        dgamma_data[c] = sum;
+      }
+    }
+    if (dbeta.defined()) {
+      scalar_t* dbeta_data = dbeta.data<scalar_t>();
+      for (int64_t c = 0; c < C; c++) {
+        scalar_t sum = 0;
+        for (int64_t n = 0; n < N; n++) {
+          sum += db[n * C + c];
+        }
+        dbeta_data[c] = sum;
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(layer_norm_kernel, &layer_norm_kernel_impl);
+REGISTER_DISPATCH(layer_norm_backward_kernel, &layer_norm_backward_kernel_impl);
+REGISTER_DISPATCH(group_norm_kernel, &group_norm_kernel_impl);
+REGISTER_DISPATCH(group_norm_backward_kernel, &group_norm_backward_kernel_impl);
+
+}} // namespace at::native
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include "CapabilityDispatch.h"
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+
+// Fused layer_norm and group_norm. All tensors are contiguous; gamma and beta
+// may be undefined, and so may the gradients the backward kernels should not
+// compute.
+//
+// layer_norm normalizes each of the M rows of N elements of X and applies
+// gamma and beta (of N elements) to every row. mean and rstd
+// (1 / sqrt(var + eps)) have M elements.
+using layer_norm_fn = void(*)(
+    const Tensor& X, const Tensor& gamma, const Tensor& beta,
+    int64_t M, int64_t N, double eps, Tensor& Y, Tensor& mean, Tensor& rstd);
+using layer_norm_backward_fn = void(*)(
+    const Tensor& dY, const Tensor& X, const Tensor& mean, const Tensor& rstd,
+    const Tensor& gamma, int64_t M, int64_t N,
+    Tensor& dX, Tensor& dgamma, Tensor& dbeta);
+
+// group_norm normalizes X of shape (N, C, HxW) over each of the group groups
+// of C / group channels of every sample and applies gamma and beta (of C
+// elements) per channel. mean and rstd have N * group elements.
+using group_norm_fn = void(*)(
+    const Tensor& X, const Tensor& gamma, const Tensor& beta,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps,
+    Tensor& Y, Tensor& mean, Tensor& rstd);
+using group_norm_backward_fn = void(*)(
+    const Tensor& dY, const Tensor& X, const Tensor& mean, const Tensor& rstd,
+    const Tensor& gamma, int64_t N, int64_t C, int64_t HxW, int64_t group,
+    Tensor& dX, Tensor& dgamma, Tensor& dbeta);
+
+// Number of chunks the backward kernels split nrows rows of row_size elements
+// into, one per thread. Each chunk has its own partial sums for dgamma and
+// dbeta.
+inline int64_t normalization_row_chunks(int64_t nrows, int64_t row_size) {
+  if (nrows * row_size < internal::GRAIN_SIZE) {
+    return 1;
+  }
+  return std::max<int64_t>(1, std::min<int64_t>(internal::get_intraop_num_threads(), nrows));
+}
+
+extern DispatchStub<layer_norm_fn> layer_norm_kernel;
+extern DispatchStub<layer_norm_backward_fn> layer_norm_backward_kernel;
+extern DispatchStub<group_norm_fn> group_norm_kernel;
+extern DispatchStub<group_norm_backward_fn> group_norm_backward_kernel;
+
+}
+}
@@ -0,0 +1,381 @@
+#pragma once
+
+// Loops for reductions over a TensorIterator built by reduce_op.
+//
+// reduce_kernel splits the dimensions of the iterator into the kept ones,
+// where the outputs have a nonzero stride, and the reduced ones. If the
+// innermost dimension is reduced (e.g. sum(-1)), every output reduces runs
+// along it. Otherwise (e.g. sum(0)) a block of adjacent outputs is reduced
+// together, one row of the input at a time, which vectorizes across the
+// outputs and reads the input in memory order.
+//
+// Reductions into fewer outputs than there are threads are also split along
+// the reduced dimensions, and the partial results of the threads are
+// combined at the end. Within a thread, partial results over chunks of the
+// input are combined pairwise, so the rounding error of floating point sums
+// grows with the logarithm of the number of elements.
+//
+// The reduction itself is described by an ops object with an accumulator
+// type acc_t:
+//
+//   acc_t identity() const;
+//   // folds n elements, stride elements apart, into acc. index is the
+//   // position of the first element in the reduced dimensions.
+//   acc_t reduce_run(acc_t acc, const scalar_t* data, int64_t n,
+//                    int64_t stride, int64_t index) const;
+//   // folds nrows rows of ncols elements into acc[0 .. ncols). Element
+//   // (row, col) is data[row * row_stride + col * col_stride] and has index
+//   // index + row.
+//   void reduce_rows(acc_t* acc, const scalar_t* data, int64_t ncols,
+//                    int64_t col_stride, int64_t nrows, int64_t row_stride,
+//                    int64_t index) const;
+//   // combines the results of two consecutive ranges, a's coming first
+//   acc_t combine(acc_t a, acc_t b) const;
+//   // writes the result of one output element
+//   void store(char** out, acc_t acc) const;
+//
+// Indices count the elements of the reduced dimensions in iteration order,
+// which is only meaningful when a single dimension is reduced.
+// ElementwiseReduceOps implements reduce_run and reduce_rows for ops that
+// fold one element at a time.
+
+#include "ATen/native/TensorIterator.h"
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace at { namespace native { namespace {
+
+// Elements of a run (for inner reductions) or rows (for outer reductions)
+// folded into one partial result before it is combined with the others
+constexpr int64_t REDUCE_CHUNK_ELEMENTS = 4096;
+constexpr int64_t REDUCE_CHUNK_ROWS = 128;
+// Adjacent outputs of an outer reduction that are reduced together
+constexpr int64_t REDUCE_COLUMNS = 256;
+
+template <typename scalar_t, typename acc_t, typename derived_t>
+struct ElementwiseReduceOps {
+  // derived_t provides acc_t reduce(acc_t acc, scalar_t value, int64_t index)
+  acc_t reduce_run(acc_t acc, const scalar_t* data, int64_t n, int64_t stride, int64_t index) const {
+    auto& self = static_cast<const derived_t&>(*this);
+    for (int64_t i = 0; i < n; i++) {
+      acc = self.reduce(acc, data[i * stride], index + i);
+    }
+    return acc;
+  }
+
+  void reduce_rows(acc_t* acc, const scalar_t* data, int64_t ncols, int64_t col_stride,
+                   int64_t nrows, int64_t row_stride, int64_t index) const {
+    auto& self = static_cast<const derived_t&>(*this);
+    for (int64_t row = 0; row < nrows; row++) {
+      const scalar_t* row_data = data + row * row_stride;
+      for (int64_t col = 0; col < ncols; col++) {
+        acc[col] = self.reduce(acc[col], row_data[col * col_stride], index + row);
+      }
+    }
+  }
+};
+
+// Combines the partial results of consecutive chunks pairwise. Level i holds
+// the combination of 2^i chunks, like the digits of a binary counter, so
+// every partial result takes part in a logarithmic number of combines.
+template <typename ops_t, typename acc_t>
+struct PairwiseAccumulator {
+  PairwiseAccumulator(const ops_t& ops, int64_t capacity)
+    : ops(ops), capacity(capacity), width(capacity) {}
+
+  // starts over with chunks of width <= capacity partial results
+  void reset(int64_t width) {
+    this->width = width;
+    std::fill(full.begin(), full.end(), false);
+  }
+
+  // chunk holds width partial results and is clobbered
+  void push(acc_t* chunk) {
+    size_t level = 0;
+    for (; level < full.size() && full[level]; level++) {
+      const acc_t* prev = &levels[level * capacity];
+      for (int64_t i = 0; i < width; i++) {
+        chunk[i] = ops.combine(prev[i], chunk[i]);
+      }
+      full[level] = false;
+    }
+    if (level == full.size()) {
+      full.push_back(false);
+      levels.resize(full.size() * capacity);
+    }
+    std::copy(chunk, chunk + width, &levels[level * capacity]);
+    full[level] = true;
+  }
+
+  // the combination of all chunks pushed since the last reset
+  void finish(acc_t* result) const {
+    std::fill(result, result + width, ops.identity());
+    // the highest level holds the earliest chunks
+    for (size_t level = full.size(); level-- > 0;) {
+      if (full[level]) {
+        const acc_t* partial = &levels[level * capacity];
+        for (int64_t i = 0; i < width; i++) {
+          result[i] = ops.combine(result[i], partial[i]);
+        }
+      }
+    }
+  }
+
+  const ops_t& ops;
+  int64_t capacity;
+  int64_t width;
+  std::vector<acc_t> levels;
+  std::vector<bool> full;
+};
+
+// Number of slices the reduced elements of each of ntiles tiles are split
+// into, so that reductions into fewer outputs than there are threads still
+// use all of them. Every slice has at least GRAIN_SIZE elements.
+inline int64_t reduce_slices(int64_t ntiles, int64_t nreduce, int64_t work_per_tile) {
+  int64_t max_threads = internal::get_intraop_num_threads();
+  if (ntiles >= max_threads || work_per_tile < 2 * internal::GRAIN_SIZE) {
+    return 1;
+  }
+  int64_t nslices = std::min(divup(max_threads, ntiles), work_per_tile / internal::GRAIN_SIZE);
+  return std::min(nslices, nreduce);
+}
+
+template <typename scalar_t, typename ops_t>
+struct ReduceLoop {
+  using acc_t = typename std::decay<decltype(std::declval<ops_t>().identity())>::type;
+
+  struct Dim {
+    int64_t size;
+    std::array<int64_t, TensorIterator::MAX_OPERANDS> strides;  // in bytes
+  };
+
+  ReduceLoop(const TensorIterator& iter, const ops_t& ops)
+    : ops(ops), ntensors(iter.ntensors()), noutputs(iter.noutputs()) {
+    for (int arg = 0; arg < ntensors; arg++) {
+      data[arg] = iter.data_ptr(arg);
+    }
+    auto get_dim = [&](int dim) {
+      Dim d;
+      d.size = iter.shape()[dim];
+      for (int arg = 0; arg < ntensors; arg++) {
+        d.strides[arg] = iter.stride(dim, arg);
+      }
+      return d;
+    };
+    auto is_reduced = [&](int dim) {
+      return iter.stride(dim, 0) == 0;
+    };
+    inner = get_dim(0);
+    inner_reduced = is_reduced(0);
+    for (int dim = 1; dim < iter.ndim(); dim++) {
+      (is_reduced(dim) ? reduced : kept).push_back(get_dim(dim));
+    }
+    if (reduced.empty()) {
+      reduced.push_back(Dim{1, {}});
+    }
+    nkept = 1;
+    for (auto& d : kept) {
+      nkept *= d.size;
+    }
+    int64_t nreduced_outer = 1;
+    for (auto& d : reduced) {
+      nreduced_outer *= d.size;
+    }
+    if (inner_reduced) {
+      ncols = 1;
+      col_block = 1;
+      nreduce = inner.size * nreduced_outer;
+    } else {
+      ncols = inner.size;
+      col_block = std::min(ncols, REDUCE_COLUMNS);
+      nreduce = nreduced_outer;
+    }
+    ntiles = col_block == 0 ? 0 : nkept * divup(ncols, col_block);
+  }
+
+  void run() const {
+    if (ntiles == 0) {
+      return;
+    }
+    int64_t work_per_tile = std::max<int64_t>(nreduce * col_block, 1);
+    int64_t nslices = reduce_slices(ntiles, nreduce, work_per_tile);
+    if (nslices == 1) {
+      int64_t grain = std::max<int64_t>(internal::GRAIN_SIZE / work_per_tile, 1);
+      parallel_for(0, ntiles, grain, [&](int64_t begin, int64_t end) {
+        std::vector<acc_t> acc(col_block), chunk(col_block);
+        PairwiseAccumulator<ops_t, acc_t> pairwise(ops, col_block);
+        for (int64_t tile = begin; tile < end; tile++) {
+          reduce_tile(tile, 0, nreduce, acc.data(), chunk.data(), pairwise);
+          store_tile(tile, acc.data());
+        }
+      });
+      return;
+    }
+    // one partial result per tile and slice of the reduced dimensions
+    std::vector<acc_t> partial(ntiles * nslices * col_block);
+    int64_t slice_size = divup(nreduce, nslices);
+    parallel_for(0, ntiles * nslices, 1, [&](int64_t begin, int64_t end) {
+      std::vector<acc_t> chunk(col_block);
+      PairwiseAccumulator<ops_t, acc_t> pairwise(ops, col_block);
+      for (int64_t i = begin; i < end; i++) {
+        int64_t slice_begin = std::min((i % nslices) * slice_size, nreduce);
+        int64_t slice_end = std::min(slice_begin + slice_size, nreduce);
+        reduce_tile(i / nslices, slice_begin, slice_end, &partial[i * col_block],
+                    chunk.data(), pairwise);
+      }
+    });
+    for (int64_t tile = 0; tile < ntiles; tile++) {
+      acc_t* acc = &partial[tile * nslices * col_block];
+      for (int64_t slice = 1; slice < nslices; slice++) {
+        const acc_t* other = &partial[(tile * nslices + slice) * col_block];
+        for (int64_t col = 0; col < tile_width(tile); col++) {
+          acc[col] = ops.combine(acc[col], other[col]);
+        }
+      }
+      store_tile(tile, acc);
+    }
+  }
+
+  // Offset of operand arg at the kept position of a tile
+  int64_t kept_offset(int64_t tile, int arg) const {
+    int64_t index = tile / divup(ncols, col_block);
+    int64_t offset = 0;
+    for (auto& d : kept) {
+      offset += (index % d.size) * d.strides[arg];
+      index /= d.size;
+    }
+    return offset;
+  }
+
+  int64_t first_col(int64_t tile) const {
+    return (tile % divup(ncols, col_block)) * col_block;
+  }
+
+  int64_t tile_width(int64_t tile) const {
+    return std::min(col_block, ncols - first_col(tile));
+  }
+
+  // Folds the elements [begin, end) of the reduction into acc, which has an
+  // entry for every output of the tile.
+  void reduce_tile(int64_t tile, int64_t begin, int64_t end, acc_t* acc, acc_t* chunk,
+                   PairwiseAccumulator<ops_t, acc_t>& pairwise) const {
+    int in = noutputs;
+    int64_t width = tile_width(tile);
+    const char* base = data[in] + kept_offset(tile, in) + first_col(tile) * inner.strides[in];
+    pairwise.reset(width);
+
+    // position in the outer reduced dimensions
+    int64_t outer_begin = inner_reduced ? begin / inner.size : begin;
+    std::vector<int64_t> counter(reduced.size());
+    int64_t offset = 0;
+    int64_t index = outer_begin;
+    for (size_t dim = 0; dim < reduced.size(); dim++) {
+      counter[dim] = index % reduced[dim].size;
+      index /= reduced[dim].size;
+      offset += counter[dim] * reduced[dim].strides[in];
+    }
+    auto advance = [&](int64_t steps) {
+      counter[0] += steps;
+      offset += steps * reduced[0].strides[in];
+      for (size_t dim = 0; dim + 1 < reduced.size() && counter[dim] == reduced[dim].size; dim++) {
+        offset -= counter[dim] * reduced[dim].strides[in];
+        counter[dim] = 0;
+        counter[dim + 1]++;
+        offset += reduced[dim + 1].strides[in];
+      }
+    };
+
+    std::fill(chunk, chunk + width, ops.identity());
+    int64_t chunk_count = 0;
+    if (inner_reduced) {
+      int64_t stride = inner.strides[in] / sizeof(scalar_t);
+      int64_t k = begin % inner.size;
+      for (int64_t pos = begin; pos < end;) {
+        int64_t n = std::min({inner.size - k, end - pos, REDUCE_CHUNK_ELEMENTS - chunk_count});
+        auto ptr = reinterpret_cast<const scalar_t*>(base + offset + k * inner.strides[in]);
+        chunk[0] = ops.reduce_run(chunk[0], ptr, n, stride, pos);
+        pos += n;
+        k += n;
+        chunk_count += n;
+        if (chunk_count == REDUCE_CHUNK_ELEMENTS) {
+          pairwise.push(chunk);
+          chunk[0] = ops.identity();
+          chunk_count = 0;
+        }
+        if (k == inner.size && pos < end) {
+          k = 0;
+          advance(1);
+        }
+      }
+    } else {
+      int64_t col_stride = inner.strides[in] / sizeof(scalar_t);
+      int64_t row_stride = reduced[0].strides[in] / sizeof(scalar_t);
+      for (int64_t pos = begin; pos < end;) {
+        int64_t nrows = std::min({reduced[0].size - counter[0], end - pos,
+                                  REDUCE_CHUNK_ROWS - chunk_count});
+        auto ptr = reinterpret_cast<const scalar_t*>(base + offset);
+        ops.reduce_rows(chunk, ptr, width, col_stride, nrows, row_stride, pos);
+        pos += nrows;
+        chunk_count += nrows;
+        if (chunk_count == REDUCE_CHUNK_ROWS) {
+          pairwise.push(chunk);
+          std::fill(chunk, chunk + width, ops.identity());
+          chunk_count = 0;
+        }
+        if (pos < end) {
+          advance(nrows);
+        }
+      }
+    }
+    if (chunk_count > 0) {
+      pairwise.push(chunk);
+    }
+    pairwise.finish(acc);
+  }
+
+  void store_tile(int64_t tile, const acc_t* acc) const {
+    std::array<char*, TensorIterator::MAX_OPERANDS> base;
+    std::array<char*, TensorIterator::MAX_OPERANDS> ptrs;
+    int64_t col0 = first_col(tile);
+    for (int arg = 0; arg < noutputs; arg++) {
+      base[arg] = data[arg] + kept_offset(tile, arg) + col0 * inner.strides[arg];
+    }
+    int64_t width = tile_width(tile);
+    for (int64_t col = 0; col < width; col++) {
+      for (int arg = 0; arg < noutputs; arg++) {
+        ptrs[arg] = base[arg] + col * inner.strides[arg];
+      }
+      ops.store(ptrs.data(), acc[col]);
+    }
+  }
+
+  const ops_t& ops;
+  int ntensors;
+  int noutputs;
+  std::array<char*, TensorIterator::MAX_OPERANDS> data;
+  Dim inner;
+  bool inner_reduced;
+  // the other dimensions, innermost first
+  std::vector<Dim> kept;
+  std::vector<Dim> reduced;
+  // number of positions in the kept dimensions other than the innermost
+  int64_t nkept;
+  // outputs along the innermost dimension, and how many of them a tile has
+  int64_t ncols;
+  int64_t col_block;
+  int64_t ntiles;
+  // elements (inner reductions) or rows (outer reductions) reduced per tile
+  int64_t nreduce;
+};
+
+// Reduces the input of iter (a TensorIterator built by reduce_op, whose input
+// has type scalar_t) into its outputs.
+template <typename scalar_t, typename ops_t>
+void reduce_kernel(const TensorIterator& iter, const ops_t& ops) {
+  ReduceLoop<scalar_t, ops_t>(iter, ops).run();
+}
+
+}}} // namespace at::native::<anonymous>
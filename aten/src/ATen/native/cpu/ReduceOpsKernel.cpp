@@ -1,185 +1,366 @@
 #include "ATen/native/cpu/ReduceOpsKernel.h"
 
-#include <numeric>
-#include <iterator>
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
 
+#include "ATen/AccumulateType.h"
 #include "ATen/Dispatch.h"
-#include "ATen/Parallel.h"
-#include "ATen/cpu/vec256/vec256.h"
-#include "ATen/optional.h"
+#include "ATen/cpu/vec.h"
+#include "ATen/native/cpu/Reduce.h"
 
 namespace at { namespace native { namespace {
 
-using namespace vec256;
+using namespace vec;
 
-static inline int64_t round_down(int64_t a, int64_t m) {
-  return a - (a % m);
-}
+struct AbsMap {
+  template <typename T> T operator()(T x) const { return std::abs(x); }
+};
+
+struct SquareMap {
+  template <typename T> T operator()(T x) const { return x * x; }
+};
+
+// Reduces with the associative and commutative Op, which is applied to both
+// scalar_t and Vectorized<scalar_t>. Contiguous runs are reduced into four
+// vectors at a time, and contiguous rows into up to four vectors of adjacent
+// outputs, which stay in registers until all rows are done.
+template <typename scalar_t, template <class> class Op>
+struct VecReduceOps {
+  using Vec = Vectorized<scalar_t>;
+
+  VecReduceOps(scalar_t ident) : ident(ident) {}
+
+  scalar_t identity() const { return ident; }
 
-template <typename F>
-static void _parallel_for(int64_t size, int64_t step, bool parallelize, F func) {
-  if (parallelize) {
-    parallel_for(0, size / step, 1, [func, step](int64_t begin, int64_t end) {
-      int64_t k = begin * step;
-      for (int64_t i = begin; i < end; i++, k += step) {
-        func(k);
+  scalar_t combine(scalar_t a, scalar_t b) const { return Op<scalar_t>()(a, b); }
+
+  scalar_t reduce_run(scalar_t acc, const scalar_t* data, int64_t n, int64_t stride, int64_t) const {
+    int64_t i = 0;
+    if (stride == 1 && n >= 4 * Vec::size) {
+      Vec acc_vec[4] = {Vec(ident), Vec(ident), Vec(ident), Vec(ident)};
+      for (; i <= n - 4 * Vec::size; i += 4 * Vec::size) {
+        for (int j = 0; j != 4; j++) {
+          acc_vec[j] = Op<Vec>()(acc_vec[j], Vec::loadu(data + i + j * Vec::size));
+        }
       }
-    });
-  } else {
-    for (int64_t i = 0; i != size; i += step) {
-      func(i);
+      acc_vec[0] = Op<Vec>()(Op<Vec>()(acc_vec[0], acc_vec[1]), Op<Vec>()(acc_vec[2], acc_vec[3]));
+      scalar_t buf[Vec::size];
+      acc_vec[0].store(buf);
+      for (int j = 0; j != Vec::size; j++) {
+        acc = combine(acc, buf[j]);
+      }
+    }
+    for (; i < n; i++) {
+      acc = combine(acc, data[i * stride]);
     }
+    return acc;
   }
-}
 
-// Vectorized reduction defined by reduce operation `Op` with identity `ident`.
-// The reduction is built on top of reduce128, which reduces down a column
-// 128 bytes wide (WIDTH scalar elements). The width of 128 bytes is chosen
-// because of the "adjacent cache line prefetch" behavior on x86 CPUs.
-template<typename scalar_t, template <class> class Op, int ident>
-struct Reduction {
-  // reduction width in number of scalar elements
-  static constexpr int WIDTH = 128 / sizeof(scalar_t);
-
-  using Vec = Vec256<scalar_t>;
-  using Reduce = Op<Vec>;
-  using ReduceScalar = Op<scalar_t>;
-
-  static void apply(Tensor& res, const Tensor& self, at::optional<int64_t> dim) {
-    auto out_ = res.data<scalar_t>();
-    auto data_ = self.data<scalar_t>();
-    auto numel = self.numel();
-    if (!dim.has_value()) {
-      *out_ = reduce_all(data_, numel);
-      return;
-    }
-
-    int64_t n = self.size(*dim);
-    int64_t stride = self.stride(*dim);
-    // A contiguous tensor does not need to hold a meaningful stride
-    // if the corresponding size is 1
-    if (n == 1) {
-      stride = 1;
-      for (int64_t i = self.ndimension() - 1; i > *dim; i--) {
-        stride *= self.size(i);
+  void reduce_rows(scalar_t* acc, const scalar_t* data, int64_t ncols, int64_t col_stride,
+                   int64_t nrows, int64_t row_stride, int64_t) const {
+    int64_t col = 0;
+    if (col_stride == 1) {
+      for (; col <= ncols - 4 * Vec::size; col += 4 * Vec::size) {
+        reduce_rows_vec<4>(acc + col, data + col, nrows, row_stride);
+      }
+      for (; col <= ncols - Vec::size; col += Vec::size) {
+        reduce_rows_vec<1>(acc + col, data + col, nrows, row_stride);
       }
     }
-    int64_t batch = numel / (n * stride);
-    bool paralellize = batch * n > internal::GRAIN_SIZE;
-    if (stride == 1) {
-      parallel_for(0, batch, 1, [=](int64_t begin, int64_t end) {
-        for (int64_t b = begin; b < end; b++) {
-          const scalar_t* data = &data_[b * n];
-          scalar_t* out = &out_[b];
-          scalar_t buf[WIDTH] = {0};
-          std::fill(buf, buf + WIDTH, ident);
-          int64_t cols_rounded = n / WIDTH;
-          reduce128(data, buf, cols_rounded, WIDTH);
-          scalar_t result = ident;
-          for (int64_t i = 0; i < WIDTH; i++) {
-            result = ReduceScalar()(result, buf[i]);
-          }
-          for (int64_t col = cols_rounded * WIDTH; col != n; col++) {
-            result = ReduceScalar()(result, data[col]);
-          }
-          out_[b] = result;
-        }
-      });
-    } else {
-      int64_t rows = n;
-      int64_t cols = stride;
-      int64_t cols_rounded = round_down(cols, WIDTH);
-      int64_t size = cols_rounded;
-      parallel_for(
-          0,
-          batch * (size / WIDTH),
-          1,
-          [out_, data_, n, stride, rows, cols, cols_rounded, size](
-              int64_t begin, int64_t end) {
-            for (int64_t bi = begin; bi < end; bi++) {
-              int64_t b = bi / (size / WIDTH);
-              int64_t i = bi % (size / WIDTH);
-              int64_t k = i * WIDTH;
-              reduce128(
-                  &data_[b * n * stride + k],
-                  &out_[b * stride + k],
-                  rows,
-                  stride);
-            }
-          });
-
-      _parallel_for(batch, 1, paralellize, [=](int64_t b) {
-        const scalar_t* data = &data_[b * n * stride];
-        scalar_t* out = &out_[b * stride];
-        int64_t rows = n;
-        int64_t cols = stride;
-
-        int64_t cols_rounded = round_down(cols, WIDTH);
-        if (cols_rounded != cols) {
-          scalar_t buf[WIDTH] = {0};
-          std::fill(buf, buf + WIDTH, ident);
-          for (int64_t row = 0; row != rows; row++) {
-            for (int64_t j = 0; j != cols - cols_rounded; j++) {
-              auto val = data[row * stride + j + cols_rounded];
-              buf[j] = ReduceScalar()(buf[j], val);
-            }
-          }
-          for (int64_t j = 0; j != cols - cols_rounded; j++) {
-            out[j + cols_rounded] = buf[j];
-          }
+    for (int64_t row = 0; row < nrows; row++) {
+      const scalar_t* row_data = data + row * row_stride;
+      for (int64_t j = col; j < ncols; j++) {
+        acc[j] = combine(acc[j], row_data[j * col_stride]);
+      }
+    }
+  }
+
+  template <int nvec>
+  void reduce_rows_vec(scalar_t* acc, const scalar_t* data, int64_t nrows, int64_t row_stride) const {
+    Vec acc_vec[nvec];
+    for (int j = 0; j != nvec; j++) {
+      acc_vec[j] = Vec::loadu(acc + j * Vec::size);
+    }
+    for (int64_t row = 0; row < nrows; row++) {
+      for (int j = 0; j != nvec; j++) {
+        acc_vec[j] = Op<Vec>()(acc_vec[j], Vec::loadu(data + row * row_stride + j * Vec::size));
+      }
+    }
+    for (int j = 0; j != nvec; j++) {
+      acc_vec[j].store(acc + j * Vec::size);
+    }
+  }
+
+  void store(char** out, scalar_t acc) const {
+    *(scalar_t*)out[0] = acc;
+  }
+
+  scalar_t ident;
+};
+
+// The 1- and 2-norms, which sum map(x) in acc_type like TH's norm, so that
+// squares of large floats do not overflow. Contiguous runs are summed into
+// one partial sum per vector lane; those are independent, so the compiler
+// vectorizes the loop without reassociating any additions.
+template <typename scalar_t, typename map_t>
+struct SumNormOps {
+  using acc_t = acc_type<scalar_t, false>;
+
+  SumNormOps(bool take_sqrt) : take_sqrt(take_sqrt) {}
+
+  acc_t identity() const { return 0; }
+
+  acc_t combine(acc_t a, acc_t b) const { return a + b; }
+
+  acc_t reduce_run(acc_t acc, const scalar_t* data, int64_t n, int64_t stride, int64_t) const {
+    constexpr int lanes = Vectorized<scalar_t>::size;
+    int64_t i = 0;
+    if (stride == 1 && n >= lanes) {
+      acc_t partial[lanes] = {};
+      for (; i <= n - lanes; i += lanes) {
+        for (int j = 0; j != lanes; j++) {
+          partial[j] += map(static_cast<acc_t>(data[i + j]));
         }
-      });
+      }
+      for (int j = 0; j != lanes; j++) {
+        acc += partial[j];
+      }
+    }
+    for (; i < n; i++) {
+      acc += map(static_cast<acc_t>(data[i * stride]));
+    }
+    return acc;
+  }
+
+  void reduce_rows(acc_t* acc, const scalar_t* data, int64_t ncols, int64_t col_stride,
+                   int64_t nrows, int64_t row_stride, int64_t) const {
+    for (int64_t row = 0; row < nrows; row++) {
+      const scalar_t* row_data = data + row * row_stride;
+      for (int64_t col = 0; col < ncols; col++) {
+        acc[col] += map(static_cast<acc_t>(row_data[col * col_stride]));
+      }
     }
   }
 
-  static scalar_t reduce_all(const scalar_t* data, int64_t size) {
-    int64_t k = size / WIDTH;
+  void store(char** out, acc_t acc) const {
+    *(scalar_t*)out[0] = static_cast<scalar_t>(take_sqrt ? std::sqrt(acc) : acc);
+  }
+
+  map_t map;
+  bool take_sqrt;
+};
+
+// Norms other than 1 and 2, accumulated in acc_type like TH's norm.
+template <typename scalar_t>
+struct NormOps : ElementwiseReduceOps<scalar_t, acc_type<scalar_t, false>, NormOps<scalar_t>> {
+  using acc_t = acc_type<scalar_t, false>;
 
-    scalar_t sum = parallel_reduce(
-        0,
-        k,
-        internal::GRAIN_SIZE / WIDTH,
-        (scalar_t)ident,
-        [data](int64_t begin, int64_t end, scalar_t init) {
-          scalar_t buf[WIDTH];
-          reduce128(&data[begin * WIDTH], buf, end - begin, WIDTH);
-          return std::accumulate(buf, buf + WIDTH, init, ReduceScalar());
-        },
-        ReduceScalar());
+  NormOps(acc_t p) : p(p) {}
 
-    for (int64_t i = k * WIDTH; i != size; i++) {
-      sum = ReduceScalar()(sum, data[i]);
+  acc_t identity() const { return 0; }
+
+  acc_t reduce(acc_t acc, scalar_t x, int64_t) const {
+    if (p == 0) {
+      return acc + (x != 0);
+    }
+    acc_t abs_x = std::abs(static_cast<acc_t>(x));
+    if (p == INFINITY) {
+      return acc > abs_x ? acc : abs_x;
     }
-    return sum;
+    return acc + std::pow(abs_x, p);
   }
 
-  // Reduce down a column of WIDTH elements (128 bytes) with the given number
-  // of rows. Stores the results in out[0 ... WIDTH-1].
-  static void reduce128(const scalar_t* data, scalar_t* out, int64_t rows, int64_t stride) {
-    Vec acc[4] = {ident, ident, ident, ident};  // 128 bytes (two cache lines)
-    static_assert(sizeof(acc) == 128, "accumulator should be 128 bytes");
-    for (int64_t row = 0; row != rows; row++) {
-      for (int j = 0; j != 4; j++) {
-        auto val = Vec::loadu(&data[row * stride + j * Vec::size]);
-        acc[j] = Reduce()(acc[j], val);
+  acc_t combine(acc_t a, acc_t b) const {
+    if (p == INFINITY) {
+      return a > b ? a : b;
+    }
+    return a + b;
+  }
+
+  void store(char** out, acc_t acc) const {
+    if (p != 0 && p != INFINITY) {
+      acc = std::pow(acc, 1 / p);
+    }
+    *(scalar_t*)out[0] = static_cast<scalar_t>(acc);
+  }
+
+  acc_t p;
+};
+
+template <typename acc_t>
+struct WelfordData {
+  acc_t mean;
+  acc_t m2;
+  int64_t n;
+};
+
+// Variance with the mean and sum of squared deviations of every run (or
+// chunk of rows) computed in two passes over the data, and combined with
+// those of the others using Chan et al.'s formula.
+template <typename scalar_t>
+struct WelfordOps {
+  using acc_t = acc_type<scalar_t, false>;
+  using data_t = WelfordData<acc_t>;
+
+  WelfordOps(bool unbiased, bool take_sqrt) : unbiased(unbiased), take_sqrt(take_sqrt) {}
+
+  data_t identity() const { return {0, 0, 0}; }
+
+  data_t combine(data_t a, data_t b) const {
+    if (a.n == 0) {
+      return b;
+    } else if (b.n == 0) {
+      return a;
+    }
+    int64_t n = a.n + b.n;
+    acc_t delta = b.mean - a.mean;
+    acc_t b_weight = static_cast<acc_t>(b.n) / n;
+    return {a.mean + delta * b_weight, a.m2 + b.m2 + delta * delta * a.n * b_weight, n};
+  }
+
+  data_t reduce_run(data_t acc, const scalar_t* data, int64_t n, int64_t stride, int64_t) const {
+    acc_t sum = 0;
+    for (int64_t i = 0; i < n; i++) {
+      sum += data[i * stride];
+    }
+    acc_t mean = sum / n;
+    acc_t m2 = 0;
+    for (int64_t i = 0; i < n; i++) {
+      acc_t delta = data[i * stride] - mean;
+      m2 += delta * delta;
+    }
+    return combine(acc, {mean, m2, n});
+  }
+
+  void reduce_rows(data_t* acc, const scalar_t* data, int64_t ncols, int64_t col_stride,
+                   int64_t nrows, int64_t row_stride, int64_t) const {
+    acc_t sum[REDUCE_COLUMNS];
+    acc_t m2[REDUCE_COLUMNS];
+    std::fill(sum, sum + ncols, 0);
+    std::fill(m2, m2 + ncols, 0);
+    for (int64_t row = 0; row < nrows; row++) {
+      const scalar_t* row_data = data + row * row_stride;
+      for (int64_t col = 0; col < ncols; col++) {
+        sum[col] += row_data[col * col_stride];
       }
     }
-    for (int j = 0; j != 4; j++) {
-      acc[j].store(&out[j * Vec::size]);
+    // sum now holds the means
+    for (int64_t col = 0; col < ncols; col++) {
+      sum[col] /= nrows;
+    }
+    for (int64_t row = 0; row < nrows; row++) {
+      const scalar_t* row_data = data + row * row_stride;
+      for (int64_t col = 0; col < ncols; col++) {
+        acc_t delta = row_data[col * col_stride] - sum[col];
+        m2[col] += delta * delta;
+      }
+    }
+    for (int64_t col = 0; col < ncols; col++) {
+      acc[col] = combine(acc[col], {sum[col], m2[col], nrows});
+    }
+  }
+
+  void store(char** out, data_t acc) const {
+    int64_t divisor = unbiased ? acc.n - 1 : acc.n;
+    acc_t var = divisor > 0 ? acc.m2 / divisor : std::numeric_limits<acc_t>::quiet_NaN();
+    *(scalar_t*)out[0] = static_cast<scalar_t>(take_sqrt ? std::sqrt(var) : var);
+  }
+
+  bool unbiased;
+  bool take_sqrt;
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type _isnan(T) {
+  return false;
+}
+
+template <typename T>
+inline typename std::enable_if<!std::is_integral<T>::value, bool>::type _isnan(T x) {
+  return std::isnan(x);
+}
+
+template <typename scalar_t>
+struct ValueIndex {
+  scalar_t value;
+  int64_t index;  // -1 if no element has been seen
+};
+
+// max or min and its index. Like TH, the first NaN wins over everything
+// else, and the first of several equal values wins.
+template <typename scalar_t, bool is_max>
+struct ArgReduceOps : ElementwiseReduceOps<scalar_t, ValueIndex<scalar_t>, ArgReduceOps<scalar_t, is_max>> {
+  using acc_t = ValueIndex<scalar_t>;
+
+  ArgReduceOps(bool with_index) : with_index(with_index) {}
+
+  acc_t identity() const { return {0, -1}; }
+
+  acc_t reduce(acc_t acc, scalar_t x, int64_t index) const {
+    bool better = is_max ? x > acc.value : x < acc.value;
+    if (acc.index < 0 || (!_isnan(acc.value) && (better || _isnan(x)))) {
+      return {x, index};
+    }
+    return acc;
+  }
+
+  acc_t combine(acc_t a, acc_t b) const {
+    return b.index < 0 ? a : reduce(a, b.value, b.index);
+  }
+
+  void store(char** out, acc_t acc) const {
+    *(scalar_t*)out[0] = acc.value;
+    if (with_index) {
+      *(int64_t*)out[1] = acc.index;
     }
   }
+
+  bool with_index;
 };
 
-static void sum_kernel_impl(Tensor& result, const Tensor& self, at::optional<int64_t> dim) {
-  AT_DISPATCH_ALL_TYPES(self.type(), "sum", [&] {
-    Reduction<scalar_t, std::plus, 0>::apply(result, self, dim);
+static void sum_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.type(), "sum", [&] {
+    reduce_kernel<scalar_t>(iter, VecReduceOps<scalar_t, std::plus>(0));
+  });
+}
+
+static void prod_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.type(), "prod", [&] {
+    reduce_kernel<scalar_t>(iter, VecReduceOps<scalar_t, std::multiplies>(1));
+  });
+}
+
+static void norm_kernel_impl(TensorIterator& iter, Scalar p_scalar) {
+  AT_DISPATCH_FLOATING_TYPES(iter.type(), "norm", [&] {
+    auto p = p_scalar.to<acc_type<scalar_t, false>>();
+    if (p == 1) {
+      reduce_kernel<scalar_t>(iter, SumNormOps<scalar_t, AbsMap>(/*take_sqrt=*/false));
+    } else if (p == 2) {
+      reduce_kernel<scalar_t>(iter, SumNormOps<scalar_t, SquareMap>(/*take_sqrt=*/true));
+    } else {
+      reduce_kernel<scalar_t>(iter, NormOps<scalar_t>(p));
+    }
+  });
+}
+
+static void std_var_kernel_impl(TensorIterator& iter, bool unbiased, bool take_sqrt) {
+  AT_DISPATCH_FLOATING_TYPES(iter.type(), "std_var", [&] {
+    reduce_kernel<scalar_t>(iter, WelfordOps<scalar_t>(unbiased, take_sqrt));
+  });
+}
+
+static void max_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.type(), "max", [&] {
+    reduce_kernel<scalar_t>(iter, ArgReduceOps<scalar_t, true>(iter.noutputs() == 2));
   });
 }
 
-static void prod_kernel_impl(Tensor& result, const Tensor& self, at::optional<int64_t> dim) {
-  AT_DISPATCH_ALL_TYPES(self.type(), "prod", [&] {
-    Reduction<scalar_t, std::multiplies, 1>::apply(result, self, dim);
+static void min_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.type(), "min", [&] {
+    reduce_kernel<scalar_t>(iter, ArgReduceOps<scalar_t, false>(iter.noutputs() == 2));
   });
 }
 
@@ -187,5 +368,9 @@ static void prod_kernel_impl(Tensor& result, const Tensor& self, at::optional<in
 
 REGISTER_DISPATCH(sum_kernel, &sum_kernel_impl);
 REGISTER_DISPATCH(prod_kernel, &prod_kernel_impl);
+REGISTER_DISPATCH(norm_kernel, &norm_kernel_impl);
+REGISTER_DISPATCH(std_var_kernel, &std_var_kernel_impl);
+REGISTER_DISPATCH(max_kernel, &max_kernel_impl);
+REGISTER_DISPATCH(min_kernel, &min_kernel_impl);
 
 }}  // namespace at::native
@@ -1,16 +1,25 @@
 #pragma once
 
 #include <ATen/ATen.h>
-#include <ATen/optional.h>
+#include "ATen/native/TensorIterator.h"
 #include "CapabilityDispatch.h"
 
 namespace at {
 namespace native {
 
-using reduce_fn = void(*)(Tensor &, const Tensor &, at::optional<int64_t>);
+// All kernels take a TensorIterator built by TensorIterator::reduce_op.
+using reduce_fn = void(*)(TensorIterator&);
+using norm_fn = void(*)(TensorIterator&, Scalar p);
+using std_var_fn = void(*)(TensorIterator&, bool unbiased, bool take_sqrt);
 
 extern DispatchStub<reduce_fn> sum_kernel;
 extern DispatchStub<reduce_fn> prod_kernel;
+// floating point types only
+extern DispatchStub<norm_fn> norm_kernel;
+extern DispatchStub<std_var_fn> std_var_kernel;
+// also writes the (Long) indices of the values if iter has two outputs
+extern DispatchStub<reduce_fn> max_kernel;
+extern DispatchStub<reduce_fn> min_kernel;
 
 }
 }
@@ -0,0 +1,168 @@
+#include "ATen/native/cpu/SmallGemmKernel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec.h"
+
+// Every matrix of the batch is multiplied by one thread. The result is
+// computed in blocks of kRows rows and one or two vectors of columns, which
+// stay in registers while the k products are accumulated into them, so
+// every element of the result is loaded and stored once. The rows of batch2
+// are read with vector loads; when they are not contiguous or their length
+// is not a multiple of the vector size, the matrix is first copied into a
+// zero-padded buffer. The loop over k is unrolled at compile time for the
+// common sizes 8, 16, 32 and 64.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec;
+
+// rows of a block of the result
+constexpr int64_t kRows = 4;
+
+template <typename scalar_t>
+struct Matrix {
+  const scalar_t* data;
+  int64_t row_stride;
+  int64_t col_stride;
+};
+
+// Computes rows [i, i + ROWS) and columns [j, j + VECS * Vec::size) of
+// c = beta * c + alpha * a * b, where the rows of b are contiguous and padded
+// to a multiple of the vector size, and only the first n - j columns of the
+// block are stored. K is the length of the products, or 0 if it is only
+// known at runtime.
+template <typename scalar_t, int64_t ROWS, int64_t VECS, int64_t K>
+void gemm_block(
+    int64_t i, int64_t j, int64_t n, int64_t k,
+    const Matrix<scalar_t>& a, const scalar_t* b, int64_t ldb,
+    scalar_t* c, scalar_t beta, scalar_t alpha) {
+  using Vec = Vectorized<scalar_t>;
+  Vec acc[ROWS][VECS];
+  for (int64_t r = 0; r < ROWS; r++) {
+    for (int64_t v = 0; v < VECS; v++) {
+      acc[r][v] = Vec(scalar_t(0));
+    }
+  }
+  const int64_t length = K > 0 ? K : k;
+  for (int64_t p = 0; p < length; p++) {
+    Vec b_vec[VECS];
+    for (int64_t v = 0; v < VECS; v++) {
+      b_vec[v] = Vec::loadu(b + p * ldb + j + v * Vec::size);
+    }
+    for (int64_t r = 0; r < ROWS; r++) {
+      Vec a_vec(a.data[(i + r) * a.row_stride + p * a.col_stride]);
+      for (int64_t v = 0; v < VECS; v++) {
+        acc[r][v] = acc[r][v] + a_vec * b_vec[v];
+      }
+    }
+  }
+  Vec alpha_vec(alpha);
+  Vec beta_vec(beta);
+  for (int64_t r = 0; r < ROWS; r++) {
+    scalar_t* c_row = c + (i + r) * n + j;
+    for (int64_t v = 0; v < VECS; v++) {
+      int64_t count = std::min<int64_t>(Vec::size, n - j - v * Vec::size);
+      if (count <= 0) {
+        break;
+      }
+      Vec out = acc[r][v] * alpha_vec;
+      if (beta != scalar_t(0)) {
+        out = out + Vec::loadu(c_row + v * Vec::size, count) * beta_vec;
+      }
+      out.store(c_row + v * Vec::size, count);
+    }
+  }
+}
+
+template <typename scalar_t, int64_t ROWS, int64_t K>
+void gemm_rows(
+    int64_t i, int64_t n, int64_t n_padded, int64_t k,
+    const Matrix<scalar_t>& a, const scalar_t* b, int64_t ldb,
+    scalar_t* c, scalar_t beta, scalar_t alpha) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t j = 0;
+  for (; j + 2 * Vec::size <= n_padded; j += 2 * Vec::size) {
+    gemm_block<scalar_t, ROWS, 2, K>(i, j, n, k, a, b, ldb, c, beta, alpha);
+  }
+  if (j < n_padded) {
+    gemm_block<scalar_t, ROWS, 1, K>(i, j, n, k, a, b, ldb, c, beta, alpha);
+  }
+}
+
+template <typename scalar_t, int64_t K>
+void gemm(
+    int64_t m, int64_t n, int64_t n_padded, int64_t k,
+    const Matrix<scalar_t>& a, const scalar_t* b, int64_t ldb,
+    scalar_t* c, scalar_t beta, scalar_t alpha) {
+  int64_t i = 0;
+  for (; i + kRows <= m; i += kRows) {
+    gemm_rows<scalar_t, kRows, K>(i, n, n_padded, k, a, b, ldb, c, beta, alpha);
+  }
+  switch (m - i) {
+    case 3: gemm_rows<scalar_t, 3, K>(i, n, n_padded, k, a, b, ldb, c, beta, alpha); break;
+    case 2: gemm_rows<scalar_t, 2, K>(i, n, n_padded, k, a, b, ldb, c, beta, alpha); break;
+    case 1: gemm_rows<scalar_t, 1, K>(i, n, n_padded, k, a, b, ldb, c, beta, alpha); break;
+  }
+}
+
+template <typename scalar_t>
+void small_gemm(
+    Tensor& result, const Tensor& batch1, const Tensor& batch2,
+    scalar_t beta, scalar_t alpha) {
+  using Vec = Vectorized<scalar_t>;
+  int64_t batch = result.size(0);
+  int64_t m = result.size(1);
+  int64_t n = result.size(2);
+  int64_t k = batch1.size(2);
+  int64_t n_padded = divup(n, Vec::size) * Vec::size;
+  bool pack = batch2.stride(2) != 1 || n_padded != n;
+
+  scalar_t* result_data = result.data<scalar_t>();
+  const scalar_t* batch1_data = batch1.data<scalar_t>();
+  const scalar_t* batch2_data = batch2.data<scalar_t>();
+  auto gemm_fn = gemm<scalar_t, 0>;
+  switch (k) {
+    case 8: gemm_fn = gemm<scalar_t, 8>; break;
+    case 16: gemm_fn = gemm<scalar_t, 16>; break;
+    case 32: gemm_fn = gemm<scalar_t, 32>; break;
+    case 64: gemm_fn = gemm<scalar_t, 64>; break;
+  }
+
+  parallel_for(0, batch, divup(internal::GRAIN_SIZE, m * n * k), [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> packed(pack ? k * n_padded : 0, scalar_t(0));
+    for (int64_t bi = begin; bi < end; bi++) {
+      Matrix<scalar_t> a = {batch1_data + bi * batch1.stride(0), batch1.stride(1), batch1.stride(2)};
+      const scalar_t* b = batch2_data + bi * batch2.stride(0);
+      int64_t ldb = batch2.stride(1);
+      if (pack) {
+        for (int64_t p = 0; p < k; p++) {
+          for (int64_t j = 0; j < n; j++) {
+            packed[p * n_padded + j] = b[p * batch2.stride(1) + j * batch2.stride(2)];
+          }
+        }
+        b = packed.data();
+        ldb = n_padded;
+      }
+      gemm_fn(m, n, n_padded, k, a, b, ldb, result_data + bi * m * n, beta, alpha);
+    }
+  });
+}
+
+static void small_gemm_kernel_impl(
+    Tensor& result, const Tensor& batch1, const Tensor& batch2,
+    Scalar beta, Scalar alpha) {
+  AT_DISPATCH_FLOATING_TYPES(result.type(), "small_gemm", [&] {
+    small_gemm<scalar_t>(result, batch1, batch2, beta.to<scalar_t>(), alpha.to<scalar_t>());
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(small_gemm_kernel, &small_gemm_kernel_impl);
+
+}} // namespace at::native
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// result[b] = beta * result[b] + alpha * batch1[b] * batch2[b] for every
+// matrix b of a batch of small float or double matrices (see
+// kSmallGemmMaxSize). result is a contiguous (batch, m, n) tensor and is not
+// read if beta is 0; batch1 (batch, m, k) and batch2 (batch, k, n) may have
+// any strides.
+using small_gemm_fn = void(*)(
+    Tensor& result, const Tensor& batch1, const Tensor& batch2,
+    Scalar beta, Scalar alpha);
+
+extern DispatchStub<small_gemm_fn> small_gemm_kernel;
+
+// The largest m, k and n for which bmm and baddbmm use small_gemm_kernel
+// rather than one BLAS call per matrix.
+constexpr int64_t kSmallGemmMaxSize = 64;
+
+}
+}
@@ -6,8 +6,7 @@
 
 #include "ATen/Dispatch.h"
 #include "ATen/Parallel.h"
-#include "ATen/cpu/vec256/functional.h"
-#include "ATen/cpu/vec256/vec256.h"
+#include "ATen/cpu/vec.h"
 #include "ATen/optional.h"
 
 // [Note AVX-SSE transitions] In general we avoid calls into cmath for code
@@ -28,7 +27,7 @@ inline void _vec_log_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -48,8 +47,8 @@ inline void _vec_log_softmax_lastdim(
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
-                [](Vec& x, Vec& y) { return vec256::max(x, y); },
+            max_input_arr[j] = vec::reduce_all<scalar_t>(
+                [](Vec& x, Vec& y) { return vec::max(x, y); },
                 input_data,
                 dim_size);
           }
@@ -57,7 +56,7 @@ inline void _vec_log_softmax_lastdim(
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
+            tmp_sum_scalar[j] = vec::map_reduce_all<scalar_t>(
                 [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
                 [](Vec x, Vec y) { return x + y; },
                 input_data,
@@ -65,7 +64,7 @@ inline void _vec_log_softmax_lastdim(
           }
           // See [Note AVX-SSE transitions] for why this should call the
           // vectorized version (aside from perf improvements).
-          vec256::map2(
+          vec::map2(
               [](Vec x, Vec y) { return x.log() + y; },
               tmp_sum_scalar,
               tmp_sum_scalar,
@@ -76,7 +75,7 @@ inline void _vec_log_softmax_lastdim(
             scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t* output_data = output_data_base + i * dim_size;
             scalar_t tmp_sum = tmp_sum_scalar[j];
-            vec256::map(
+            vec::map(
                 [tmp_sum](Vec x) { return x - Vec(tmp_sum); },
                 output_data,
                 input_data,
@@ -92,7 +91,7 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -105,19 +104,19 @@ inline void _vec_softmax_lastdim(
         for (int64_t i = begin; i < end; i++) {
           scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
-              [](Vec& x, Vec& y) { return vec256::max(x, y); },
+          scalar_t max_input = vec::reduce_all<scalar_t>(
+              [](Vec& x, Vec& y) { return vec::max(x, y); },
               input_data,
               dim_size);
-          vec256::map(
+          vec::map(
               [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
+          scalar_t tmp_sum = vec::reduce_all<scalar_t>(
               [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
           tmp_sum = 1 / tmp_sum;
-          vec256::map(
+          vec::map(
               [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
               output_data,
               output_data,
@@ -133,7 +132,7 @@ inline void _vec_host_softmax_backward_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -149,10 +148,10 @@ inline void _vec_host_softmax_backward_lastdim(
           scalar_t* output_data = output_data_base + i * dim_size;
           scalar_t sum;
           if (log_softmax) {
-            sum = vec256::reduce_all<scalar_t>(
+            sum = vec::reduce_all<scalar_t>(
                 [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
           } else {
-            sum = vec256::map2_reduce_all<scalar_t>(
+            sum = vec::map2_reduce_all<scalar_t>(
                 [](Vec x, Vec y) { return x * y; },
                 [](Vec x, Vec y) { return x + y; },
                 grad_data,
@@ -160,14 +159,14 @@ inline void _vec_host_softmax_backward_lastdim(
                 dim_size);
           }
           if (log_softmax) {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
                 grad_input_data,
                 grad_data,
                 output_data,
                 dim_size);
           } else {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
                 grad_input_data,
                 grad_data,
@@ -0,0 +1,66 @@
+#include "ATen/native/cpu/SparseCsrKernel.h"
+
+#include <algorithm>
+
+#include "ATen/Dispatch.h"
+#include "ATen/Parallel.h"
+#include "ATen/cpu/vec.h"
+
+// Every row of the result is computed by one thread, which adds the scaled
+// rows of dense selected by the columns of the row of A into it. The result
+// row stays in cache while the rows of dense are streamed, and no two threads
+// write the same row.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec;
+
+// out += row * alpha
+template <typename scalar_t>
+void axpy(scalar_t* out, const scalar_t* row, int64_t n, scalar_t alpha) {
+  using Vec = Vectorized<scalar_t>;
+  Vec alpha_vec(alpha);
+  int64_t i = 0;
+  for (; i <= n - Vec::size; i += Vec::size) {
+    (Vec::loadu(out + i) + Vec::loadu(row + i) * alpha_vec).store(out + i);
+  }
+  for (; i < n; i++) {
+    out[i] += row[i] * alpha;
+  }
+}
+
+static void sparse_csr_addmm_kernel_impl(
+    Tensor& result, const Tensor& crow_indices, const Tensor& col_indices,
+    const Tensor& values, const Tensor& dense, Scalar alpha) {
+  int64_t rows = result.size(0);
+  int64_t n = result.size(1);
+  int64_t nnz = values.numel();
+  if (nnz == 0) {
+    return;
+  }
+  const int64_t* crow_data = crow_indices.data<int64_t>();
+  const int64_t* col_data = col_indices.data<int64_t>();
+  // elements written per row on average
+  int64_t row_work = std::max<int64_t>(1, nnz / std::max<int64_t>(rows, 1)) * n;
+  AT_DISPATCH_ALL_TYPES(values.type(), "addmm_sparse_csr_dense", [&] {
+    const scalar_t* values_data = values.data<scalar_t>();
+    const scalar_t* dense_data = dense.data<scalar_t>();
+    scalar_t* result_data = result.data<scalar_t>();
+    scalar_t cast_alpha = alpha.to<scalar_t>();
+    parallel_for(0, rows, divup(internal::GRAIN_SIZE, std::max<int64_t>(row_work, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        scalar_t* out = result_data + row * n;
+        for (int64_t i = crow_data[row]; i < crow_data[row + 1]; i++) {
+          axpy(out, dense_data + col_data[i] * n, n, static_cast<scalar_t>(cast_alpha * values_data[i]));
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(sparse_csr_addmm_kernel, &sparse_csr_addmm_kernel_impl);
+
+}} // namespace at::native
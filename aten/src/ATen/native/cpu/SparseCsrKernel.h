@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include "CapabilityDispatch.h"
+
+namespace at {
+namespace native {
+
+// result += alpha * A * dense, where A is the CSR matrix with the given
+// crow_indices, col_indices and values (see SparseCsrTensorImpl.h). result is
+// a contiguous (rows, n) matrix, dense a contiguous (cols, n) matrix of the
+// type of values, and every column index is in range.
+using sparse_csr_addmm_fn = void(*)(
+    Tensor& result, const Tensor& crow_indices, const Tensor& col_indices,
+    const Tensor& values, const Tensor& dense, Scalar alpha);
+
+extern DispatchStub<sparse_csr_addmm_fn> sparse_csr_addmm_kernel;
+
+}
+}
@@ -9,7 +9,7 @@
 namespace at { namespace native {
 namespace {
 
-using namespace vec256;
+using namespace vec;
 
 #define IMPLEMENT_FLOAT_KERNEL(dispatchtypes, op)                          \
   static void op##_kernel(Tensor& result, const Tensor& self) {            \
@@ -67,6 +67,7 @@ IMPLEMENT_FLOAT_KERNEL(FLOATING, log1p)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, log2)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, round)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, rsqrt)
+IMPLEMENT_FLOAT_KERNEL(FLOATING, sigmoid)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, sin)
 // IMPLEMENT_FLOAT_KERNEL(FLOATING, sinh)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, sqrt)
@@ -42,4 +42,11 @@ Tensor& _tanh_out_cuda(Tensor& result, const Tensor& self) {
   return at::_th_tanh_out(result, self);
 }
 
+Tensor& _sigmoid__cuda(Tensor& self) {
+  return at::_th_sigmoid_out(self, self);
+}
+Tensor& _sigmoid_out_cuda(Tensor& result, const Tensor& self) {
+  return at::_th_sigmoid_out(result, self);
+}
+
 }}
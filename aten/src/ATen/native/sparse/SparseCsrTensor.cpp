@@ -0,0 +1,280 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace at { namespace native {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+using SparseTensor = Tensor;
+using LongTensor = Tensor;
+using SparseCsrType = Type;
+
+namespace {
+  // The SparseCsrTensorImpl counterpart of _get_sparse_impl in
+  // SparseTensor.cpp.
+  SparseCsrTensorImpl* _get_sparse_csr_impl(const SparseCsrTensor& self) {
+    if (self.type().layout() != kSparseCsr) AT_ERROR("_internal_get_SparseCsrTensorImpl: not a sparse CSR tensor");
+    return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+  }
+
+  // Does NOT make copies of crow_indices/col_indices/values
+  SparseCsrTensor _new_with_tensors_sparse_csr(
+      const SparseCsrType& dtype,
+      const LongTensor& crow_indices,
+      const LongTensor& col_indices,
+      const Tensor& values,
+      ArrayRef<int64_t> size) {
+    SparseCsrTensor self = new_sparse_csr(dtype);
+    _get_sparse_csr_impl(self)->set_member_tensors(crow_indices, col_indices, values, size);
+    return self;
+  }
+
+  // The number of nonzeros of every row, computed in parallel, as the
+  // crow_indices of a CSR matrix with rows rows: crow[0] = 0 and
+  // crow[i + 1] - crow[i] = count(i).
+  template <typename F>
+  LongTensor _crow_indices_from_counts(int64_t rows, int64_t grain_size, const F& count) {
+    LongTensor crow_indices = at::CPU(kLong).tensor({rows + 1});
+    int64_t* crow_data = crow_indices.data<int64_t>();
+    crow_data[0] = 0;
+    parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        crow_data[row + 1] = count(row);
+      }
+    });
+    std::partial_sum(crow_data, crow_data + rows + 1, crow_data);
+    return crow_indices;
+  }
+}
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return _get_sparse_csr_impl(self)->nnz();
+}
+
+LongTensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return _get_sparse_csr_impl(self)->crow_indices();
+}
+
+LongTensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return _get_sparse_csr_impl(self)->col_indices();
+}
+
+Tensor _values_sparse_csr(const SparseCsrTensor& self) {
+  return _get_sparse_csr_impl(self)->values();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+/* Empty init */
+SparseCsrTensor new_sparse_csr(const SparseCsrType& dtype) {
+  AT_ASSERT(!dtype.is_undefined());
+  AT_ASSERT(!dtype.is_variable());
+  AT_ASSERT(dtype.layout() == kSparseCsr);
+  // TODO: Hmm... this const_cast business seems a bit dodgy
+  return SparseCsrTensor(new SparseCsrTensorImpl(const_cast<SparseCsrType*>(&dtype)), /* retain */ false);
+}
+
+SparseCsrTensor new_with_size_sparse_csr(const SparseCsrType& dtype, ArrayRef<int64_t> size) {
+  AT_CHECK(size.size() == 2, "sparse CSR tensors must have 2 dimensions, but got size ", size);
+  LongTensor crow_indices = at::CPU(kLong).tensor({size[0] + 1}).zero_();
+  return _new_with_tensors_sparse_csr(dtype, crow_indices, at::CPU(kLong).tensor(), dtype.toDense().tensor(), size);
+}
+
+// Checks the indices and makes them contiguous, but does NOT copy
+// contiguous crow_indices/col_indices/values
+SparseCsrTensor new_with_tensors_sparse_csr(const LongTensor& crow_indices_, const LongTensor& col_indices_, const Tensor& values_, ArrayRef<int64_t> size) {
+  AT_CHECK(size.size() == 2, "sparse CSR tensors must have 2 dimensions, but got size ", size);
+  AT_CHECK(!crow_indices_.is_sparse() && !col_indices_.is_sparse() && !values_.is_sparse(),
+           "crow_indices, col_indices and values must be dense tensors");
+  LongTensor crow_indices = crow_indices_.contiguous();
+  LongTensor col_indices = col_indices_.contiguous();
+  Tensor values = values_.contiguous();
+  const SparseCsrType& dtype = values.type().toBackend(kSparseCsrCPU);
+  SparseCsrTensor self = _new_with_tensors_sparse_csr(dtype, crow_indices, col_indices, values, size);
+
+  int64_t rows = size[0];
+  int64_t cols = size[1];
+  int64_t nnz = values.numel();
+  const int64_t* crow_data = crow_indices.data<int64_t>();
+  AT_CHECK(crow_data[0] == 0, "crow_indices[0] must be 0, but got ", crow_data[0]);
+  AT_CHECK(crow_data[rows] == nnz, "crow_indices[-1] must be nnz = ", nnz, ", but got ", crow_data[rows]);
+  for (int64_t row = 0; row < rows; row++) {
+    AT_CHECK(crow_data[row] <= crow_data[row + 1], "crow_indices must be nondecreasing, but row ", row,
+             " starts at ", crow_data[row], " and ends at ", crow_data[row + 1]);
+  }
+  if (nnz == 0) {
+    return self;
+  }
+  const int64_t* col_data = col_indices.data<int64_t>();
+  for (int64_t row = 0; row < rows; row++) {
+    for (int64_t i = crow_data[row]; i < crow_data[row + 1]; i++) {
+      int64_t col = col_data[i];
+      AT_CHECK(col >= 0 && col < cols, "column index ", col, " in row ", row, " is out of range for ", cols, " columns");
+      AT_CHECK(i == crow_data[row] || col_data[i - 1] < col,
+               "the column indices of row ", row, " must be strictly increasing");
+    }
+  }
+  return self;
+}
+
+// Like sparse_coo_tensor, this is called with Variables and dispatches on the
+// CSR type of values.
+SparseCsrTensor sparse_csr_tensor(const LongTensor& crow_indices, const LongTensor& col_indices, const Tensor& values, ArrayRef<int64_t> size) {
+  AT_CHECK(!values.is_cuda(), "sparse CSR tensors are only supported on the CPU");
+  return values.type().toBackend(kSparseCsrCPU)._native_sparse_csr_tensor(crow_indices, col_indices, values, size);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  int64_t rows = self.size(0);
+  int64_t cols = self.size(1);
+  Tensor dst = at::zeros({rows, cols}, self.type().toDense());
+  if (self._nnz() == 0) {
+    return dst;
+  }
+  const int64_t* crow_data = self.crow_indices().data<int64_t>();
+  const int64_t* col_data = self.col_indices().data<int64_t>();
+  AT_DISPATCH_ALL_TYPES(self.type(), "sparse_csr_to_dense", [&] {
+    const scalar_t* values_data = self._values().data<scalar_t>();
+    scalar_t* dst_data = dst.data<scalar_t>();
+    parallel_for(0, rows, divup(internal::GRAIN_SIZE, std::max<int64_t>(cols, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        for (int64_t i = crow_data[row]; i < crow_data[row + 1]; i++) {
+          dst_data[row * cols + col_data[i]] = values_data[i];
+        }
+      }
+    });
+  });
+  return dst;
+}
+
+// The nonzeros of a 2-D dense matrix. Every row is scanned twice, once to
+// count its nonzeros and once to write them at the offset of the row.
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self_) {
+  AT_CHECK(self_.dim() == 2, "to_sparse_csr expects a 2-D tensor, but got ", self_.dim(), " dimensions");
+  Tensor self = self_.contiguous();
+  int64_t rows = self.size(0);
+  int64_t cols = self.size(1);
+  int64_t grain_size = divup(internal::GRAIN_SIZE, std::max<int64_t>(cols, 1));
+  const SparseCsrType& dtype = self.type().toBackend(kSparseCsrCPU);
+  SparseCsrTensor result;
+  AT_DISPATCH_ALL_TYPES(self.type(), "dense_to_sparse_csr", [&] {
+    const scalar_t* self_data = self.data<scalar_t>();
+    LongTensor crow_indices = _crow_indices_from_counts(rows, grain_size, [&](int64_t row) {
+      const scalar_t* row_data = self_data + row * cols;
+      return std::count_if(row_data, row_data + cols, [](scalar_t value) { return value != scalar_t(0); });
+    });
+    const int64_t* crow_data = crow_indices.data<int64_t>();
+    int64_t nnz = crow_data[rows];
+    if (nnz == 0) {
+      result = new_with_size_sparse_csr(dtype, {rows, cols});
+      return;
+    }
+    LongTensor col_indices = at::CPU(kLong).tensor({nnz});
+    Tensor values = self.type().tensor({nnz});
+    int64_t* col_data = col_indices.data<int64_t>();
+    scalar_t* values_data = values.data<scalar_t>();
+    parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const scalar_t* row_data = self_data + row * cols;
+        int64_t i = crow_data[row];
+        for (int64_t col = 0; col < cols; col++) {
+          if (row_data[col] != scalar_t(0)) {
+            col_data[i] = col;
+            values_data[i] = row_data[col];
+            i++;
+          }
+        }
+      }
+    });
+    result = _new_with_tensors_sparse_csr(dtype, crow_indices, col_indices, values, {rows, cols});
+  });
+  return result;
+}
+
+// A coalesced COO matrix already holds its nonzeros in row-major order, so
+// only the row indices have to be compressed.
+SparseCsrTensor sparse_to_sparse_csr(const SparseTensor& self_) {
+  AT_CHECK(self_._sparseDims() == 2, "to_sparse_csr expects 2 sparse dimensions, but got ", self_._sparseDims());
+  AT_CHECK(self_._denseDims() == 0, "to_sparse_csr expects scalar values, but got ", self_._denseDims(), "D values");
+  SparseTensor self = self_.coalesce();
+  int64_t rows = self.size(0);
+  int64_t cols = self.size(1);
+  int64_t nnz = self._nnz();
+  const SparseCsrType& dtype = self.type().toBackend(kSparseCsrCPU);
+  if (nnz == 0) {
+    return new_with_size_sparse_csr(dtype, {rows, cols});
+  }
+  LongTensor indices = self._indices().contiguous();
+  const int64_t* row_data = indices.data<int64_t>();
+  LongTensor crow_indices = at::CPU(kLong).tensor({rows + 1}).zero_();
+  int64_t* crow_data = crow_indices.data<int64_t>();
+  for (int64_t i = 0; i < nnz; i++) {
+    crow_data[row_data[i] + 1]++;
+  }
+  std::partial_sum(crow_data, crow_data + rows + 1, crow_data);
+  return _new_with_tensors_sparse_csr(dtype, crow_indices, indices[1].clone(), self._values().clone(), {rows, cols});
+}
+
+SparseTensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  int64_t rows = self.size(0);
+  int64_t nnz = self._nnz();
+  const Type& dtype = self.type().toBackend(kSparseCPU);
+  if (nnz == 0) {
+    return dtype.tensor(self.sizes());
+  }
+  const int64_t* crow_data = self.crow_indices().data<int64_t>();
+  LongTensor indices = at::CPU(kLong).tensor({2, nnz});
+  int64_t* row_data = indices.data<int64_t>();
+  parallel_for(0, rows, divup(internal::GRAIN_SIZE, std::max<int64_t>(1, nnz / std::max<int64_t>(rows, 1))), [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      std::fill(row_data + crow_data[row], row_data + crow_data[row + 1], row);
+    }
+  });
+  indices[1].copy_(self.col_indices());
+  return dtype._native_sparse_coo_tensor_unsafe(indices, self._values().clone(), self.sizes())._coalesced_(true);
+}
+
+/******************************************************************************
+ * reshaping methods
+ ******************************************************************************/
+
+SparseCsrTensor slice_rows_sparse_csr(const SparseCsrTensor& self, int64_t start, int64_t end) {
+  int64_t rows = self.size(0);
+  AT_CHECK(0 <= start && start <= end && end <= rows,
+           "invalid row range [", start, ", ", end, ") for a sparse CSR tensor with ", rows, " rows");
+  LongTensor crow_indices = self.crow_indices();
+  const int64_t* crow_data = crow_indices.data<int64_t>();
+  int64_t first = crow_data[start];
+  int64_t last = crow_data[end];
+  LongTensor new_crow_indices = crow_indices.slice(0, start, end + 1) - first;
+  LongTensor col_indices;
+  Tensor values;
+  if (last > first) {
+    col_indices = self.col_indices().slice(0, first, last);
+    values = self._values().slice(0, first, last);
+  } else {
+    // Narrows don't work on 0-length tensors
+    col_indices = at::CPU(kLong).tensor();
+    values = self.type().toDense().tensor();
+  }
+  return _new_with_tensors_sparse_csr(self.type(), new_crow_indices, col_indices, values, {end - start, self.size(1)});
+}
+
+}} // namespace at::native
@@ -0,0 +1,132 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/cpu/SparseCsrKernel.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+
+namespace {
+  // TODO: put this into the public API
+  bool isSameTensor(const Tensor& lhs, const Tensor& rhs) {
+    return lhs.unsafeGetTensorImpl() == rhs.unsafeGetTensorImpl();
+  }
+}
+
+// --------------------------------------------------------------------
+// addmm(Tensor, SparseCsrTensor, Tensor, Scalar, Scalar)  [broadcasts]
+// --------------------------------------------------------------------
+
+// Unlike the COO addmm, this needs neither a coalesce nor a conversion of
+// the indices, and the rows of the result are computed in parallel by
+// sparse_csr_addmm_kernel.
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  AT_CHECK(sparse.type().layout() == kSparseCsr, "Argument #2 (mat1): expected a sparse CSR tensor");
+  AT_CHECK(dense.dim() == 2, "matrices expected, got ", dense.dim(), "D tensor");
+  AT_CHECK(!dense.is_sparse() && dense.type().layout() == kStrided, "Argument #3 (mat2): expected a dense tensor");
+  AT_CHECK(dense.type().scalarType() == sparse.type().scalarType(),
+      "Argument #3 (mat2): expected ", sparse.type().toDense().toString(), ", got ", dense.type().toString());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = sparse.size(0);
+  int64_t dim_j = sparse.size(1);
+  int64_t dim_k = dense.size(1);
+
+  AT_CHECK(dense.size(0) == dim_j,
+      "Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+  AT_CHECK(t.dim() == 2 && t.size(0) == dim_i,
+      "Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  AT_CHECK(t.size(1) == dim_k,
+      "Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+
+  if (beta.toDouble() == 0) {
+    r.zero_();
+  } else if (beta.toDouble() == 1) {
+    if (!isSameTensor(r, t)) r.copy_(t);
+  } else {
+    at::mul_out(r, t, beta);
+  }
+
+  if (sparse._nnz() == 0) {
+    return r;
+  }
+
+  Tensor result = r.is_contiguous() ? r : r.contiguous();
+  sparse_csr_addmm_kernel(result, sparse.crow_indices(), sparse.col_indices(), sparse._values(), dense.contiguous(), alpha);
+  if (!isSameTensor(result, r)) r.copy_(result);
+  return r;
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor r = t.type().tensor();
+  addmm_out_sparse_csr_dense_cpu(r, t, sparse, dense, beta, alpha);
+  return r;
+}
+
+Tensor& addmm_sparse_csr_dense_cpu_(
+    Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  return addmm_out_sparse_csr_dense_cpu(t, t, sparse, dense, beta, alpha);
+}
+
+// --------------------------------------------------------------------
+// mv(SparseCsrTensor, Tensor)
+// --------------------------------------------------------------------
+
+Tensor mv_sparse_csr(const SparseCsrTensor& self, const Tensor& vec_) {
+  AT_CHECK(vec_.dim() == 1 && !vec_.is_sparse(), "vector expected, got ", vec_.dim(), "D tensor");
+  AT_CHECK(vec_.size(0) == self.size(1),
+      "size mismatch, got ", self.size(0), "x", self.size(1), " and ", vec_.size(0));
+  AT_CHECK(vec_.type() == self.type().toDense(),
+      "Argument #2 (vec): expected ", self.type().toDense().toString(), ", got ", vec_.type().toString());
+  int64_t rows = self.size(0);
+  int64_t nnz = self._nnz();
+  Tensor result = at::zeros({rows}, vec_.type());
+  if (nnz == 0) {
+    return result;
+  }
+  Tensor vec = vec_.contiguous();
+  const int64_t* crow_data = self.crow_indices().data<int64_t>();
+  const int64_t* col_data = self.col_indices().data<int64_t>();
+  AT_DISPATCH_ALL_TYPES(self.type(), "mv_sparse_csr", [&] {
+    const scalar_t* values_data = self._values().data<scalar_t>();
+    const scalar_t* vec_data = vec.data<scalar_t>();
+    scalar_t* result_data = result.data<scalar_t>();
+    int64_t row_work = std::max<int64_t>(1, nnz / std::max<int64_t>(rows, 1));
+    parallel_for(0, rows, divup(internal::GRAIN_SIZE, row_work), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        scalar_t sum = 0;
+        for (int64_t i = crow_data[row]; i < crow_data[row + 1]; i++) {
+          sum += values_data[i] * vec_data[col_data[i]];
+        }
+        result_data[row] = sum;
+      }
+    });
+  });
+  return result;
+}
+
+}} // namespace at::native
@@ -3,8 +3,8 @@
 #include <ATen/ATen.h>
 #include <ATen/SparseTensorImpl.h>
 #include <ATen/NativeFunctions.h>
-
-#include <TH/THBlasUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/IndexGrouping.h>
 
 namespace at { namespace native {
 
@@ -43,6 +43,11 @@ bool is_coalesced_sparse(const SparseTensor& self) {
   return _get_sparse_impl(self)->coalesced();
 }
 
+SparseTensor& _coalesced_sparse_(SparseTensor& self, bool coalesced) {
+  _get_sparse_impl(self)->set_coalesced(coalesced);
+  return self;
+}
+
 int64_t _nnz_sparse(const SparseTensor& self) {
   return _get_sparse_impl(self)->nnz();
 }
@@ -354,47 +359,51 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
     factor *= self.size(d);
   }
 
+  // Equal indices are grouped with a parallel radix sort, which keeps the
+  // entries of every index in their original order, and every group is then
+  // summed on its own, so the result does not depend on the number of
+  // threads.
+  IndexGroups groups = group_indices(indices_scalar.data<int64_t>(), nnz, factor);
+  int64_t newNnz = groups.size();
+
   SparseTensor dst = new_sparse(values.type().toSparse());
   _raw_resize_sparse(dst, sparseDims, denseDims, self.sizes());
-  // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = indices.type().tensor(indices.sizes());
-  Tensor newValues = values.type().tensor(values.sizes());
+  std::vector<int64_t> newValuesSize = values.sizes();
+  newValuesSize[0] = newNnz;
+  LongTensor newIndices = indices.type().tensor({sparseDims, newNnz});
+  Tensor newValues = values.type().tensor(newValuesSize);
   _alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
-
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data<scalar_t>();
         scalar_t* newValues_ptr = newValues.data<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-          } else {
-            ++i;
+        int64_t groupWork = std::max<int64_t>(1, nnz / newNnz) * std::max<int64_t>(blockSize, 1);
+        parallel_for(0, newNnz, divup(internal::GRAIN_SIZE, groupWork), [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t* positions = groups.positions.data() + groups.offsets[i];
+            int64_t count = groups.offsets[i + 1] - groups.offsets[i];
             for (int64_t d = 0; d < sparseDims; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][i] = indicesAccessor[d][positions[0]];
+            }
+            scalar_t* out = newValues_ptr + i * blockSize;
+            std::copy(values_ptr + positions[0] * blockSize, values_ptr + (positions[0] + 1) * blockSize, out);
+            for (int64_t j = 1; j < count; j++) {
+              const scalar_t* in = values_ptr + positions[j] * blockSize;
+              for (int64_t k = 0; k < blockSize; k++) {
+                out[k] += in[k];
+              }
             }
-            THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
           }
-          prev = curr;
-        }
+        });
     });
 
   _get_sparse_impl(dst)->set_coalesced(true);
-  _get_sparse_impl(dst)->set_nnz(i + 1);
+  _get_sparse_impl(dst)->set_nnz(newNnz);
 
   return dst;
 }
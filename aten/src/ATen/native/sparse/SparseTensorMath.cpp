@@ -2,9 +2,14 @@
 #include <ATen/SparseTensorImpl.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 namespace at { namespace native {
 
 // Just for documentary purposes
@@ -703,6 +708,197 @@ SparseTensor hspmm_sparse_cpu(const SparseTensor& sparse, const Tensor& dense) {
   return r;
 }
 
+// --------------------------------------------------------------------
+// mm(SparseTensor, SparseTensor)
+// --------------------------------------------------------------------
+
+namespace {
+  // The sums of the products of one row of a sparse-sparse product, keyed by
+  // column in an open addressing hash table. The table holds at least twice
+  // as many slots as the row has products, so probes stay short no matter
+  // how many columns mat2 has, and it is reused for every row of a thread.
+  template <typename scalar_t>
+  class RowAccumulator {
+  public:
+    void reset(int64_t products) {
+      int64_t capacity = 2;
+      shift_ = 63;
+      while (capacity < 2 * products) {
+        capacity <<= 1;
+        shift_--;
+      }
+      if (capacity > static_cast<int64_t>(cols_.size())) {
+        cols_.assign(capacity, -1);
+        sums_.resize(capacity);
+      }
+    }
+
+    void add(int64_t col, scalar_t value) {
+      // Fibonacci hashing spreads the consecutive columns of a dense block
+      uint64_t slot = (static_cast<uint64_t>(col) * 0x9E3779B97F4A7C15ULL) >> shift_;
+      uint64_t mask = (uint64_t(1) << (64 - shift_)) - 1;
+      while (cols_[slot] != -1 && cols_[slot] != col) {
+        slot = (slot + 1) & mask;
+      }
+      if (cols_[slot] == -1) {
+        cols_[slot] = col;
+        sums_[slot] = value;
+        used_.push_back(slot);
+      } else {
+        sums_[slot] += value;
+      }
+    }
+
+    int64_t size() const {
+      return used_.size();
+    }
+
+    // Writes the columns in increasing order and their sums, and empties the
+    // table.
+    void flush(int64_t* cols, scalar_t* sums) {
+      std::sort(used_.begin(), used_.end(), [&](int64_t a, int64_t b) { return cols_[a] < cols_[b]; });
+      for (size_t i = 0; i < used_.size(); i++) {
+        cols[i] = cols_[used_[i]];
+        sums[i] = sums_[used_[i]];
+      }
+      clear();
+    }
+
+    void clear() {
+      for (int64_t slot : used_) {
+        cols_[slot] = -1;
+      }
+      used_.clear();
+    }
+
+  private:
+    std::vector<int64_t> cols_;
+    std::vector<scalar_t> sums_;
+    std::vector<int64_t> used_;
+    int shift_ = 63;
+  };
+
+  // Splits the rows into one range per thread with about the same number of
+  // products each, since the rows of power-law matrices differ in length by
+  // orders of magnitude. products holds the running total of the products of
+  // the rows, with products[0] = 0.
+  std::vector<int64_t> _balanced_row_ranges(const std::vector<int64_t>& products) {
+    int64_t rows = products.size() - 1;
+    int64_t total = products[rows];
+    int64_t nranges = std::max<int64_t>(
+        1, std::min<int64_t>(internal::get_intraop_num_threads(), total / internal::GRAIN_SIZE));
+    std::vector<int64_t> bounds(nranges + 1, rows);
+    bounds[0] = 0;
+    for (int64_t r = 1; r < nranges; r++) {
+      auto it = std::lower_bound(products.begin(), products.end(), total / nranges * r);
+      bounds[r] = std::max(bounds[r - 1], std::min<int64_t>(it - products.begin(), rows));
+    }
+    return bounds;
+  }
+}
+
+// Gustavson's row-by-row product: row i of the result is the sum of the rows
+// of mat2 selected by the columns of row i of mat1, scaled by its values.
+// Every thread takes a range of rows, counts the distinct columns of every
+// row in a first pass, and after the offsets of the rows are known, sums and
+// writes them in a second pass. The result comes out coalesced.
+SparseTensor sparse_sparse_matmul_cpu(const SparseTensor& mat1_, const SparseTensor& mat2_) {
+  AT_CHECK(mat1_._sparseDims() == 2 && mat1_._denseDims() == 0,
+      "Argument #1 (mat1): matrices with scalar values expected, got ", mat1_._sparseDims(), " sparse and ",
+      mat1_._denseDims(), " dense dims");
+  AT_CHECK(mat2_._sparseDims() == 2 && mat2_._denseDims() == 0,
+      "Argument #2 (mat2): matrices with scalar values expected, got ", mat2_._sparseDims(), " sparse and ",
+      mat2_._denseDims(), " dense dims");
+  AT_CHECK(mat1_.type() == mat2_.type(),
+      "Argument #2 (mat2): expected ", mat1_.type().toString(), ", got ", mat2_.type().toString());
+  AT_CHECK(mat1_.size(1) == mat2_.size(0),
+      "size mismatch, got ", mat1_.size(0), "x", mat1_.size(1), " and ", mat2_.size(0), "x", mat2_.size(1));
+
+  // ixj * jxk = ixk
+  int64_t dim_i = mat1_.size(0);
+  int64_t dim_j = mat1_.size(1);
+  int64_t dim_k = mat2_.size(1);
+
+  SparseTensor mat1 = mat1_.coalesce();
+  SparseTensor mat2 = mat2_.coalesce();
+  int64_t nnz1 = mat1._nnz();
+  int64_t nnz2 = mat2._nnz();
+  if (nnz1 == 0 || nnz2 == 0) {
+    return mat1.type().tensor({dim_i, dim_k});
+  }
+
+  LongTensor indices1 = mat1._indices().contiguous();
+  LongTensor indices2 = mat2._indices().contiguous();
+  const int64_t* col1 = indices1.data<int64_t>() + nnz1;
+  const int64_t* col2 = indices2.data<int64_t>() + nnz2;
+  LongTensor csr1 = _to_csr(indices1.data<int64_t>(), dim_i, nnz1);
+  LongTensor csr2 = _to_csr(indices2.data<int64_t>(), dim_j, nnz2);
+  const int64_t* row1 = csr1.data<int64_t>();
+  const int64_t* row2 = csr2.data<int64_t>();
+
+  std::vector<int64_t> products(dim_i + 1, 0);
+  for (int64_t i = 0; i < dim_i; i++) {
+    int64_t count = 0;
+    for (int64_t p = row1[i]; p < row1[i + 1]; p++) {
+      count += row2[col1[p] + 1] - row2[col1[p]];
+    }
+    products[i + 1] = products[i] + count;
+  }
+  if (products[dim_i] == 0) {
+    return mat1.type().tensor({dim_i, dim_k});
+  }
+  std::vector<int64_t> bounds = _balanced_row_ranges(products);
+  int64_t nranges = bounds.size() - 1;
+
+  std::vector<int64_t> offsets(dim_i + 1, 0);
+  LongTensor indices;
+  Tensor values;
+  AT_DISPATCH_ALL_TYPES(
+      mat1.type(), "sparse_sparse_matmul", [&] {
+        Tensor values1_contig = mat1._values().contiguous();
+        Tensor values2_contig = mat2._values().contiguous();
+        const scalar_t* values1 = values1_contig.data<scalar_t>();
+        const scalar_t* values2 = values2_contig.data<scalar_t>();
+        auto for_each_row = [&](const std::function<void(RowAccumulator<scalar_t>&, int64_t)>& f) {
+          parallel_for(0, nranges, 1, [&](int64_t begin, int64_t end) {
+            RowAccumulator<scalar_t> acc;
+            for (int64_t r = begin; r < end; r++) {
+              for (int64_t i = bounds[r]; i < bounds[r + 1]; i++) {
+                acc.reset(products[i + 1] - products[i]);
+                for (int64_t p = row1[i]; p < row1[i + 1]; p++) {
+                  scalar_t value = values1[p];
+                  for (int64_t q = row2[col1[p]]; q < row2[col1[p] + 1]; q++) {
+                    acc.add(col2[q], value * values2[q]);
+                  }
+                }
+                f(acc, i);
+              }
+            }
+          });
+        };
+
+        for_each_row([&](RowAccumulator<scalar_t>& acc, int64_t i) {
+          offsets[i + 1] = acc.size();
+          acc.clear();
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        int64_t nnz = offsets[dim_i];
+
+        indices = at::CPU(kLong).tensor({2, nnz});
+        values = mat1._values().type().tensor({nnz});
+        int64_t* rows_ptr = indices.data<int64_t>();
+        int64_t* cols_ptr = rows_ptr + nnz;
+        scalar_t* values_ptr = values.data<scalar_t>();
+        for_each_row([&](RowAccumulator<scalar_t>& acc, int64_t i) {
+          std::fill(rows_ptr + offsets[i], rows_ptr + offsets[i + 1], i);
+          acc.flush(cols_ptr + offsets[i], values_ptr + offsets[i]);
+        });
+      }
+  );
+
+  return mat1.type()._native_sparse_coo_tensor_unsafe(indices, values, {dim_i, dim_k})._coalesced_(true);
+}
+
 // --------------------------------------------------------------------
 // sspaddmm
 // --------------------------------------------------------------------
@@ -96,11 +96,15 @@ def parse_arguments(args, func_decl, func_name, func_return):
 
 def has_sparse_dispatches(dispatches):
     for dispatch in dispatches:
-        if 'Sparse' in dispatch:
+        if 'Sparse' in dispatch and 'SparseCsr' not in dispatch:
             return True
     return False
 
 
+def has_sparse_csr_dispatches(dispatches):
+    return isinstance(dispatches, dict) and 'SparseCsrCPU' in dispatches
+
+
 def parse_native_yaml(path):
     with open(path, 'r') as f:
         return yaml.load(f, Loader=Loader)
@@ -130,6 +134,8 @@ def run(paths):
                 declaration['type_method_definition_dispatch'] = func.get('dispatch', declaration['name'])
                 declaration['aten_sparse'] = has_sparse_dispatches(
                     declaration['type_method_definition_dispatch'])
+                declaration['aten_sparse_csr'] = has_sparse_csr_dispatches(
+                    declaration['type_method_definition_dispatch'])
                 declarations.append(declaration)
             except Exception as e:
                 msg = '''Exception raised in processing function:
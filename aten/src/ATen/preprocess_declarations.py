@@ -21,7 +21,7 @@ type_map = {
 all_types = type_map['floating_point'] + type_map['integral']
 type_map['all'] = all_types
 
-all_backends = ['CPU', 'CUDA', 'SparseCPU', 'SparseCUDA']
+all_backends = ['CPU', 'CUDA', 'SparseCPU', 'SparseCUDA', 'SparseCsrCPU']
 default_backends = ['CPU', 'CUDA']
 
 sparse_map = {
@@ -38,6 +38,8 @@ def process_types_and_backends(option):
         backends = option.get('backends', default_backends)
         if option.get('aten_sparse', False):
             backends.extend([sparse_map[p] for p in backends if p in sparse_map])
+        if option.get('aten_sparse_csr', False):
+            backends.append('SparseCsrCPU')
         backends = set(backends)
 
         types = option.get('types', all_types)
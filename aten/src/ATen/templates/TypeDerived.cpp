@@ -10,10 +10,7 @@
 #include "ATen/${Storage}.h"
 #include "ATen/${Tensor}.h"
 #include "ATen/${Generator}.h"
-#include "ATen/${Backend}ByteTensor.h"
-#include "ATen/${Backend}IntTensor.h"
-#include "ATen/${Backend}LongTensor.h"
-#include "ATen/${SparseTensor}.h"
+$tensor_headers
 #include "ATen/${DenseTensor}.h"
 #include "ATen/${DenseBackend}LongTensor.h"
 #include "ATen/Allocator.h"
@@ -63,9 +60,7 @@ std::unique_ptr<Storage> ${Type}::storageWithAllocator(int64_t size, std::unique
         new ${Storage}(context, size, std::move(allocator)));
 }
 Tensor ${Type}::unsafeTensorFromTH(void * th_pointer, bool retain) const {
-  if (retain)
-    ${THTensor}_retain(${state,} (${THTensor}*) th_pointer);
-  return Tensor(new ${Tensor}(context,(${THTensor}*)(th_pointer)), false);
+  ${tensor_from_th}
 }
 std::unique_ptr<Storage> ${Type}::unsafeStorageFromTH(void * th_pointer, bool retain) const {
   if (retain)
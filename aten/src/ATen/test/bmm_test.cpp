@@ -0,0 +1,106 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+#include <cmath>
+
+using namespace at;
+
+// bmm and baddbmm of small matrices run on the register-blocked kernel of
+// native/cpu/SmallGemmKernel.cpp; they are compared against an mm per matrix.
+
+static Tensor bmm_reference(const Tensor& batch1, const Tensor& batch2) {
+  std::vector<Tensor> products;
+  for (int64_t i = 0; i < batch1.size(0); i++) {
+    products.push_back(at::mm(batch1[i], batch2[i]));
+  }
+  return at::stack(products);
+}
+
+static void test_sizes(Type& T) {
+  for (int64_t m : {1, 3, 4, 9, 16, 64}) {
+    for (int64_t k : {1, 5, 8, 16, 32, 33, 64}) {
+      for (int64_t n : {1, 7, 8, 16, 20, 64}) {
+        auto batch1 = at::randn({3, m, k}, T);
+        auto batch2 = at::randn({3, k, n}, T);
+        REQUIRE(at::bmm(batch1, batch2).allclose(bmm_reference(batch1, batch2)));
+      }
+    }
+  }
+}
+
+static void test_strides(Type& T) {
+  auto expected_for = [](const Tensor& batch1, const Tensor& batch2) {
+    return bmm_reference(batch1.contiguous(), batch2.contiguous());
+  };
+  auto batch1 = at::randn({5, 12, 10}, T).transpose(1, 2);
+  auto batch2 = at::randn({5, 17, 12}, T).transpose(1, 2);
+  REQUIRE(at::bmm(batch1, batch2).allclose(expected_for(batch1, batch2)));
+
+  // every other matrix of a larger batch
+  auto strided1 = at::randn({10, 6, 16}, T).slice(0, 0, 10, 2);
+  auto strided2 = at::randn({10, 16, 24}, T).slice(0, 0, 10, 2);
+  REQUIRE(at::bmm(strided1, strided2).allclose(expected_for(strided1, strided2)));
+
+  // a non-contiguous output
+  auto out = at::zeros({5, 17, 10}, T).transpose(1, 2);
+  at::bmm_out(out, batch1, batch2);
+  REQUIRE(out.allclose(expected_for(batch1, batch2)));
+}
+
+static void test_baddbmm(Type& T) {
+  auto batch1 = at::randn({4, 8, 16}, T);
+  auto batch2 = at::randn({4, 16, 12}, T);
+  auto product = bmm_reference(batch1, batch2);
+
+  auto self = at::randn({4, 8, 12}, T);
+  REQUIRE(at::baddbmm(self, batch1, batch2, 0.5, 2).allclose(self * 0.5 + product * 2));
+  REQUIRE(at::baddbmm(self, batch1, batch2).allclose(self + product));
+
+  // self broadcasts to the size of the result
+  auto row = at::randn({12}, T);
+  REQUIRE(at::baddbmm(row, batch1, batch2, 1, 3).allclose(row + product * 3));
+
+  // beta == 0 ignores the values of self, even nans
+  auto nans = at::full({4, 8, 12}, NAN, T);
+  REQUIRE(at::baddbmm(nans, batch1, batch2, 0, 1).allclose(product));
+
+  auto inplace = self.clone();
+  inplace.baddbmm_(batch1, batch2, 2, 0.5);
+  REQUIRE(inplace.allclose(self * 2 + product * 0.5));
+
+  auto out = T.tensor();
+  at::baddbmm_out(out, self, batch1, batch2, 1, -1);
+  REQUIRE(out.allclose(self - product));
+}
+
+TEST_CASE( "bmm small sizes", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_sizes(CPU(kFloat));
+  test_sizes(CPU(kDouble));
+}
+
+TEST_CASE( "bmm strided inputs", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_strides(CPU(kFloat));
+  test_strides(CPU(kDouble));
+}
+
+TEST_CASE( "baddbmm small sizes", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_baddbmm(CPU(kFloat));
+  test_baddbmm(CPU(kDouble));
+}
+
+TEST_CASE( "bmm falls back for large and mismatched inputs", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  auto batch1 = at::randn({2, 65, 70}, CPU(kFloat));
+  auto batch2 = at::randn({2, 70, 3}, CPU(kFloat));
+  REQUIRE(at::bmm(batch1, batch2).allclose(bmm_reference(batch1, batch2)));
+  REQUIRE_THROWS(at::bmm(at::randn({2, 4, 5}, CPU(kFloat)), at::randn({2, 6, 4}, CPU(kFloat))));
+  REQUIRE_THROWS(at::bmm(at::randn({2, 4, 5}, CPU(kFloat)), at::randn({3, 5, 4}, CPU(kFloat))));
+  REQUIRE_THROWS(at::baddbmm(at::randn({3, 4}, CPU(kFloat)),
+                             at::randn({2, 4, 5}, CPU(kFloat)), at::randn({2, 5, 4}, CPU(kFloat))));
+}
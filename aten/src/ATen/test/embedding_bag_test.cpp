@@ -0,0 +1,125 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+#include <vector>
+
+using namespace at;
+
+// The sum and mean modes of embedding_bag and quantized_embedding_bag run on
+// the vectorized kernel in native/cpu/EmbeddingBagKernel.cpp. They are
+// compared against index_select followed by a sum over every bag.
+
+// bags of 0 to 8 random indices, every fifth one empty
+static std::pair<Tensor, Tensor> make_bags(int64_t num_bags, int64_t num_weights) {
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> indices;
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    offsets.push_back(indices.size());
+    int64_t size = bag % 5 == 0 ? 0 : bag % 9;
+    for (int64_t i = 0; i < size; i++) {
+      indices.push_back((bag * 7919 + i * 104729) % num_weights);
+    }
+  }
+  auto offsets_tensor = CPU(kLong).tensor({num_bags});
+  auto indices_tensor = CPU(kLong).tensor({static_cast<int64_t>(indices.size())});
+  std::copy(offsets.begin(), offsets.end(), offsets_tensor.data<int64_t>());
+  std::copy(indices.begin(), indices.end(), indices_tensor.data<int64_t>());
+  return {indices_tensor, offsets_tensor};
+}
+
+static Tensor reference(const Tensor& weight, const Tensor& indices, const Tensor& offsets, bool mean) {
+  int64_t num_bags = offsets.size(0);
+  auto output = at::zeros({num_bags, weight.size(1)}, weight.type());
+  auto offsets_data = offsets.data<int64_t>();
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    int64_t begin = offsets_data[bag];
+    int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : indices.size(0);
+    if (end > begin) {
+      auto rows = weight.index_select(0, indices.slice(0, begin, end));
+      output[bag] = mean ? rows.mean(0) : rows.sum(0);
+    }
+  }
+  return output;
+}
+
+static void test_embedding_bag(Type& T, int64_t dim) {
+  auto weight = at::randn({100, dim}, T);
+  auto bags = make_bags(64, 100);
+  for (int64_t mode : {0, 1}) {
+    auto output = std::get<0>(at::embedding_bag(weight, bags.first, bags.second, false, mode));
+    REQUIRE(output.allclose(reference(weight, bags.first, bags.second, mode == 1)));
+  }
+  // a transposed table is made contiguous first
+  auto weight_t = at::randn({dim, 100}, T).t();
+  auto output = std::get<0>(at::embedding_bag(weight_t, bags.first, bags.second));
+  REQUIRE(output.allclose(reference(weight_t, bags.first, bags.second, false)));
+}
+
+static void test_quantized_embedding_bag(int64_t dim) {
+  auto weight = at::randn({100, dim}, CPU(kFloat));
+  auto bags = make_bags(64, 100);
+
+  auto half_weight = weight.toType(kHalf);
+  auto byte_weight = at::fused8bit_rowwise_quantize(weight);
+  REQUIRE(byte_weight.size(1) == dim + 8);
+  auto dequantized = at::fused8bit_rowwise_dequantize(byte_weight);
+  // one step of 255 over the range of a row
+  auto range = std::get<0>(weight.max(1)) - std::get<0>(weight.min(1));
+  REQUIRE(((dequantized - weight).abs() - range.unsqueeze(1) / 255 * 0.5001).max().toCFloat() <= 0);
+
+  for (int64_t mode : {0, 1}) {
+    bool mean = mode == 1;
+    auto half_output = at::quantized_embedding_bag(half_weight, bags.first, bags.second, mode);
+    REQUIRE(half_output.type().scalarType() == kFloat);
+    REQUIRE(half_output.allclose(reference(half_weight.toType(kFloat), bags.first, bags.second, mean), 1e-5, 1e-5));
+    auto byte_output = at::quantized_embedding_bag(byte_weight, bags.first, bags.second, mode);
+    REQUIRE(byte_output.allclose(reference(dequantized, bags.first, bags.second, mean), 1e-5, 1e-5));
+  }
+}
+
+TEST_CASE( "embedding bag float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  for (int64_t dim : {1, 13, 64, 300}) {
+    test_embedding_bag(CPU(kFloat), dim);
+  }
+}
+
+TEST_CASE( "embedding bag double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  for (int64_t dim : {1, 13, 64, 300}) {
+    test_embedding_bag(CPU(kDouble), dim);
+  }
+}
+
+TEST_CASE( "quantized embedding bag", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  for (int64_t dim : {1, 13, 64, 300}) {
+    test_quantized_embedding_bag(dim);
+  }
+  auto weight = at::randn({10, 4}, CPU(kFloat));
+  auto bags = make_bags(4, 10);
+  // float tables go through embedding_bag
+  REQUIRE_THROWS(at::quantized_embedding_bag(weight, bags.first, bags.second));
+  // max mode is not supported
+  REQUIRE_THROWS(at::quantized_embedding_bag(weight.toType(kHalf), bags.first, bags.second, 2));
+  // out of range indices
+  auto indices = bags.first.clone();
+  indices[0] = 10;
+  REQUIRE_THROWS(at::quantized_embedding_bag(weight.toType(kHalf), indices, bags.second));
+  // negative, decreasing and out of range offsets
+  for (int64_t bad : {-1, 100}) {
+    auto offsets = bags.second.clone();
+    offsets[1] = bad;
+    REQUIRE_THROWS(at::quantized_embedding_bag(weight.toType(kHalf), bags.first, offsets));
+    REQUIRE_THROWS(at::embedding_bag(weight, bags.first, offsets));
+  }
+  // indices before the first offset go to the first bag
+  auto offsets = bags.second.slice(0, 2).clone();  // [1, 3]
+  auto shifted = at::quantized_embedding_bag(weight.toType(kHalf), bags.first, offsets);
+  offsets[0] = 0;
+  auto expected = at::quantized_embedding_bag(weight.toType(kHalf), bags.first, offsets);
+  REQUIRE(shifted.equal(expected));
+}
@@ -0,0 +1,86 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+using namespace at;
+
+// The CPU embedding backward groups equal indices with a parallel radix sort
+// and sums every group once. The dense result is compared against a row by
+// row accumulation, and the sparse result against the dense one.
+
+static Tensor make_indices(int64_t n, int64_t num_weights) {
+  auto indices = CPU(kLong).tensor({n});
+  auto data = indices.data<int64_t>();
+  for (int64_t i = 0; i < n; i++) {
+    // many repeats of the low rows
+    data[i] = i % 3 == 0 ? i % 4 : (i * 7919) % num_weights;
+  }
+  return indices;
+}
+
+static Tensor reference(const Tensor& grad, const Tensor& indices, int64_t num_weights,
+                        int64_t padding_idx, bool scale_grad_by_freq) {
+  auto grad_weight = at::zeros({num_weights, grad.size(1)}, grad.type());
+  auto counts = at::zeros({num_weights}, CPU(kLong));
+  auto data = indices.data<int64_t>();
+  for (int64_t i = 0; i < indices.size(0); i++) {
+    counts.data<int64_t>()[data[i]]++;
+  }
+  for (int64_t i = 0; i < indices.size(0); i++) {
+    if (data[i] != padding_idx) {
+      double scale = scale_grad_by_freq ? 1.0 / counts.data<int64_t>()[data[i]] : 1.0;
+      grad_weight[data[i]].add_(grad[i], scale);
+    }
+  }
+  return grad_weight;
+}
+
+static void test_embedding_backward(Type& T, int64_t n, int64_t dim) {
+  int64_t num_weights = 50;
+  auto indices = make_indices(n, num_weights);
+  auto grad = at::randn({n, dim}, T);
+  for (int64_t padding_idx : {-1, 0}) {
+    for (bool scale_grad_by_freq : {false, true}) {
+      auto expected = reference(grad, indices, num_weights, padding_idx, scale_grad_by_freq);
+      auto dense = at::embedding_backward(grad, indices, num_weights, padding_idx, scale_grad_by_freq, false);
+      REQUIRE(dense.allclose(expected));
+      auto sparse = at::embedding_backward(grad, indices, num_weights, padding_idx, scale_grad_by_freq, true);
+      REQUIRE(sparse.is_coalesced());
+      REQUIRE(sparse.to_dense().allclose(expected));
+      auto index = sparse._indices().contiguous();
+      for (int64_t i = 1; i < index.size(1); i++) {
+        REQUIRE(index.data<int64_t>()[i - 1] < index.data<int64_t>()[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE( "embedding backward float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  for (int64_t n : {1, 40, 5000}) {
+    test_embedding_backward(CPU(kFloat), n, 13);
+  }
+}
+
+TEST_CASE( "embedding backward double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  for (int64_t n : {1, 40, 5000}) {
+    test_embedding_backward(CPU(kDouble), n, 13);
+  }
+}
+
+TEST_CASE( "embedding backward edge cases", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  // every gradient comes from padding_idx
+  auto indices = CPU(kLong).tensor({3}).fill_(2);
+  auto grad = at::randn({3, 4}, CPU(kFloat));
+  auto sparse = at::embedding_backward(grad, indices, 5, 2, false, true);
+  REQUIRE(sparse._nnz() == 0);
+  REQUIRE(sparse.to_dense().equal(at::zeros({5, 4}, CPU(kFloat))));
+  // out of range indices
+  indices[0] = 5;
+  REQUIRE_THROWS(at::embedding_backward(grad, indices, 5, -1, false, false));
+  REQUIRE_THROWS(at::embedding_backward(grad, indices, 5, -1, false, true));
+}
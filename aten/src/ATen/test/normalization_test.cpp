@@ -0,0 +1,150 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "ATen/native/cpu/NormalizationKernel.h"
+#include "test_seed.h"
+
+using namespace at;
+
+// The fused CPU layer_norm and group_norm kernels are compared against the
+// same normalization written with ATen ops, forward and backward. Both
+// normalize groups of contiguous elements: layer_norm the M rows of N
+// elements, group_norm the N * group groups of C / group * HxW elements.
+
+struct Reference {
+  Tensor y, mean, rstd, dx, dgamma, dbeta;
+};
+
+// x and dy are viewed as (groups, -1) for the statistics and as affine_shape
+// for gamma and beta, which are viewed as param_shape.
+static Reference reference(
+    const Tensor& x, const Tensor& dy, const Tensor& gamma, const Tensor& beta,
+    int64_t groups, IntList affine_shape, IntList param_shape, double eps) {
+  auto x_ = x.contiguous().view({groups, -1});
+  auto mean = x_.mean(1, true);
+  auto rstd = ((x_ - mean) * (x_ - mean)).mean(1, true).add(eps).rsqrt();
+  auto x_hat = ((x_ - mean) * rstd).view(affine_shape);
+  auto g = gamma.view(param_shape);
+  auto dy_ = dy.contiguous().view(affine_shape);
+
+  Reference r;
+  r.y = x_hat * g + beta.view(param_shape);
+  r.mean = mean.view(-1);
+  r.rstd = rstd.view(-1);
+  auto g_hat = (dy_ * g).view({groups, -1});
+  auto x_hat_ = x_hat.view({groups, -1});
+  r.dx = rstd * (g_hat - g_hat.mean(1, true) - x_hat_ * (g_hat * x_hat_).mean(1, true));
+  r.dgamma = dy_ * x_hat;
+  r.dbeta = dy_;
+  for (int64_t dim = affine_shape.size() - 1; dim >= 0; dim--) {
+    if (param_shape[dim] == 1) {
+      r.dgamma = r.dgamma.sum(dim, true);
+      r.dbeta = r.dbeta.sum(dim, true);
+    }
+  }
+  r.dgamma = r.dgamma.view(-1);
+  r.dbeta = r.dbeta.view(-1);
+  return r;
+}
+
+static void check(const Tensor& actual, const Tensor& expected, double tol) {
+  REQUIRE(actual.view(-1).allclose(expected.contiguous().view(-1), tol, tol));
+}
+
+static void test_layer_norm(Type& T, int64_t M, int64_t N, double tol) {
+  // an offset mean checks that the variance does not cancel catastrophically
+  auto x = at::randn({M, N}, T) + 10;
+  auto dy = at::randn({M, N}, T);
+  auto gamma = at::randn({N}, T);
+  auto beta = at::randn({N}, T);
+  auto expected = reference(x, dy, gamma, beta, M, {M, N}, {1, N}, 1e-5);
+
+  Tensor y, mean, rstd;
+  std::tie(y, mean, rstd) = at::native_layer_norm(x, gamma, beta, M, N, 1e-5);
+  check(y, expected.y, tol);
+  check(mean, expected.mean, tol);
+  check(rstd, expected.rstd, tol);
+
+  Tensor dx, dgamma, dbeta;
+  std::tie(dx, dgamma, dbeta) = at::native_layer_norm_backward(
+      dy, x, mean, rstd, gamma, M, N, {{true, true, true}});
+  check(dx, expected.dx, tol);
+  check(dgamma, expected.dgamma, tol);
+  check(dbeta, expected.dbeta, tol);
+
+  // the public function, without the affine transform
+  auto ones = at::ones({N}, T);
+  auto zeros = at::zeros({N}, T);
+  auto plain = reference(x, dy, ones, zeros, M, {M, N}, {1, N}, 1e-5);
+  check(at::layer_norm(x.view({M, 1, N}), {1, N}), plain.y, tol);
+  std::tie(dx, dgamma, dbeta) = at::native_layer_norm_backward(
+      dy, x, mean, rstd, Tensor(), M, N, {{true, false, false}});
+  check(dx, plain.dx, tol);
+  REQUIRE(!dgamma.defined());
+  REQUIRE(!dbeta.defined());
+}
+
+static void test_group_norm(Type& T, int64_t N, int64_t C, int64_t HxW, int64_t group, double tol) {
+  auto x = at::randn({N, C, HxW}, T) + 10;
+  auto dy = at::randn({N, C, HxW}, T);
+  auto gamma = at::randn({C}, T);
+  auto beta = at::randn({C}, T);
+  auto expected = reference(x, dy, gamma, beta, N * group, {N, C, HxW}, {1, C, 1}, 1e-5);
+
+  Tensor y, mean, rstd;
+  std::tie(y, mean, rstd) = at::native_group_norm(x, gamma, beta, N, C, HxW, group, 1e-5);
+  check(y, expected.y, tol);
+  check(mean, expected.mean, tol);
+  check(rstd, expected.rstd, tol);
+  check(at::group_norm(x, group, gamma, beta), expected.y, tol);
+
+  Tensor dx, dgamma, dbeta;
+  std::tie(dx, dgamma, dbeta) = at::native_group_norm_backward(
+      dy, x, mean, rstd, gamma, N, C, HxW, group, {{true, true, true}});
+  check(dx, expected.dx, tol);
+  check(dgamma, expected.dgamma, tol);
+  check(dbeta, expected.dbeta, tol);
+}
+
+TEST_CASE( "layer norm float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  // rows shorter than a vector, with a vector remainder, and enough work to
+  // run in parallel
+  test_layer_norm(CPU(kFloat), 5, 3, 1e-4);
+  test_layer_norm(CPU(kFloat), 37, 101, 1e-4);
+  test_layer_norm(CPU(kFloat), 1024, 512, 1e-4);
+}
+
+TEST_CASE( "layer norm double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_layer_norm(CPU(kDouble), 5, 3, 1e-10);
+  test_layer_norm(CPU(kDouble), 37, 101, 1e-10);
+  test_layer_norm(CPU(kDouble), 1024, 512, 1e-10);
+}
+
+TEST_CASE( "group norm float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_group_norm(CPU(kFloat), 2, 6, 1, 3, 1e-4);
+  test_group_norm(CPU(kFloat), 3, 8, 49, 4, 1e-4);
+  test_group_norm(CPU(kFloat), 16, 64, 256, 32, 1e-4);
+}
+
+TEST_CASE( "group norm double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_group_norm(CPU(kDouble), 2, 6, 1, 3, 1e-10);
+  test_group_norm(CPU(kDouble), 3, 8, 49, 4, 1e-10);
+  test_group_norm(CPU(kDouble), 16, 64, 256, 32, 1e-10);
+}
+
+TEST_CASE( "layer norm backward chunks", "[cpu]" ) {
+  // no thread count is set in this test, so at::get_num_threads() is -1
+  // unless the environment sets one; the backward still gives every thread of
+  // the pool a chunk of the rows
+  int64_t threads = internal::get_intraop_num_threads();
+  REQUIRE(native::normalization_row_chunks(5, 3) == 1);
+  REQUIRE(native::normalization_row_chunks(1 << 16, 512) == threads);
+  if (threads > 1) {
+    REQUIRE(native::normalization_row_chunks(1 << 16, 512) > 1);
+  }
+}
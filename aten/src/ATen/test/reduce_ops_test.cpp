@@ -0,0 +1,176 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "ATen/ThreadPool.h"
+#include "ATen/native/cpu/Reduce.h"
+#include "test_seed.h"
+
+#include <thread>
+
+using namespace at;
+
+// The dense CPU reductions run on the kernels in native/cpu/ReduceOpsKernel.cpp;
+// the _th_* functions still run the TH kernels and serve as the reference.
+
+static void require_close(const Tensor& actual, const Tensor& expected) {
+  REQUIRE(actual.is_same_size(expected));
+  if (isIntegralType(expected.type().scalarType())) {
+    REQUIRE(actual.equal(expected));
+  } else {
+    // the kernels and TH sum in different orders
+    REQUIRE(actual.allclose(expected, 1e-4, 1e-5));
+  }
+}
+
+static Tensor th_sum(const Tensor& self, IntList dims, bool keepdim) {
+  Tensor result = self;
+  for (int64_t dim = self.dim() - 1; dim >= 0; dim--) {
+    if (std::find(dims.begin(), dims.end(), dim) != dims.end()) {
+      result = at::_th_sum(result, dim, keepdim);
+    }
+  }
+  return result;
+}
+
+static void test_dim_reductions(const Tensor& a) {
+  for (int64_t dim = 0; dim < a.dim(); dim++) {
+    for (bool keepdim : {false, true}) {
+      require_close(a.sum(dim, keepdim), at::_th_sum(a, dim, keepdim));
+      require_close(a.var(dim, true, keepdim), at::_th_var(a, dim, true, keepdim));
+      require_close(a.std(dim, false, keepdim), at::_th_std(a, dim, false, keepdim));
+      require_close(a.norm(2, dim, keepdim), at::_th_norm(a, 2, dim, keepdim));
+      require_close(a.norm(1.5, dim, keepdim), at::_th_norm(a, 1.5, dim, keepdim));
+      auto max = a.max(dim, keepdim);
+      auto th_max = at::_th_max(a, dim, keepdim);
+      require_close(std::get<0>(max), std::get<0>(th_max));
+      require_close(std::get<1>(max), std::get<1>(th_max));
+      auto min = a.min(dim, keepdim);
+      auto th_min = at::_th_min(a, dim, keepdim);
+      require_close(std::get<0>(min), std::get<0>(th_min));
+      require_close(std::get<1>(min), std::get<1>(th_min));
+    }
+  }
+}
+
+static void test_full_reductions(const Tensor& a) {
+  require_close(a.sum(), a._sumall());
+  require_close(a.var(), at::_th_var(a));
+  require_close(a.std(false), at::_th_std(a, false));
+  require_close(a.max(), at::_th_max(a));
+  require_close(a.min(), at::_th_min(a));
+  for (double p : {0.0, 1.0, 2.0, 3.0, 0.5, double(INFINITY)}) {
+    require_close(a.norm(p), at::th_norm(a, p));
+  }
+}
+
+static void test_reductions(Type& T) {
+  SECTION( "contiguous" ) {
+    test_dim_reductions(randn({5, 7, 3}, T));
+    test_full_reductions(randn({5, 7, 3}, T));
+    test_full_reductions(randn({}, T));
+  }
+
+  SECTION( "non-contiguous" ) {
+    test_dim_reductions(randn({7, 5}, T).t());
+    test_dim_reductions(randn({4, 9, 6}, T).slice(1, 0, 9, 2).permute({2, 0, 1}));
+    test_full_reductions(randn({10, 8}, T).slice(1, 0, 8, 3));
+  }
+
+  SECTION( "large" ) {
+    // large enough to be split between threads, along the reduced dimension
+    // as well as along the outputs
+    test_dim_reductions(randn({3, 100000}, T));
+    test_dim_reductions(randn({100000, 3}, T));
+    test_full_reductions(randn({300, 1001}, T));
+  }
+}
+
+TEST_CASE( "reduce ops float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_reductions(CPU(kFloat));
+}
+
+TEST_CASE( "reduce ops double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_reductions(CPU(kDouble));
+}
+
+TEST_CASE( "reduce ops", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+
+  SECTION( "multiple dimensions" ) {
+    auto a = randn({4, 6, 5, 3}, CPU(kDouble));
+    for (bool keepdim : {false, true}) {
+      require_close(a.sum({0, 2}, keepdim), th_sum(a, {0, 2}, keepdim));
+      require_close(a.sum({1, 2, 3}, keepdim), th_sum(a, {1, 2, 3}, keepdim));
+      require_close(a.sum({-1, 0}, keepdim), th_sum(a, {0, 3}, keepdim));
+      require_close(a.transpose(1, 3).sum({1, 2}, keepdim), th_sum(a.transpose(1, 3), {1, 2}, keepdim));
+    }
+    auto result = a.type().tensor();
+    at::sum_out(result, a, {1, 3});
+    require_close(result, th_sum(a, {1, 3}, false));
+  }
+
+  SECTION( "integral" ) {
+    auto a = (at::rand({33, 17}, CPU(kDouble)) * 100).toType(kLong);
+    test_full_reductions(a.toType(kDouble));
+    require_close(a.sum(), a._sumall());
+    require_close(a.sum(0), at::_th_sum(a, 0));
+    require_close(a.prod(1), at::_th_prod(a, 1));
+    require_close(std::get<1>(a.max(0)), std::get<1>(at::_th_max(a, 0)));
+    require_close(std::get<1>(a.min(1)), std::get<1>(at::_th_min(a, 1)));
+  }
+
+  SECTION( "ties and NaN" ) {
+    // the first of equal values and the first NaN win, like in TH
+    auto a = (at::rand({50, 40}, CPU(kFloat)) * 4).floor();
+    a[3][7] = NAN;
+    a[5][7] = NAN;
+    a[9][2] = NAN;
+    for (int64_t dim = 0; dim < 2; dim++) {
+      auto max = a.max(dim);
+      auto th_max = at::_th_max(a, dim);
+      REQUIRE(std::get<1>(max).equal(std::get<1>(th_max)));
+      auto min = a.min(dim);
+      auto th_min = at::_th_min(a, dim);
+      REQUIRE(std::get<1>(min).equal(std::get<1>(th_min)));
+    }
+    REQUIRE(std::isnan(a.max().toCDouble()));
+  }
+
+  SECTION( "float precision" ) {
+    // pairwise summation keeps the error of large float sums small
+    auto a = at::ones({1 << 24}, CPU(kFloat)).mul_(0.1);
+    double expected = (1 << 24) * double(0.1f);
+    REQUIRE(std::abs(a.sum().toCDouble() - expected) < 1e-5 * expected);
+    REQUIRE(std::abs(a.view({1 << 12, 1 << 12}).sum(0).sum().toCDouble() - expected) < 1e-5 * expected);
+
+    // float norms accumulate in double, so the squares do not overflow
+    auto b = at::randn({100, 70}, CPU(kFloat)).mul_(1e30);
+    REQUIRE(std::isfinite(b.norm(2).toCDouble()));
+    require_close(b.norm(2), at::th_norm(b, 2));
+    require_close(b.norm(2, 0), at::_th_norm(b, 2, 0));
+    require_close(b.norm(2, 1), at::_th_norm(b, 2, 1));
+  }
+}
+
+TEST_CASE( "reduce ops threads", "[cpu]" ) {
+  // no thread count is set in this test, so at::get_num_threads() is -1
+  // unless the environment sets one; reductions still split their work
+  // between the threads of the pool
+  int64_t threads = internal::get_intraop_num_threads();
+  REQUIRE(threads >= 1);
+  if (internal::use_thread_pool() && get_num_threads() <= 0) {
+    REQUIRE(threads == std::max<int64_t>(std::thread::hardware_concurrency(), 1));
+  }
+  // a full sum of 1 << 24 elements is a single tile
+  int64_t numel = 1 << 24;
+  int64_t nslices = native::reduce_slices(1, numel, numel);
+  REQUIRE(nslices == std::min<int64_t>(threads, numel / internal::GRAIN_SIZE));
+  if (threads > 1) {
+    REQUIRE(nslices > 1);
+  }
+  // as many tiles as threads are not split any further
+  REQUIRE(native::reduce_slices(threads, numel, numel) == 1);
+}
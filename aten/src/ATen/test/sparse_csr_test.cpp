@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+using namespace at;
+
+// Sparse CSR matrices are compared against the dense matrices they were made
+// from, and their products against the products of those dense matrices.
+
+// a random matrix with about a fifth of its entries nonzero and with the rows
+// in [rows / 2, rows / 2 + 3) empty
+static Tensor random_sparse_dense(Type& T, int64_t rows, int64_t cols) {
+  auto dense = at::randn({rows, cols}, T);
+  dense.mul_(at::rand({rows, cols}, T).lt(0.2).toType(T));
+  dense.narrow(0, rows / 2, 3).zero_();
+  return dense;
+}
+
+static void test_conversions(Type& T) {
+  auto dense = random_sparse_dense(T, 20, 30);
+  auto csr = dense.to_sparse_csr();
+  REQUIRE(csr.layout() == kSparseCsr);
+  REQUIRE(csr.type().backend() == kSparseCsrCPU);
+  REQUIRE(csr.sizes().equals({20, 30}));
+  REQUIRE(csr._nnz() == dense.ne(0).sum().toCLong());
+  REQUIRE(csr.crow_indices().size(0) == 21);
+  REQUIRE(csr.to_dense().equal(dense));
+
+  auto coo = csr.to_sparse_coo();
+  REQUIRE(coo.is_sparse());
+  REQUIRE(coo.is_coalesced());
+  REQUIRE(coo.to_dense().equal(dense));
+  REQUIRE(coo.to_sparse_csr().to_dense().equal(dense));
+
+  auto rebuilt = at::sparse_csr_tensor(csr.crow_indices(), csr.col_indices(), csr._values(), {20, 30});
+  REQUIRE(rebuilt.to_dense().equal(dense));
+
+  auto empty = at::zeros({4, 5}, T).to_sparse_csr();
+  REQUIRE(empty._nnz() == 0);
+  REQUIRE(empty.to_dense().equal(at::zeros({4, 5}, T)));
+  REQUIRE(empty.to_sparse_coo()._nnz() == 0);
+}
+
+static void test_products(Type& T) {
+  auto dense = random_sparse_dense(T, 40, 30);
+  auto csr = dense.to_sparse_csr();
+  for (int64_t n : {1, 7, 64}) {
+    auto mat2 = at::randn({30, n}, T);
+    REQUIRE(at::mm(csr, mat2).allclose(at::mm(dense, mat2)));
+
+    auto bias = at::randn({n}, T);
+    REQUIRE(at::addmm(bias, csr, mat2, 0.5, 2).allclose(at::addmm(bias, dense, mat2, 0.5, 2)));
+
+    auto result = at::randn({40, n}, T);
+    auto expected = at::addmm(result, dense, mat2, 0, 3);
+    result.addmm_(csr, mat2, 0, 3);
+    REQUIRE(result.allclose(expected));
+
+    // a transposed mat2 is made contiguous first
+    auto mat2_t = at::randn({n, 30}, T).t();
+    REQUIRE(at::mm(csr, mat2_t).allclose(at::mm(dense, mat2_t)));
+  }
+  auto vec = at::randn({30}, T);
+  REQUIRE(at::mv(csr, vec).allclose(at::mv(dense, vec)));
+}
+
+TEST_CASE( "sparse csr conversions", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_conversions(CPU(kFloat));
+  test_conversions(CPU(kDouble));
+}
+
+TEST_CASE( "sparse csr products", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_products(CPU(kFloat));
+  test_products(CPU(kDouble));
+}
+
+TEST_CASE( "sparse csr row slices", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  auto dense = random_sparse_dense(CPU(kFloat), 20, 30);
+  auto csr = dense.to_sparse_csr();
+  for (int64_t start : {0, 5, 10, 19}) {
+    for (int64_t length : {int64_t(1), int64_t(3), 20 - start}) {
+      if (start + length > 20) continue;
+      auto rows = csr.narrow(0, start, length);
+      REQUIRE(rows.layout() == kSparseCsr);
+      REQUIRE(rows.to_dense().equal(dense.narrow(0, start, length)));
+    }
+  }
+  // the empty rows in the middle
+  REQUIRE(csr.narrow(0, 10, 3)._nnz() == 0);
+  auto mat2 = at::randn({30, 4}, CPU(kFloat));
+  REQUIRE(at::mm(csr.narrow(0, 5, 10), mat2).allclose(at::mm(dense.narrow(0, 5, 10), mat2)));
+  // columns cannot be sliced
+  REQUIRE_THROWS(csr.narrow(1, 0, 5));
+}
+
+TEST_CASE( "sparse csr invalid input", "[cpu]" ) {
+  auto values = at::ones({3}, CPU(kFloat));
+  auto crow = CPU(kLong).tensor({3});
+  auto col = CPU(kLong).tensor({3});
+  auto set = [](Tensor t, std::vector<int64_t> v) {
+    std::copy(v.begin(), v.end(), t.data<int64_t>());
+  };
+
+  set(crow, {0, 2, 3});
+  set(col, {0, 2, 1});
+  REQUIRE(at::sparse_csr_tensor(crow, col, values, {2, 3}).to_dense().sum().toCFloat() == 3);
+  // wrong number of rows
+  REQUIRE_THROWS(at::sparse_csr_tensor(crow, col, values, {3, 3}));
+  // last offset is not nnz
+  set(crow, {0, 2, 2});
+  REQUIRE_THROWS(at::sparse_csr_tensor(crow, col, values, {2, 3}));
+  // decreasing offsets
+  set(crow, {0, 3, 2});
+  REQUIRE_THROWS(at::sparse_csr_tensor(crow, col, values, {2, 3}));
+  // column out of range
+  set(crow, {0, 2, 3});
+  set(col, {0, 3, 1});
+  REQUIRE_THROWS(at::sparse_csr_tensor(crow, col, values, {2, 3}));
+  // unsorted columns
+  set(col, {2, 0, 1});
+  REQUIRE_THROWS(at::sparse_csr_tensor(crow, col, values, {2, 3}));
+  // sizes of mm mismatch
+  set(col, {0, 2, 1});
+  auto csr = at::sparse_csr_tensor(crow, col, values, {2, 3});
+  REQUIRE_THROWS(at::mm(csr, at::ones({4, 2}, CPU(kFloat))));
+  REQUIRE_THROWS(at::mm(csr, at::ones({3, 2}, CPU(kDouble))));
+}
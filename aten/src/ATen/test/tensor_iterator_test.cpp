@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+using namespace at;
+
+// The dense CPU pointwise ops run on TensorIterator; the th_* functions still
+// run the TH kernels and serve as the reference.
+
+// TH may use fused multiply-adds, so floating point results are only close.
+static void require_same(const Tensor& actual, const Tensor& expected) {
+  REQUIRE(actual.is_same_size(expected));
+  if (isIntegralType(expected.type().scalarType())) {
+    REQUIRE(actual.equal(expected));
+  } else {
+    REQUIRE(actual.allclose(expected));
+  }
+}
+
+static void test_binary_ops(const Tensor& a, const Tensor& b) {
+  require_same(at::add(a, b, 2), at::th_add(a, b, 2));
+  require_same(at::sub(a, b, 2), at::th_sub(a, b, 2));
+  require_same(at::mul(a, b), at::th_mul(a, b));
+  require_same(at::div(a, b), at::th_div(a, b));
+}
+
+static void test_binary(Type& T) {
+  auto rand = [&](IntList sizes) {
+    // avoid zeros, which integral division would trap on
+    return (at::rand(sizes, CPU(kDouble)) * 100 + 1).toType(T);
+  };
+
+  SECTION( "contiguous" ) {
+    test_binary_ops(rand({5, 7}), rand({5, 7}));
+  }
+
+  SECTION( "broadcast" ) {
+    test_binary_ops(rand({3, 1}), rand({5}));
+    test_binary_ops(rand({64, 33}), rand({33}));
+    test_binary_ops(rand({64, 33}), rand({64, 1}));
+    test_binary_ops(rand({2, 1, 4}), rand({3, 1}));
+  }
+
+  SECTION( "scalar" ) {
+    test_binary_ops(rand({}), rand({4, 3}));
+    test_binary_ops(rand({4, 3}), rand({}));
+    test_binary_ops(rand({}), rand({}));
+  }
+
+  SECTION( "non-contiguous" ) {
+    test_binary_ops(rand({7, 5}).t(), rand({5, 7}));
+    test_binary_ops(rand({10, 8}).slice(1, 0, 8, 3), rand({10, 3}));
+  }
+
+  SECTION( "empty" ) {
+    test_binary_ops(rand({0}), rand({0}));
+  }
+
+  SECTION( "large" ) {
+    // large enough to be split between threads
+    test_binary_ops(rand({300, 301}), rand({301}));
+  }
+
+  SECTION( "in-place" ) {
+    auto a = rand({6, 9}).t();
+    auto b = rand({9, 1});
+    auto expected = at::th_add(a, b, 3);
+    a.add_(b, 3);
+    require_same(a, expected);
+  }
+
+  SECTION( "out" ) {
+    auto a = rand({4, 1});
+    auto b = rand({5});
+    auto result = T.tensor();
+    at::mul_out(result, a, b);
+    require_same(result, at::th_mul(a, b));
+  }
+}
+
+TEST_CASE( "tensor iterator binary ops float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_binary(CPU(kFloat));
+}
+
+TEST_CASE( "tensor iterator binary ops double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_binary(CPU(kDouble));
+}
+
+TEST_CASE( "tensor iterator binary ops long", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_binary(CPU(kLong));
+}
+
+TEST_CASE( "tensor iterator binary ops byte", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_binary(CPU(kByte));
+}
+
+TEST_CASE( "tensor iterator ternary ops", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  Type& T = CPU(kFloat);
+
+  SECTION( "addcmul" ) {
+    auto a = randn({3, 1, 5}, T);
+    auto b = randn({4, 1}, T);
+    auto c = randn({5}, T);
+    require_same(at::addcmul(a, b, c, 0.5), at::th_addcmul(a, b, c, 0.5));
+    auto d = randn({3, 4, 5}, T);
+    auto expected = at::th_addcmul(d, b, c, 2);
+    d.addcmul_(b, c, 2);
+    require_same(d, expected);
+  }
+
+  SECTION( "where" ) {
+    auto cond = randn({6, 1}, T).gt(0);
+    auto a = randn({6, 7}, T);
+    auto b = randn({7}, T);
+    auto c = cond.toType(T);
+    auto expected = at::th_add(at::th_mul(c, a), at::th_mul(at::th_sub(ones_like(c), c), b));
+    require_same(at::where(cond, a, b), expected);
+  }
+}
@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "ATen/ThreadPool.h"
+#include "test_seed.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace at;
+
+// Runs the body with the native pool selected and restores the previous
+// backend afterwards.
+struct ThreadPoolGuard {
+  ThreadPoolGuard() : prev(internal::use_thread_pool()) {
+    internal::set_use_thread_pool(true);
+  }
+  ~ThreadPoolGuard() {
+    internal::set_use_thread_pool(prev);
+  }
+  bool prev;
+};
+
+TEST_CASE( "thread pool parallel_for covers the range once", "[cpu]" ) {
+  ThreadPoolGuard guard;
+  set_num_threads(4);
+  for (int64_t numel : {0, 1, 7, 1000, 100003}) {
+    for (int64_t grain_size : {1, 16, 5000}) {
+      std::vector<std::atomic<int>> hits(numel);
+      for (auto& h : hits) h = 0;
+      std::atomic<int64_t> min_chunk(numel);
+      parallel_for(0, numel, grain_size, [&](int64_t begin, int64_t end) {
+        if (end < numel && end - begin < min_chunk) min_chunk = end - begin;
+        for (int64_t i = begin; i < end; i++) hits[i]++;
+      });
+      for (auto& h : hits) REQUIRE(h == 1);
+      // Only the trailing chunk may be smaller than the grain size.
+      REQUIRE(min_chunk >= std::min(grain_size, numel));
+    }
+  }
+}
+
+TEST_CASE( "thread pool parallel_reduce", "[cpu]" ) {
+  ThreadPoolGuard guard;
+  set_num_threads(4);
+  int64_t numel = 1 << 20;
+  int64_t sum = parallel_reduce(
+      0, numel, 1024, (int64_t)0,
+      [](int64_t begin, int64_t end, int64_t ident) {
+        for (int64_t i = begin; i < end; i++) ident += i;
+        return ident;
+      },
+      std::plus<int64_t>());
+  REQUIRE(sum == numel * (numel - 1) / 2);
+
+  manual_seed(123, at::Backend::CPU);
+  Tensor t = rand({1000, 1000}, CPU(kDouble));
+  internal::set_use_thread_pool(false);
+  Tensor expected = t.sum();
+  internal::set_use_thread_pool(true);
+  REQUIRE(t.sum().allclose(expected));
+}
+
+TEST_CASE( "thread pool nested regions and exceptions", "[cpu]" ) {
+  ThreadPoolGuard guard;
+  set_num_threads(4);
+  std::atomic<int64_t> count(0);
+  parallel_for(0, 100, 1, [&](int64_t begin, int64_t end) {
+    parallel_for(0, 10, 1, [&](int64_t inner_begin, int64_t inner_end) {
+      count += (end - begin) * (inner_end - inner_begin);
+    });
+  });
+  REQUIRE(count == 1000);
+
+  REQUIRE_THROWS_AS(
+      parallel_for(0, 1000, 1, [](int64_t begin, int64_t end) {
+        if (begin <= 500 && 500 < end) throw std::runtime_error("task failed");
+      }),
+      std::runtime_error);
+}
+
+TEST_CASE( "thread pool shared by several threads", "[cpu]" ) {
+  ThreadPoolGuard guard;
+  set_num_threads(4);
+  std::vector<std::thread> threads;
+  std::atomic<int> failures(0);
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int iter = 0; iter < 200; iter++) {
+        std::atomic<int64_t> covered(0);
+        parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+          covered += end - begin;
+        });
+        if (covered != 1000) failures++;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  REQUIRE(failures == 0);
+}
@@ -0,0 +1,113 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ATen/ATen.h"
+#include "test_seed.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace at;
+
+// The dense CPU unary ops run on the vml functions in ATen/cpu/vml.h. Their
+// results are compared against long double libm, which is accurate to well
+// below one ULP of float and double. SLEEF and MKL are within 1 ULP and
+// sigmoid within 2 ULP, so every result must be within 2 ULP.
+
+using ref_fn = long double(*)(long double);
+
+// Error of actual in units in the last place of the correctly rounded result.
+// Results below the normal range have no meaningful relative error and are
+// skipped.
+template <typename scalar_t>
+static double max_ulp_error(const Tensor& actual, const Tensor& input, ref_fn ref) {
+  auto a = actual.accessor<scalar_t, 1>();
+  auto x = input.accessor<scalar_t, 1>();
+  double max_error = 0;
+  for (int64_t i = 0; i < input.size(0); i++) {
+    long double expected = ref(x[i]);
+    auto rounded = static_cast<scalar_t>(expected);
+    if (std::abs(rounded) < std::numeric_limits<scalar_t>::min() || std::isinf(rounded)) {
+      continue;
+    }
+    long double ulp = std::nextafter(std::abs(rounded), std::numeric_limits<scalar_t>::infinity()) - std::abs(rounded);
+    double error = static_cast<double>(std::abs(a[i] - expected) / ulp);
+    max_error = std::max(max_error, error);
+  }
+  return max_error;
+}
+
+// uniform values in [low, high], with a length that leaves a vector remainder
+static Tensor uniform(Type& T, double low, double high) {
+  return at::rand({10007}, T) * (high - low) + low;
+}
+
+static long double sigmoid_ref(long double x) { return 1 / (1 + std::exp(-x)); }
+static long double rsqrt_ref(long double x) { return 1 / std::sqrt(x); }
+
+template <typename scalar_t>
+static void test_accuracy(Type& T) {
+  struct Case { const char* name; Tensor (*op)(const Tensor&); ref_fn ref; double low, high; };
+  Case cases[] = {
+    {"acos", at::acos, [](long double x) { return std::acos(x); }, -1, 1},
+    {"asin", at::asin, [](long double x) { return std::asin(x); }, -1, 1},
+    {"atan", at::atan, [](long double x) { return std::atan(x); }, -100, 100},
+    {"cos", at::cos, [](long double x) { return std::cos(x); }, -10, 10},
+    {"erf", at::erf, [](long double x) { return std::erf(x); }, -4, 4},
+    {"exp", at::exp, [](long double x) { return std::exp(x); }, -80, 80},
+    {"expm1", at::expm1, [](long double x) { return std::expm1(x); }, -10, 10},
+    {"log", at::log, [](long double x) { return std::log(x); }, 1e-6, 1e6},
+    {"log10", at::log10, [](long double x) { return std::log10(x); }, 1e-6, 1e6},
+    {"log1p", at::log1p, [](long double x) { return std::log1p(x); }, -0.9, 100},
+    {"log2", at::log2, [](long double x) { return std::log2(x); }, 1e-6, 1e6},
+    {"rsqrt", at::rsqrt, rsqrt_ref, 1e-3, 1e4},
+    {"sigmoid", at::sigmoid, sigmoid_ref, -20, 20},
+    {"sin", at::sin, [](long double x) { return std::sin(x); }, -10, 10},
+    {"sqrt", at::sqrt, [](long double x) { return std::sqrt(x); }, 0, 1e4},
+    {"tan", at::tan, [](long double x) { return std::tan(x); }, -1.5, 1.5},
+    {"tanh", at::tanh, [](long double x) { return std::tanh(x); }, -10, 10},
+  };
+  for (auto& c : cases) {
+    auto input = uniform(T, c.low, c.high);
+    INFO(c.name);
+    REQUIRE(max_ulp_error<scalar_t>(c.op(input), input, c.ref) <= 2);
+    // the non-contiguous path copies through a buffer
+    auto strided = uniform(T, c.low, c.high).as_strided({5000}, {2});
+    REQUIRE(max_ulp_error<scalar_t>(c.op(strided), strided.contiguous(), c.ref) <= 2);
+  }
+}
+
+TEST_CASE( "unary ops float", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_accuracy<float>(CPU(kFloat));
+}
+
+TEST_CASE( "unary ops double", "[cpu]" ) {
+  manual_seed(123, at::Backend::CPU);
+  test_accuracy<double>(CPU(kDouble));
+}
+
+TEST_CASE( "unary ops special values", "[cpu]" ) {
+  auto x = CPU(kFloat).tensor({5});
+  x[0] = -INFINITY;
+  x[1] = -200;
+  x[2] = 0;
+  x[3] = 200;
+  x[4] = INFINITY;
+  auto sigmoid = at::sigmoid(x);
+  REQUIRE(sigmoid[0].toCFloat() == 0);
+  REQUIRE(sigmoid[1].toCFloat() == 0);
+  REQUIRE(sigmoid[2].toCFloat() == 0.5);
+  REQUIRE(sigmoid[3].toCFloat() == 1);
+  REQUIRE(sigmoid[4].toCFloat() == 1);
+  auto exp = at::exp(x);
+  REQUIRE(exp[0].toCFloat() == 0);
+  REQUIRE(std::isinf(exp[4].toCFloat()));
+  REQUIRE(std::isnan(at::log(-x[4]).toCFloat()));
+
+  // in place on a transposed tensor
+  auto a = at::rand({33, 17}, CPU(kFloat)).t();
+  auto expected = at::sigmoid(a);
+  a.sigmoid_();
+  REQUIRE(a.allclose(expected));
+}
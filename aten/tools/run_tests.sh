@@ -14,6 +14,14 @@ VALGRIND=${VALGRIND:=ON}
 ./apply_utils_test
 ./dlconvertor_test
 ./native_test
+./tensor_iterator_test
+./reduce_ops_test
+./unary_ops_test
+./normalization_test
+./embedding_bag_test
+./embedding_test
+./sparse_csr_test
+./bmm_test
 ./scalar_tensor_test
 ./undefined_tensor_test
 if [[ -x ./cudnn_test ]]; then
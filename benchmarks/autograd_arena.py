@@ -0,0 +1,61 @@
+"""Compares forward + backward time of small-batch training steps with and
+without arena allocation of autograd graph nodes."""
+import argparse
+import timeit
+
+import torch
+
+
+def mlp_step(batch, width, depth):
+    x = torch.randn(batch, width)
+    weights = [torch.randn(width, width, requires_grad=True) for _ in range(depth)]
+
+    def step():
+        h = x
+        for w in weights:
+            h = torch.relu(h.mm(w)) + h
+        h.sum().backward()
+    return step
+
+
+def elementwise_step(length):
+    x = torch.randn(16, requires_grad=True)
+
+    def step():
+        h = x
+        for _ in range(length):
+            h = h * 0.5 + h.sigmoid()
+        h.sum().backward()
+    return step
+
+
+CASES = [
+    ('mlp_b1_w64_d32', lambda: mlp_step(1, 64, 32)),
+    ('mlp_b8_w256_d16', lambda: mlp_step(8, 256, 16)),
+    ('elementwise_1000', lambda: elementwise_step(1000)),
+]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=20)
+    args = parser.parse_args()
+
+    torch.set_num_threads(1)
+    print('{:<20} {:>12} {:>12} {:>8}'.format('case', 'heap (ms)', 'arena (ms)', 'speedup'))
+    for name, build in CASES:
+        step = build()
+        results = []
+        for enabled in (False, True):
+            def run():
+                with torch.autograd.arena_allocation(enabled):
+                    step()
+            times = timeit.repeat(run, repeat=args.repeat, number=args.number)
+            results.append(min(times) / args.number)
+        print('{:<20} {:>12.3f} {:>12.3f} {:>7.2f}x'.format(
+            name, results[0] * 1e3, results[1] * 1e3, results[0] / results[1]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,97 @@
+"""Measures backward wall-clock time for different numbers of autograd CPU
+workers on graphs with independent branches.
+
+The worker count is fixed per process (TORCH_AUTOGRAD_CPU_THREADS), so every
+configuration is timed in a fresh subprocess. Intra-op parallelism is pinned
+to one thread to isolate the effect of the engine.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import timeit
+
+
+def multi_tower(num_towers, depth, width, batch):
+    import torch
+    x = torch.randn(batch, width)
+    weights = [[torch.randn(width, width, requires_grad=True) / width ** 0.5
+                for _ in range(depth)] for _ in range(num_towers)]
+    outputs = []
+    for tower in weights:
+        h = x
+        for w in tower:
+            h = torch.tanh(h.mm(w))
+        outputs.append(h.sum())
+    return sum(outputs)
+
+
+def unrolled_rnn(steps, width, batch):
+    import torch
+    w_ih = torch.randn(width, width, requires_grad=True)
+    w_hh = torch.randn(width, width, requires_grad=True)
+    inputs = [torch.randn(batch, width) for _ in range(steps)]
+    h = torch.zeros(batch, width)
+    loss = 0
+    for x in inputs:
+        # The input projection of every step is independent of the recurrence.
+        h = torch.tanh(x.mm(w_ih).sigmoid().mm(w_ih) + h.mm(w_hh))
+        loss = loss + h.sum()
+    return loss
+
+
+CASES = [
+    ('towers_8x16_w256', lambda: multi_tower(8, 16, 256, 32)),
+    ('towers_32x4_w64', lambda: multi_tower(32, 4, 64, 16)),
+    ('chain_1x64_w256', lambda: multi_tower(1, 64, 256, 32)),
+    ('rnn_64_steps_w256', lambda: unrolled_rnn(64, 256, 32)),
+]
+
+
+def run_cases(repeat, number):
+    for name, build in CASES:
+        loss = build()
+        times = timeit.repeat(lambda: loss.backward(retain_graph=True),
+                              repeat=repeat, number=number)
+        print('{} {:.6f}'.format(name, min(times) / number))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 2, 4, 8])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=10)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        import torch
+        torch.set_num_threads(1)
+        run_cases(args.repeat, args.number)
+        return
+
+    results = {}
+    for threads in args.threads:
+        env = dict(os.environ)
+        env['TORCH_AUTOGRAD_CPU_THREADS'] = str(threads)
+        output = subprocess.check_output(
+            [sys.executable, __file__, '--worker',
+             '--repeat', str(args.repeat), '--number', str(args.number)],
+            env=env)
+        for line in output.decode().splitlines():
+            name, seconds = line.split()
+            results.setdefault(name, {})[threads] = float(seconds)
+
+    print('{:<20} {:>7} {:>14} {:>8}'.format(
+        'case', 'workers', 'backward (ms)', 'speedup'))
+    for name, _ in CASES:
+        baseline = results[name][args.threads[0]]
+        for threads in args.threads:
+            seconds = results[name][threads]
+            print('{:<20} {:>7} {:>14.3f} {:>7.2f}x'.format(
+                name, threads, seconds * 1e3, baseline / seconds))
+
+
+if __name__ == '__main__':
+    main()
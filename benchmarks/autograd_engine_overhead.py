@@ -0,0 +1,46 @@
+"""Measures the per-node overhead of the autograd engine.
+
+Builds long chains (and a wide fan-in) of backward nodes that do almost no
+work, so the backward time is dominated by the engine itself: ready queue
+pushes and pops, dependency bookkeeping and input buffers.
+"""
+import argparse
+import timeit
+
+import torch
+
+
+def chain(length):
+    x = torch.zeros(1, requires_grad=True)
+    y = x
+    for _ in range(length):
+        y = y * 1
+    return y.sum(), length + 1
+
+
+def fan_in(width):
+    xs = [torch.zeros(1, requires_grad=True) for _ in range(width)]
+    return torch.stack([x * 1 for x in xs]).sum(), 2 * width + 2
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--length', type=int, default=10000)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=10)
+    args = parser.parse_args()
+
+    torch.set_num_threads(1)
+    print('{:<12} {:>8} {:>14} {:>12}'.format(
+        'graph', 'nodes', 'backward (ms)', 'ns / node'))
+    for name, build in (('chain', chain), ('fan_in', fan_in)):
+        loss, nodes = build(args.length)
+        times = timeit.repeat(lambda: loss.backward(retain_graph=True),
+                              repeat=args.repeat, number=args.number)
+        seconds = min(times) / args.number
+        print('{:<12} {:>8} {:>14.3f} {:>12.1f}'.format(
+            name, nodes, seconds * 1e3, seconds * 1e9 / nodes))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,60 @@
+"""Compares pointwise binary ops on TensorIterator with the TH kernels.
+
+Dense CPU add/sub/mul/div/addcmul run on the native TensorIterator kernels,
+while torch.th_* still call the TH implementations, so both can be timed in
+the same process. The shapes focus on broadcasts, where TH walks expanded
+(stride 0) inputs with its generic apply loops.
+"""
+import argparse
+import timeit
+
+# (name, setup, native statement, TH statement)
+CASES = [
+    ('add_contig_1M', 'a = torch.rand(1024, 1024); b = torch.rand(1024, 1024)',
+     'torch.add(a, b)', 'torch.th_add(a, b)'),
+    ('add_bias_row', 'a = torch.rand(1024, 1024); b = torch.rand(1024)',
+     'torch.add(a, b)', 'torch.th_add(a, b)'),
+    ('add_bias_col', 'a = torch.rand(1024, 1024); b = torch.rand(1024, 1)',
+     'torch.add(a, b)', 'torch.th_add(a, b)'),
+    ('add_outer', 'a = torch.rand(1024, 1); b = torch.rand(1024)',
+     'torch.add(a, b)', 'torch.th_add(a, b)'),
+    ('sub_scalar_tensor', 'a = torch.rand(1024, 1024); b = torch.rand([])',
+     'torch.sub(a, b)', 'torch.th_sub(a, b)'),
+    ('mul_nchw_channel', 'a = torch.rand(32, 64, 28, 28); b = torch.rand(64, 1, 1)',
+     'torch.mul(a, b)', 'torch.th_mul(a, b)'),
+    ('mul_transposed', 'a = torch.rand(1024, 1024).t(); b = torch.rand(1024, 1024)',
+     'torch.mul(a, b)', 'torch.th_mul(a, b)'),
+    ('div_bias_row', 'a = torch.rand(1024, 1024); b = torch.rand(1024) + 1',
+     'torch.div(a, b)', 'torch.th_div(a, b)'),
+    ('addcmul_bias', 'a = torch.rand(1024, 1024); b = torch.rand(1024); c = torch.rand(1024, 1)',
+     'torch.addcmul(a, b, c, value=0.5)', 'torch.th_addcmul(a, b, c, value=0.5)'),
+    ('add_small', 'a = torch.rand(64, 64); b = torch.rand(64)',
+     'torch.add(a, b)', 'torch.th_add(a, b)'),
+]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--threads', type=int, default=None,
+                        help='intra-op threads (default: library default)')
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=20)
+    args = parser.parse_args()
+
+    import torch
+    if args.threads is not None:
+        torch.set_num_threads(args.threads)
+
+    print('{:<20} {:>12} {:>12} {:>8}'.format('case', 'TH (ms)', 'native (ms)', 'speedup'))
+    for name, setup, native, th in CASES:
+        results = []
+        for stmt in (th, native):
+            times = timeit.repeat(stmt, setup='import torch; ' + setup,
+                                  repeat=args.repeat, number=args.number)
+            results.append(min(times) / args.number * 1000)
+        print('{:<20} {:>12.3f} {:>12.3f} {:>8.2f}'.format(
+            name, results[0], results[1], results[0] / results[1]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,61 @@
+"""Time a training loop is blocked by saving checkpoints.
+
+Compares torch.save, which pickles the state dict and writes every storage
+before returning, against torch.serialization.AsyncCheckpointWriter, which
+returns once the storages are copied to its staging buffer and writes them on
+a background thread. The time to the end of the write (future.wait()) is
+printed as well; it is about the same for both, since the disk is the limit.
+"""
+import argparse
+import os
+import shutil
+import tempfile
+import time
+
+import torch
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--size', type=float, default=1.0,
+                        help='total size of the tensors in GB')
+    parser.add_argument('--tensors', type=int, default=64)
+    parser.add_argument('--staging', type=int, default=256,
+                        help='size of the staging buffer in MB')
+    parser.add_argument('--no-fsync', dest='fsync', action='store_false')
+    parser.add_argument('--cuda', action='store_true')
+    args = parser.parse_args()
+
+    numel = int(args.size * 1e9 / 4 / args.tensors)
+    device = 'cuda' if args.cuda else 'cpu'
+    state = {'weight{}'.format(i): torch.randn(numel, device=device) for i in range(args.tensors)}
+    writer = torch.serialization.AsyncCheckpointWriter(staging_bytes=args.staging << 20)
+
+    d = tempfile.mkdtemp()
+    try:
+        path = os.path.join(d, 'checkpoint.pt')
+
+        def save():
+            with open(path, 'wb') as f:
+                torch.save(state, f, layout='aligned')
+                if args.fsync:
+                    f.flush()
+                    os.fsync(f.fileno())
+
+        def save_async():
+            return writer.save(state, path, fsync=args.fsync)
+
+        print('{:<10} {:>12} {:>12}'.format('save', 'blocked (s)', 'written (s)'))
+        for name, run in (('torch.save', save), ('async', save_async)):
+            start = time.time()
+            future = run()
+            blocked = time.time() - start
+            if future is not None:
+                future.wait()
+            print('{:<10} {:>12.2f} {:>12.2f}'.format(name, blocked, time.time() - start))
+    finally:
+        shutil.rmtree(d)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,45 @@
+"""Backward time of nn.Embedding with dense and sparse gradients.
+
+The CPU backward groups equal indices with a parallel radix sort
+(aten/src/ATen/native/IndexGrouping.cpp) and sums the gradient rows of every
+distinct index once, in parallel over the indices. The sparse gradient is
+returned coalesced, so the optimizer step does not sort it again. Indices are
+drawn from a Zipf-like distribution to get the repeats of real workloads. The
+table shows the time of the backward plus the coalesce in milliseconds.
+"""
+import argparse
+import timeit
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--rows', type=int, default=1000000)
+    parser.add_argument('--dim', type=int, default=64)
+    parser.add_argument('--indices', type=int, default=200000)
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 4, 16])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=10)
+    args = parser.parse_args()
+
+    import torch
+    ranks = torch.rand(args.indices).pow(4)
+    indices = (ranks * args.rows).long().clamp(max=args.rows - 1)
+    grad = torch.randn(args.indices, args.dim)
+
+    print(('{:<8}' + ' {:>10}' * len(args.threads)).format(
+        'grad', *['{} thr'.format(t) for t in args.threads]))
+    for sparse in [False, True]:
+        def step():
+            g = torch.embedding_backward(grad, indices, args.rows, -1, False, sparse)
+            return g.coalesce() if sparse else g
+        row = []
+        for threads in args.threads:
+            torch.set_num_threads(threads)
+            times = timeit.repeat(step, repeat=args.repeat, number=args.number)
+            row.append(min(times) / args.number * 1000)
+        print(('{:<8}' + ' {:>10.3f}' * len(row)).format(
+            'sparse' if sparse else 'dense', *row))
+
+
+if __name__ == '__main__':
+    main()
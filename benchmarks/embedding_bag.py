@@ -0,0 +1,48 @@
+"""Lookup throughput of embedding_bag on float, fp16 and 8-bit tables.
+
+The sum and mean modes of torch.embedding_bag and
+torch.quantized_embedding_bag run on the kernel in
+aten/src/ATen/native/cpu/EmbeddingBagKernel.cpp, in parallel over the bags.
+The table is larger than the caches, so lookups are bound by memory bandwidth
+and the smaller fp16 and fused 8-bit row-wise tables read 2x and ~4x fewer
+bytes per row. The table shows the time per batch in milliseconds.
+"""
+import argparse
+import timeit
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--rows', type=int, default=4000000)
+    parser.add_argument('--dim', type=int, default=64)
+    parser.add_argument('--bags', type=int, default=2048)
+    parser.add_argument('--bag-size', type=int, default=40)
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 4, 16])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=10)
+    args = parser.parse_args()
+
+    import torch
+    weight = torch.randn(args.rows, args.dim)
+    tables = [
+        ('float', weight, lambda w, i, o: torch.embedding_bag(w, i, o)[0]),
+        ('fp16', weight.half(), torch.quantized_embedding_bag),
+        ('8-bit', torch.fused8bit_rowwise_quantize(weight), torch.quantized_embedding_bag),
+    ]
+    indices = torch.randint(0, args.rows, (args.bags * args.bag_size,), dtype=torch.long)
+    offsets = torch.arange(0, args.bags * args.bag_size, args.bag_size, dtype=torch.long)
+
+    print(('{:<8}' + ' {:>10}' * len(args.threads)).format(
+        'table', *['{} thr'.format(t) for t in args.threads]))
+    for name, table, fn in tables:
+        row = []
+        for threads in args.threads:
+            torch.set_num_threads(threads)
+            times = timeit.repeat(lambda: fn(table, indices, offsets),
+                                  repeat=args.repeat, number=args.number)
+            row.append(min(times) / args.number * 1000)
+        print(('{:<8}' + ' {:>10.3f}' * len(row)).format(name, *row))
+
+
+if __name__ == '__main__':
+    main()
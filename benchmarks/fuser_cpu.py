@@ -0,0 +1,108 @@
+"""Compares the CPU backends of the JIT fusion compiler: the in-process
+bytecode backend and the system compiler (PYTORCH_FUSION_CPU_BACKEND=cxx).
+
+For every fused function, reports the latency of the first call, which
+includes compiling the fusion group, and the steady-state time per call.
+The backend is fixed per process, so each one is timed in a fresh subprocess.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import time
+import timeit
+
+
+def lstm_cell(x, hx, cx, w_ih, w_hh):
+    import torch
+    gates = x.mm(w_ih.t()) + hx.mm(w_hh.t())
+    ingate, forgetgate, cellgate, outgate = gates.chunk(4, 1)
+    ingate = torch.sigmoid(ingate)
+    forgetgate = torch.sigmoid(forgetgate)
+    cellgate = torch.tanh(cellgate)
+    outgate = torch.sigmoid(outgate)
+    cy = (forgetgate * cx) + (ingate * cellgate)
+    hy = outgate * torch.tanh(cy)
+    return hy, cy
+
+
+def pointwise(x, y):
+    import torch
+    z = (x + .5 * y).clamp(min=-3, max=3)
+    return torch.sigmoid(z) * torch.tanh(x) + z * z - y
+
+
+def lstm_inputs(batch, hidden):
+    import torch
+    return (torch.randn(batch, hidden), torch.randn(batch, hidden),
+            torch.randn(batch, hidden), torch.randn(4 * hidden, hidden),
+            torch.randn(4 * hidden, hidden))
+
+
+def pointwise_inputs(numel, transposed):
+    import torch
+    side = int(numel ** 0.5)
+    x = torch.randn(side, side)
+    y = torch.randn(side, side)
+    if transposed:
+        y = y.t()
+    return x, y
+
+
+CASES = [
+    ('lstm_b64_h256', lstm_cell, lambda: lstm_inputs(64, 256)),
+    ('lstm_b8_h1024', lstm_cell, lambda: lstm_inputs(8, 1024)),
+    ('pointwise_64k', pointwise, lambda: pointwise_inputs(1 << 16, False)),
+    ('pointwise_4m', pointwise, lambda: pointwise_inputs(1 << 22, False)),
+    ('pointwise_4m_strided', pointwise, lambda: pointwise_inputs(1 << 22, True)),
+]
+
+
+def run_cases(repeat, number):
+    import torch
+    for name, fn, make_inputs in CASES:
+        inputs = make_inputs()
+        traced = torch.jit.trace(*inputs)(fn)
+        start = time.time()
+        traced(*inputs)
+        first = time.time() - start
+        times = timeit.repeat(lambda: traced(*inputs), repeat=repeat, number=number)
+        print('{} {:.6f} {:.6f}'.format(name, first, min(times) / number))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--backends', nargs='+', default=['bytecode', 'cxx'])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=20)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_cases(args.repeat, args.number)
+        return
+
+    results = {}
+    for backend in args.backends:
+        env = dict(os.environ)
+        env['PYTORCH_FUSION_CPU_BACKEND'] = backend
+        output = subprocess.check_output(
+            [sys.executable, __file__, '--worker',
+             '--repeat', str(args.repeat), '--number', str(args.number)],
+            env=env)
+        for line in output.decode().splitlines():
+            name, first, steady = line.split()
+            results.setdefault(name, {})[backend] = (float(first), float(steady))
+
+    print('{:<22} {:>9} {:>16} {:>14}'.format(
+        'case', 'backend', 'first call (ms)', 'per call (us)'))
+    for name, _, _ in CASES:
+        for backend in args.backends:
+            first, steady = results[name][backend]
+            print('{:<22} {:>9} {:>16.1f} {:>14.1f}'.format(
+                name, backend, first * 1e3, steady * 1e6))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,72 @@
+"""Measures the throughput of one traced function called from many threads.
+
+Serving code often shares a single graph executor between request threads.
+Every call looks up the compiled plan for its input shapes, so this benchmark
+shows whether that lookup, and the interpreter behind it, lets throughput
+scale with the number of threads. Each thread runs small batches on one
+intra-op thread, so the work per call is small and any serialization in the
+executor shows up directly.
+"""
+import argparse
+import threading
+import time
+
+import torch
+import torch.nn as nn
+
+
+def mlp(width, depth):
+    layers = []
+    for _ in range(depth):
+        layers += [nn.Linear(width, width), nn.ReLU()]
+    model = nn.Sequential(*layers)
+    x = torch.randn(1, width)
+    return torch.jit.trace(x)(model), (x,)
+
+
+def run_threads(fn, inputs, num_threads, calls):
+    go = threading.Event()
+
+    def worker():
+        go.wait()
+        with torch.no_grad():
+            for _ in range(calls):
+                fn(*inputs)
+
+    threads = [threading.Thread(target=worker) for _ in range(num_threads)]
+    for t in threads:
+        t.start()
+    start = time.time()
+    go.set()
+    for t in threads:
+        t.join()
+    return time.time() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--width', type=int, default=64)
+    parser.add_argument('--depth', type=int, default=4)
+    parser.add_argument('--calls', type=int, default=2000,
+                        help='calls per thread')
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 2, 4, 8])
+    parser.add_argument('--repeat', type=int, default=3)
+    args = parser.parse_args()
+
+    torch.set_num_threads(1)
+    fn, inputs = mlp(args.width, args.depth)
+    with torch.no_grad():
+        fn(*inputs)  # optimize and compile before timing
+
+    print('{:>8} {:>16} {:>10}'.format('threads', 'calls/s', 'speedup'))
+    base = None
+    for num_threads in args.threads:
+        elapsed = min(run_threads(fn, inputs, num_threads, args.calls)
+                      for _ in range(args.repeat))
+        rate = num_threads * args.calls / elapsed
+        base = base or rate
+        print('{:>8} {:>16.0f} {:>10.2f}'.format(num_threads, rate, rate / base))
+
+
+if __name__ == '__main__':
+    main()
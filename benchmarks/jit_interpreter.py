@@ -0,0 +1,56 @@
+"""Measures the per-call overhead of the JIT interpreter at batch size 1.
+
+Runs traced and scripted functions whose operators do almost no work, so the
+time per call is dominated by the interpreter and the graph executor: setting
+up register frames, moving values between registers and the stack, and
+dispatching instructions.
+"""
+import argparse
+import timeit
+
+import torch
+import torch.nn as nn
+
+
+def mlp(width, depth):
+    layers = []
+    for _ in range(depth):
+        layers += [nn.Linear(width, width), nn.ReLU()]
+    model = nn.Sequential(*layers)
+    x = torch.randn(1, width)
+    return torch.jit.trace(x)(model), (x,)
+
+
+def pointwise_chain(width, depth):
+    def f(x, y):
+        for _ in range(depth):
+            x = (x * y + 1).tanh()
+        return x
+
+    x = torch.randn(1, width)
+    y = torch.randn(1, width)
+    return torch.jit.trace(x, y)(f), (x, y)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--width', type=int, default=16)
+    parser.add_argument('--depth', type=int, default=32)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=2000)
+    args = parser.parse_args()
+
+    torch.set_num_threads(1)
+    print('{:<16} {:>8} {:>16}'.format('model', 'depth', 'per call (us)'))
+    with torch.no_grad():
+        for name, build in (('mlp', mlp), ('pointwise_chain', pointwise_chain)):
+            fn, inputs = build(args.width, args.depth)
+            fn(*inputs)  # optimize and compile before timing
+            times = timeit.repeat(lambda: fn(*inputs),
+                                  repeat=args.repeat, number=args.number)
+            print('{:<16} {:>8} {:>16.2f}'.format(
+                name, args.depth, min(times) / args.number * 1e6))
+
+
+if __name__ == '__main__':
+    main()
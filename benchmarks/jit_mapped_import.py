@@ -0,0 +1,70 @@
+"""Time to import an exported model with large weights.
+
+Compares torch._C._jit_import_graph on a protobuf with the weights inline,
+which decodes and copies every weight, against
+torch._C._jit_import_mapped_graph on a mapped model file, which maps the file
+and makes the weights views of it (torch/csrc/jit/mapped_model.h). The first
+run of each reads the file from the page cache; the mapped import only touches
+the pages of the weights when they are used.
+"""
+import argparse
+import os
+import shutil
+import tempfile
+import time
+
+import torch
+from torch.onnx import OperatorExportTypes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--width', type=int, default=4096)
+    parser.add_argument('--depth', type=int, default=8)
+    parser.add_argument('--repeat', type=int, default=5)
+    args = parser.parse_args()
+
+    def f(x, *weights):
+        for w in weights:
+            x = x.mm(w)
+        return x
+
+    x = torch.randn(1, args.width)
+    weights = [torch.randn(args.width, args.width) for _ in range(args.depth)]
+    trace, _ = torch.jit.get_trace_graph(f, (x,) + tuple(weights))
+    graph = trace.graph()
+    nbytes = sum(w.numel() * w.element_size() for w in weights)
+    print('{} weights, {:.1f} MB'.format(len(weights), nbytes / 1e6))
+
+    d = tempfile.mkdtemp()
+    try:
+        proto_path = os.path.join(d, 'model.pb')
+        mapped_path = os.path.join(d, 'model.mapped')
+        proto, _ = graph.export(weights, onnx_opset_version=0, defer_weight_export=False,
+                                operator_export_type=OperatorExportTypes.RAW)
+        with open(proto_path, 'wb') as out:
+            out.write(proto)
+        graph.export_mapped(mapped_path, weights, onnx_opset_version=0,
+                            operator_export_type=OperatorExportTypes.RAW)
+
+        def load_proto():
+            with open(proto_path, 'rb') as f:
+                return torch._C._jit_import_graph(f.read())
+
+        def load_mapped():
+            return torch._C._jit_import_mapped_graph(mapped_path)
+
+        print('{:<10} {:>12}'.format('format', 'import (ms)'))
+        for name, load in (('protobuf', load_proto), ('mapped', load_mapped)):
+            load()
+            start = time.time()
+            for _ in range(args.repeat):
+                load()
+            elapsed = (time.time() - start) / args.repeat
+            print('{:<10} {:>12.2f}'.format(name, elapsed * 1e3))
+    finally:
+        shutil.rmtree(d)
+
+
+if __name__ == '__main__':
+    main()
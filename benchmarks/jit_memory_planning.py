@@ -0,0 +1,68 @@
+"""Time per call of traced models with and without JIT memory planning.
+
+The execution plans of the graph executor place the intermediate results of
+ops that have an _out variant in one preallocated arena, so that steady state
+inference does not allocate them (torch/csrc/jit/memory_planning.h). Each
+configuration runs in a subprocess, since memory planning is turned off with
+the PYTORCH_JIT_MEMORY_PLANNING=0 environment variable, read at startup.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import timeit
+
+
+def mlp(batch, width, depth):
+    import torch
+    import torch.nn as nn
+    layers = []
+    for _ in range(depth):
+        layers += [nn.Linear(width, width), nn.Tanh()]
+    model = nn.Sequential(*layers)
+    x = torch.randn(batch, width)
+    return torch.jit.trace(x)(model), (x,)
+
+
+def run(args):
+    import torch
+    torch.set_num_threads(args.threads)
+    with torch.no_grad():
+        for batch in args.batch:
+            fn, inputs = mlp(batch, args.width, args.depth)
+            fn(*inputs)  # optimize and compile before timing
+            times = timeit.repeat(lambda: fn(*inputs),
+                                  repeat=args.repeat, number=args.number)
+            print('{} {}'.format(batch, min(times) / args.number * 1e6))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--batch', type=int, nargs='+', default=[1, 16, 256])
+    parser.add_argument('--width', type=int, default=256)
+    parser.add_argument('--depth', type=int, default=8)
+    parser.add_argument('--threads', type=int, default=1)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=200)
+    parser.add_argument('--child', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        run(args)
+        return
+
+    results = {}
+    for planning in ('1', '0'):
+        env = dict(os.environ, PYTORCH_JIT_MEMORY_PLANNING=planning)
+        out = subprocess.check_output([sys.executable, __file__, '--child'] + sys.argv[1:], env=env)
+        for line in out.decode().splitlines():
+            batch, us = line.split()
+            results.setdefault(int(batch), {})[planning] = float(us)
+
+    print('{:<8} {:>16} {:>16}'.format('batch', 'planned (us)', 'unplanned (us)'))
+    for batch in args.batch:
+        print('{:<8} {:>16.2f} {:>16.2f}'.format(batch, results[batch]['1'], results[batch]['0']))
+
+
+if __name__ == '__main__':
+    main()
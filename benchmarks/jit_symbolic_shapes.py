@@ -0,0 +1,74 @@
+"""Time of a traced model called on batches of many different sizes.
+
+Without symbolic shapes, the graph executor optimizes and compiles a new
+execution plan, and new fused kernels, for every batch size it sees. With
+them, the second batch size compiles one plan in which the batch size is
+symbolic, and the later sizes reuse it (torch/csrc/jit/passes/shape_analysis.h).
+Each configuration runs in a subprocess, since symbolic shapes are turned off
+with the PYTORCH_JIT_SYMBOLIC_SHAPES=0 environment variable, read at startup.
+"""
+import argparse
+import os
+import random
+import subprocess
+import sys
+import time
+
+
+def mlp(width, depth):
+    import torch
+    import torch.nn as nn
+    layers = []
+    for _ in range(depth):
+        layers += [nn.Linear(width, width), nn.Sigmoid()]
+    model = nn.Sequential(*layers)
+    return torch.jit.trace(torch.randn(2, width))(model)
+
+
+def run(args):
+    import torch
+    torch.set_num_threads(args.threads)
+    random.seed(0)
+    batches = random.sample(range(2, args.max_batch + 1), args.sizes)
+    with torch.no_grad():
+        fn = mlp(args.width, args.depth)
+        inputs = [torch.randn(batch, args.width) for batch in batches]
+        start = time.time()
+        for x in inputs:
+            fn(x)
+        first = time.time() - start
+        start = time.time()
+        for _ in range(args.repeat):
+            for x in inputs:
+                fn(x)
+        steady = (time.time() - start) / args.repeat
+    print('{} {}'.format(first * 1e3, steady * 1e3))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--sizes', type=int, default=64,
+                        help='number of distinct batch sizes')
+    parser.add_argument('--max-batch', type=int, default=512)
+    parser.add_argument('--width', type=int, default=256)
+    parser.add_argument('--depth', type=int, default=4)
+    parser.add_argument('--threads', type=int, default=1)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--child', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        run(args)
+        return
+
+    print('{} batch sizes in [2, {}]'.format(args.sizes, args.max_batch))
+    print('{:<10} {:>18} {:>18}'.format('symbolic', 'first pass (ms)', 'later passes (ms)'))
+    for symbolic in ('1', '0'):
+        env = dict(os.environ, PYTORCH_JIT_SYMBOLIC_SHAPES=symbolic)
+        out = subprocess.check_output([sys.executable, __file__, '--child'] + sys.argv[1:], env=env)
+        first, steady = map(float, out.decode().split())
+        print('{:<10} {:>18.2f} {:>18.2f}'.format('on' if symbolic == '1' else 'off', first, steady))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,74 @@
+"""Compares the fused CPU layer_norm and group_norm with the batch_norm path.
+
+On dense CPU tensors torch.layer_norm and torch.group_norm run the fused
+kernels in aten/src/ATen/native/cpu/NormalizationKernel.cpp. The composite
+they replaced (reshape, batch_norm, affine) is rebuilt here from public ops,
+so both can be timed in the same process, forward only and forward+backward.
+"""
+import argparse
+import timeit
+
+# (name, input shape, layer_norm normalized_shape or group_norm num_groups)
+CASES = [
+    ('ln_bert_base', (32 * 128, 768), (768,)),
+    ('ln_bert_large', (16 * 128, 1024), (1024,)),
+    ('ln_small_rows', (64, 64), (64,)),
+    ('gn_resnet_c64', (32, 64, 56, 56), 32),
+    ('gn_resnet_c256', (32, 256, 14, 14), 32),
+]
+
+SETUP = '''
+import torch
+import torch.nn.functional as F
+x = torch.randn({shape}, requires_grad={grad})
+arg = {arg}
+is_ln = isinstance(arg, tuple)
+c = arg[-1] if is_ln else x.size(1)
+w = torch.randn(c, requires_grad={grad})
+b = torch.randn(c, requires_grad={grad})
+
+def composite():
+    if is_ln:
+        n = x.numel() // c
+        out = F.batch_norm(x.contiguous().view(1, n, -1), None, None, training=True)
+        return torch.addcmul(b, 1, out.view(x.size()), w)
+    out = F.batch_norm(x.contiguous().view(1, x.size(0) * arg, -1), None, None, training=True)
+    shape = [1, c] + [1] * (x.dim() - 2)
+    return torch.addcmul(b.view(shape), 1, out.view(x.size()), w.view(shape))
+
+def fused():
+    if is_ln:
+        return F.layer_norm(x, arg, w, b)
+    return F.group_norm(x, arg, w, b)
+'''
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--threads', type=int, default=None,
+                        help='intra-op threads (default: library default)')
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=10)
+    args = parser.parse_args()
+
+    import torch
+    if args.threads is not None:
+        torch.set_num_threads(args.threads)
+
+    print('{:<16} {:<9} {:>15} {:>11} {:>8}'.format(
+        'case', 'pass', 'composite (ms)', 'fused (ms)', 'speedup'))
+    for name, shape, arg in CASES:
+        for pass_name, grad, stmt in (('forward', False, '{}()'),
+                                      ('backward', True, '{}().sum().backward()')):
+            setup = SETUP.format(shape=shape, arg=arg, grad=grad)
+            results = []
+            for fn in ('composite', 'fused'):
+                times = timeit.repeat(stmt.format(fn), setup=setup,
+                                      repeat=args.repeat, number=args.number)
+                results.append(min(times) / args.number * 1000)
+            print('{:<16} {:<9} {:>15.3f} {:>11.3f} {:>8.2f}'.format(
+                name, pass_name, results[0], results[1], results[0] / results[1]))
+
+
+if __name__ == '__main__':
+    main()
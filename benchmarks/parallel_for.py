@@ -0,0 +1,72 @@
+"""Compares the OpenMP and native thread pool backends of at::parallel_for.
+
+The backend is chosen once per process through the ATEN_THREAD_POOL
+environment variable, so every configuration is timed in a fresh subprocess.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import timeit
+
+# (name, setup, statement). The shapes cover both large, evenly divisible
+# work and ranges barely above the grain size, where fork/join cost dominates.
+CASES = [
+    ('sum_all_64M', 'x = torch.rand(1 << 26)', 'x.sum()'),
+    ('sum_all_64K', 'x = torch.rand(1 << 16)', 'x.sum()'),
+    ('sum_dim0_4Kx4K', 'x = torch.rand(4096, 4096)', 'x.sum(0)'),
+    ('sum_dim1_4Kx4K', 'x = torch.rand(4096, 4096)', 'x.sum(1)'),
+    ('sum_dim1_64x100K', 'x = torch.rand(64, 100000)', 'x.sum(1)'),
+    ('prod_dim1_4Kx4K', 'x = torch.rand(4096, 4096)', 'x.prod(1)'),
+    ('exp_16M', 'x = torch.rand(1 << 24)', 'torch.exp(x)'),
+    ('exp_16K', 'x = torch.rand(1 << 14)', 'torch.exp(x)'),
+    ('tanh_16M', 'x = torch.rand(1 << 24)', 'torch.tanh(x)'),
+    ('sqrt_16M', 'x = torch.rand(1 << 24)', 'torch.sqrt(x)'),
+    ('softmax_1Kx1K', 'x = torch.rand(1024, 1024)', 'torch.softmax(x, 1)'),
+]
+
+
+def run_cases(repeat, number):
+    import torch
+    for name, setup, stmt in CASES:
+        times = timeit.repeat(stmt, setup='import torch; ' + setup,
+                              repeat=repeat, number=number)
+        print('{} {:.6f}'.format(name, min(times) / number))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 2, 4, 8])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=20)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_cases(args.repeat, args.number)
+        return
+
+    print('{:<20} {:>7} {:>12} {:>12} {:>8}'.format(
+        'case', 'threads', 'openmp (ms)', 'native (ms)', 'speedup'))
+    for threads in args.threads:
+        results = {}
+        for backend, flag in (('openmp', '0'), ('native', '1')):
+            env = dict(os.environ)
+            env['ATEN_THREAD_POOL'] = flag
+            env['OMP_NUM_THREADS'] = str(threads)
+            output = subprocess.check_output(
+                [sys.executable, __file__, '--worker',
+                 '--repeat', str(args.repeat), '--number', str(args.number)],
+                env=env)
+            for line in output.decode().splitlines():
+                name, seconds = line.split()
+                results.setdefault(name, {})[backend] = float(seconds)
+        for name, _, _ in CASES:
+            omp, native = results[name]['openmp'], results[name]['native']
+            print('{:<20} {:>7} {:>12.3f} {:>12.3f} {:>7.2f}x'.format(
+                name, threads, omp * 1e3, native * 1e3, omp / native))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,65 @@
+"""Load time of a large state dict saved with torch.save.
+
+Compares the default sequential layout, loaded on one thread, against
+layout='aligned' loaded with several threads and with mmap=True. Mapped
+storages are only read from disk when they are used, so the mmap time is
+printed both for the load and for the load plus one pass over every tensor.
+Drop the page cache between runs (or use --size larger than the memory) to
+measure loads from disk instead of from the page cache.
+"""
+import argparse
+import os
+import shutil
+import tempfile
+import time
+
+import torch
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--size', type=float, default=2.0,
+                        help='total size of the tensors in GB')
+    parser.add_argument('--tensors', type=int, default=64)
+    parser.add_argument('--threads', type=int, default=torch.get_num_threads())
+    args = parser.parse_args()
+
+    numel = int(args.size * 1e9 / 4 / args.tensors)
+    state = {'weight{}'.format(i): torch.randn(numel) for i in range(args.tensors)}
+
+    d = tempfile.mkdtemp()
+    try:
+        sequential = os.path.join(d, 'sequential.pt')
+        aligned = os.path.join(d, 'aligned.pt')
+        start = time.time()
+        torch.save(state, sequential)
+        print('save sequential: {:.2f} s'.format(time.time() - start))
+        start = time.time()
+        torch.save(state, aligned, layout='aligned')
+        print('save aligned:    {:.2f} s'.format(time.time() - start))
+        del state
+
+        def touch(loaded):
+            return sum(t.sum().item() for t in loaded.values())
+
+        configs = [
+            ('sequential', lambda: torch.load(sequential)),
+            ('aligned, 1 thread', lambda: torch.load(aligned, num_threads=1)),
+            ('aligned, {} threads'.format(args.threads),
+             lambda: torch.load(aligned, num_threads=args.threads)),
+            ('aligned, mmap', lambda: torch.load(aligned, mmap=True)),
+        ]
+        print('{:<24} {:>10} {:>18}'.format('load', 'load (s)', 'load + read (s)'))
+        for name, load in configs:
+            start = time.time()
+            loaded = load()
+            loaded_time = time.time() - start
+            touch(loaded)
+            print('{:<24} {:>10.2f} {:>18.2f}'.format(name, loaded_time, time.time() - start))
+            del loaded
+    finally:
+        shutil.rmtree(d)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,59 @@
+"""SpMM and SpMV time of sparse CSR matrices against sparse COO matrices.
+
+A CSR matrix (torch.sparse_csr) keeps its nonzeros sorted by row with the
+offset of every row, so torch.mm and torch.mv split the rows between threads
+and read the matrix once, without the coalesce and the conversion of the row
+indices that every product of a COO matrix does. The matrices are adjacency
+matrices of random graphs with power-law degrees, as in graph and
+recommendation workloads. The table shows the time of one product in
+milliseconds.
+"""
+import argparse
+import timeit
+
+
+def power_law_graph(nodes, edges):
+    import torch
+    rows = (torch.rand(edges).pow(3) * nodes).long().clamp(max=nodes - 1)
+    cols = (torch.rand(edges).pow(3) * nodes).long().clamp(max=nodes - 1)
+    values = torch.rand(edges)
+    indices = torch.stack([rows, cols])
+    return torch.sparse_coo_tensor(indices, values, (nodes, nodes)).coalesce()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--nodes', type=int, default=100000)
+    parser.add_argument('--edges', type=int, default=1000000)
+    parser.add_argument('--features', type=int, nargs='+', default=[16, 128])
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 4, 16])
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=5)
+    args = parser.parse_args()
+
+    import torch
+    coo = power_law_graph(args.nodes, args.edges)
+    csr = coo.to_sparse_csr()
+
+    benchmarks = []
+    for features in args.features:
+        dense = torch.randn(args.nodes, features)
+        benchmarks.append(('mm {}'.format(features), lambda a, d=dense: torch.mm(a, d)))
+    vec = torch.randn(args.nodes)
+    # there is no mv for COO matrices; mm with one column does the same work
+    benchmarks.append(('mv', lambda a: torch.mv(a, vec) if a is csr else torch.mm(a, vec.unsqueeze(1))))
+
+    print(('{:<8} {:<6}' + ' {:>10}' * len(args.threads)).format(
+        'op', 'layout', *['{} thr'.format(t) for t in args.threads]))
+    for name, fn in benchmarks:
+        for layout, matrix in [('coo', coo), ('csr', csr)]:
+            row = []
+            for threads in args.threads:
+                torch.set_num_threads(threads)
+                times = timeit.repeat(lambda: fn(matrix), repeat=args.repeat, number=args.number)
+                row.append(min(times) / args.number * 1000)
+            print(('{:<8} {:<6}' + ' {:>10.3f}' * len(row)).format(name, layout, *row))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,63 @@
+"""Coalesce and sparse-sparse matmul time of sparse COO matrices.
+
+coalesce() groups equal indices with a parallel radix sort
+(aten/src/ATen/native/IndexGrouping.cpp) and sums the entries of every index
+in parallel. torch.mm of two sparse matrices runs a multi-threaded hash-based
+Gustavson product, which splits the rows between threads by their number of
+products. The matrices have power-law row and column degrees and, by default,
+tens of millions of nonzeros; the coalesce runs on a matrix with about half
+of its entries duplicated. The table shows the time of one call in
+milliseconds.
+"""
+import argparse
+import timeit
+
+
+def power_law_matrix(nodes, nnz, duplicate=0.0):
+    import torch
+    rows = (torch.rand(nnz).pow(3) * nodes).long().clamp(max=nodes - 1)
+    cols = (torch.rand(nnz).pow(3) * nodes).long().clamp(max=nodes - 1)
+    indices = torch.stack([rows, cols])
+    if duplicate > 0:
+        repeats = indices[:, :int(nnz * duplicate)]
+        indices = torch.cat([indices, repeats], 1)
+        indices = indices[:, torch.randperm(indices.size(1))]
+    values = torch.rand(indices.size(1))
+    return torch.sparse_coo_tensor(indices, values, (nodes, nodes))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--nodes', type=int, default=5000000)
+    parser.add_argument('--nnz', type=int, default=20000000)
+    parser.add_argument('--mm-nnz', type=int, default=2000000,
+                        help='nonzeros of the factors of the product')
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 4, 16])
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--number', type=int, default=1)
+    args = parser.parse_args()
+
+    import torch
+    uncoalesced = power_law_matrix(args.nodes, args.nnz, duplicate=0.5)
+    a = power_law_matrix(args.nodes, args.mm_nnz).coalesce()
+    b = power_law_matrix(args.nodes, args.mm_nnz).coalesce()
+    print('coalesce: {} entries, mm: {} x {} nonzeros, {} in the result'.format(
+        uncoalesced._nnz(), a._nnz(), b._nnz(), torch.mm(a, b)._nnz()))
+
+    benchmarks = [
+        ('coalesce', lambda: uncoalesced.coalesce()),
+        ('mm', lambda: torch.mm(a, b)),
+    ]
+    print(('{:<10}' + ' {:>10}' * len(args.threads)).format(
+        'op', *['{} thr'.format(t) for t in args.threads]))
+    for name, fn in benchmarks:
+        row = []
+        for threads in args.threads:
+            torch.set_num_threads(threads)
+            times = timeit.repeat(fn, repeat=args.repeat, number=args.number)
+            row.append(min(times) / args.number * 1000)
+        print(('{:<10}' + ' {:>10.3f}' * len(row)).format(name, *row))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,77 @@
+"""Throughput of the vectorized unary ops for every CPU capability.
+
+The dense CPU unary ops (exp, log, tanh, sigmoid, ...) run on the vml
+functions in aten/src/ATen/cpu/vml.h, which are compiled once per CPU
+capability. The DEFAULT build calls libm for every element, the AVX, AVX2 and
+AVX512 builds call the SLEEF vector functions (unless ATen was built with
+MKL). Each capability is timed in its own process, selected with the
+ATEN_DISABLE_* environment variables, and the table shows elements per
+nanosecond.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import timeit
+
+OPS = ['acos', 'asin', 'atan', 'cos', 'erf', 'exp', 'expm1', 'log', 'log10',
+       'log1p', 'log2', 'rsqrt', 'sigmoid', 'sin', 'sqrt', 'tan', 'tanh']
+
+# capability -> environment variables that make it the best available one
+CAPABILITIES = [
+    ('DEFAULT', ['ATEN_DISABLE_AVX512', 'ATEN_DISABLE_AVX2', 'ATEN_DISABLE_AVX']),
+    ('AVX', ['ATEN_DISABLE_AVX512', 'ATEN_DISABLE_AVX2']),
+    ('AVX2', ['ATEN_DISABLE_AVX512']),
+    ('AVX512', []),
+]
+
+
+def run_worker(args):
+    import torch
+    torch.set_num_threads(1)
+    dtype = getattr(torch, args.dtype)
+    x = torch.rand(args.numel, dtype=dtype) * 2 - 1
+    out = torch.empty_like(x)
+    for op in OPS:
+        fn = getattr(torch, op)
+        # keep the inputs in the domain of every op
+        inp = x.abs() + 0.5 if op in ('log', 'log10', 'log2', 'rsqrt', 'sqrt') else x * 0.9
+        times = timeit.repeat(lambda: fn(inp, out=out), repeat=args.repeat, number=args.number)
+        print('{} {}'.format(op, args.numel * args.number / min(times) / 1e9))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--dtype', default='float32', choices=['float32', 'float64'])
+    parser.add_argument('--numel', type=int, default=1 << 20)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--number', type=int, default=20)
+    parser.add_argument('--worker', action='store_true', help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args)
+        return
+
+    results = {}
+    for name, disabled in CAPABILITIES:
+        env = dict(os.environ)
+        for var in disabled:
+            env[var] = '1'
+        cmd = [sys.executable, __file__, '--worker', '--dtype', args.dtype,
+               '--numel', str(args.numel), '--repeat', str(args.repeat),
+               '--number', str(args.number)]
+        output = subprocess.check_output(cmd, env=env).decode()
+        results[name] = dict(line.split() for line in output.splitlines())
+
+    # capabilities the CPU or the build lacks fall back to the next lower one,
+    # so their columns repeat it
+    names = [name for name, _ in CAPABILITIES]
+    print(('{:<10}' + ' {:>10}' * len(names)).format('op', *names))
+    for op in OPS:
+        row = [float(results[name][op]) for name in names]
+        print(('{:<10}' + ' {:>10.3f}' * len(names)).format(op, *row))
+
+
+if __name__ == '__main__':
+    main()
@@ -743,11 +743,16 @@ main_sources = [
     "torch/csrc/utils/variadic.cpp",
     "torch/csrc/allocators.cpp",
     "torch/csrc/serialization.cpp",
+    "torch/csrc/checkpoint.cpp",
     "torch/csrc/jit/init.cpp",
+    "torch/csrc/jit/argument_spec.cpp",
     "torch/csrc/jit/interpreter.cpp",
     "torch/csrc/jit/python_interpreter.cpp",
     "torch/csrc/jit/ir.cpp",
+    "torch/csrc/jit/memory_planning.cpp",
+    "torch/csrc/jit/fusion_bytecode.cpp",
     "torch/csrc/jit/fusion_compiler.cpp",
+    "torch/csrc/jit/fusion_kernel_cache.cpp",
     "torch/csrc/jit/graph_executor.cpp",
     "torch/csrc/jit/python_ir.cpp",
     "torch/csrc/jit/test_jit.cpp",
@@ -792,6 +797,7 @@ main_sources = [
     "torch/csrc/autograd/python_anomaly_mode.cpp",
     "torch/csrc/autograd/engine.cpp",
     "torch/csrc/autograd/function.cpp",
+    "torch/csrc/autograd/function_arena.cpp",
     "torch/csrc/autograd/variable.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
     "torch/csrc/autograd/input_buffer.cpp",
@@ -172,6 +172,21 @@ def freeze_rng_state():
     torch.set_rng_state(rng_state)
 
 
+@contextlib.contextmanager
+def num_threads(n):
+    """Runs the body with n threads, then restores the thread count, including
+    ATen's, which stays unset while set_num_threads has not been called."""
+    prev = torch.get_num_threads()
+    prev_aten = torch._C._get_aten_num_threads()
+    torch.set_num_threads(n)
+    try:
+        yield
+    finally:
+        torch.set_num_threads(prev)
+        # 0 leaves ATen's thread count unset, like the initial -1
+        torch._C._set_aten_num_threads(max(prev_aten, 0))
+
+
 def iter_indices(tensor):
     if tensor.dim() == 0:
         return range(0)
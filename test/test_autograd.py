@@ -1,5 +1,7 @@
 import contextlib
 import gc
+import os
+import subprocess
 import sys
 import math
 import torch
@@ -1830,6 +1832,90 @@ class TestAutograd(TestCase):
         out.sum().backward()
         self.assertEqual(x.grad.data, y_data)
 
+    def test_arena_allocation(self):
+        def run(x, w):
+            h = x
+            for _ in range(50):
+                h = torch.tanh(h.mm(w)) * 2
+            return h.sum()
+
+        x = torch.randn(4, 8)
+        w = torch.randn(8, 8, requires_grad=True)
+        expected, = torch.autograd.grad(run(x, w), w)
+
+        # only entering the context manager switches the allocator
+        arena = torch.autograd.arena_allocation()
+        self.assertFalse(torch._C._is_arena_enabled())
+
+        arena_blocks, heap_blocks = torch._C._arena_stats()
+        with arena:
+            self.assertTrue(torch._C._is_arena_enabled())
+            out = run(x, w)
+            retained = run(x, w)
+        self.assertFalse(torch._C._is_arena_enabled())
+        # the 151 nodes of each graph come from the arena, none from the heap
+        stats = torch._C._arena_stats()
+        self.assertGreaterEqual(stats[0] - arena_blocks, 2 * 151)
+        self.assertEqual(stats[1], heap_blocks)
+        run(x, w)
+        self.assertEqual(torch._C._arena_stats()[0], stats[0])
+        self.assertGreaterEqual(torch._C._arena_stats()[1] - heap_blocks, 151)
+        grad, = torch.autograd.grad(out, w)
+        self.assertEqual(grad, expected)
+        # Graphs outlive the context manager and can be used repeatedly.
+        for _ in range(2):
+            grad, = torch.autograd.grad(retained, w, retain_graph=True)
+            self.assertEqual(grad, expected)
+        del out, retained
+
+        with torch.autograd.arena_allocation():
+            grad, = torch.autograd.grad(run(x, w), w, create_graph=True)
+            grad.sum().backward()
+        w_grad = w.grad.clone()
+        w.grad = None
+        grad, = torch.autograd.grad(run(x, w), w, create_graph=True)
+        grad.sum().backward()
+        self.assertEqual(w.grad, w_grad)
+
+    def test_multiple_cpu_threads(self):
+        # The number of CPU workers is fixed once the engine has started, so
+        # the check runs in a fresh interpreter.
+        script = """
+import torch
+from torch.autograd import Function
+
+assert torch.autograd._get_num_cpu_threads() == 4
+
+class Reenter(Function):
+    @staticmethod
+    def forward(ctx, x):
+        return x * 2
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        with torch.enable_grad():
+            x = torch.ones(3, requires_grad=True)
+            (x * grad_output).sum().backward()
+        return grad_output * 2 + x.grad
+
+w = torch.randn(3, requires_grad=True)
+towers = [Reenter.apply((w * i).tanh()) for i in range(1, 9)]
+loss = sum(t.exp().sum() for t in towers)
+grad, = torch.autograd.grad(loss, w, retain_graph=True)
+for _ in range(20):
+    w.grad = None
+    loss.backward(retain_graph=True)
+    assert torch.allclose(w.grad, grad)
+try:
+    torch.autograd._set_num_cpu_threads(2)
+    raise AssertionError('changing the number of threads should fail')
+except RuntimeError:
+    pass
+"""
+        env = dict(os.environ)
+        env['TORCH_AUTOGRAD_CPU_THREADS'] = '4'
+        subprocess.check_call([sys.executable, '-c', script], env=env)
+
     def test_cat(self):
         f_args_variable = (torch.randn(1, S, S, requires_grad=True),
                            torch.randn(2, S, S, requires_grad=True),
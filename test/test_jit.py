@@ -20,6 +20,7 @@ import textwrap
 import numpy as np
 import tempfile
 import shutil
+import subprocess
 import warnings
 from test_autograd import method_tests, create_input, unpack_variables, \
     exclude_tensor_method, EXCLUDE_GRADCHECK, EXCLUDE_FUNCTIONAL
@@ -243,6 +244,34 @@ class TestJit(JitTestCase):
 
         self.assertEqual(run(trace.graph()), run(imported_graph))
 
+    def test_export_import_mapped(self):
+        def f(x, w, idx):
+            return x.mm(w).index_select(1, idx)
+
+        x = torch.randn(3, 4)
+        w = torch.randn(4, 5)
+        idx = torch.tensor([4, 0, 2])
+        trace, z = torch.jit.get_trace_graph(f, (x, w, idx))
+
+        d = tempfile.mkdtemp()
+        try:
+            path = os.path.join(d, 'model')
+            trace.graph().export_mapped(path, [w, idx], onnx_opset_version=0,
+                                        operator_export_type=OperatorExportTypes.RAW)
+            imported_graph, initializers = torch._C._jit_import_mapped_graph(path)
+            self.assertEqual(initializers, [w, idx])
+            self.assertEqual(initializers[1].dtype, torch.int64)
+            for t in initializers:
+                self.assertEqual(t.data_ptr() % 4096, 0)
+            self.assertEqual(torch._C.GraphExecutor(imported_graph, False)(x, *initializers), z)
+
+            # the mapping is copy-on-write
+            initializers[0].add_(1)
+            _, initializers = torch._C._jit_import_mapped_graph(path)
+            self.assertEqual(initializers[0], w)
+        finally:
+            shutil.rmtree(d)
+
     def test_simple(self):
         x = torch.tensor([0.4], requires_grad=True)
         y = torch.tensor([0.7], requires_grad=True)
@@ -363,6 +392,69 @@ class TestJit(JitTestCase):
             else:
                 raise
 
+    @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
+    def test_fusion_cpu_bytecode(self):
+        def f(x, y):
+            z = (x + .5 * y).clamp(min=-1, max=2)
+            return torch.sigmoid(z) * torch.tanh(x) - z.exp()
+
+        x = torch.randn(5, 7, dtype=torch.float)
+        y = torch.randn(7, 5, dtype=torch.float).t()
+
+        ge = self.checkTrace(f, (x, y))
+        self.assertIn('prim::FusionGroup', str(ge.graph_for(x, y)))
+
+    @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
+    def test_fusion_cpu_reduction(self):
+        def f(x, y):
+            z = x * y + x
+            return z.sum(1), (z * y).mean(1, keepdim=True)
+
+        x = torch.randn(8, 300, dtype=torch.float)
+        y = torch.randn(300, 8, dtype=torch.float).t()
+
+        ge = self.checkTrace(f, (x, y))
+        graph = str(ge.graph_for(x, y)).split('with prim::FusionGroup')[0]
+        self.assertIn('prim::FusionGroup', graph)
+        self.assertNotIn('aten::sum', graph)
+        self.assertNotIn('aten::mean', graph)
+
+    @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
+    def test_fusion_cpu_kernel_cache(self):
+        from distutils.spawn import find_executable
+        if find_executable(os.environ.get('CXX', 'g++')) is None:
+            raise unittest.SkipTest('no C++ compiler')
+        script = dedent("""
+            import torch
+
+            def f(x, y):
+                return torch.sigmoid(x) * torch.tanh(y) + x
+
+            x = torch.randn(4, 4)
+            y = torch.randn(4, 4)
+            traced = torch.jit.trace(x, y)(f)
+            assert (traced(x, y) - f(x, y)).abs().max() < 1e-6
+            print('{} {}'.format(*torch._C._jit_fusion_kernel_cache_stats()))
+        """)
+        cache_dir = tempfile.mkdtemp()
+        try:
+            env = dict(os.environ)
+            env['PYTORCH_FUSION_CPU_BACKEND'] = 'cxx'
+            env['PYTORCH_FUSION_CACHE_DIR'] = cache_dir
+
+            def run():
+                output = subprocess.check_output([sys.executable, '-c', script], env=env)
+                return [int(n) for n in output.decode().split()]
+
+            hits, misses = run()
+            self.assertEqual(hits, 0)
+            self.assertGreater(misses, 0)
+            hits, misses = run()
+            self.assertGreater(hits, 0)
+            self.assertEqual(misses, 0)
+        finally:
+            shutil.rmtree(cache_dir)
+
     @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
     @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
     def test_lstm_fusion_concat(self):
@@ -4519,6 +4611,14 @@ class TestPytorchExportModes(JitTestCase):
                            export_type=torch.onnx.ExportTypes.DIRECTORY)
         shutil.rmtree(d)
 
+    def test_mapped_file(self):
+        torch_model = TestPytorchExportModes.MyModel()
+        fake_input = Variable(torch.randn(1, 1, 224, 224), requires_grad=True)
+        d = tempfile.mkdtemp()
+        torch.onnx._export(torch_model, (fake_input), os.path.join(d, 'model'), verbose=False,
+                           export_type=torch.onnx.ExportTypes.MAPPED_FILE)
+        shutil.rmtree(d)
+
     def test_aten_fallback(self):
         class ModelWithAtenNotONNXOp(nn.Module):
             def forward(self, x, y):
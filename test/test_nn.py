@@ -1806,6 +1806,15 @@ class TestNN(NNTestCase):
         self._test_EmbeddingBag(False, 'sum', True)
         self._test_EmbeddingBag(False, 'mean', True)
 
+    def test_embedding_bag_bad_offsets(self):
+        weight = torch.randn(10, 3)
+        input = torch.LongTensor([1, 2, 4, 5, 4, 3])
+        for offsets in ([-1, 2], [0, 4, 2], [0, 7]):
+            offsets = torch.LongTensor(offsets)
+            self.assertRaises(RuntimeError, lambda: F.embedding_bag(input, weight, offsets))
+            self.assertRaises(RuntimeError,
+                              lambda: torch.quantized_embedding_bag(weight.half(), input, offsets))
+
     @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
     @repeat_test_for_types(ALL_TENSORTYPES)
     def test_embedding_bag_cuda(self, dtype=torch.float):
@@ -4,7 +4,7 @@ from torch import sparse
 import itertools
 import random
 import unittest
-from common import TestCase, run_tests
+from common import TestCase, run_tests, num_threads
 from common_cuda import TEST_CUDA
 from test_torch import TestTorch
 from numbers import Number
@@ -493,6 +493,44 @@ class TestSparse(TestCase):
         test_shape(1000, 100, 100)
         test_shape(3000, 64, 300)
 
+    @cpu_only
+    def test_sparse_sparse_mm(self):
+        def test_shape(di, dj, dk, nnz):
+            x = self._gen_sparse(2, nnz, [di, dj])[0]
+            y = self._gen_sparse(2, nnz, [dj, dk])[0]
+
+            res = torch.mm(x, y)
+            expected = torch.mm(self.safeToDense(x), self.safeToDense(y))
+            self.assertTrue(res.is_sparse)
+            self.assertTrue(res.is_coalesced())
+            self.assertEqual(res.to_dense(), expected)
+            self.assertEqual(res.coalesce()._indices(), res._indices())
+
+        test_shape(7, 5, 3, 1)
+        test_shape(7, 5, 3, 10)
+        test_shape(100, 1000, 200, 2000)
+        test_shape(1000, 100, 100, 5000)
+
+        x = self._gen_sparse(2, 20, [10, 5])[0]
+        self.assertRaises(RuntimeError, lambda: torch.mm(x, self._gen_sparse(2, 20, [6, 5])[0]))
+        self.assertRaises(RuntimeError, lambda: torch.mm(x, self._gen_sparse(3, 20, [5, 5, 5])[0]))
+
+    @cpu_only
+    def test_coalesce_threads(self):
+        x = self._gen_sparse(3, 50000, [40, 30, 20])[0]
+        x_hybrid = self._gen_sparse(2, 50000, [40, 30, 4])[0]
+        with num_threads(1):
+            expected = x.coalesce()
+            expected_hybrid = x_hybrid.coalesce()
+        with num_threads(4):
+            # the entries of every index are summed in the same order
+            for y, z in [(x.coalesce(), expected), (x_hybrid.coalesce(), expected_hybrid)]:
+                self.assertTrue(y.is_coalesced())
+                self.assertEqual(y._indices(), z._indices(), 0)
+                self.assertEqual(y._values(), z._values(), 0)
+        self.safeCoalesce(x)
+        self.safeCoalesce(x_hybrid)
+
     def _test_spadd_shape(self, shape_i, shape_v=None):
         shape = shape_i + (shape_v or [])
         x, _, _ = self._gen_sparse(len(shape_i), 10, shape)
@@ -6468,6 +6468,67 @@ class TestTorch(TestCase):
             c = torch.load(f)
         self._test_serialization_assert(b, c)
 
+    def test_serialization_aligned(self):
+        b = self._test_serialization_data()
+        for mmap, num_threads in ((False, 1), (False, 4), (True, None)):
+            # Loading with several threads or with mmap opens the file again,
+            # which is not supported on Windows
+            if sys.platform == "win32" and (mmap or num_threads > 1):
+                continue
+            with tempfile.NamedTemporaryFile() as f:
+                torch.save(b, f, layout='aligned')
+                f.seek(0)
+                c = torch.load(f, mmap=mmap, num_threads=num_threads)
+                if mmap:
+                    self.assertEqual(c[4].data_ptr() % torch.serialization.STORAGE_ALIGNMENT, 0)
+                self._test_serialization_assert(b, c)
+                if mmap:
+                    # mapped storages are copy-on-write
+                    f.seek(0)
+                    self.assertEqual(b, torch.load(f, mmap=True), 0)
+
+    def test_serialization_aligned_filelike(self):
+        b = self._test_serialization_data()
+        with BytesIOContext() as f:
+            torch.save(b, f, layout='aligned')
+            f.seek(0)
+            self.assertRaises(RuntimeError, lambda: torch.load(f, mmap=True))
+            f.seek(0)
+            c = torch.load(f, num_threads=4)
+        self._test_serialization_assert(b, c)
+
+        with BytesIOContext() as f:
+            torch.save(b, f)
+            f.seek(0)
+            self.assertRaises(RuntimeError, lambda: torch.load(f, mmap=True))
+
+    def test_serialization_async_checkpoint(self):
+        b = self._test_serialization_data()
+        x = torch.randn(1000)
+        expected = x.clone()
+        # a small staging buffer, so that x is written in several chunks
+        writer = torch.serialization.AsyncCheckpointWriter(staging_bytes=256)
+        d = tempfile.mkdtemp()
+        try:
+            paths = [os.path.join(d, 'checkpoint{}.pt'.format(i)) for i in range(3)]
+            futures = [writer.save({'b': b, 'x': x}, path, fsync=i == 0)
+                       for i, path in enumerate(paths)]
+            # the storages are copied when save returns
+            x.fill_(0)
+            futures[0].wait()
+            self.assertTrue(futures[0].done())
+            writer.wait()
+            for path in paths:
+                self.assertFalse(os.path.exists(path + '.tmp'))
+                c = torch.load(path)
+                self._test_serialization_assert(b, c['b'])
+                self.assertEqual(c['x'], expected, 0)
+
+            self.assertRaises(RuntimeError,
+                              lambda: writer.save(b, os.path.join(d, 'missing', 'checkpoint.pt')))
+        finally:
+            shutil.rmtree(d)
+
     def test_serialization_gzip(self):
         # Test serialization with gzip file
         b = self._test_serialization_data()
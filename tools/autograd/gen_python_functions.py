@@ -25,6 +25,7 @@ SKIP_PYTHON_BINDINGS = [
     'index',
     '_indexCopy_', 'max_values', 'min_values', 'argmax', 'argmin',
     '_cumsum.*', '_cumprod.*', '_sum.*', '_prod.*', '_th_sum.*', '_th_prod.*',
+    '_th_max.*', '_th_min.*', '_th_norm.*', '_th_var.*', '_th_std.*',
     'arange.*', 'range.*', '_gesv.*', 'slice',
 ]
 
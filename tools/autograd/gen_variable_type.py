@@ -52,8 +52,16 @@ RENAME_TRACE = {
     's_native_sub': 'sub',
     'th_mul': 'mul',
     's_native_mul': 'mul',
+    'th_div': 'div',
+    's_native_div': 'div',
+    'th_addcmul': 'addcmul',
+    's_native_addcmul': 'addcmul',
     'th_addmm': 'addmm',
     's_native_addmm': 'addmm',
+    'th_bmm': 'bmm',
+    's_native_bmm': 'bmm',
+    'th_baddbmm': 'baddbmm',
+    's_native_baddbmm': 'baddbmm',
 }
 
 # These functions are not worth profiling because they are very cheap and may
@@ -101,7 +109,7 @@ if (compute_requires_grad( ${args_with_derivatives} )) {
 """)
 
 ASSIGN_GRAD_FN = CodeTemplate("""\
-grad_fn = std::shared_ptr<${op}>(new ${op}(${op_ctor}), deleteFunction);
+grad_fn = make_function<${op}>(${op_ctor});
 grad_fn->set_next_edges(collect_next_edges( ${args_with_derivatives} ));
 """)
 
@@ -182,8 +190,16 @@ def should_trace(declaration):
         return False
     if base_name == 'mul' and overload == ['Tensor', 'Tensor', 'Scalar']:
         return False
+    if base_name == 'div' and overload == ['Tensor', 'Tensor']:
+        return False
+    if base_name == 'addcmul' and overload == ['Tensor', 'Tensor', 'Tensor', 'Scalar']:
+        return False
     if base_name == 'addmm' and overload == ['Tensor', 'Tensor', 'Tensor', 'Scalar', 'Scalar']:
         return False
+    if base_name == 'bmm' and overload == ['Tensor', 'Tensor']:
+        return False
+    if base_name == 'baddbmm' and overload == ['Tensor', 'Tensor', 'Tensor', 'Scalar', 'Scalar']:
+        return False
     return True
 
 
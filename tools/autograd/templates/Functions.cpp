@@ -1323,6 +1323,131 @@ std::tuple<Tensor, Tensor, Tensor> batchnorm_double_backward(
 
 }
 
+// Helper for layer_norm_double_backward and group_norm_double_backward.
+// input is normalized over R groups of contiguous elements, so its (1, R, -1)
+// view is batch norm input and batchnorm_double_backward can differentiate
+// the normalization. weight and bias are applied to the affine_shape view of
+// input and have weight_shape there.
+// Returns the gradients of grad_out, input and weight.
+std::tuple<Tensor, Tensor, Tensor> normalization_double_backward(
+    const Tensor & input,
+    const Tensor & weight,
+    const Tensor & ggI,
+    const Tensor & ggW,
+    const Tensor & ggB,
+    const Tensor & gO,
+    const Tensor & mean,
+    const Tensor & rstd,
+    int64_t R,
+    IntList affine_shape,
+    IntList weight_shape,
+    std::array<bool,3> output_mask) {
+
+  auto norm_view = [&](const Tensor& t) { return t.contiguous().view({1, R, -1}); };
+  auto affine_view = [&](const Tensor& t) { return t.contiguous().view(affine_shape); };
+  auto sum_to_weight = [&](const Tensor& t) {
+    auto r = t;
+    for (size_t dim = 0; dim < affine_shape.size(); dim++) {
+      if (weight_shape[dim] == 1) {
+        r = r.sum(dim, true);
+      }
+    }
+    return r.view(weight.sizes());
+  };
+
+  auto mean_ = mean.contiguous().view({R});
+  auto rstd_ = rstd.contiguous().view({R});
+  auto gO_ = affine_view(gO);
+  auto w = weight.defined() ? weight.contiguous().view(weight_shape) : Tensor();
+  auto ggW_ = ggW.defined() ? ggW.contiguous().view(weight_shape) : Tensor();
+  auto x_hat = affine_view((norm_view(input) - mean_.view({1, R, 1})) * rstd_.view({1, R, 1}));
+
+  // the first backward's grad_input for the gradient h of the normalized input
+  auto normalize_backward = [&](const Tensor& h) -> Tensor {
+    auto h_ = norm_view(h);
+    auto x_hat_ = norm_view(x_hat);
+    auto r = h_ - h_.mean(2, true) - x_hat_ * (h_ * x_hat_).mean(2, true);
+    return affine_view(r * rstd_.view({1, R, 1}));
+  };
+
+  Tensor ggO, gI, gW;
+  if (ggI.defined()) {
+    // the normalization sees gO * weight as its output gradient
+    Tensor bn_gI, bn_gG, bn_ggO;
+    std::tie(bn_gI, bn_gG, bn_ggO) = batchnorm_double_backward(
+        norm_view(input), Tensor(), norm_view(ggI), Tensor(), Tensor(),
+        norm_view(w.defined() ? gO_ * w : gO_), Tensor(), Tensor(),
+        true, 0, mean_, rstd_, {{false, false, output_mask[1]}});
+    auto ggI_normalized = affine_view(bn_ggO);
+    ggO = w.defined() ? ggI_normalized * w : ggI_normalized;
+    if (output_mask[1]) {
+      gI = affine_view(bn_gI);
+    }
+    if (output_mask[2] && w.defined()) {
+      gW = sum_to_weight(ggI_normalized * gO_);
+    }
+  }
+  if (ggW_.defined()) {
+    auto ggO_W_term = ggW_ * x_hat;
+    ggO = ggO.defined() ? ggO.add_(ggO_W_term) : ggO_W_term;
+    if (output_mask[1]) {
+      auto gI_W_term = normalize_backward(gO_ * ggW_);
+      gI = gI.defined() ? gI.add_(gI_W_term) : gI_W_term;
+    }
+  }
+  if (ggB.defined()) {
+    auto ggO_B_term = ggB.contiguous().view(weight_shape).expand_as(gO_);
+    ggO = ggO.defined() ? ggO.add(ggO_B_term) : ggO_B_term.clone();
+  }
+
+  if (output_mask[0]) {
+    ggO = ggO.defined() ? ggO.view(gO.sizes()) : at::zeros_like(gO);
+  }
+  if (output_mask[1]) {
+    gI = gI.defined() ? gI.view(input.sizes()) : at::zeros_like(input);
+  }
+  if (output_mask[2] && !gW.defined()) {
+    AT_ASSERTM(weight.defined(), "weight should always be defined when it requires grad");
+    gW = at::zeros_like(weight);
+  }
+
+  return std::tuple<Tensor, Tensor, Tensor>{ggO, gI, gW};
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_double_backward(
+    const Tensor & input,
+    const Tensor & weight,
+    const Tensor & ggI,
+    const Tensor & ggW,
+    const Tensor & ggB,
+    const Tensor & gO,
+    const Tensor & mean,
+    const Tensor & rstd,
+    int64_t M,
+    int64_t N,
+    std::array<bool,3> output_mask) {
+  return normalization_double_backward(
+      input, weight, ggI, ggW, ggB, gO, mean, rstd, M, {M, N}, {1, N}, output_mask);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_double_backward(
+    const Tensor & input,
+    const Tensor & weight,
+    const Tensor & ggI,
+    const Tensor & ggW,
+    const Tensor & ggB,
+    const Tensor & gO,
+    const Tensor & mean,
+    const Tensor & rstd,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    std::array<bool,3> output_mask) {
+  return normalization_double_backward(
+      input, weight, ggI, ggW, ggB, gO, mean, rstd, N * group, {N, C, HxW}, {1, C, 1}, output_mask);
+}
+
 std::tuple<Tensor, Tensor, Tensor> _trilinear_backward(const Tensor& grad_out, const Tensor& i1, const Tensor& i2, const Tensor& i3,
 						       IntList expand1, IntList expand2, IntList expand3,
 						       IntList sumdim, int64_t unroll_dim, std::array<bool, 3> grad_mask) {
@@ -70,6 +70,30 @@ CONSTRUCTOR = CodeTemplate("""\
 """)
 
 
+# Runs the _out variant of an op, writing into a preallocated output tensor that
+# is passed on top of the stack, above the inputs of the op. This lets a memory
+# plan place the outputs of ops, see torch/csrc/jit/memory_planning.h.
+OUT_CONSTRUCTOR = CodeTemplate("""\
+{"${descriptor}", [](Node *node) {
+  ${kw_assignments}
+  return TensorOp([=](Stack & stack) {
+    autograd::profiler::RecordFunction record("${name}");
+    auto output = pop(stack);
+    ${pos_assignments}
+    at::${name}(output, ${args});
+    drop(stack, ${num_dynamic_inputs});
+    stack.push_back(std::move(output));
+    return 0;
+  }, "${name}", ${num_dynamic_inputs}, 1);
+}},
+""")
+
+
+# _out variants that do not write into the given output: as_strided_out makes it
+# a view of the input, and the output of the others is sparse.
+skip_out_variants = {'as_strided', 'hspmm', 'native_hspmm', 'th_hspmm', 'sspaddmm'}
+
+
 def is_magic_method(api_name):
     return api_name.startswith('__') and api_name.endswith('__')
 
@@ -134,6 +158,7 @@ def gen_jit_dispatch(declarations, out, template_path):
     ATEN_INTERNED_STRINGS_H = CodeTemplate.from_file(template_path + '/aten_interned_strings.h')
 
     ops = {}
+    out_ops = {}
 
     def get_invocation(decl, args, num_dynamic_inputs):
         if decl.get('has_tensor_options'):
@@ -260,6 +285,15 @@ def gen_jit_dispatch(declarations, out, template_path):
         assert descriptor not in ops, descriptor
         ops[descriptor] = constructor
 
+        out_decl = out_decls.get(out_key(decl))
+        if out_decl is not None and decl['name'] not in skip_out_variants and not has_tensorlist and not decl.get('has_tensor_options') and \
+                len(returns) == 1 and returns[0]['dynamic_type'] == 'Tensor':
+            out_ops[descriptor] = OUT_CONSTRUCTOR.substitute(descriptor=descriptor, name=out_decl['name'],
+                                                             args=arguments,
+                                                             kw_assignments=kw_assignments,
+                                                             pos_assignments=pos_assignments,
+                                                             num_dynamic_inputs=num_dynamic_inputs)
+
     def emit_decl(decl):
         arguments = decl['arguments']
         has_tensorlist = any(arg['simple_type'] == 'TensorList' for arg in arguments)
@@ -318,6 +352,19 @@ def gen_jit_dispatch(declarations, out, template_path):
 
     jit_decls = [d for d in aten_decls if is_jit_op(d)]
 
+    # the _out variant of an op takes one output tensor followed by the
+    # arguments of the op
+    def out_key(decl):
+        return (decl['name'] + '_out',
+                tuple((arg['name'], arg['simple_type']) for arg in decl['arguments'] if not arg.get('output')))
+
+    out_decls = {}
+    for decl in aten_decls:
+        if (decl['name'].endswith('_out') and 'namespace' in decl['method_of'] and
+                sum(1 for arg in decl['arguments'] if arg.get('output')) == 1 and
+                decl['arguments'][0].get('output') and decl['arguments'][0]['simple_type'] == 'Tensor'):
+            out_decls[out_key(dict(decl, name=decl['name'][:-len('_out')]))] = decl
+
     # add arguments dtype and device for functions like zeros
     for decl in jit_decls:
         arguments = decl['arguments']
@@ -342,6 +389,7 @@ def gen_jit_dispatch(declarations, out, template_path):
     # Sort the generated snippets to ensure that the generation is deterministic
     env = {
         'constructors': sorted(ops.values()),
+        'out_constructors': sorted(out_ops.values()),
     }
     write(out, 'aten_dispatch.cpp', ATEN_DISPATCH_CPP, env)
 
@@ -113,6 +113,12 @@ std::unordered_map<std::string, operator_constructor> constructors = {
   ${constructors}
 };
 
+// constructors of the operations that run the _out variant of an op, by the
+// descriptor of the op
+std::unordered_map<std::string, operator_constructor> out_constructors = {
+  ${out_constructors}
+};
+
 std::string getDescriptor(jit::Node* n) {
   std::stringstream s;
   JIT_ASSERTM(n->kind().is_aten(), "%s is not an ATen op", n->kind().toDisplayString());
@@ -143,6 +149,16 @@ at::optional<TensorOp> findTensorOp(jit::Node* n) {
   }
   return it->second(n);
 }
+at::optional<TensorOp> findTensorOutOp(jit::Node* n) {
+  if (!n->kind().is_aten() || n->outputs().size() != 1) {
+    return at::nullopt;
+  }
+  auto it = out_constructors.find(getDescriptor(n));
+  if(it == out_constructors.end()) {
+    return at::nullopt;
+  }
+  return it->second(n);
+}
 TensorOp getTensorOp(jit::Node* n) {
   auto op = findTensorOp(n);
   if (!op) {
@@ -12,6 +12,7 @@ from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
 from .grad_mode import no_grad, enable_grad, set_grad_enabled
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .arena_mode import arena_allocation
 from . import profiler
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
@@ -163,6 +164,19 @@ def _is_checkpoint_valid():
     return Variable._execution_engine.is_checkpoint_valid()
 
 
+# The CPU part of a backward pass is executed by a pool of worker threads in
+# the engine. With more than one worker, independent branches of the graph
+# (e.g. separate towers of a model) are differentiated concurrently. The pool
+# size defaults to 1 (or the TORCH_AUTOGRAD_CPU_THREADS environment variable)
+# and can only be changed before the first backward pass of the process.
+def _set_num_cpu_threads(num_threads):
+    Variable._execution_engine.set_num_cpu_threads(num_threads)
+
+
+def _get_num_cpu_threads():
+    return Variable._execution_engine.get_num_cpu_threads()
+
+
 def variable(*args, **kwargs):
     warnings.warn("torch.autograd.variable(...) is deprecated, use torch.tensor(...) instead")
     return torch.tensor(*args, **kwargs)
@@ -0,0 +1,39 @@
+import torch
+
+
+class arena_allocation(object):
+    r"""Context-manager that allocates the nodes of the autograd graph from
+    a per-thread arena.
+
+    Every operation recorded for autograd creates a graph node. Inside this
+    context manager those nodes are carved out of large thread-local slabs
+    instead of being allocated one by one, and a slab is returned to the
+    system in one piece once all nodes in it have been freed, typically when
+    the backward pass that consumed the graph has finished. This reduces
+    allocator traffic and improves locality when traversing the graph,
+    which matters most for small batches.
+
+    Nodes created by a backward pass with ``create_graph=True`` use the
+    arena if the backward pass was started inside this context manager.
+
+    Example::
+
+        >>> with torch.autograd.arena_allocation():
+        ...     loss = model(input).sum()
+        >>> loss.backward()
+
+    Arguments:
+        mode (bool): Flag whether to enable arena allocation (``True``),
+                     or disable (``False``). Default: ``True``.
+    """
+
+    def __init__(self, mode=True):
+        self.mode = mode
+
+    def __enter__(self):
+        self.prev = torch._C._is_arena_enabled()
+        torch._C._set_arena_enabled(self.mode)
+
+    def __exit__(self, *args):
+        torch._C._set_arena_enabled(self.prev)
+        return False
@@ -96,7 +96,15 @@ void registerLayoutObject(THPLayout *layout, at::Backend backend) {
 }
 
 at::Type& getType(at::ScalarType scalarType, const THPLayout& layout, const at::Device& device) {
-  const at::Backend backend = get_backend(device.type() == at::Device::Type::CUDA, layout.layout == at::Layout::Sparse);
+  at::Backend backend;
+  if (layout.layout == at::Layout::SparseCsr) {
+    if (device.type() == at::Device::Type::CUDA) {
+      throw std::runtime_error("sparse CSR tensors are only supported on the CPU");
+    }
+    backend = at::kSparseCsrCPU;
+  } else {
+    backend = get_backend(device.type() == at::Device::Type::CUDA, layout.layout == at::Layout::Sparse);
+  }
   auto baseType = at::globalContext().getTypeOpt(backend, scalarType);
   if (!baseType) {
     std::ostringstream oss;
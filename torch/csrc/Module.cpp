@@ -37,6 +37,7 @@
 #include "torch/csrc/jit/init.h"
 #include "torch/csrc/jit/python_ir.h"
 #include "torch/csrc/onnx/init.h"
+#include "torch/csrc/checkpoint.h"
 
 #ifdef USE_CUDNN
 #include "cudnn.h"
@@ -146,6 +147,21 @@ static PyObject * THPModule_setNumThreads(PyObject *module, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+// ATen's own thread count, which is unset (-1 or 0) until set_num_threads is
+// called; tests use these to restore it.
+static PyObject * THPModule_getATenNumThreads(PyObject *module)
+{
+  return PyLong_FromLong(at::get_num_threads());
+}
+
+static PyObject * THPModule_setATenNumThreads(PyObject *module, PyObject *arg)
+{
+  THPUtils_assert(THPUtils_checkLong(arg), "_set_aten_num_threads expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  at::set_num_threads((int)THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+}
+
 PyObject * THPModule_setDefaultTensorType(PyObject *_unused, PyObject *type)
 {
   HANDLE_TH_ERRORS
@@ -408,6 +424,8 @@ static PyMethodDef TorchMethods[] = {
   {"_get_backcompat_keepdim_warn", (PyCFunction)THPModule_getBackcompatKeepdimWarn, METH_NOARGS, NULL},
   {"get_num_threads", (PyCFunction)THPModule_getNumThreads,     METH_NOARGS,  NULL},
   {"set_num_threads", (PyCFunction)THPModule_setNumThreads,     METH_O,       NULL},
+  {"_get_aten_num_threads", (PyCFunction)THPModule_getATenNumThreads, METH_NOARGS, NULL},
+  {"_set_aten_num_threads", (PyCFunction)THPModule_setATenNumThreads, METH_O,  NULL},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     NULL},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  NULL},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     NULL},
@@ -535,6 +553,7 @@ static PyObject* initModule() {
   torch::jit::initJITBindings(module);
   torch::autograd::initNNFunctions(module);
   torch::autograd::init_legacy_variable(module);
+  torch::initCheckpointBindings(module);
 #ifdef USE_CUDA
   torch::cuda::initModule(module);
 #endif
@@ -59,6 +59,25 @@ THAllocator THStorageWeakRefAllocator = {
   free_wrapper<StorageWeakRefAllocator>,
 };
 
+static void * no_free_malloc(void *ctx, ptrdiff_t size) {
+  THError("NoFreeAllocator: malloc not supported");
+  return nullptr;
+}
+
+static void * no_free_realloc(void *ctx, void *ptr, ptrdiff_t size) {
+  THError("NoFreeAllocator: realloc not supported");
+  return nullptr;
+}
+
+static void no_free_free(void *ctx, void *ptr) {
+}
+
+THAllocator THNoFreeAllocator = {
+  no_free_malloc,
+  no_free_realloc,
+  no_free_free,
+};
+
 #ifdef USE_CUDA
 cudaError_t CudaStorageWeakRefAllocator::malloc(void** ptr, size_t size, cudaStream_t stream) {
   THError("CudaStorageWeakRefAllocator: malloc not supported");
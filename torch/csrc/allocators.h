@@ -63,6 +63,9 @@ public:
 
 extern THAllocator THObjectPtrAllocator;
 extern THAllocator THStorageWeakRefAllocator;
+// Neither allocates nor frees. Wrapped by an ObjectPtrAllocator, it gives
+// storages that view memory owned by the wrapped object.
+extern THAllocator THNoFreeAllocator;
 #ifdef USE_CUDA
 extern THCDeviceAllocator THCStorageWeakRefAllocator;
 #endif
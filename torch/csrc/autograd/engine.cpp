@@ -1,10 +1,12 @@
 #include "torch/csrc/autograd/engine.h"
 
 #include "torch/csrc/autograd/function.h"
+#include "torch/csrc/autograd/function_arena.h"
 #include "torch/csrc/autograd/functions/basic_ops.h"
 #include "torch/csrc/autograd/grad_mode.h"
 #include "torch/csrc/autograd/anomaly_mode.h"
 #include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/utils/spin_lock.h"
 
 #include <ATen/DeviceGuard.h>
 
@@ -22,6 +24,7 @@
 #include <typeinfo>
 #include <sstream>
 #include <queue>
+#include <cstdlib>
 #include <TH/TH.h>
 
 #ifdef USE_CUDA
@@ -46,11 +49,13 @@ static thread_local int worker_device = NO_DEVICE;
 static thread_local bool checkpoint_valid = true;
 
 // XXX: Changes to the way multithreading works in execute should be done with
-// great care. Right now the implementation guarantees that a single function's
-// apply will never be entered concurrently (even if multiple graphs are
-// executed at the same time). Adding multiple threads per-device or removing
-// engine thread affinity to the device can break this invariant, and we depend
-// on it in a few places (e.g. AccumulateGrad function).
+// great care. With the default of one CPU worker the implementation guarantees
+// that a single function's apply will never be entered concurrently (even if
+// multiple graphs are executed at the same time). When the CPU ready queue is
+// served by several workers (see Engine::set_num_cpu_threads) only the
+// dependency counting in GraphTask keeps a function from running twice within
+// one graph; functions shared between concurrently executing graphs must
+// synchronize themselves (e.g. AccumulateGrad function).
 
 struct FunctionTask {
   GraphTask* base;
@@ -73,13 +78,35 @@ struct CompareFunctionTaskTime {
   }
 };
 
+// The ready queue is on the path of every single FunctionTask, so pushing and
+// popping must not go through the kernel while workers are busy. The heap is
+// guarded by a spin lock held for one heap operation only. The mutex and
+// condition variable are used exclusively to put idle workers to sleep: pop()
+// registers itself in `sleepers` before re-checking `size` under the mutex,
+// and push() / notify_all() only touch the mutex when somebody sleeps. Both
+// sides use sequentially consistent operations on `size` / outstanding_tasks
+// and `sleepers`, so either the sleeper sees the new task or the waker sees
+// the sleeper.
 struct ReadyQueue {
   std::priority_queue<FunctionTask, std::vector<FunctionTask>, CompareFunctionTaskTime> heap;
+  SpinLock heap_lock;
+  std::atomic<size_t> size {0};
+
+  std::atomic<int> sleepers {0};
   std::condition_variable not_empty;
   std::mutex mutex;
 
   void push(FunctionTask item);
-  FunctionTask pop();
+  // Blocks until a task is available. If graph_task is given, it also returns
+  // as soon as graph_task has no outstanding tasks left, handing back a task
+  // with a null base. See Note [Reentrant backwards]
+  FunctionTask pop(GraphTask* graph_task = nullptr);
+  // Wakes up all workers blocked in pop(), so that a reentrant owner notices
+  // that its graph_task was completed by another worker of the same queue.
+  void notify_all();
+
+ private:
+  bool try_pop(FunctionTask& task);
 };
 
 // Note [Reentrant backwards]
@@ -117,6 +144,12 @@ struct ReadyQueue {
 //    thread so that it actually has a chance to exit the thread_main()
 //    loop.  Thus the faffing about in thread_main() after
 //    evaluate_function() completes.
+//
+// When the CPU queue is served by several workers, the last task of a
+// GraphTask may finish on a different CPU worker than the owner, and a dummy
+// task pushed to the shared queue may be picked up by anyone.  Instead, the
+// owner waits in ReadyQueue::pop() on its own GraphTask as well, and whoever
+// drops outstanding_tasks to zero wakes up every worker of the owner's queue.
 
 
 // GraphTask holds metadata needed for a single execution of backward()
@@ -128,6 +161,9 @@ struct GraphTask {
   std::atomic<uint64_t> outstanding_tasks;
   bool keep_graph;
   bool grad_mode;
+  // Whether functions created during this backward pass (create_graph=True)
+  // are allocated from the arena, inherited from the thread calling backward.
+  bool arena_mode;
 
   std::mutex mutex;
   // Notified when a task finishes executing.  Check outstanding_tasks to see
@@ -174,6 +210,7 @@ struct GraphTask {
     , outstanding_tasks(0)
     , keep_graph(keep_graph)
     , grad_mode(grad_mode)
+    , arena_mode(ArenaMode::is_enabled())
     , mutex()
     , not_done()
     , not_ready()
@@ -182,22 +219,69 @@ struct GraphTask {
 };
 
 auto ReadyQueue::push(FunctionTask item) -> void {
+  // The task has to be accounted for before anybody can pop (and finish) it.
+  ++item.base->outstanding_tasks;
   {
-    std::lock_guard<std::mutex> lock(mutex);
-    ++item.base->outstanding_tasks;
+    std::lock_guard<SpinLock> lock(heap_lock);
     heap.push(std::move(item));
+    ++size;
+  }
+  if (sleepers.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex);
+    not_empty.notify_one();
+  }
+}
+
+auto ReadyQueue::try_pop(FunctionTask& task) -> bool {
+  if (size.load(std::memory_order_relaxed) == 0) {
+    return false;
   }
-  not_empty.notify_one();
+  std::lock_guard<SpinLock> lock(heap_lock);
+  if (heap.empty()) {
+    return false;
+  }
+  task = std::move(const_cast<FunctionTask&>(heap.top())); heap.pop();
+  --size;
+  return true;
 }
 
-auto ReadyQueue::pop() -> FunctionTask {
-  std::unique_lock<std::mutex> lock(mutex);
-  not_empty.wait(lock, [this]{ return !heap.empty(); });
-  auto task = std::move(const_cast<FunctionTask&>(heap.top())); heap.pop();
+auto ReadyQueue::pop(GraphTask* graph_task) -> FunctionTask {
+  auto graph_task_done = [graph_task] {
+    return graph_task && graph_task->outstanding_tasks.load() == 0;
+  };
+  FunctionTask task(nullptr, nullptr, InputBuffer(0));
+  while (!graph_task_done()) {
+    if (try_pop(task)) {
+      return task;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    ++sleepers;
+    not_empty.wait(lock, [this, &graph_task_done]{
+      return size.load() > 0 || graph_task_done();
+    });
+    --sleepers;
+  }
   return task;
 }
 
-Engine::Engine() : ready_queues() {
+auto ReadyQueue::notify_all() -> void {
+  if (sleepers.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex);
+    not_empty.notify_all();
+  }
+}
+
+static int default_num_cpu_threads() {
+  if (const char* env = std::getenv("TORCH_AUTOGRAD_CPU_THREADS")) {
+    int num_threads = std::atoi(env);
+    if (num_threads >= 1) {
+      return num_threads;
+    }
+  }
+  return 1;
+}
+
+Engine::Engine() : ready_queues(), num_cpu_threads(default_num_cpu_threads()) {
 }
 
 // This Engine's ReadyQueues and their corresponding threads are leaked here
@@ -229,9 +313,14 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
   // Why the test on graph_task->outstanding_tasks?  See
   // Note [Reentrant backwards]
   while (!graph_task || graph_task->outstanding_tasks > 0) {
-    FunctionTask task = queue->pop();
+    FunctionTask task = queue->pop(graph_task);
+    if (!task.base) {
+      // graph_task was completed by another worker serving this queue.
+      break;
+    }
     if (task.fn && !task.base->has_error.load()) {
       GradMode::set_enabled(task.base->grad_mode);
+      ArenaMode::set_enabled(task.base->arena_mode);
       try {
         evaluate_function(task);
       } catch (std::exception& e) {
@@ -249,10 +338,14 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
         task.base->not_done.notify_all();
       }
     } else {
-      // If it's a task initiated from this thread, decrease the counter, but
-      // don't do anything - loop condition will do all checks for us next.
+      // If it's a task initiated from this device, decrease the counter. The
+      // loop condition does all the checks for us next if this thread is the
+      // owner; otherwise the owner is another worker of this device, blocked
+      // in pop(), which we have to wake up.
       if (base_owner == worker_device) {
-        --task.base->outstanding_tasks;
+        if (--task.base->outstanding_tasks == 0 && worker_device == -1 && num_cpu_threads > 1) {
+          queue->notify_all();
+        }
       // Otherwise send a dummy function task to the owning thread just to
       // ensure that it's not sleeping. If it has work, it might see that
       // graph_task->outstanding_tasks == 0 before it gets to the task, but
@@ -503,6 +596,9 @@ auto Engine::execute(const edge_list& input_roots,
   if (!outputs.empty()) {
     graph_task.init_to_execute(*graph_root, outputs);
   }
+  // The owner has to be known before any worker can pick up the root.
+  // See Note [Reentrant backwards]
+  graph_task.owner = worker_device;
   ready_queue(-1).push(FunctionTask(&graph_task, std::move(graph_root), InputBuffer(0)));
 
   // Not a worker
@@ -515,7 +611,6 @@ auto Engine::execute(const edge_list& input_roots,
     // Get back to work while we wait for our new graph_task to
     // complete!
     // See Note [Reentrant backwards]
-    graph_task.owner = worker_device;
     lock.unlock();
     thread_main(&graph_task);
   }
@@ -570,11 +665,30 @@ bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
 
+void Engine::set_num_cpu_threads(int num_threads) {
+  if (num_threads < 1) {
+    throw std::runtime_error("the autograd engine needs at least one CPU thread");
+  }
+  std::lock_guard<std::mutex> lock(start_threads_mutex);
+  if (threads_started && num_threads != num_cpu_threads) {
+    throw std::runtime_error(
+        "the number of autograd CPU threads can only be changed before the "
+        "first backward pass");
+  }
+  num_cpu_threads = num_threads;
+}
+
+int Engine::get_num_cpu_threads() const {
+  return num_cpu_threads;
+}
+
 auto Engine::ready_queue(int device) -> ReadyQueue& {
   return *ready_queues.at(device + 1);
 }
 
 auto Engine::start_threads() -> void {
+  std::lock_guard<std::mutex> lock(start_threads_mutex);
+  threads_started = true;
   int num_devices = 0;
 #ifdef USE_CUDA
   // check for case of compiled with CUDA but no available devices
@@ -583,12 +697,18 @@ auto Engine::start_threads() -> void {
     num_devices = 0;
   }
 #endif
-  // One for CPU, plus one for every GPU device
-  int num_threads = num_devices + 1;
-  ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
+  // One queue for CPU, plus one for every GPU device
+  int num_queues = num_devices + 1;
+  ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_queues);
   for (auto& queue : ready_queues)
     queue.reset(new ReadyQueue());
-  for (int i = 0; i < num_threads; ++i) {
+  // The CPU queue is served by num_cpu_threads workers, every GPU queue by
+  // exactly one.
+  for (int i = 0; i < num_cpu_threads; ++i) {
+    std::thread t(&Engine::thread_init, this, -1);
+    t.detach();
+  }
+  for (int i = 1; i < num_queues; ++i) {
     std::thread t(&Engine::thread_init, this, i - 1);
     t.detach();
   }
@@ -11,6 +11,7 @@
 #include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -50,6 +51,13 @@ struct Engine {
 
   bool is_checkpoint_valid();
 
+  // Sets the number of worker threads serving the CPU ready queue. Defaults
+  // to 1, or to the TORCH_AUTOGRAD_CPU_THREADS environment variable. More
+  // than one worker lets independent branches of a graph be differentiated
+  // concurrently. Can only be changed before the first backward pass.
+  void set_num_cpu_threads(int num_threads);
+  int get_num_cpu_threads() const;
+
 protected:
   void compute_dependencies(Function* root, GraphTask& task);
   void evaluate_function(FunctionTask& task);
@@ -60,6 +68,9 @@ protected:
   virtual void thread_on_exception(FunctionTask& task, std::exception& e);
 
   std::once_flag start_threads_flag;
+  std::mutex start_threads_mutex;
+  bool threads_started = false;
+  int num_cpu_threads;
   std::vector<std::shared_ptr<ReadyQueue>> ready_queues;
   std::vector<std::function<void()>> final_callbacks;
   std::mutex post_callbacks_lock;
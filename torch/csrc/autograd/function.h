@@ -2,6 +2,7 @@
 
 #include "torch/csrc/assertions.h"
 #include "torch/csrc/autograd/edge.h"
+#include "torch/csrc/autograd/function_arena.h"
 #include "torch/csrc/autograd/grad_mode.h"
 #include "torch/csrc/autograd/anomaly_mode.h"
 #include "torch/csrc/autograd/profiler.h"
@@ -113,6 +114,21 @@ struct Function : std::enable_shared_from_this<Function> {
   Function& operator=(Function&& other) = delete;
   virtual ~Function() = default;
 
+  /// `Function`s are allocated from the autograd arena while `ArenaMode` is
+  /// enabled, and from the heap otherwise. See function_arena.h.
+  static void* operator new(size_t size) {
+    return detail::arena_malloc(size);
+  }
+  static void operator delete(void* ptr) noexcept {
+    detail::arena_free(ptr);
+  }
+  // Declaring the operators above hides the global placement forms, which
+  // are needed to construct e.g. `PyFunction`s inside of Python objects.
+  static void* operator new(size_t size, void* ptr) noexcept {
+    return ptr;
+  }
+  static void operator delete(void* ptr, void* place) noexcept {}
+
   /// Evaluates the function on the given inputs and returns the result of the
   /// function call.
   variable_list operator()(const variable_list& inputs) {
@@ -391,6 +407,16 @@ inline void create_gradient_edge(
   variable.set_gradient_edge({std::move(function), input_nr});
 }
 
+/// Creates a `T` owned by a `shared_ptr` that destroys it with
+/// `deleteFunction`. The control block of the `shared_ptr` is allocated like
+/// the `Function` itself, i.e. from the autograd arena if `ArenaMode` is
+/// enabled.
+template <typename T, typename... Args>
+std::shared_ptr<T> make_function(Args&&... args) {
+  return std::shared_ptr<T>(
+      new T(std::forward<Args>(args)...), deleteFunction, ArenaAllocator<T>());
+}
+
 /// Return true if any of the variables in the list require a gradient.
 inline bool any_variable_requires_grad(const variable_list& variables) {
   return std::any_of(
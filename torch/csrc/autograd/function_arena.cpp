@@ -0,0 +1,115 @@
+#include "torch/csrc/autograd/function_arena.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+namespace torch { namespace autograd {
+
+thread_local bool ArenaMode::_enabled = false;
+
+namespace detail {
+
+namespace {
+
+constexpr size_t kSlabSize = 256 * 1024;
+constexpr size_t kAlignment = 16;
+// Larger blocks would waste too much of a slab; they go to the heap.
+constexpr size_t kMaxArenaBlock = kSlabSize / 16;
+
+constexpr size_t round_up(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+struct Slab {
+  // Number of live blocks, plus one while the slab is the current slab of
+  // its thread.
+  std::atomic<size_t> refcount;
+  size_t offset;
+};
+
+// Every block is preceded by a header naming the slab it lives in, or
+// nullptr for blocks taken from the heap.
+struct alignas(kAlignment) BlockHeader {
+  Slab* slab;
+};
+
+constexpr size_t kSlabBegin = round_up(sizeof(Slab));
+
+void release(Slab* slab) {
+  if (slab && slab->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    std::free(slab);
+  }
+}
+
+struct ThreadArena {
+  ~ThreadArena() {
+    release(current);
+  }
+
+  Slab* slab_for(size_t size) {
+    if (current && current->offset + size <= kSlabSize) {
+      return current;
+    }
+    // Only this thread adds references to its current slab, so if ours is
+    // the last one, every block in it is dead and the slab can be rewound.
+    if (current && current->refcount.load(std::memory_order_acquire) == 1) {
+      current->offset = kSlabBegin;
+      return current;
+    }
+    release(current);
+    current = static_cast<Slab*>(std::malloc(kSlabSize));
+    if (!current) {
+      throw std::bad_alloc();
+    }
+    new (&current->refcount) std::atomic<size_t>(1);
+    current->offset = kSlabBegin;
+    return current;
+  }
+
+  Slab* current = nullptr;
+  ArenaStats stats;
+};
+
+thread_local ThreadArena thread_arena;
+
+} // anonymous namespace
+
+void* arena_malloc(size_t size) {
+  const size_t total = round_up(sizeof(BlockHeader) + size);
+  BlockHeader* header;
+  if (ArenaMode::is_enabled() && total <= kMaxArenaBlock) {
+    Slab* slab = thread_arena.slab_for(total);
+    header = reinterpret_cast<BlockHeader*>(
+        reinterpret_cast<char*>(slab) + slab->offset);
+    slab->offset += total;
+    slab->refcount.fetch_add(1, std::memory_order_relaxed);
+    header->slab = slab;
+    thread_arena.stats.arena_blocks++;
+  } else {
+    header = static_cast<BlockHeader*>(::operator new(total));
+    header->slab = nullptr;
+    thread_arena.stats.heap_blocks++;
+  }
+  return header + 1;
+}
+
+void arena_free(void* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+  if (header->slab) {
+    release(header->slab);
+  } else {
+    ::operator delete(header);
+  }
+}
+
+} // namespace detail
+
+ArenaStats arena_stats() {
+  return detail::thread_arena.stats;
+}
+
+}} // namespace torch::autograd
@@ -0,0 +1,92 @@
+#pragma once
+
+// Arena allocation for autograd graph nodes.
+//
+// Building the graph of a forward pass allocates every `Function` and the
+// control block of the `shared_ptr` owning it separately on the heap. While
+// arena mode is enabled, both are instead carved out of a thread-local slab
+// with a bump pointer. A slab counts the blocks that are still alive and goes
+// back to the system in one piece once the last of them is released, which is
+// usually right after the backward pass that consumed the graph. Nodes that
+// are kept alive (e.g. with retain_graph) simply keep their slab alive.
+//
+// Blocks can be released from any thread, e.g. by the engine workers.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace torch { namespace autograd {
+
+struct ArenaMode {
+  static bool is_enabled() {
+    return _enabled;
+  }
+  static void set_enabled(bool enabled) {
+    _enabled = enabled;
+  }
+private:
+  static thread_local bool _enabled;
+};
+
+// A RAII, thread local (!) guard that enables or disables arena allocation of
+// graph nodes upon construction, and sets it back to the original value upon
+// destruction.
+struct AutoArenaMode {
+  AutoArenaMode(bool enabled) : prev_mode(ArenaMode::is_enabled()) {
+    ArenaMode::set_enabled(enabled);
+  }
+  ~AutoArenaMode() {
+    ArenaMode::set_enabled(prev_mode);
+  }
+  bool prev_mode;
+};
+
+// Number of graph node allocations the current thread has made from its
+// arena and from the heap.
+struct ArenaStats {
+  uint64_t arena_blocks = 0;
+  uint64_t heap_blocks = 0;
+};
+ArenaStats arena_stats();
+
+namespace detail {
+
+// Allocates from the current thread's slab if arena mode is enabled, and
+// from the heap otherwise. Either way the block has to be released with
+// arena_free, which works out where it came from.
+void* arena_malloc(size_t size);
+void arena_free(void* ptr) noexcept;
+
+} // namespace detail
+
+/// A standard allocator on top of the arena, used for the control blocks of
+/// `shared_ptr<Function>`.
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  ArenaAllocator() = default;
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(detail::arena_malloc(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t) noexcept {
+    detail::arena_free(ptr);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return false;
+}
+
+}} // namespace torch::autograd
@@ -23,8 +23,8 @@ AccumulateGrad::AccumulateGrad(Variable variable_)
 }
 
 auto AccumulateGrad::apply(const variable_list& grads) -> variable_list {
-  // XXX: this method is not thread-safe!
   check_input_variables("AccumulateGrad", grads, 1, 0);
+  std::lock_guard<std::mutex> lock(mutex_);
 
   if (!grads[0].defined())
     return {};
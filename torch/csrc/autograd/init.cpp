@@ -2,6 +2,7 @@
 
 #include "torch/csrc/Exceptions.h"
 #include "torch/csrc/utils/pybind.h"
+#include "torch/csrc/autograd/function_arena.h"
 #include "torch/csrc/autograd/grad_mode.h"
 #include "torch/csrc/autograd/profiler.h"
 #include "torch/csrc/autograd/python_function.h"
@@ -97,12 +98,43 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_arena_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  ArenaMode::set_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_arena_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (ArenaMode::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_arena_stats(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  auto stats = arena_stats();
+  return Py_BuildValue("(KK)", (unsigned long long)stats.arena_blocks,
+                       (unsigned long long)stats.heap_blocks);
+  END_HANDLE_TH_ERRORS
+}
+
 // autograd methods on torch._C
 static PyMethodDef methods[] = {
   {"set_grad_enabled", (PyCFunction)set_grad_enabled, METH_O, nullptr},
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_anomaly_enabled", (PyCFunction)set_anomaly_mode_enabled, METH_O, nullptr},
   {"is_anomaly_enabled", (PyCFunction)is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_set_arena_enabled", (PyCFunction)set_arena_enabled, METH_O, nullptr},
+  {"_is_arena_enabled", (PyCFunction)is_arena_enabled, METH_NOARGS, nullptr},
+  {"_arena_stats", (PyCFunction)get_arena_stats, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -0,0 +1,307 @@
+#include "torch/csrc/checkpoint.h"
+
+#include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/utils/pybind.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace torch {
+
+namespace {
+
+[[noreturn]] void throwErrno(const std::string& what) {
+  throw std::system_error(errno, std::system_category(), what);
+}
+
+int openForWrite(const std::string& path) {
+#ifdef _WIN32
+  int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+  if (fd < 0)
+    throwErrno("could not open " + path);
+  return fd;
+}
+
+void writeAt(int fd, int64_t offset, const uint8_t* data, size_t nbytes) {
+#ifdef _WIN32
+  if (_lseeki64(fd, offset, SEEK_SET) < 0)
+#else
+  if (lseek(fd, offset, SEEK_SET) < 0)
+#endif
+    throwErrno("could not seek in checkpoint");
+  while (nbytes > 0) {
+    // we write in 1GB blocks to avoid bugs on some OSes
+    auto result = write(fd, data, std::min<size_t>(nbytes, 1073741824));
+    if (result < 0)
+      throwErrno("could not write checkpoint");
+    data += result;
+    nbytes -= result;
+  }
+}
+
+void syncFile(int fd) {
+#ifdef _WIN32
+  if (_commit(fd) != 0)
+#else
+  if (fsync(fd) != 0)
+#endif
+    throwErrno("could not sync checkpoint");
+}
+
+void closeFile(int fd) {
+  if (close(fd) != 0)
+    throwErrno("could not close checkpoint");
+}
+
+void replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+  // rename does not replace existing files on Windows
+  std::remove(to.c_str());
+#endif
+  if (std::rename(from.c_str(), to.c_str()) != 0)
+    throwErrno("could not rename " + from + " to " + to);
+}
+
+} // anonymous namespace
+
+struct CheckpointWriter::Job {
+  std::string path;
+  std::string tmp_path;
+  int fd = -1;
+  bool fsync = false;
+  // the bytes of the blob tasks
+  std::vector<Blob> blobs;
+  std::exception_ptr error;
+  std::promise<void> done;
+};
+
+CheckpointWriter::CheckpointWriter(at::Tensor staging)
+  : staging_(std::move(staging)) {
+  if (staging_.type().backend() != at::kCPU || staging_.type().scalarType() != at::kByte ||
+      !staging_.is_contiguous() || staging_.numel() < 64) {
+    throw std::runtime_error("the staging buffer of a CheckpointWriter must be a "
+                             "contiguous CPU byte tensor of at least 64 bytes");
+  }
+  base_ = static_cast<uint8_t*>(staging_.data_ptr());
+  capacity_ = staging_.numel();
+  thread_ = std::thread([this] { run(); });
+}
+
+CheckpointWriter::~CheckpointWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  task_added_.notify_one();
+  thread_.join();
+}
+
+size_t CheckpointWriter::reserve(size_t n, size_t& used) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // The bytes in use are the used_ bytes before head_, wrapping around the
+  // end of the buffer, and are released in the order they were reserved. A
+  // reservation that does not fit before the end of the buffer starts at its
+  // beginning, and also takes the bytes it skips.
+  while (true) {
+    if (used_ == 0)
+      head_ = 0;
+    size_t start = head_;
+    used = n;
+    if (start + n > capacity_) {
+      used = capacity_ - start + n;
+      start = 0;
+    }
+    if (used_ + used <= capacity_) {
+      head_ = start + n;
+      used_ += used;
+      return start;
+    }
+    space_freed_.wait(lock);
+  }
+}
+
+void CheckpointWriter::release(size_t used) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    used_ -= used;
+  }
+  space_freed_.notify_all();
+}
+
+void CheckpointWriter::push(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  task_added_.notify_one();
+}
+
+std::shared_future<void> CheckpointWriter::write(const std::string& filename,
+                                                 std::vector<Blob> blobs,
+                                                 std::vector<TensorSegment> tensors,
+                                                 bool fsync) {
+  auto job = std::make_shared<Job>();
+  job->path = filename;
+  job->tmp_path = filename + ".tmp";
+  job->fsync = fsync;
+  job->blobs = std::move(blobs);
+  std::shared_future<void> future = job->done.get_future().share();
+  for (auto & segment : tensors) {
+    if (!segment.tensor.is_contiguous()) {
+      throw std::runtime_error("CheckpointWriter expected contiguous tensors");
+    }
+  }
+  job->fd = openForWrite(job->tmp_path);
+
+  for (auto & blob : job->blobs) {
+    Task task;
+    task.job = job;
+    task.offset = blob.offset;
+    task.data = reinterpret_cast<const uint8_t*>(blob.bytes.data());
+    task.nbytes = blob.bytes.size();
+    push(std::move(task));
+  }
+
+  // the file is finished, and the staging buffer released, even if a copy
+  // fails
+  std::exception_ptr error;
+  try {
+    snapshot(job, tensors);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  Task task;
+  task.job = job;
+  task.finish = true;
+  task.error = error;
+  push(std::move(task));
+  if (error)
+    std::rethrow_exception(error);
+  return future;
+}
+
+void CheckpointWriter::snapshot(const std::shared_ptr<Job>& job,
+                                const std::vector<TensorSegment>& tensors) {
+  for (auto & segment : tensors) {
+    auto & tensor = segment.tensor;
+    size_t element_size = tensor.type().elementSizeInBytes();
+    size_t nbytes = tensor.numel() * element_size;
+    // chunks of whole elements, at most a quarter of the buffer, so that one
+    // chunk can be copied while earlier ones are written
+    size_t max_chunk = std::max(capacity_ / 4 / element_size, size_t(1)) * element_size;
+    at::Tensor flat = tensor.view({-1});
+    for (size_t begin = 0; begin < nbytes; begin += max_chunk) {
+      size_t n = std::min(max_chunk, nbytes - begin);
+      Task task;
+      task.job = job;
+      task.offset = segment.offset + begin;
+      size_t pos = reserve(n, task.staged);
+      if (tensor.is_cuda()) {
+        auto count = static_cast<int64_t>(n / element_size);
+        auto staged = tensor.type().toBackend(at::kCPU).tensorFromBlob(base_ + pos, {count});
+        staged.copy_(flat.narrow(0, begin / element_size, count));
+      } else {
+        std::memcpy(base_ + pos, static_cast<const uint8_t*>(tensor.data_ptr()) + begin, n);
+      }
+      task.data = base_ + pos;
+      task.nbytes = n;
+      push(std::move(task));
+    }
+  }
+}
+
+void CheckpointWriter::run() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_added_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      // the tasks that were pushed are finished before stopping
+      if (tasks_.empty())
+        return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    Job& job = *task.job;
+    if (task.finish) {
+      finish(job, task.error);
+      continue;
+    }
+    if (!job.error) {
+      try {
+        writeAt(job.fd, task.offset, task.data, task.nbytes);
+      } catch (...) {
+        job.error = std::current_exception();
+      }
+    }
+    if (task.staged > 0)
+      release(task.staged);
+  }
+}
+
+void CheckpointWriter::finish(Job& job, std::exception_ptr error) {
+  try {
+    if (job.error)
+      std::rethrow_exception(job.error);
+    if (error)
+      std::rethrow_exception(error);
+    if (job.fsync)
+      syncFile(job.fd);
+    int fd = job.fd;
+    job.fd = -1;
+    closeFile(fd);
+    replaceFile(job.tmp_path, job.path);
+    job.done.set_value();
+  } catch (...) {
+    if (job.fd >= 0)
+      close(job.fd);
+    std::remove(job.tmp_path.c_str());
+    job.done.set_exception(std::current_exception());
+  }
+}
+
+void initCheckpointBindings(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+
+  py::class_<std::shared_future<void>>(m, "_CheckpointFuture")
+    .def("wait", [](const std::shared_future<void>& future) {
+      future.get();
+    }, py::call_guard<py::gil_scoped_release>())
+    .def("done", [](const std::shared_future<void>& future) {
+      return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+
+  py::class_<CheckpointWriter>(m, "_CheckpointWriter")
+    .def(py::init([](const at::Tensor& staging) {
+      return new CheckpointWriter(autograd::as_variable_ref(staging).data());
+    }))
+    .def("write", [](CheckpointWriter& writer, const std::string& filename,
+                     std::vector<std::pair<int64_t, py::bytes>> blobs,
+                     std::vector<std::pair<int64_t, at::Tensor>> tensors,
+                     bool fsync) {
+      std::vector<CheckpointWriter::Blob> blob_segments;
+      for (auto & blob : blobs)
+        blob_segments.push_back({blob.first, blob.second});
+      std::vector<CheckpointWriter::TensorSegment> tensor_segments;
+      for (auto & tensor : tensors)
+        tensor_segments.push_back({tensor.first, autograd::as_variable_ref(tensor.second).data()});
+      py::gil_scoped_release no_gil;
+      return writer.write(filename, std::move(blob_segments), std::move(tensor_segments), fsync);
+    });
+}
+
+} // namespace torch
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "torch/csrc/python_headers.h"
+
+#include <ATen/ATen.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch {
+
+// Writes checkpoints to disk on a background thread.
+//
+// write() snapshots the tensors of a checkpoint into a staging buffer, and
+// returns once all of them are copied, so that the caller can change them
+// right away; the thread then writes the staging buffer to the file. The
+// staging buffer has a fixed size: a checkpoint larger than it is copied in
+// chunks, each as soon as the thread has written enough of the earlier ones,
+// so write() returns when all but at most a staging buffer of the checkpoint
+// is on its way to disk. Copies of CUDA tensors are fastest when the staging
+// buffer is pinned.
+//
+// A checkpoint is written to filename + ".tmp", which is renamed to filename
+// once all of it is written (and, with fsync, is on disk), so filename never
+// holds a partial checkpoint. Checkpoints are written in the order of the
+// calls to write().
+struct CheckpointWriter {
+  // bytes written at offset of the file
+  struct Blob {
+    int64_t offset;
+    std::string bytes;
+  };
+  // the bytes of a contiguous tensor, written at offset of the file
+  struct TensorSegment {
+    int64_t offset;
+    at::Tensor tensor;
+  };
+
+  // staging is a contiguous CPU byte tensor
+  explicit CheckpointWriter(at::Tensor staging);
+  // Finishes the checkpoints that were started.
+  ~CheckpointWriter();
+
+  // The future is ready when the checkpoint is in filename, and holds the
+  // error that stopped it otherwise.
+  std::shared_future<void> write(const std::string& filename,
+                                 std::vector<Blob> blobs,
+                                 std::vector<TensorSegment> tensors,
+                                 bool fsync);
+
+private:
+  struct Job;
+  struct Task {
+    std::shared_ptr<Job> job;
+    int64_t offset = 0;
+    const uint8_t* data = nullptr;
+    size_t nbytes = 0;
+    size_t staged = 0; // bytes of the staging buffer to release once written
+    bool finish = false;
+    std::exception_ptr error; // of the snapshot, for the finish task
+  };
+
+  // Returns the position of n contiguous free bytes of the staging buffer,
+  // and in used the number of bytes they take from it, waiting until there
+  // are.
+  size_t reserve(size_t n, size_t& used);
+  void release(size_t used);
+  void push(Task task);
+  // Copies the tensors to the staging buffer, and queues their writes.
+  void snapshot(const std::shared_ptr<Job>& job, const std::vector<TensorSegment>& tensors);
+  void run();
+  void finish(Job& job, std::exception_ptr error);
+
+  at::Tensor staging_;
+  uint8_t* base_;
+  size_t capacity_;
+
+  std::mutex mutex_;
+  std::condition_variable space_freed_;
+  std::condition_variable task_added_;
+  size_t head_ = 0;
+  size_t used_ = 0;
+  std::deque<Task> tasks_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+void initCheckpointBindings(PyObject* module);
+
+} // namespace torch
@@ -179,6 +179,39 @@ static PyObject * THPStorage_(fromBuffer)(PyObject *_unused, PyObject *args, PyO
 }
 #endif
 
+#if !defined(THC_GENERIC_FILE) && !defined(THD_GENERIC_FILE)
+// A storage of size elements that views the bytes of a ByteStorage from
+// offset on, and keeps it alive, e.g. a storage in a file mapped by
+// ByteStorage.from_file.
+static PyObject * THPStorage_(newWithBytes)(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *bytes;
+  Py_ssize_t offset, size;
+  if (!PyArg_ParseTuple(args, "Onn", &bytes, &offset, &size)) {
+    return NULL;
+  }
+  THPUtils_assert(THPByteStorage_Check(bytes), "_new_with_bytes expected a "
+      "torch.ByteStorage, but got %s", THPUtils_typename(bytes));
+  THByteStorage *byte_storage = ((THPByteStorage*)bytes)->cdata;
+  int64_t nbytes = THByteStorage_size(byte_storage);
+  THPUtils_assert(offset >= 0 && offset % sizeof(real) == 0,
+      "offset (%" PRId64 ") must be a non-negative multiple of the element size "
+      "(%" PRId64 ")", (int64_t)offset, (int64_t)sizeof(real));
+  THPUtils_assert(size >= 0 && offset <= nbytes &&
+      size <= (nbytes - offset) / (int64_t)sizeof(real), "storage has only %"
+      PRId64 " bytes, but specified %" PRId64 " elements at offset %" PRId64,
+      nbytes, (int64_t)size, (int64_t)offset);
+
+  real *data = (real*)(THByteStorage_data(byte_storage) + offset);
+  THWStorage *storage = THWStorage_(newWithDataAndAllocator)(data, size,
+      &THObjectPtrAllocator, new ObjectPtrAllocator(bytes, &THNoFreeAllocator, nullptr));
+  THWStorage_(clearFlag)(storage, TH_STORAGE_RESIZABLE);
+  return (PyObject*)THPStorage_(New)(storage);
+  END_HANDLE_TH_ERRORS
+}
+#endif
+
 static PyObject * THPStorage_(fromFile)(PyObject *_unused, PyObject *args, PyObject *keywds)
 {
   HANDLE_TH_ERRORS
@@ -328,6 +361,7 @@ static PyMethodDef THPStorage_(methods)[] = {
 #endif // !defined(THD_GENERIC_FILE)
 #if !defined(THC_GENERIC_FILE) && !defined(THD_GENERIC_FILE)
   {"from_buffer", (PyCFunction)THPStorage_(fromBuffer), METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
+  {"_new_with_bytes", (PyCFunction)THPStorage_(newWithBytes), METH_VARARGS | METH_STATIC, NULL},
 #endif
   {"from_file", (PyCFunction)THPStorage_(fromFile), METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
 #ifdef THC_GENERIC_FILE
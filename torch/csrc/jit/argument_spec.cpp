@@ -0,0 +1,134 @@
+#include "torch/csrc/jit/ir.h"
+#include "torch/csrc/jit/argument_spec.h"
+
+#include <map>
+#include <utility>
+
+namespace torch { namespace jit {
+
+namespace {
+
+std::vector<int64_t> contiguousStridesOf(at::IntList sizes) {
+  std::vector<int64_t> strides(sizes.size());
+  int64_t stride = 1;
+  for(size_t i = sizes.size(); i > 0; i--) {
+    strides[i - 1] = stride;
+    stride *= sizes[i - 1];
+  }
+  return strides;
+}
+
+bool isContiguous(at::IntList sizes, at::IntList strides) {
+  return strides.equals(contiguousStridesOf(sizes));
+}
+
+bool sameStructure(const SymbolicSpec::Input & input, const TensorInfo & t) {
+  if(t.defined() != input.defined)
+    return false;
+  if(!input.defined)
+    return true;
+  return t.type() == input.type &&
+         t.device() == input.device &&
+         t.requires_grad() == input.requires_grad &&
+         static_cast<size_t>(t.ndimension()) == input.sizes.size();
+}
+
+} // anonymous namespace
+
+SymbolicSpec::SymbolicSpec(const ArgumentSpec & spec) {
+  inputs.reserve(spec.size());
+  for(size_t i = 0; i < spec.size(); i++) {
+    auto t = spec.tensorInfo(i);
+    Input input;
+    input.defined = t.defined();
+    if(t.defined()) {
+      input.type = t.type();
+      input.device = t.device();
+      input.requires_grad = t.requires_grad();
+      input.sizes = t.sizes().vec();
+      input.strides = t.strides().vec();
+      input.symbols.resize(input.sizes.size(), 0);
+    }
+    inputs.push_back(std::move(input));
+  }
+}
+
+at::optional<SymbolicSpec> SymbolicSpec::generalize(const ArgumentSpec & spec) const {
+  if(spec.size() != inputs.size())
+    return at::nullopt;
+  SymbolicSpec result = *this;
+  result.num_symbols = 0;
+  // (symbol, or size if static, in this spec; size in spec) -> new symbol,
+  // where symbols are stored as negative numbers
+  std::map<std::pair<int64_t, int64_t>, int64_t> new_symbols;
+  for(size_t i = 0; i < inputs.size(); i++) {
+    auto t = spec.tensorInfo(i);
+    auto & input = result.inputs[i];
+    if(!sameStructure(input, t))
+      return at::nullopt;
+    if(!input.defined)
+      continue;
+    auto sizes = t.sizes();
+    bool has_symbols = false;
+    for(size_t d = 0; d < sizes.size(); d++) {
+      int64_t old_symbol = input.symbols[d];
+      if(old_symbol == 0 && input.sizes[d] == sizes[d])
+        continue;
+      if(sizes[d] < 2 || (old_symbol == 0 && input.sizes[d] < 2))
+        return at::nullopt;
+      auto key = std::make_pair(old_symbol != 0 ? -old_symbol : input.sizes[d], sizes[d]);
+      auto it = new_symbols.find(key);
+      if(it == new_symbols.end())
+        it = new_symbols.emplace(key, ++result.num_symbols).first;
+      input.symbols[d] = it->second;
+      input.sizes[d] = sizes[d];
+      has_symbols = true;
+    }
+    if(has_symbols) {
+      if(!isContiguous(sizes, t.strides()))
+        return at::nullopt;
+      if(!input.strides.empty() && !isContiguous(inputs[i].sizes, input.strides))
+        return at::nullopt;
+      input.strides.clear();
+    } else if(!t.strides().equals(input.strides)) {
+      return at::nullopt;
+    }
+  }
+  if(result.num_symbols == 0)
+    return at::nullopt;
+  return result;
+}
+
+bool SymbolicSpec::matches(const ArgumentSpec & spec) const {
+  if(spec.size() != inputs.size())
+    return false;
+  std::vector<int64_t> bound(num_symbols, -1);
+  for(size_t i = 0; i < inputs.size(); i++) {
+    auto t = spec.tensorInfo(i);
+    auto & input = inputs[i];
+    if(!sameStructure(input, t))
+      return false;
+    if(!input.defined)
+      continue;
+    auto sizes = t.sizes();
+    for(size_t d = 0; d < sizes.size(); d++) {
+      if(input.symbols[d] == 0) {
+        if(sizes[d] != input.sizes[d])
+          return false;
+        continue;
+      }
+      if(sizes[d] < 2)
+        return false;
+      auto & size = bound[input.symbols[d] - 1];
+      if(size == -1)
+        size = sizes[d];
+      else if(size != sizes[d])
+        return false;
+    }
+    if(input.strides.empty() ? !isContiguous(sizes, t.strides()) : !t.strides().equals(input.strides))
+      return false;
+  }
+  return true;
+}
+
+}}
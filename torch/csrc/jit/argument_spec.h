@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <vector>
+#include "ATen/optional.h"
 #include "torch/csrc/autograd/variable.h"
 #include "torch/csrc/utils/hash.h"
 #include "torch/csrc/jit/variable_tensor_list.h"
@@ -188,6 +189,58 @@ inline TensorInfo ArgumentSpec::tensorInfo(size_t i) const {
   return TensorInfo(*this, i);
 }
 
+// SymbolicSpec is a specialization in which some dimensions of the inputs are
+// symbolic, so that it matches the ArgumentSpecs of inputs of many sizes.
+// GraphExecutor creates one by generalizing a spec it has compiled when it sees
+// inputs that differ from it only in their sizes, e.g. batches of another size.
+//
+// A symbolic dimension matches any size >= 2, and all dimensions with the same
+// symbol must have the same size. Sizes 0 and 1 are never symbolic, because
+// broadcasting and squeezing treat them differently from other sizes. Only
+// the dimensions of contiguous inputs are made symbolic, and such inputs must
+// be contiguous to match.
+struct SymbolicSpec {
+  struct Input {
+    bool defined;
+    at::ScalarType type;
+    int device;
+    bool requires_grad;
+    // for a symbolic dimension, the size it had in the last spec that was
+    // generalized, which shape analysis uses as a hint for its example size
+    std::vector<int64_t> sizes;
+    // empty if the input has symbolic dimensions, since it is contiguous then
+    std::vector<int64_t> strides;
+    // 0 for static dimensions, otherwise the symbol (1-based) of the dimension
+    std::vector<int64_t> symbols;
+  };
+
+  // a spec without symbolic dimensions, that only matches spec
+  explicit SymbolicSpec(const ArgumentSpec & spec);
+
+  // A spec that matches spec and everything this spec matches, or nullopt if
+  // spec differs from this one in more than the sizes of contiguous inputs.
+  // Dimensions that differ become symbolic. Two dimensions get the same symbol
+  // if they have the same symbol or size in this spec and the same size in
+  // spec.
+  at::optional<SymbolicSpec> generalize(const ArgumentSpec & spec) const;
+
+  bool matches(const ArgumentSpec & spec) const;
+
+  size_t size() const {
+    return inputs.size();
+  }
+  const Input & input(size_t i) const {
+    return inputs.at(i);
+  }
+  size_t numSymbols() const {
+    return num_symbols;
+  }
+
+private:
+  std::vector<Input> inputs;
+  size_t num_symbols = 0;
+};
+
 }}
 
 namespace std {
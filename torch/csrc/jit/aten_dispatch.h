@@ -64,5 +64,9 @@ struct TensorOp {
 
 at::optional<TensorOp> findTensorOp(jit::Node* n);
 TensorOp getTensorOp(jit::Node* n);
+// The operation that runs the _out variant of n, if there is one. It takes the
+// inputs of n followed by the tensor to write the output into, and pushes that
+// tensor as its output.
+at::optional<TensorOp> findTensorOutOp(jit::Node* n);
 
 }} // namespace torch::jit;
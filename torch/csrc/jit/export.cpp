@@ -1,4 +1,5 @@
 #include "torch/csrc/jit/export.h"
+#include "torch/csrc/jit/mapped_model.h"
 #include "torch/csrc/onnx/onnx.h"
 #include "torch/csrc/autograd/symbolic.h"
 
@@ -6,6 +7,7 @@
 #include <ATen/ATen.h>
 #include <ATen/optional.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <memory>
@@ -405,6 +407,32 @@ RawDataExportMap ToModelProto(
   return raw_data_export_map;
 }
 
+std::string serializeModelProto(onnx::ModelProto& model_proto) {
+  size_t out_size;
+  pb_get_encoded_size(&out_size, onnx_ModelProto_fields, &model_proto.proto);
+
+  // Allocate storage and export the graph
+  std::string out(out_size, '\0');
+  pb_ostream_t ostream = pb_ostream_from_buffer(reinterpret_cast<pb_byte_t *>(&out[0]), out_size);
+  pb_encode(&ostream, onnx_ModelProto_fields, &model_proto.proto);
+  return out;
+}
+
+uint64_t alignUp(uint64_t n, uint64_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+// Writes zeros up to offset, which is not before the current position.
+void padTo(std::ofstream& out, uint64_t offset) {
+  static const char zeros[kMappedTensorAlignment] = {};
+  uint64_t pos = static_cast<uint64_t>(out.tellp());
+  while (pos < offset) {
+    uint64_t n = std::min<uint64_t>(offset - pos, sizeof(zeros));
+    out.write(zeros, n);
+    pos += n;
+  }
+}
+
 }  // namespace
 
 
@@ -439,15 +467,68 @@ std::tuple<std::string, RawDataExportMap> ExportGraph(
     graph, initializers, onnx_opset_version, defer_weight_export, operator_export_type,
     &model_proto);
 
-  size_t out_size;
-  pb_get_encoded_size(&out_size, onnx_ModelProto_fields, &model_proto.proto);
+  return std::make_tuple(serializeModelProto(model_proto), raw_data_export_map);
+}
 
-  // Allocate storage and export the graph
-  std::string out(out_size, '\0');
-  pb_ostream_t ostream = pb_ostream_from_buffer(reinterpret_cast<pb_byte_t *>(&out[0]), out_size);
-  pb_encode(&ostream, onnx_ModelProto_fields, &model_proto.proto);
+void ExportMappedGraph(
+                        const std::string& filename,
+                        const std::shared_ptr<Graph>& graph,
+                        const std::vector<at::Tensor> & initializers,
+                        int64_t onnx_opset_version,
+                        ::torch::onnx::OperatorExportTypes operator_export_type) {
+  // The initializers are deferred only so that the protobuf does not hold a
+  // copy of them; the export map, which has some of them cast to other types,
+  // is not used.
+  ::torch::onnx::ModelProto model_proto;
+  ToModelProto(
+    graph, initializers, onnx_opset_version, /*defer_weight_export=*/true,
+    operator_export_type, &model_proto);
+  std::string proto = serializeModelProto(model_proto);
+
+  // in their own scalar types, unlike the protobuf, which stores e.g. half
+  // tensors as int32
+  auto payloads = fmap(initializers, [](const at::Tensor& t) {
+    return t.contiguous().toBackend(at::kCPU);
+  });
+
+  MappedModelHeader header;
+  std::memcpy(header.magic, kMappedModelMagic, sizeof(header.magic));
+  header.version = kMappedModelVersion;
+  header.proto_offset = sizeof(MappedModelHeader);
+  header.proto_size = proto.size();
+  header.table_offset = alignUp(header.proto_offset + header.proto_size, alignof(MappedTensorEntry));
+  header.num_initializers = payloads.size();
+
+  std::vector<MappedTensorEntry> table;
+  uint64_t offset = header.table_offset + payloads.size() * sizeof(MappedTensorEntry);
+  for (auto & t : payloads) {
+    MappedTensorEntry entry;
+    entry.scalar_type = static_cast<int64_t>(t.type().scalarType());
+    entry.nbytes = t.numel() * t.type().elementSizeInBytes();
+    // empty tensors take no space, and must not point past the end of the file
+    entry.offset = entry.nbytes > 0 ? alignUp(offset, kMappedTensorAlignment) : 0;
+    offset = std::max(offset, entry.offset + entry.nbytes);
+    table.push_back(entry);
+  }
 
-  return std::make_tuple(out, raw_data_export_map);
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("could not open " + filename + " for writing");
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(proto.data(), proto.size());
+  padTo(out, header.table_offset);
+  out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(MappedTensorEntry));
+  for (size_t i = 0; i < payloads.size(); i++) {
+    if (table[i].nbytes == 0) {
+      continue;
+    }
+    padTo(out, table[i].offset);
+    out.write(static_cast<const char*>(payloads[i].data_ptr()), table[i].nbytes);
+  }
+  if (!out) {
+    throw std::runtime_error("could not write " + filename);
+  }
 }
 
 }}
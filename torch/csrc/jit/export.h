@@ -23,6 +23,18 @@ std::tuple<std::string, RawDataExportMap> ExportGraph(
     ::torch::onnx::OperatorExportTypes operator_export_type
       = ::torch::onnx::OperatorExportTypes::ONNX);
 
+// Writes graph and initializers to the file at filename in the container
+// described in mapped_model.h, in which the initializers are stored in their
+// own scalar types, outside the protobuf and page aligned, so that
+// ImportMappedIRGraph can map them instead of copying them.
+void ExportMappedGraph(
+    const std::string& filename,
+    const std::shared_ptr<Graph>& graph,
+    const std::vector<at::Tensor>& initializers,
+    int64_t onnx_opset_version,
+    ::torch::onnx::OperatorExportTypes operator_export_type
+      = ::torch::onnx::OperatorExportTypes::ONNX);
+
 // For testing purposes
 std::string PrettyPrintExportedGraph(
     const std::shared_ptr<Graph>& graph,
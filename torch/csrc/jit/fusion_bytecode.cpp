@@ -0,0 +1,548 @@
+#include "torch/csrc/jit/fusion_bytecode.h"
+#include "torch/csrc/assertions.h"
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch { namespace jit {
+
+namespace {
+
+using OpCode = FusedBytecodeKernel::OpCode;
+constexpr int64_t kBlockSize = FusedBytecodeKernel::kBlockSize;
+
+// Host-side view of the TensorInfo structs passed to launch_raw.
+struct TensorInfoView {
+  void * data;
+#pragma GCC diagnostic ignored "-Wpedantic"
+  uint32_t sizes_strides[0];
+#pragma GCC diagnostic pop
+
+  const uint32_t* sizes() const { return &sizes_strides[0]; }
+  const uint32_t* strides(size_t nDim) const { return &sizes_strides[nDim]; }
+};
+
+const std::unordered_map<NodeKind, OpCode> & opcodes() {
+  static std::unordered_map<NodeKind, OpCode> map = {
+    {aten::type_as, OpCode::Copy},
+    {aten::abs, OpCode::Abs},
+    {aten::neg, OpCode::Neg},
+    {aten::reciprocal, OpCode::Reciprocal},
+    {aten::relu, OpCode::Relu},
+    {aten::sigmoid, OpCode::Sigmoid},
+    {aten::exp, OpCode::Exp},
+    {aten::expm1, OpCode::Expm1},
+    {aten::log, OpCode::Log},
+    {aten::log10, OpCode::Log10},
+    {aten::log1p, OpCode::Log1p},
+    {aten::log2, OpCode::Log2},
+    {aten::lgamma, OpCode::Lgamma},
+    {aten::sqrt, OpCode::Sqrt},
+    {aten::rsqrt, OpCode::Rsqrt},
+    {aten::sin, OpCode::Sin},
+    {aten::cos, OpCode::Cos},
+    {aten::tan, OpCode::Tan},
+    {aten::asin, OpCode::Asin},
+    {aten::acos, OpCode::Acos},
+    {aten::atan, OpCode::Atan},
+    {aten::sinh, OpCode::Sinh},
+    {aten::cosh, OpCode::Cosh},
+    {aten::tanh, OpCode::Tanh},
+    {aten::ceil, OpCode::Ceil},
+    {aten::floor, OpCode::Floor},
+    {aten::round, OpCode::Round},
+    {aten::trunc, OpCode::Trunc},
+    {aten::frac, OpCode::Frac},
+    {aten::add, OpCode::Add},
+    {aten::sub, OpCode::Sub},
+    {aten::mul, OpCode::Mul},
+    {aten::div, OpCode::Div},
+    {aten::pow, OpCode::Pow},
+    {aten::fmod, OpCode::Fmod},
+    {aten::remainder, OpCode::Remainder},
+    {aten::atan2, OpCode::Atan2},
+    {aten::min, OpCode::Min},
+    {aten::max, OpCode::Max},
+    {aten::eq, OpCode::Eq},
+    {aten::ne, OpCode::Ne},
+    {aten::lt, OpCode::Lt},
+    {aten::le, OpCode::Le},
+    {aten::gt, OpCode::Gt},
+    {aten::ge, OpCode::Ge},
+    {aten::__and__, OpCode::And},
+    {aten::__or__, OpCode::Or},
+    {aten::__xor__, OpCode::Xor},
+    {aten::__lshift__, OpCode::Lshift},
+    {aten::__rshift__, OpCode::Rshift},
+    {aten::_sigmoid_backward, OpCode::SigmoidBackward},
+    {aten::_tanh_backward, OpCode::TanhBackward},
+    {aten::lerp, OpCode::Lerp},
+    {aten::clamp, OpCode::Clamp},
+  };
+  return map;
+}
+
+bool hasScalarAttribute(Node * n, Symbol name) {
+  if (!n->hasAttribute(name))
+    return false;
+  auto kind = n->kindOf(name);
+  return kind == AttributeKind::f || kind == AttributeKind::i ||
+    (kind == AttributeKind::t && n->t(name).dim() == 0);
+}
+
+float scalarAttribute(Node * n, Symbol name, float default_value) {
+  if (!hasScalarAttribute(n, name))
+    return default_value;
+  switch (n->kindOf(name)) {
+    case AttributeKind::f: return n->f(name);
+    case AttributeKind::i: return n->i(name);
+    default: return at::Scalar(n->t(name)).toDouble();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Block kernels
+
+template<typename F>
+inline void unary(float * d, const float * a, int64_t n, F f) {
+  for (int64_t j = 0; j < n; j++)
+    d[j] = f(a[j]);
+}
+
+template<typename F>
+inline void binary(float * d, const float * a, const float * b, int64_t n, F f) {
+  for (int64_t j = 0; j < n; j++)
+    d[j] = f(a[j], b[j]);
+}
+
+template<typename T>
+void loadBlock(const TensorInfoView & t, const int64_t * offsets, int64_t start, int64_t n, float * d) {
+  const T * data = static_cast<const T*>(t.data);
+  if (offsets) {
+    for (int64_t j = 0; j < n; j++)
+      d[j] = static_cast<float>(data[offsets[j]]);
+  } else {
+    data += start;
+    for (int64_t j = 0; j < n; j++)
+      d[j] = static_cast<float>(data[j]);
+  }
+}
+
+template<typename T>
+void storeBlock(const TensorInfoView & t, const int64_t * offsets, int64_t start, int64_t n, const float * a) {
+  T * data = static_cast<T*>(t.data);
+  if (offsets) {
+    for (int64_t j = 0; j < n; j++)
+      data[offsets[j]] = static_cast<T>(a[j]);
+  } else {
+    data += start;
+    for (int64_t j = 0; j < n; j++)
+      data[j] = static_cast<T>(a[j]);
+  }
+}
+
+// Loads or stores n elements of a tensor, converting from or to float.
+void transfer(bool load, at::ScalarType type, const TensorInfoView & t,
+              const int64_t * offsets, int64_t start, int64_t n, float * block) {
+  switch (type) {
+    #define DEFINE_CASE(ctype,name,_) \
+      case at::ScalarType::name: \
+        if (load) \
+          loadBlock<ctype>(t, offsets, start, n, block); \
+        else \
+          storeBlock<ctype>(t, offsets, start, n, block); \
+        break;
+    AT_FORALL_SCALAR_TYPES(DEFINE_CASE)
+    #undef DEFINE_CASE
+    default:
+      barf("fused CPU kernels do not support %s tensors", at::toString(type));
+  }
+}
+
+// Walks the elements of a strided tensor in linear order. The index is
+// advanced with carries rather than recomputed with a division per dimension
+// for every element, which is what the generated kernels do.
+struct StridedCursor {
+  void reset(const TensorInfoView & t, size_t nDim, int64_t linear_index) {
+    this->nDim = nDim;
+    sizes = t.sizes();
+    strides = t.strides(nDim);
+    index.assign(nDim, 0);
+    offset = 0;
+    for (int64_t d = nDim - 1; d >= 0; --d) {
+      index[d] = d > 0 ? linear_index % sizes[d] : linear_index;
+      offset += index[d] * strides[d];
+      linear_index /= sizes[d];
+    }
+  }
+  void fill(int64_t n, int64_t * offsets) {
+    const int64_t last = nDim - 1;
+    for (int64_t j = 0; j < n; j++) {
+      offsets[j] = offset;
+      offset += strides[last];
+      if (++index[last] == sizes[last]) {
+        carry(last);
+      }
+    }
+  }
+private:
+  void carry(int64_t d) {
+    while (d > 0 && index[d] == sizes[d]) {
+      offset -= index[d] * strides[d];
+      index[d] = 0;
+      --d;
+      index[d]++;
+      offset += strides[d];
+    }
+  }
+  size_t nDim = 0;
+  const uint32_t * sizes = nullptr;
+  const uint32_t * strides = nullptr;
+  std::vector<int64_t> index;
+  int64_t offset = 0;
+};
+
+} // anonymous namespace
+
+FusedBytecodeKernel::FusedBytecodeKernel(
+    Graph & graph,
+    at::ArrayRef<Value*> outputs,
+    std::vector<TensorDesc> formals_)
+  : formals(std::move(formals_)) {
+  const size_t num_inputs = graph.inputs().size();
+  JIT_ASSERT(formals.size() == num_inputs + outputs.size());
+
+  std::vector<Node*> nodes;
+  for (auto n : graph.nodes()) {
+    // Concat nodes are handled by narrowing the outputs before the kernel runs
+    if (n->kind() != aten::cat)
+      nodes.push_back(n);
+  }
+
+  // Registers are recycled once the last node reading them has executed, so
+  // that long fusion groups keep a small working set.
+  std::unordered_map<Value*, size_t> last_use;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    for (auto input : nodes[i]->inputs())
+      last_use[input] = i;
+  }
+  std::unordered_map<Value*, std::vector<uint32_t>> stores;
+  for (size_t i = 0; i < outputs.size(); ++i)
+    stores[outputs[i]].push_back(num_inputs + i);
+
+  std::unordered_map<Value*, uint32_t> registers;
+  std::vector<uint32_t> free_registers;
+  std::map<float, uint32_t> constant_registers;
+  auto allocate = [&]() -> uint32_t {
+    if (!free_registers.empty()) {
+      uint32_t r = free_registers.back();
+      free_registers.pop_back();
+      return r;
+    }
+    return num_registers++;
+  };
+  auto constant = [&](float value) -> uint32_t {
+    auto it = constant_registers.find(value);
+    if (it == constant_registers.end()) {
+      it = constant_registers.emplace(value, num_registers++).first;
+      constants.emplace_back(it->second, value);
+    }
+    return it->second;
+  };
+  auto define = [&](Value * v, uint32_t r, int64_t position) {
+    registers[v] = r;
+    auto s = stores.find(v);
+    if (s != stores.end()) {
+      for (auto formal : s->second)
+        program.push_back({OpCode::Store, formal, r, 0, 0.f, 0.f});
+    }
+    auto u = last_use.find(v);
+    if (u == last_use.end() || static_cast<int64_t>(u->second) <= position) {
+      free_registers.push_back(r);
+    }
+  };
+
+  auto release = [&](at::ArrayRef<Value*> inputs, size_t position) {
+    for (auto input : inputs) {
+      auto u = last_use.find(input);
+      if (u != last_use.end() && u->second == position) {
+        free_registers.push_back(registers.at(input));
+        last_use.erase(u); // release inputs that appear twice only once
+      }
+    }
+  };
+
+  for (size_t i = 0; i < num_inputs; ++i) {
+    auto r = allocate();
+    program.push_back({OpCode::Load, r, static_cast<uint32_t>(i), 0, 0.f, 0.f});
+    define(graph.inputs()[i], r, -1);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    Node * n = nodes[i];
+    if (n->kind() == aten::sum || n->kind() == aten::mean) {
+      // the graph fuser only admits reductions over the innermost dimension
+      // whose results are outputs of the group
+      uint32_t accumulator = num_accumulators++;
+      program.push_back({OpCode::Sum, accumulator, registers.at(n->input()), 0, 0.f, 0.f});
+      release(n->inputs(), i);
+      for (auto formal : stores.at(n->output()))
+        reductions.push_back({formal, accumulator, n->kind() == aten::mean});
+      continue;
+    }
+    auto op = opcodes().find(n->kind());
+    if (op == opcodes().end()) {
+      barf("fused CPU kernels do not support %s", n->kind().toQualString());
+    }
+    Instruction inst {op->second, 0, 0, 0, 0.f, 0.f};
+    auto inputs = n->inputs();
+    inst.a = registers.at(inputs.at(0));
+    if (inputs.size() > 1) {
+      inst.b = registers.at(inputs[1]);
+    } else if (hasScalarAttribute(n, attr::other)) {
+      inst.b = constant(scalarAttribute(n, attr::other, 0.f));
+    } else if (hasScalarAttribute(n, attr::exponent)) {
+      inst.b = constant(scalarAttribute(n, attr::exponent, 0.f));
+    }
+    switch (inst.op) {
+      case OpCode::Add:
+      case OpCode::Sub:
+        inst.s0 = scalarAttribute(n, attr::alpha, 1.f);
+        break;
+      case OpCode::Lerp:
+        inst.s0 = scalarAttribute(n, attr::weight, 0.f);
+        break;
+      case OpCode::Clamp:
+        inst.s0 = scalarAttribute(n, attr::min, -std::numeric_limits<float>::infinity());
+        inst.s1 = scalarAttribute(n, attr::max, std::numeric_limits<float>::infinity());
+        break;
+      default:
+        break;
+    }
+    // Allocate the result before releasing the inputs, so that no
+    // instruction reads and writes the same register.
+    inst.dst = allocate();
+    program.push_back(inst);
+    release(inputs, i);
+    define(n->output(), inst.dst, i);
+  }
+}
+
+void FusedBytecodeKernel::run(uint32_t numel, void ** arguments) const {
+  const size_t num_formals = formals.size();
+  std::vector<const TensorInfoView*> infos(num_formals);
+  std::vector<bool> contiguous(num_formals);
+  std::vector<bool> reduced(num_formals);
+  for (size_t i = 0; i < num_formals; ++i) {
+    infos[i] = static_cast<const TensorInfoView*>(arguments[i + 1]);
+    contiguous[i] = formals[i].nDim() == 1 && formals[i].lastIsContiguous();
+  }
+  for (auto & r : reductions)
+    reduced[r.formal] = true;
+  // Without reductions every element is a row of its own.
+  int64_t row_size = 1;
+  if (!reductions.empty()) {
+    row_size = *static_cast<const uint32_t*>(arguments[num_formals + 1]);
+    JIT_ASSERT(row_size > 0);
+  }
+  const int64_t num_rows = numel / row_size;
+  const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / row_size, 1);
+
+  at::parallel_for(0, num_rows, grain_size, [&](int64_t row_begin, int64_t row_end) {
+    if (row_begin >= row_end)
+      return;
+    const int64_t begin = row_begin * row_size;
+    const int64_t end = row_end * row_size;
+    std::vector<float> storage(num_registers * kBlockSize);
+    std::vector<float> accumulators(num_accumulators);
+    std::vector<int64_t> offsets(num_formals * kBlockSize);
+    std::vector<StridedCursor> cursors(num_formals);
+    for (size_t i = 0; i < num_formals; ++i) {
+      if (!contiguous[i])
+        cursors[i].reset(*infos[i], formals[i].nDim(), reduced[i] ? row_begin : begin);
+    }
+    auto reg = [&](uint32_t r) { return &storage[r * kBlockSize]; };
+    for (auto & c : constants)
+      std::fill_n(reg(c.first), kBlockSize, c.second);
+
+    auto runBlock = [&](int64_t start, int64_t n) {
+      for (size_t i = 0; i < num_formals; ++i) {
+        if (!contiguous[i] && !reduced[i])
+          cursors[i].fill(n, &offsets[i * kBlockSize]);
+      }
+      for (auto & inst : program) {
+        if (inst.op == OpCode::Load || inst.op == OpCode::Store) {
+          uint32_t formal = inst.op == OpCode::Load ? inst.a : inst.dst;
+          const int64_t * offs = contiguous[formal] ? nullptr : &offsets[formal * kBlockSize];
+          if (inst.op == OpCode::Load)
+            transfer(true, formals[formal].scalar_type, *infos[formal], offs, start, n, reg(inst.dst));
+          else
+            transfer(false, formals[formal].scalar_type, *infos[formal], offs, start, n, reg(inst.a));
+          continue;
+        }
+        if (inst.op == OpCode::Sum) {
+          const float * a = reg(inst.a);
+          float sum = 0.f;
+          for (int64_t j = 0; j < n; j++)
+            sum += a[j];
+          accumulators[inst.dst] += sum;
+          continue;
+        }
+        float * d = reg(inst.dst);
+        const float * a = reg(inst.a);
+        const float * b = reg(inst.b);
+        const float s0 = inst.s0;
+        const float s1 = inst.s1;
+        switch (inst.op) {
+          case OpCode::Copy: std::copy(a, a + n, d); break;
+          case OpCode::Abs: unary(d, a, n, [](float x) { return std::fabs(x); }); break;
+          case OpCode::Neg: unary(d, a, n, [](float x) { return -x; }); break;
+          case OpCode::Reciprocal: unary(d, a, n, [](float x) { return 1.f / x; }); break;
+          case OpCode::Relu: unary(d, a, n, [](float x) { return x < 0 ? 0.f : x; }); break;
+          case OpCode::Sigmoid: unary(d, a, n, [](float x) { return 1.f / (1.f + std::exp(-x)); }); break;
+          case OpCode::Exp: unary(d, a, n, [](float x) { return std::exp(x); }); break;
+          case OpCode::Expm1: unary(d, a, n, [](float x) { return std::expm1(x); }); break;
+          case OpCode::Log: unary(d, a, n, [](float x) { return std::log(x); }); break;
+          case OpCode::Log10: unary(d, a, n, [](float x) { return std::log10(x); }); break;
+          case OpCode::Log1p: unary(d, a, n, [](float x) { return std::log1p(x); }); break;
+          case OpCode::Log2: unary(d, a, n, [](float x) { return std::log2(x); }); break;
+          case OpCode::Lgamma: unary(d, a, n, [](float x) { return std::lgamma(x); }); break;
+          case OpCode::Sqrt: unary(d, a, n, [](float x) { return std::sqrt(x); }); break;
+          case OpCode::Rsqrt: unary(d, a, n, [](float x) { return 1.f / std::sqrt(x); }); break;
+          case OpCode::Sin: unary(d, a, n, [](float x) { return std::sin(x); }); break;
+          case OpCode::Cos: unary(d, a, n, [](float x) { return std::cos(x); }); break;
+          case OpCode::Tan: unary(d, a, n, [](float x) { return std::tan(x); }); break;
+          case OpCode::Asin: unary(d, a, n, [](float x) { return std::asin(x); }); break;
+          case OpCode::Acos: unary(d, a, n, [](float x) { return std::acos(x); }); break;
+          case OpCode::Atan: unary(d, a, n, [](float x) { return std::atan(x); }); break;
+          case OpCode::Sinh: unary(d, a, n, [](float x) { return std::sinh(x); }); break;
+          case OpCode::Cosh: unary(d, a, n, [](float x) { return std::cosh(x); }); break;
+          case OpCode::Tanh: unary(d, a, n, [](float x) { return std::tanh(x); }); break;
+          case OpCode::Ceil: unary(d, a, n, [](float x) { return std::ceil(x); }); break;
+          case OpCode::Floor: unary(d, a, n, [](float x) { return std::floor(x); }); break;
+          case OpCode::Round: unary(d, a, n, [](float x) { return std::round(x); }); break;
+          case OpCode::Trunc: unary(d, a, n, [](float x) { return std::trunc(x); }); break;
+          case OpCode::Frac: unary(d, a, n, [](float x) { return x - std::trunc(x); }); break;
+          case OpCode::Add: binary(d, a, b, n, [s0](float x, float y) { return x + s0 * y; }); break;
+          case OpCode::Sub: binary(d, a, b, n, [s0](float x, float y) { return x - s0 * y; }); break;
+          case OpCode::Mul: binary(d, a, b, n, [](float x, float y) { return x * y; }); break;
+          case OpCode::Div: binary(d, a, b, n, [](float x, float y) { return x / y; }); break;
+          case OpCode::Pow: binary(d, a, b, n, [](float x, float y) { return std::pow(x, y); }); break;
+          case OpCode::Fmod: binary(d, a, b, n, [](float x, float y) { return std::fmod(x, y); }); break;
+          case OpCode::Remainder:
+            binary(d, a, b, n, [](float x, float y) { return x - y * std::floor(x / y); });
+            break;
+          case OpCode::Atan2: binary(d, a, b, n, [](float x, float y) { return std::atan2(x, y); }); break;
+          case OpCode::Min: binary(d, a, b, n, [](float x, float y) { return std::fmin(x, y); }); break;
+          case OpCode::Max: binary(d, a, b, n, [](float x, float y) { return std::fmax(x, y); }); break;
+          case OpCode::Eq: binary(d, a, b, n, [](float x, float y) { return float(x == y); }); break;
+          case OpCode::Ne: binary(d, a, b, n, [](float x, float y) { return float(x != y); }); break;
+          case OpCode::Lt: binary(d, a, b, n, [](float x, float y) { return float(x < y); }); break;
+          case OpCode::Le: binary(d, a, b, n, [](float x, float y) { return float(x <= y); }); break;
+          case OpCode::Gt: binary(d, a, b, n, [](float x, float y) { return float(x > y); }); break;
+          case OpCode::Ge: binary(d, a, b, n, [](float x, float y) { return float(x >= y); }); break;
+          case OpCode::And: binary(d, a, b, n, [](float x, float y) { return float(x && y); }); break;
+          case OpCode::Or: binary(d, a, b, n, [](float x, float y) { return float(x || y); }); break;
+          case OpCode::Xor:
+            binary(d, a, b, n, [](float x, float y) {
+              return float(static_cast<int64_t>(x) ^ static_cast<int64_t>(y));
+            });
+            break;
+          case OpCode::Lshift: binary(d, a, b, n, [](float x, float y) { return x * std::exp2(y); }); break;
+          case OpCode::Rshift: binary(d, a, b, n, [](float x, float y) { return x / std::exp2(y); }); break;
+          case OpCode::SigmoidBackward:
+            binary(d, a, b, n, [](float x, float y) { return x * y * (1.f - y); });
+            break;
+          case OpCode::TanhBackward:
+            binary(d, a, b, n, [](float x, float y) { return x * (1.f - y * y); });
+            break;
+          case OpCode::Lerp:
+            binary(d, a, b, n, [s0](float x, float y) { return x + s0 * (y - x); });
+            break;
+          case OpCode::Clamp:
+            unary(d, a, n, [s0, s1](float x) { return std::min(std::max(x, s0), s1); });
+            break;
+          default:
+            JIT_ASSERT(false);
+        }
+      }
+    };
+
+    if (reductions.empty()) {
+      for (int64_t start = begin; start < end; start += kBlockSize)
+        runBlock(start, std::min(kBlockSize, end - start));
+      return;
+    }
+    for (int64_t row = row_begin; row < row_end; row++) {
+      std::fill(accumulators.begin(), accumulators.end(), 0.f);
+      const int64_t row_start = row * row_size;
+      const int64_t row_stop = row_start + row_size;
+      for (int64_t start = row_start; start < row_stop; start += kBlockSize)
+        runBlock(start, std::min(kBlockSize, row_stop - start));
+      for (auto & r : reductions) {
+        float value = accumulators[r.accumulator];
+        if (r.mean)
+          value /= row_size;
+        int64_t offset = row;
+        if (!contiguous[r.formal])
+          cursors[r.formal].fill(1, &offset);
+        transfer(false, formals[r.formal].scalar_type, *infos[r.formal], &offset, 0, 1, &value);
+      }
+    }
+  });
+}
+
+std::ostream & operator<<(std::ostream & out, FusedBytecodeKernel::OpCode op) {
+  static const char * names[] = {
+    "Load", "Store",
+    "Copy", "Abs", "Neg", "Reciprocal", "Relu", "Sigmoid", "Exp", "Expm1", "Log", "Log10", "Log1p",
+    "Log2", "Lgamma", "Sqrt", "Rsqrt", "Sin", "Cos", "Tan", "Asin", "Acos", "Atan", "Sinh", "Cosh",
+    "Tanh", "Ceil", "Floor", "Round", "Trunc", "Frac",
+    "Add", "Sub", "Mul", "Div", "Pow", "Fmod", "Remainder", "Atan2", "Min", "Max",
+    "Eq", "Ne", "Lt", "Le", "Gt", "Ge", "And", "Or", "Xor", "Lshift", "Rshift",
+    "SigmoidBackward", "TanhBackward",
+    "Lerp", "Clamp",
+    "Sum",
+  };
+  JIT_ASSERT(static_cast<size_t>(op) < sizeof(names) / sizeof(names[0]));
+  return out << names[static_cast<size_t>(op)];
+}
+
+std::string FusedBytecodeKernel::str() const {
+  std::stringstream out;
+  for (auto & c : constants)
+    out << "r" << c.first << " = " << c.second << "\n";
+  for (auto & inst : program) {
+    switch (inst.op) {
+      case OpCode::Load:
+        out << "r" << inst.dst << " = Load t" << inst.a << "\n";
+        break;
+      case OpCode::Store:
+        out << "Store t" << inst.dst << ", r" << inst.a << "\n";
+        break;
+      case OpCode::Sum:
+        out << "a" << inst.dst << " += Sum r" << inst.a << "\n";
+        break;
+      default:
+        out << "r" << inst.dst << " = " << inst.op << " r" << inst.a << ", r" << inst.b;
+        if (inst.op == OpCode::Add || inst.op == OpCode::Sub || inst.op == OpCode::Lerp)
+          out << ", " << inst.s0;
+        if (inst.op == OpCode::Clamp)
+          out << ", " << inst.s0 << ", " << inst.s1;
+        out << "\n";
+    }
+  }
+  for (auto & r : reductions)
+    out << "Store t" << r.formal << ", a" << r.accumulator << (r.mean ? " / row_size" : "") << "\n";
+  return out.str();
+}
+
+}} // namespace torch::jit
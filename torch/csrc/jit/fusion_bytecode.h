@@ -0,0 +1,100 @@
+#pragma once
+#include "torch/csrc/jit/fusion_compiler.h"
+#include "torch/csrc/jit/ir.h"
+#include "torch/csrc/utils/disallow_copy.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace torch { namespace jit {
+
+// An in-process backend for CPU fusion groups.
+//
+// Rather than emitting C++ and running it through the system compiler, the
+// fusion group is lowered to a short linear program over float registers.
+// Each register holds a block of kBlockSize consecutive elements and each
+// instruction is a tight loop over one block, so the cost of dispatching an
+// instruction is amortized over the whole block and the loops themselves are
+// vectorized by the compiler that built PyTorch. Like the generated kernels,
+// all arithmetic is done in float; loads and stores convert from and to the
+// scalar type of the tensor.
+//
+// Sums and means over the innermost dimension of the map accumulate each
+// block into a per-row accumulator, and are stored when the row is done.
+// Kernels with reductions walk the map row by row, so that every row is
+// reduced by a single thread.
+//
+// run() takes its arguments in the layout launch_raw uses for compiled
+// kernels: arguments[0] points to numel and is followed by one TensorInfo
+// (data pointer, then compressed sizes, then compressed strides) per input
+// and per flattened output, and, for kernels with reductions, by a pointer to
+// the size of the reduced dimension.
+struct FusedBytecodeKernel {
+  TH_DISALLOW_COPY_AND_ASSIGN(FusedBytecodeKernel);
+
+  // outputs lists the values written to the output TensorInfos, in argument
+  // order (concatenated outputs contribute one value per subtensor).
+  // formals describes the graph inputs followed by these outputs.
+  FusedBytecodeKernel(
+      Graph & graph,
+      at::ArrayRef<Value*> outputs,
+      std::vector<TensorDesc> formals);
+
+  void run(uint32_t numel, void ** arguments) const;
+
+  // A listing of the program, for PYTORCH_FUSION_DEBUG.
+  std::string str() const;
+
+  static constexpr int64_t kBlockSize = 128;
+
+  enum class OpCode : uint8_t {
+    Load, Store,
+    // unary
+    Copy, Abs, Neg, Reciprocal, Relu, Sigmoid, Exp, Expm1, Log, Log10, Log1p,
+    Log2, Lgamma, Sqrt, Rsqrt, Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh,
+    Tanh, Ceil, Floor, Round, Trunc, Frac,
+    // binary
+    Add, Sub, Mul, Div, Pow, Fmod, Remainder, Atan2, Min, Max,
+    Eq, Ne, Lt, Le, Gt, Ge, And, Or, Xor, Lshift, Rshift,
+    SigmoidBackward, TanhBackward,
+    // binary with scalar parameters
+    Lerp, Clamp,
+    // adds up a register into an accumulator
+    Sum,
+  };
+
+  struct Instruction {
+    OpCode op;
+    // Load/Store: argument index into arguments[1:]; Sum: an accumulator;
+    // otherwise a register.
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    // alpha of add/sub, weight of lerp, bounds of clamp
+    float s0;
+    float s1;
+  };
+
+  // An output reduced over the innermost dimension of the map.
+  struct Reduction {
+    uint32_t formal;
+    uint32_t accumulator;
+    bool mean;
+  };
+
+private:
+  std::vector<Instruction> program;
+  // stored after each row, in this order
+  std::vector<Reduction> reductions;
+  size_t num_accumulators = 0;
+  // registers holding constants, filled once per parallel chunk
+  std::vector<std::pair<uint32_t, float>> constants;
+  std::vector<TensorDesc> formals;
+  size_t num_registers = 0;
+};
+
+std::ostream & operator<<(std::ostream & out, FusedBytecodeKernel::OpCode op);
+
+}} // namespace torch::jit
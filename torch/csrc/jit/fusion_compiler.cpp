@@ -1,5 +1,7 @@
 #ifndef _WIN32
 #include "torch/csrc/jit/fusion_compiler.h"
+#include "torch/csrc/jit/fusion_bytecode.h"
+#include "torch/csrc/jit/fusion_kernel_cache.h"
 #include "torch/csrc/jit/ir.h"
 #include "torch/csrc/jit/code_template.h"
 #include "torch/csrc/jit/resource_guard.h"
@@ -20,6 +22,8 @@
 #include <vector>
 #include <sstream>
 #include <iostream>
+#include <limits>
+#include <cstdio>
 #include <dlfcn.h>
 #include <unistd.h>
 
@@ -47,6 +51,12 @@ static int ceilDiv(int a, int b) {
 
 #endif
 
+// The graph fuser only lets sums and means over the innermost dimension of
+// the map into a fusion group, and only as outputs (see graph_fuser.cpp).
+bool isReduction(Node * n) {
+  return n->kind() == aten::sum || n->kind() == aten::mean;
+}
+
 std::ostream& operator<<(std::ostream & out, const TensorDesc & d) {
   out << d.scalar_type << "[";
   for(auto b : d.contiguity)
@@ -122,6 +132,125 @@ void ${kernelName}(IndexType totalElements, void ** args) {
 }
 )");
 
+// Used by CPU kernels whose tensors are all contiguous. Every element is
+// addressed by linearIndex alone, so the inner loop over a block has no index
+// arithmetic and is vectorized by the host compiler.
+auto cpu_contiguous_compilation_unit_template = CodeTemplate(R"(
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+${type_declarations}
+${vectorizable_math}
+
+#define OMP_THRESHOLD 100000
+#define BLOCK_SIZE 4096
+static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
+  ${dataPointers}
+  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
+  for (IndexType blockStart = 0; blockStart < totalElements; blockStart += BLOCK_SIZE) {
+    IndexType blockEnd = totalElements - blockStart > BLOCK_SIZE ? blockStart + BLOCK_SIZE : totalElements;
+    #pragma omp simd
+    for (IndexType linearIndex = blockStart; linearIndex < blockEnd; linearIndex++) {
+      ${kernelBody}
+    }
+  }
+}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
+// Used by CPU kernels that end in reductions over the innermost dimension of
+// the map. Each row of the map is reduced by one thread; tensors that have
+// the size of the map are indexed by linearIndex as in the kernels above,
+// and reduced outputs by rowIndex.
+auto cpu_reduction_compilation_unit_template = CodeTemplate(R"(
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+${type_declarations}
+${vectorizable_math}
+
+#define OMP_THRESHOLD 100000
+static void ${kernelName}_kernel(IndexType totalElements, IndexType reductionSize, ${formals}) {
+  ${dataPointers}
+  IndexType totalRows = totalElements / reductionSize;
+  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
+  for (IndexType rowIndex = 0; rowIndex < totalRows; rowIndex++) {
+    ${accumulators}
+    IndexType rowStart = rowIndex * reductionSize;
+    ${innerLoopPragma}
+    for (IndexType linearIndex = rowStart; linearIndex < rowStart + reductionSize; linearIndex++) {
+      ${tensorOffsets}
+      ${kernelBody}
+    }
+    ${reductionOffsets}
+    ${reductionBody}
+  }
+}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements, *static_cast<IndexType*>(args[${reduction_size_index}]) ${,argument_loads});
+}
+)");
+
+// expf and tanhf from libm are opaque calls that keep the loops above from
+// being vectorized. These versions are written as straight-line arithmetic
+// and selects, which the compiler turns into SIMD code. fused_expf is the
+// Cephes approximation: x = n * ln(2) + r with |r| <= ln(2) / 2, exp(r) from a
+// polynomial and 2^n assembled from exponent bits, in two halves so that
+// n = -126 and n = 128 stay representable. Its relative error is about 1 ulp.
+// Rounding t to the nearest integer uses the 1.5 * 2^23 trick rather than a
+// branch or a float to int conversion of an unclamped value, both of which
+// prevent if-conversion. fused_tanhf is the Cephes tanhf: 1 - 2 / (exp(2x) + 1)
+// cancels for small |x|, so below 0.625 an odd polynomial is selected
+// instead. Its relative error is about 2 ulp.
+constexpr auto vectorizable_math_literal = R"(
+static inline float fused_expf(float x) {
+  float c = x < -87.3365447505531f ? -87.3365447505531f : x;
+  c = c > 88.7228391116729f ? 88.7228391116729f : c;
+  float t = c * 1.44269504088896341f;
+  float fx = (t + 12582912.f) - 12582912.f;
+  int n = (int)fx;
+  float r = c - fx * 0.693359375f + fx * 2.12194440e-4f;
+  float y = 1.9875691500e-4f;
+  y = y * r + 1.3981999507e-3f;
+  y = y * r + 8.3334519073e-3f;
+  y = y * r + 4.1665795894e-2f;
+  y = y * r + 1.6666665459e-1f;
+  y = y * r + 5.0000001201e-1f;
+  y = y * r * r + r + 1.f;
+  int n1 = n >> 1;
+  unsigned int b1 = (unsigned int)(n1 + 127) << 23;
+  unsigned int b2 = (unsigned int)(n - n1 + 127) << 23;
+  float p1, p2;
+  memcpy(&p1, &b1, sizeof(p1));
+  memcpy(&p2, &b2, sizeof(p2));
+  float result = y * p1 * p2;
+  result = x > 88.7228391116729f ? INFINITY : result;
+  result = x < -87.3365447505531f ? 0.f : result;
+  return x != x ? x : result;
+}
+
+static inline float fused_tanhf(float x) {
+  float z = x * x;
+  float p = -5.70498872745e-3f;
+  p = p * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  float small = p * z * x + x;
+  float large = 1.f - 2.f / (fused_expf(2.f * x) + 1.f);
+  float ax = x < 0.f ? -x : x;
+  return ax < 0.625f ? small : large;
+}
+)";
+
 // This snippet enables half support in the jit. Following the pattern for
 // reductions, fp16 input data is immediately upconverted to float
 // with __half2float(). All mathematical operations are done on float
@@ -169,11 +298,13 @@ size_t ${tensor}_dimIndex${d} = ${tensor}_linearIndex ${mod_sizes};
 ${tensor}_offset += ${tensor}_dimIndex${d} ${times_stride};
 )");
 
-void emitIndexingFor(std::ostream & out, const std::string & tensor, int ndim, bool last_is_cont) {
+void emitIndexingFor(std::ostream & out, const std::string & tensor, int ndim, bool last_is_cont,
+                     const std::string & index = "linearIndex") {
   TemplateEnv env;
   env.s("tensor",tensor);
+  env.s("index",index);
   out << format("IndexType ${tensor}_offset = 0;\n",env);
-  out << format("IndexType ${tensor}_linearIndex = linearIndex;\n",env);
+  out << format("IndexType ${tensor}_linearIndex = ${index};\n",env);
   for(int d = ndim - 1; d >= 0; --d) {
     env.d("d",d);
     env.s("mod_sizes", d > 0 ? format("% ${tensor}.sizes[${d}]",env) : "");
@@ -212,7 +343,15 @@ const char * scalarTypeName(at::ScalarType type) {
   }
 }
 
-std::string encodeRHS(Node * n) {
+// vectorizable_math selects the versions of exp, sigmoid and tanh that are
+// defined in vectorizable_math_literal.
+std::string encodeRHS(Node * n, bool vectorizable_math) {
+  static std::unordered_map<NodeKind, std::string> vectorizable_math_ops = {
+    {aten::sigmoid, "1.f / (1.f + fused_expf(-${0}))"},
+    {aten::exp, "fused_expf(${0})"},
+    {aten::tanh, "fused_tanhf(${0})"},
+  };
+
   static std::unordered_map<NodeKind, std::string> simple_map_ops = {
     // unary
     {aten::abs, "absf(${0})"},
@@ -305,6 +444,11 @@ std::string encodeRHS(Node * n) {
       }
     }
   }
+  if(vectorizable_math) {
+    auto it = vectorizable_math_ops.find(n->kind());
+    if(it != vectorizable_math_ops.end())
+      return format(it->second, env);
+  }
   const auto & str = simple_map_ops.at(n->kind());
   return format(str, env);
 }
@@ -321,18 +465,34 @@ std::vector<ConcatDesc> emitCompilationUnit(std::ostream & out,
 
   std::stringstream body;
   std::stringstream tensorOffsets;
+  std::stringstream dataPointers;
+  // reductions accumulate over a row of the map in the inner loop, and are
+  // indexed by rowIndex when they are stored after it
+  std::stringstream reductionOffsets;
+  std::stringstream accumulators;
+  std::stringstream reductionBody;
+  std::vector<std::string> accumulator_names;
   std::vector<std::string> formals;
   std::vector<std::string> argument_loads;
+  bool all_contiguous = true;
   auto emitFormal = [&](Value * n, const TensorDesc & desc) {
     std::string tensor = "t" + std::to_string(formals.size()); //can't be unique() because Param may be an output
     size_t nDim = desc.nDim();
-    emitIndexingFor(tensorOffsets, tensor, nDim,  desc.lastIsContiguous());
+    if(isReduction(n->node())) {
+      emitIndexingFor(reductionOffsets, tensor, nDim, desc.lastIsContiguous(), "rowIndex");
+    } else {
+      emitIndexingFor(tensorOffsets, tensor, nDim,  desc.lastIsContiguous());
+      all_contiguous = all_contiguous && nDim == 1 && desc.lastIsContiguous();
+    }
     env.s("tensor",tensor);
     env.d("formal_index", formals.size() + 1); // + 1 because the first argument is the linearIndex
     env.d("nDim",nDim);
     env.s("scalar_type",scalarTypeName(desc.scalar_type));
     formals.push_back(format("TensorInfo<${scalar_type},${nDim}> ${tensor}",env));
     argument_loads.push_back(format("*static_cast<TensorInfo<${scalar_type},${nDim}>*>(args[${formal_index}])",env));
+    // outputs are never views of inputs (launch allocates them), so the
+    // pointers can be marked restrict for the vectorizer
+    dataPointers << format("${scalar_type} * __restrict__ ${tensor}_data = ${tensor}.data;\n",env);
   };
   {
     size_t i = 0;
@@ -361,6 +521,11 @@ std::vector<ConcatDesc> emitCompilationUnit(std::ostream & out,
     }
   }
 
+  const bool contiguous_cpu_kernel = !use_cuda && all_contiguous;
+  // contiguous CPU kernels index every tensor with linearIndex directly
+  const char * element_access = contiguous_cpu_kernel ?
+    "t${formal}_data[linearIndex]" : "t${formal}.data[t${formal}_offset]";
+
   bool has_half_tensor = false;
   size_t formal_count = 0;
   for(auto p : subgraph.inputs()) {
@@ -375,7 +540,7 @@ std::vector<ConcatDesc> emitCompilationUnit(std::ostream & out,
       , format("__half2float(t${formal}.data[t${formal}_offset])", env));
       has_half_tensor = true;
     } else {
-      env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+      env.s("access", format(element_access, env));
     }
     
     //TODO: actual type propagation rather than relying on auto..
@@ -386,14 +551,26 @@ std::vector<ConcatDesc> emitCompilationUnit(std::ostream & out,
     if(n->kind() == aten::cat)
       continue; // Concat nodes by narrowing the output Tensors before the kernel runs
     env.s("node",valueName(n->output()));
-    env.s("rhs", encodeRHS(n));
+    if(isReduction(n)) {
+      env.s("input",valueName(n->input()));
+      accumulators << format("float ${node} = 0.f;\n",env);
+      accumulator_names.push_back(valueName(n->output()));
+      body << format("${node} += ${input};\n",env);
+      continue;
+    }
+    env.s("rhs", encodeRHS(n, contiguous_cpu_kernel));
     body << format("auto ${node} = ${rhs};\n",env);
   }
 
   for(auto o : flat_output_nodes) {
     env.d("formal",formal_count++);
-    env.s("access",format("t${formal}.data[t${formal}_offset]",env));
     env.s("node",valueName(o));
+    if(isReduction(o->node())) {
+      env.s("mean", o->node()->kind() == aten::mean ? " / reductionSize" : "");
+      reductionBody << format("t${formal}.data[t${formal}_offset] = ${node}${mean};\n",env);
+      continue;
+    }
+    env.s("access",format(element_access,env));
 
     // Acquires and converts (if needed) outputs
     auto ot = o->type()->cast<TensorType>();
@@ -417,8 +594,30 @@ std::vector<ConcatDesc> emitCompilationUnit(std::ostream & out,
   env.v("formals",formals);
   env.v("argument_loads",argument_loads);
   env.s("type_declarations", type_declarations_template.format(env));
-  if(use_cuda) {
+  if(!accumulator_names.empty()) {
+    JIT_ASSERTM(!use_cuda, "reductions are only fused into CPU kernels");
+    env.s("dataPointers",contiguous_cpu_kernel ? dataPointers.str() : "");
+    env.s("tensorOffsets",contiguous_cpu_kernel ? "" : tensorOffsets.str());
+    env.s("vectorizable_math",contiguous_cpu_kernel ? vectorizable_math_literal : "");
+    std::stringstream simd_pragma;
+    if(contiguous_cpu_kernel) {
+      simd_pragma << "#pragma omp simd reduction(+:";
+      for(size_t i = 0; i < accumulator_names.size(); ++i)
+        simd_pragma << (i > 0 ? "," : "") << accumulator_names[i];
+      simd_pragma << ")";
+    }
+    env.s("innerLoopPragma",simd_pragma.str());
+    env.s("accumulators",accumulators.str());
+    env.s("reductionOffsets",reductionOffsets.str());
+    env.s("reductionBody",reductionBody.str());
+    env.d("reduction_size_index",formals.size() + 1);
+    out << cpu_reduction_compilation_unit_template.format(env);
+  } else if(use_cuda) {
     out << cuda_compilation_unit_template.format(env);
+  } else if(contiguous_cpu_kernel) {
+    env.s("dataPointers",dataPointers.str());
+    env.s("vectorizable_math",vectorizable_math_literal);
+    out << cpu_contiguous_compilation_unit_template.format(env);
   } else {
     out << cpu_compilation_unit_template.format(env);
   }
@@ -446,7 +645,10 @@ struct TensorInfo {
 CompiledFusionFunction::CompiledFusionFunction(const std::string & name, AnnotatedGraph & agraph)
   : name(name)
   , input_desc(agraph.input_desc)
-  , output_desc(agraph.output_desc) {}
+  , output_desc(agraph.output_desc) {
+  for(auto o : agraph.graph->outputs())
+    reductions.push_back(isReduction(o->node()) ? o->node()->kind() : prim::Undefined);
+}
 
 namespace {
 
@@ -518,7 +720,7 @@ void CompiledFusionFunction::launch_with_tensors(at::ArrayRef<at::Tensor> inputs
   char * buffer_next = buffer.data();
   // A vector of arguments to the kernel. It's (numel, *input_descs, *output_descs)
   std::vector<void*> arguments;
-  arguments.reserve(1 + inputs.size() + flat_outputs_size);
+  arguments.reserve(2 + inputs.size() + flat_outputs_size);
   // Asserts that t's dims can be compressed in the same way as in desc
   // (that's what the kernel assumes), and appends it to the arguments vector.
   auto addTensorInfo = [&](TensorDesc & desc, const at::Tensor & t) {
@@ -533,10 +735,22 @@ void CompiledFusionFunction::launch_with_tensors(at::ArrayRef<at::Tensor> inputs
   arguments.push_back(&numel);
   for (size_t i = 0; i < input_desc.size(); ++i)
     addTensorInfo(input_desc[i], inputs[i]);
+  // Reductions produce one element per row of the map, and the kernel gets
+  // the size of the rows as an extra argument.
+  bool has_reductions = std::any_of(reductions.begin(), reductions.end(),
+                                    [](NodeKind k) { return k != prim::Undefined; });
+  uint32_t reduction_size = has_reductions ? map_size.back() : 0;
   for (size_t i = 0; i < output_desc.size(); ++i) {
     auto & c = concat_desc[i];
     at::Tensor o = outputs[i];
-    if(c.nSubtensors == 1) {
+    if(reductions[i] != prim::Undefined) {
+      // the reduced dimension is dropped unless the output kept it
+      std::vector<int64_t> reduced_size(map_size.begin(), map_size.end() - 1);
+      if(output_desc[i].contiguity.size() == map_size.size())
+        reduced_size.push_back(1);
+      o.resize_(reduced_size);
+      addTensorInfo(output_desc[i], outputs[i]);
+    } else if(c.nSubtensors == 1) {
       o.resize_(map_size);
       addTensorInfo(output_desc[i], outputs[i]);
     } else {
@@ -555,6 +769,18 @@ void CompiledFusionFunction::launch_with_tensors(at::ArrayRef<at::Tensor> inputs
       }
     }
   }
+  if(has_reductions && reduction_size == 0) {
+    // kernels walk the map row by row, and here the rows are empty
+    for (size_t i = 0; i < output_desc.size(); ++i) {
+      if(reductions[i] == prim::Undefined)
+        continue;
+      at::Tensor o = outputs[i];
+      o.fill_(reductions[i] == aten::mean ? std::numeric_limits<float>::quiet_NaN() : 0.f);
+    }
+    return;
+  }
+  if(has_reductions)
+    arguments.push_back(&reduction_size);
   launch_raw(numel, arguments.data());
 }
 
@@ -758,11 +984,6 @@ static void runCompiler(FusionCompilerConfig & config, const std::string & cpp_f
   env.s("so_file",so_file);
   std::string result = format(compile_string,env);
   int r = system(result.c_str());
-  if(config.openmp && r != 0) {
-    std::cerr << "warning: pytorch jit fuser failed to compile with openmp, trying without it...\n";
-    config.openmp = false; // disable for future compiles
-    return runCompiler(config, cpp_file, so_file);
-  }
   JIT_ASSERTM(r == 0, "Failed to compile a fused CPU kernel");
 }
 
@@ -777,24 +998,86 @@ static void disas(const std::string & so_file) {
   JIT_ASSERT(r == 0);
 }
 
+static std::string compilerVersion(const std::string & cxx) {
+  static std::unordered_map<std::string, std::string> versions;
+  auto it = versions.find(cxx);
+  if(it != versions.end())
+    return it->second;
+  std::string cmd = "\"" + cxx + "\" --version 2>/dev/null";
+  std::string version;
+  if(FILE * pipe = popen(cmd.c_str(), "r")) {
+    char buf[256];
+    size_t n;
+    while((n = fread(buf, 1, sizeof(buf), pipe)) > 0)
+      version.append(buf, n);
+    pclose(pipe);
+  }
+  return versions[cxx] = version;
+}
+
+// Everything a kernel compiled by runCompiler depends on.
+static std::string kernelCacheKey(FusionCompilerConfig & config, const std::string & compilation_unit) {
+  static const std::string host_cpu = hostCPUDescription();
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", config.openmp ? "-fopenmp" : "");
+  env.s("cpp_file", "");
+  env.s("so_file", "");
+  std::stringstream key;
+  key << format(compile_string, env) << "\n";
+  key << compilerVersion(config.cxx);
+  key << host_cpu;
+  key << compilation_unit;
+  return key.str();
+}
+
+// CPU kernels are loaded from their own library with RTLD_LOCAL, so they can
+// all use the same symbol. Keeping the per-process kernel name out of the
+// source lets the kernel cache share entries between processes that compile
+// fusion groups in a different order.
+static const std::string cpu_kernel_symbol = "fused_kernel";
+
 struct CPUFusionFunction : public CompiledFusionFunction {
-  CPUFusionFunction(const std::string & name, AnnotatedGraph & agraph, FusionCompilerConfig & config)
+  CPUFusionFunction(const std::string & name, AnnotatedGraph & agraph, FusionCompilerConfig & config, FusionKernelCache * kernel_cache)
   : CompiledFusionFunction(name, agraph) {
-    TempFile so_file(so_template, 3);
-    TempFile cpp_file(cpp_template, 4);
-
     std::stringstream cu;
-    concat_desc = codegen::emitCompilationUnit(cu, name, agraph, false);
+    concat_desc = codegen::emitCompilationUnit(cu, cpu_kernel_symbol, agraph, false);
     compilation_unit = cu.str();
-    cpp_file.write(compilation_unit);
-    cpp_file.sync();
-    runCompiler(config, cpp_file.name(), so_file.name());
-    if(config.debug) {
-      disas(so_file.name());
+    auto compile = [&](const std::string & so_file) {
+      TempFile cpp_file(cpp_template, 4);
+      cpp_file.write(compilation_unit);
+      cpp_file.sync();
+      runCompiler(config, cpp_file.name(), so_file);
+      if(config.debug) {
+        disas(so_file);
+      }
+    };
+    auto compileAndLoad = [&] {
+      std::string cached_so;
+      if(kernel_cache) {
+        cached_so = kernel_cache->getOrCompile(kernelCacheKey(config, compilation_unit), compile);
+      }
+      if(!cached_so.empty()) {
+        so_lib.reset(new DynamicLibrary(cached_so.c_str()));
+      } else {
+        TempFile so_file(so_template, 3);
+        compile(so_file.name());
+        so_lib.reset(new DynamicLibrary(so_file.name().c_str()));
+      }
+    };
+    // The fallback without -fopenmp starts over with a new cache key, so a
+    // kernel is always cached under the flags it was compiled with.
+    try {
+      compileAndLoad();
+    } catch(std::exception & e) {
+      if(!config.openmp)
+        throw;
+      std::cerr << "warning: pytorch jit fuser failed to compile with openmp, trying without it...\n";
+      config.openmp = false; // disable for future compiles
+      compileAndLoad();
     }
-    so_lib.reset(new DynamicLibrary(so_file.name().c_str()));
 #pragma GCC diagnostic ignored "-Wpedantic"
-    kernel = reinterpret_cast<void(*)(uint32_t, void**)>(so_lib->sym(name.c_str()));
+    kernel = reinterpret_cast<void(*)(uint32_t, void**)>(so_lib->sym(cpu_kernel_symbol.c_str()));
 #pragma GCC diagnostic pop
   }
 protected:
@@ -808,6 +1091,45 @@ protected:
   void (*kernel)(uint32_t, void**) = nullptr;
 };
 
+// Runs CPU fusion groups in-process, without invoking a compiler.
+struct BytecodeFusionFunction : public CompiledFusionFunction {
+  BytecodeFusionFunction(const std::string & name, AnnotatedGraph & agraph, FusionCompilerConfig & config)
+  : CompiledFusionFunction(name, agraph) {
+    Graph & subgraph = *agraph.graph;
+    std::vector<TensorDesc> formals = agraph.input_desc;
+    std::vector<Value*> flat_outputs;
+    size_t i = 0;
+    for(auto o : subgraph.outputs()) {
+      auto & desc = agraph.output_desc[i++];
+      if(o->node()->kind() != aten::cat) {
+        concat_desc.emplace_back();
+        formals.push_back(desc);
+        flat_outputs.push_back(o);
+      } else {
+        auto cat = o->node();
+        concat_desc.emplace_back(desc, cat->inputs().size(), cat->i(attr::dim));
+        for(auto c : cat->inputs()) {
+          formals.push_back(*concat_desc.back().subtensorDesc);
+          flat_outputs.push_back(c);
+        }
+      }
+    }
+    kernel.reset(new FusedBytecodeKernel(subgraph, flat_outputs, std::move(formals)));
+    compilation_unit = kernel->str();
+    if(config.debug) {
+      std::cout << name << ":\n" << compilation_unit;
+    }
+  }
+protected:
+  virtual at::Backend backend() const override {
+    return at::kCPU;
+  }
+  virtual void launch_raw(uint32_t numel, void ** arguments) override {
+    kernel->run(numel, arguments);
+  }
+  std::unique_ptr<FusedBytecodeKernel> kernel;
+};
+
 std::shared_ptr<CompiledFusionFunction> FusionCompiler::getOrCompile(AnnotatedGraph & agraph) {
   std::stringstream key;
   key << *agraph.graph << "\n";
@@ -818,6 +1140,7 @@ std::shared_ptr<CompiledFusionFunction> FusionCompiler::getOrCompile(AnnotatedGr
     key << i << "\n";
   std::string key_ = key.str();
 
+  std::lock_guard<std::mutex> guard(mutex_);
   auto it = cache.find(key_);
   if (it == cache.end()) {
     std::string name = "kernel_" + std::to_string(cache.size());
@@ -830,7 +1153,11 @@ std::shared_ptr<CompiledFusionFunction> FusionCompiler::getOrCompile(AnnotatedGr
 #endif
     } else {
       JIT_ASSERT(canCompileOnCPU());
-      raw_func = new CPUFusionFunction(name, agraph, config_);
+      if(config_.use_cxx) {
+        raw_func = new CPUFusionFunction(name, agraph, config_, kernel_cache_.get());
+      } else {
+        raw_func = new BytecodeFusionFunction(name, agraph, config_);
+      }
     }
     it = cache.emplace(key_, std::shared_ptr<CompiledFusionFunction>(raw_func)).first;
   }
@@ -886,14 +1213,39 @@ FusionCompiler::FusionCompiler() {
   if(cxx_env != nullptr) {
     config_.cxx = cxx_env;
   }
-  if(!programExists(config_.cxx)) {
+  // PYTORCH_FUSION_CPU_BACKEND=cxx compiles CPU kernels with the system
+  // compiler instead of running them on the bytecode backend.
+  const char * backend_env = getenv("PYTORCH_FUSION_CPU_BACKEND");
+  config_.use_cxx = backend_env && std::string(backend_env) == "cxx";
+  if(config_.use_cxx && !programExists(config_.cxx)) {
     config_.cxx = "";
   }
   const char * debug_env = getenv("PYTORCH_FUSION_DEBUG");
   config_.debug = debug_env && atoi(debug_env) != 0;
+  // Kernels compiled with cxx are cached in $PYTORCH_FUSION_CACHE_DIR,
+  // defaulting to $TORCH_HOME/fuser (like the model zoo, TORCH_HOME defaults
+  // to ~/.torch). An empty PYTORCH_FUSION_CACHE_DIR disables the cache.
+  if(const char * cache_env = getenv("PYTORCH_FUSION_CACHE_DIR")) {
+    config_.cache_dir = cache_env;
+  } else if(const char * torch_home = getenv("TORCH_HOME")) {
+    config_.cache_dir = std::string(torch_home) + "/fuser";
+  } else if(const char * home = getenv("HOME")) {
+    config_.cache_dir = std::string(home) + "/.torch/fuser";
+  }
+  if(config_.use_cxx && !config_.cache_dir.empty()) {
+    kernel_cache_.reset(new FusionKernelCache(config_.cache_dir));
+  }
+}
+
+FusionCompiler::~FusionCompiler() {}
+
+std::pair<uint64_t, uint64_t> FusionCompiler::kernelCacheStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if(!kernel_cache_)
+    return std::make_pair(0, 0);
+  return std::make_pair(kernel_cache_->hits(), kernel_cache_->misses());
 }
 
-//TODO: thread safety
 FusionCompiler & sharedFusionCompiler() {
   static FusionCompiler compiler;
   return compiler;
@@ -905,6 +1257,7 @@ FusionCompiler & sharedFusionCompiler() {
 // dummy implementations for windows
 
 #include "torch/csrc/jit/fusion_compiler.h"
+#include "torch/csrc/jit/fusion_kernel_cache.h"
 #include "torch/csrc/jit/ir.h"
 #include "torch/csrc/jit/code_template.h"
 #include "torch/csrc/jit/resource_guard.h"
@@ -951,6 +1304,12 @@ void FusionCompiler::debugLaunchGraph(Graph & graph, int device, at::ArrayRef<at
 
 FusionCompiler::FusionCompiler() {}
 
+FusionCompiler::~FusionCompiler() {}
+
+std::pair<uint64_t, uint64_t> FusionCompiler::kernelCacheStats() const {
+  return std::make_pair(0, 0);
+}
+
 FusionCompiler & sharedFusionCompiler() {
   throw std::runtime_error("NYI: fuser is not supported on Windows.");
 }
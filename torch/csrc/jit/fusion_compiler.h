@@ -2,6 +2,8 @@
 #include <torch/csrc/jit/ir.h>
 #include "torch/csrc/utils/disallow_copy.h"
 #include "ATen/ATen.h"
+#include <memory>
+#include <mutex>
 #include <string>
 #include <algorithm>
 #include <unordered_map>
@@ -101,7 +103,9 @@ protected:
   // cuLaunchKernel as the kernel arguments.
   // Currently the first argument is a pointer to numel (for passing to
   // CUDA code), and the remainder are pointers to the TensorInfo<T> structs
-  // that compiled code uses to load Tensor data.
+  // that compiled code uses to load Tensor data. Kernels with reductions
+  // take one more argument, a pointer to the size of the reduced (innermost)
+  // dimension of the map.
   // launch_with_tensors handles packing at::Tensors into this arguments array.
   // CPU code uses the same convension so that launch_with_tensors can be shared.
   virtual void launch_raw(uint32_t numel, void ** arguments) = 0;
@@ -115,18 +119,32 @@ protected:
   // an output is actually a concatenation of
   // many subtensors that the fusion group produces
   std::vector<ConcatDesc> concat_desc;
+
+  // same size as output_desc, the kind of the reduction over the innermost
+  // dimension of the map (aten::sum or aten::mean) that produces an output,
+  // or prim::Undefined for outputs that have the size of the map
+  std::vector<NodeKind> reductions;
 };
 
 struct FusionCompilerConfig {
   std::string cxx = "g++"; // compiler location
   bool debug = false; // emit debugging information about fusions
   bool openmp = true;
+  // compile CPU fusion groups with cxx rather than running them on the
+  // built-in bytecode backend (see fusion_bytecode.h)
+  bool use_cxx = false;
+  // where kernels compiled with cxx are cached across processes, empty to
+  // disable the cache (see fusion_kernel_cache.h)
+  std::string cache_dir;
 };
 
+struct FusionKernelCache;
+
 // caching compiler
 struct FusionCompiler {
   TH_DISALLOW_COPY_AND_ASSIGN(FusionCompiler);
   FusionCompiler();
+  ~FusionCompiler();
 
   // ignores types in graph, and uses specific contiguity annotations
   std::shared_ptr<CompiledFusionFunction> getOrCompile(AnnotatedGraph & agraph);
@@ -144,11 +162,17 @@ struct FusionCompiler {
   // the graph each time
   void debugLaunchGraph(Graph & graph, int device, at::ArrayRef<at::Tensor> inputs, at::ArrayRef<at::Tensor> outputs);
   bool canCompileOnCPU() const {
-    return config_.cxx.size() > 0;
+    return !config_.use_cxx || config_.cxx.size() > 0;
   }
+  // (hits, misses) of the on-disk kernel cache in this process
+  std::pair<uint64_t, uint64_t> kernelCacheStats() const;
 private:
   FusionCompilerConfig config_;
+  std::unique_ptr<FusionKernelCache> kernel_cache_;
   std::unordered_map<std::string, std::shared_ptr<CompiledFusionFunction>> cache;
+  // graph executors run without the GIL, so several threads can compile at once.
+  // Guards cache, config_ and kernel_cache_.
+  mutable std::mutex mutex_;
 };
 
 FusionCompiler & sharedFusionCompiler();
@@ -0,0 +1,185 @@
+#ifndef _WIN32
+#include "torch/csrc/jit/fusion_kernel_cache.h"
+#include "torch/csrc/assertions.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace torch { namespace jit {
+
+namespace {
+
+// 64-bit FNV-1a. Cache file names have to be stable across processes and
+// builds, which std::hash does not guarantee.
+uint64_t fnv1a(const std::string & s) {
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+std::string toHex(uint64_t h) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+  return buf;
+}
+
+bool readFile(const std::string & path, std::string & contents) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  std::stringstream ss;
+  ss << in.rdbuf();
+  contents = ss.str();
+  return true;
+}
+
+bool makeDirectories(const std::string & path) {
+  std::string prefix;
+  std::stringstream ss(path);
+  std::string part;
+  if (!path.empty() && path[0] == '/')
+    prefix = "/";
+  while (std::getline(ss, part, '/')) {
+    if (part.empty())
+      continue;
+    prefix += part + "/";
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+  }
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Creates a uniquely named empty file in dir and returns its path.
+std::string makeTempFile(const std::string & dir, const std::string & suffix) {
+  std::string t = dir + "/tmpXXXXXX" + suffix;
+  std::vector<char> tt(t.c_str(), t.c_str() + t.size() + 1);
+  int fd = mkstemps(tt.data(), suffix.size());
+  if (fd == -1)
+    return "";
+  close(fd);
+  return std::string(tt.begin(), tt.end() - 1);
+}
+
+} // anonymous namespace
+
+FusionKernelCache::FusionKernelCache(std::string dir)
+  : dir(std::move(dir)) {}
+
+bool FusionKernelCache::ensureDirectory() {
+  if (!checked_dir) {
+    checked_dir = true;
+    usable = makeDirectories(dir) && access(dir.c_str(), W_OK) == 0;
+    if (!usable) {
+      std::cerr << "warning: pytorch jit fuser cannot use kernel cache directory "
+                << dir << ", compiling without a cache\n";
+    }
+  }
+  return usable;
+}
+
+std::string FusionKernelCache::getOrCompile(
+    const std::string & key,
+    const std::function<void(const std::string & so_file)> & compile) {
+  if (!ensureDirectory())
+    return "";
+  std::string base = dir + "/" + toHex(fnv1a(key));
+  std::string so_file = base + ".so";
+  std::string key_file = base + ".key";
+
+  std::string cached_key;
+  if (readFile(key_file, cached_key) && cached_key == key &&
+      access(so_file.c_str(), R_OK) == 0) {
+    hits_++;
+    return so_file;
+  }
+  misses_++;
+
+  std::string tmp_so = makeTempFile(dir, ".so");
+  std::string tmp_key = makeTempFile(dir, ".key");
+  if (tmp_so.empty() || tmp_key.empty()) {
+    unlink(tmp_so.c_str());
+    unlink(tmp_key.c_str());
+    return "";
+  }
+  try {
+    compile(tmp_so);
+    std::ofstream out(tmp_key, std::ios::binary);
+    out << key;
+    out.close();
+    JIT_ASSERT(out);
+  } catch (...) {
+    unlink(tmp_so.c_str());
+    unlink(tmp_key.c_str());
+    throw;
+  }
+  // Publish the library before its key: a reader that sees the new key
+  // either finds the matching library or misses.
+  if (rename(tmp_so.c_str(), so_file.c_str()) != 0 ||
+      rename(tmp_key.c_str(), key_file.c_str()) != 0) {
+    unlink(tmp_so.c_str());
+    unlink(tmp_key.c_str());
+    return "";
+  }
+  return so_file;
+}
+
+std::string hostCPUDescription() {
+  std::stringstream out;
+  struct utsname name;
+  if (uname(&name) == 0)
+    out << name.machine << "\n";
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+  if (max_leaf >= 1) {
+    __cpuid(0, eax, ebx, ecx, edx);
+    char vendor[13];
+    memcpy(vendor, &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+    vendor[12] = '\0';
+    out << vendor << "\n";
+    __cpuid(1, eax, ebx, ecx, edx);
+    out << std::hex << eax << " " << ecx << " " << edx << "\n";
+  }
+  if (max_leaf >= 7) {
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    out << std::hex << ebx << " " << ecx << " " << edx << "\n";
+  }
+#else
+  // Keep the lines of /proc/cpuinfo that identify the core and its features,
+  // but not the ones (like frequencies) that change between runs.
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.empty())
+      break; // first processor only
+    if (line.compare(0, 3, "cpu") == 0 || line.compare(0, 3, "CPU") == 0 ||
+        line.compare(0, 8, "Features") == 0 || line.compare(0, 5, "flags") == 0 ||
+        line.compare(0, 5, "model") == 0) {
+      out << line << "\n";
+    }
+  }
+#endif
+  return out.str();
+}
+
+}} // namespace torch::jit
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include "torch/csrc/utils/disallow_copy.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace torch { namespace jit {
+
+// A content-addressed store for CPU fusion kernels compiled by the system
+// compiler, shared by every process that uses the same directory.
+//
+// Entries are keyed by a string that must capture everything the compiled
+// code depends on (the generated source, the compiler command line and
+// version, and the host CPU). A library is named after a hash of its key,
+// and the full key is stored next to it and compared on lookup, so hash
+// collisions cause a recompile rather than loading the wrong kernel.
+// Entries are published with rename(), so concurrent processes never observe
+// partially written files.
+struct FusionKernelCache {
+  TH_DISALLOW_COPY_AND_ASSIGN(FusionKernelCache);
+  explicit FusionKernelCache(std::string dir);
+
+  // Returns the path of the shared library for key. On a miss, compile is
+  // called with a temporary path to write the library to, and the result is
+  // added to the cache. Returns an empty string if the cache directory is
+  // not usable; the caller should then compile without the cache.
+  std::string getOrCompile(
+      const std::string & key,
+      const std::function<void(const std::string & so_file)> & compile);
+
+  const std::string & directory() const {
+    return dir;
+  }
+  uint64_t hits() const {
+    return hits_;
+  }
+  uint64_t misses() const {
+    return misses_;
+  }
+
+private:
+  bool ensureDirectory();
+
+  std::string dir;
+  bool checked_dir = false;
+  bool usable = false;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+// A description of the host CPU (vendor, model and feature flags) for use in
+// cache keys of kernels compiled with -march=native.
+std::string hostCPUDescription();
+
+}} // namespace torch::jit
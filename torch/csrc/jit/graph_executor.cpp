@@ -22,7 +22,10 @@
 #include "torch/csrc/autograd/function.h"
 #include "torch/csrc/jit/script/compiler.h"
 
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -68,16 +71,37 @@ private:
 };
 
 
+// PYTORCH_JIT_MEMORY_PLANNING=0 turns off the memory plans of ExecutionPlans
+bool memoryPlanningEnabled() {
+  static const bool enabled = [] {
+    const char * env = getenv("PYTORCH_JIT_MEMORY_PLANNING");
+    return env == nullptr || strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
+// PYTORCH_JIT_SYMBOLIC_SHAPES=0 turns off sharing ExecutionPlans between inputs
+// of different sizes
+bool symbolicShapesEnabled() {
+  static const bool enabled = [] {
+    const char * env = getenv("PYTORCH_JIT_SYMBOLIC_SHAPES");
+    return env == nullptr || strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
 // an optimized way of executing the subgraph computed directly on
 // tensors rather than Variables.
 // This will unwrap Variables, run the plan, and re-wrap them.
 // It can optionally also have a gradient which is hooked up
 // to the output Variables if present.
+// The graph is specialized to the sizes of the inputs, so the intermediate
+// results of f are placed in a preallocated arena (see memory_planning.h).
 struct ExecutionPlan {
   ExecutionPlan(std::shared_ptr<Graph>& graph)
-      : f(graph), graph(graph) {}
+      : f(graph, /*plan_memory=*/memoryPlanningEnabled()), graph(graph) {}
   ExecutionPlan(std::shared_ptr<Graph>& graph, Gradient grad)
-      : f(graph),
+      : f(graph, /*plan_memory=*/memoryPlanningEnabled()),
         graph(graph),
         grad(std::move(grad)),
         grad_executor(this->grad.df) {}
@@ -194,7 +218,12 @@ struct GraphExecutorImpl {
   , optimize(optimize)
   , num_inputs(this->graph->inputs().size())
   , symbolically_differentiable(symbolically_differentiable)
-  , may_introduce_gradient(calcMayIntroduceGradient(this->graph->block())) {}
+  , may_introduce_gradient(calcMayIntroduceGradient(this->graph->block()))
+  , has_autograd_fallback(false)
+  , try_symbolic_shapes(symbolicShapesEnabled()) {
+    plan_caches.emplace_back(new PlanCache());
+    plan_cache.store(plan_caches.back().get(), std::memory_order_relaxed);
+  }
   GraphExecutorImpl(std::shared_ptr<Graph> graph, bool optimize)
   : GraphExecutorImpl(graph, optimize, isDifferentiable(*graph)) {}
 
@@ -234,9 +263,9 @@ struct GraphExecutorImpl {
       return autograd_fallback_graph;
     }
 
-    auto it = plan_cache.find(spec);
-    JIT_ASSERTM(it != plan_cache.end(), "No graph found for given inputs");
-    return it->second.get_graph();
+    auto plan = findPlan(*plan_cache.load(std::memory_order_acquire), spec);
+    JIT_ASSERTM(plan, "No graph found for given inputs");
+    return plan->get_graph();
   }
 
   GraphExecutorState getDebugState() {
@@ -249,8 +278,12 @@ struct GraphExecutorImpl {
       state.autograd_fallback = nullptr;
       state.autograd_fallback_graph = nullptr;
     }
-    for (auto & entry : plan_cache) {
-      state.execution_plans.emplace(entry.first, entry.second.getDebugState());
+    const PlanCache & cache = *plan_cache.load(std::memory_order_acquire);
+    for (auto & entry : cache.plans) {
+      state.execution_plans.emplace(entry.first, entry.second->getDebugState());
+    }
+    for (auto & entry : cache.symbolic_plans) {
+      state.symbolic_execution_plans.emplace_back(entry.first, entry.second->getDebugState());
     }
     return state;
   }
@@ -372,6 +405,9 @@ private:
     RemoveExpands(g);
   }
   const Code & getOrCreateAutogradFallback() {
+    if(has_autograd_fallback.load(std::memory_order_acquire)) {
+      return autograd_fallback;
+    }
     std::lock_guard<std::mutex> lock(compile_mutex);
     if(autograd_fallback) {
       return autograd_fallback;
@@ -385,21 +421,69 @@ private:
     }
     autograd_fallback_graph = graph_;
     autograd_fallback = Code(graph_);
+    has_autograd_fallback.store(true, std::memory_order_release);
     return autograd_fallback;
   }
   const ExecutionPlan & getOrCompile(const variable_tensor_list & inputs) {
     // outside lock guard, to minimize the time holding the lock on the fast path
     // ArgumentSpec even computes its hashCode here.
     ArgumentSpec spec(autograd::GradMode::is_enabled(), inputs);
-    {
-      std::lock_guard<std::mutex> lock(compile_mutex);
-      auto it = plan_cache.find(spec);
-      if(it != plan_cache.end())
-        return it->second;
-      auto plan = compileSpec(spec);
-      auto r = plan_cache.emplace(std::move(spec), std::move(plan));
-      return r.first->second;
+    // fast path: the spec has already been compiled, no lock needed
+    if(auto plan = findPlan(*plan_cache.load(std::memory_order_acquire), spec))
+      return *plan;
+    std::lock_guard<std::mutex> lock(compile_mutex);
+    // another thread may have compiled this spec while we waited for the lock
+    const PlanCache & current = *plan_cache.load(std::memory_order_relaxed);
+    if(auto plan = findPlan(current, spec))
+      return *plan;
+    std::unique_ptr<PlanCache> next(new PlanCache(current));
+    std::shared_ptr<ExecutionPlan> plan;
+    if(auto symbolic_spec = generalizeSpec(current, spec)) {
+      plan = compileSymbolicSpec(*symbolic_spec);
+      if(plan) {
+        next->symbolic_plans.emplace(next->symbolic_plans.begin(), std::move(*symbolic_spec), plan);
+      } else {
+        try_symbolic_shapes = false;
+      }
+    }
+    if(!plan) {
+      plan = std::make_shared<ExecutionPlan>(compileSpec(spec));
+      next->plans.emplace(std::move(spec), plan);
+    }
+    plan_cache.store(next.get(), std::memory_order_release);
+    plan_caches.push_back(std::move(next));
+    return *plan;
+  }
+
+  struct PlanCache;
+  static const ExecutionPlan * findPlan(const PlanCache & cache, const ArgumentSpec & spec) {
+    auto it = cache.plans.find(spec);
+    if(it != cache.plans.end())
+      return it->second.get();
+    for(auto & entry : cache.symbolic_plans) {
+      if(entry.first.matches(spec))
+        return entry.second.get();
     }
+    return nullptr;
+  }
+
+  // When the inputs only differ from those of a compiled plan in their sizes,
+  // e.g. because they are a batch of another size, we compile one plan for
+  // both instead, in which the sizes that differ are symbolic. This is only
+  // done when no gradient is needed, because the derivatives that autodiff
+  // builds use the sizes of the forward graph.
+  at::optional<SymbolicSpec> generalizeSpec(const PlanCache & cache, const ArgumentSpec & spec) {
+    if(!try_symbolic_shapes || argumentSpecRequiresGradient(spec))
+      return at::nullopt;
+    for(auto & entry : cache.symbolic_plans) {
+      if(auto symbolic_spec = entry.first.generalize(spec))
+        return symbolic_spec;
+    }
+    for(auto & entry : cache.plans) {
+      if(auto symbolic_spec = SymbolicSpec(entry.first).generalize(spec))
+        return symbolic_spec;
+    }
+    return at::nullopt;
   }
 
   bool argumentSpecRequiresGradient(const ArgumentSpec & spec) {
@@ -415,8 +499,8 @@ private:
   // the input is defined, and 'replacement' if it is not.
   // Note: this is a very limited pass. It looks at undefined inputs,
   // and cleans up ReplaceIfUndef nodes inserted by autodiff.
-  void specializeUndef(Graph & g, const ArgumentSpec & spec) {
-    for(size_t i = 0; i < spec.size(); i++) {
+  void specializeUndef(Graph & g, const std::vector<bool> & defined) {
+    for(size_t i = 0; i < defined.size(); i++) {
       std::vector<Value*> to_replace;
       // do not edit in place, since it invalidates uses iterator
       for(auto u : g.inputs()[i]->uses()) {
@@ -427,7 +511,7 @@ private:
       for(auto v : to_replace) {
         // if it is defined, then we replace with 'v' if not,
         // we replace with 'replacement' which is normally just a zero tensor
-        int idx = spec.tensorInfo(i).defined() ? 0 : 1;
+        int idx = defined[i] ? 0 : 1;
         v->replaceAllUsesWith(v->node()->inputs()[idx]);
         v->node()->destroy();
       }
@@ -448,7 +532,7 @@ private:
       }
     }
   }
-  void specializeToSpec(std::shared_ptr<Graph> g, const ArgumentSpec & spec) {
+  void specializeToDefinedInputs(std::shared_ptr<Graph> g, const std::vector<bool> & defined) {
 
     // The following passes are specialized to clean up after autograd
     // decisions to insert/remove undefs nodes and to work before
@@ -461,14 +545,39 @@ private:
     // into a generic canonicalization pass.
     DecomposeAddmm(g);
     // clean up replaceIfUndef nodes
-    specializeUndef(*g, spec);
+    specializeUndef(*g, defined);
     // clean up additions resulting from nodes that were in fact undefined
     propagateZeros(*g);
     // clean up dead constants from specialization
     EliminateDeadCode(g);
+  }
+  void specializeToSpec(std::shared_ptr<Graph> g, const ArgumentSpec & spec) {
+    std::vector<bool> defined;
+    for(size_t i = 0; i < spec.size(); i++)
+      defined.push_back(spec.tensorInfo(i).defined());
+    specializeToDefinedInputs(g, defined);
     // calculate all input shapes
     PropagateInputShapes(*g, spec);
   }
+  // returns nullptr if the graph cannot be compiled with symbolic sizes
+  std::shared_ptr<ExecutionPlan> compileSymbolicSpec(const SymbolicSpec & spec) {
+    auto graph_ = graph->copy();
+    runRequiredPasses(graph_);
+
+    std::vector<bool> defined;
+    for(size_t i = 0; i < spec.size(); i++)
+      defined.push_back(spec.input(i).defined);
+    specializeToDefinedInputs(graph_, defined);
+    try {
+      if(!PropagateSymbolicInputShapes(*graph_, spec))
+        return nullptr;
+    } catch(std::exception & e) {
+      // compileSpec will report the error, if it happens for these sizes too
+      return nullptr;
+    }
+    runOptimization(graph_, /*graphMustSupportVariables=*/false);
+    return std::make_shared<ExecutionPlan>(graph_);
+  }
   ExecutionPlan compileSpec(const ArgumentSpec & spec) {
     auto graph_ = graph->copy();
     runRequiredPasses(graph_);
@@ -519,15 +628,34 @@ private:
   std::shared_ptr<Graph> autograd_fallback_graph;
   Code autograd_fallback;
 
+  // set once autograd_fallback has been compiled, so that runFallback can
+  // skip compile_mutex afterwards.
+  std::atomic<bool> has_autograd_fallback;
+
+  // false once compiling a plan with symbolic sizes has failed, e.g. because
+  // the graph has control flow, so that we do not try again for every size
+  bool try_symbolic_shapes;
+
   // optimizable code paths, used when we can differentiate or when no derivative is needed
   // Spec describes input conditions, Plan describes how to execute them.
-  std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+  //
+  // Many threads may share one executor, so lookups must not serialize on a
+  // lock. plan_cache points to an immutable snapshot that is read without
+  // locking. Compiling a new spec copies the current snapshot, adds the plan and
+  // publishes the copy. Old snapshots are kept in plan_caches until the executor is
+  // destroyed, because readers may still be looking at them. Executors only see
+  // a handful of distinct specs, so this costs very little memory.
+  struct PlanCache {
+    std::unordered_map<ArgumentSpec, std::shared_ptr<ExecutionPlan>> plans;
+    // plans with symbolic sizes, newest (and most general) first
+    std::vector<std::pair<SymbolicSpec, std::shared_ptr<ExecutionPlan>>> symbolic_plans;
+  };
+  std::atomic<const PlanCache*> plan_cache;
+  std::vector<std::unique_ptr<PlanCache>> plan_caches;
 
   // GraphExecutor can be accessed from  multiple thread so
-  // anytime we are checking or updating the autograd_fallback or
+  // anytime we are creating the autograd_fallback or adding to
   // plan_cache, we must hold the compile mutex.
-  // along the fast path (no compilation) code should
-  // hold this for as little time as possible.
   std::mutex compile_mutex;
 };
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <utility>
+#include <vector>
 #include "torch/csrc/jit/ir.h"
 #include "torch/csrc/jit/variable_tensor_list.h"
 #include "torch/csrc/jit/interpreter.h"
@@ -26,6 +28,8 @@ struct ExecutionPlanState {
 struct GraphExecutorState {
   Graph* graph;
   std::unordered_map<ArgumentSpec, ExecutionPlanState> execution_plans;
+  // plans with symbolic sizes, shared by inputs of several sizes, newest first
+  std::vector<std::pair<SymbolicSpec, ExecutionPlanState>> symbolic_execution_plans;
 
   // Those two fields are optional
   Code* autograd_fallback;
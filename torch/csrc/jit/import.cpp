@@ -1,10 +1,15 @@
 #include "torch/csrc/jit/import.h"
 #include "torch/csrc/onnx/onnx.npb.h"
 #include "torch/csrc/jit/ir.h"
+#include "torch/csrc/jit/mapped_model.h"
 #include "torch/csrc/utils/functional.h"
 
 #include <ATen/ATen.h>
+#include <TH/THAllocator.h>
 
+#include <cstring>
+#include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -526,4 +531,79 @@ std::shared_ptr<Graph> ImportIRGraph(const std::string& serialized_graph,
   return graph;
 }
 
+std::shared_ptr<Graph> ImportMappedIRGraph(const std::string& filename,
+                                           std::vector<at::Tensor>& initializers) {
+
+  uint64_t file_size;
+  {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+      throw std::runtime_error("could not open " + filename);
+    }
+    file_size = static_cast<uint64_t>(in.tellg());
+  }
+  if (file_size < sizeof(MappedModelHeader)) {
+    throw std::runtime_error(filename + " is not a mapped model file");
+  }
+
+  auto ctx = THMapAllocatorContext_new(filename.c_str(), 0);
+  void* data = THMapAllocator.malloc(ctx, static_cast<ptrdiff_t>(file_size));
+  std::shared_ptr<void> mapping(data, [ctx](void* data) {
+    THMapAllocator.free(ctx, data);
+  });
+  auto base = static_cast<const uint8_t*>(data);
+
+  auto inFile = [&](uint64_t offset, uint64_t size) {
+    return offset <= file_size && size <= file_size - offset;
+  };
+
+  MappedModelHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kMappedModelMagic, sizeof(header.magic)) != 0) {
+    throw std::runtime_error(filename + " is not a mapped model file");
+  }
+  if (header.version != kMappedModelVersion) {
+    throw std::runtime_error(filename + " has unsupported mapped model version " +
+                             std::to_string(header.version));
+  }
+  if (!inFile(header.proto_offset, header.proto_size) ||
+      header.table_offset % alignof(MappedTensorEntry) != 0 ||
+      header.num_initializers > file_size / sizeof(MappedTensorEntry) ||
+      !inFile(header.table_offset, header.num_initializers * sizeof(MappedTensorEntry))) {
+    throw std::runtime_error(filename + " is truncated or corrupt");
+  }
+
+  pb_istream_t istream = pb_istream_from_buffer(base + header.proto_offset, header.proto_size);
+  auto model = Reader<Model_>::read(&istream);
+  if (model.graph.initializers.size() != header.num_initializers) {
+    throw std::runtime_error(filename + " is truncated or corrupt");
+  }
+
+  auto graph = buildGraph(model.graph);
+
+  auto table = reinterpret_cast<const MappedTensorEntry*>(base + header.table_offset);
+  for (size_t i = 0; i < header.num_initializers; i++) {
+    const MappedTensorEntry& entry = table[i];
+    if (entry.scalar_type < 0 ||
+        entry.scalar_type >= static_cast<int64_t>(at::ScalarType::Undefined) ||
+        entry.offset % kMappedTensorAlignment != 0 ||
+        !inFile(entry.offset, entry.nbytes)) {
+      throw std::runtime_error(filename + " is truncated or corrupt");
+    }
+    auto& type = at::CPU(static_cast<at::ScalarType>(entry.scalar_type));
+    auto& dims = model.graph.initializers[i].dims;
+    int64_t numel = 1;
+    for (auto d : dims) {
+      numel *= d;
+    }
+    if (static_cast<uint64_t>(numel) * type.elementSizeInBytes() != entry.nbytes) {
+      throw std::runtime_error(filename + " is truncated or corrupt");
+    }
+    initializers.push_back(type.tensorFromBlob(
+        const_cast<uint8_t*>(base + entry.offset), dims, [mapping](void*) {}));
+  }
+
+  return graph;
+}
+
 }}
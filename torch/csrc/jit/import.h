@@ -6,4 +6,10 @@ namespace torch { namespace jit {
 
 std::shared_ptr<Graph> ImportIRGraph(const std::string& serialized_graph, std::vector<at::Tensor> & initializers);
 
+// Imports a file written by ExportMappedGraph. The file is mapped copy-on-write
+// and the initializers are CPU tensors that view their bytes of the mapping,
+// which stays alive as long as any of them does. Writing to an initializer
+// copies the pages it writes to; it never changes the file.
+std::shared_ptr<Graph> ImportMappedIRGraph(const std::string& filename, std::vector<at::Tensor> & initializers);
+
 }}
@@ -6,6 +6,7 @@
 #include "torch/csrc/jit/python_arg_flatten.h"
 #include "torch/csrc/jit/export.h"
 #include "torch/csrc/jit/argument_spec.h"
+#include "torch/csrc/jit/fusion_compiler.h"
 #include "torch/csrc/jit/passes/graph_fuser.h"
 #include "torch/csrc/jit/passes/onnx.h"
 #include "torch/csrc/jit/passes/dead_code_elimination.h"
@@ -22,6 +23,7 @@
 #include "torch/csrc/jit/script/init.h"
 #include "torch/csrc/jit/script/python_tree_views.h"
 #include "torch/csrc/jit/python_interpreter.h"
+#include "torch/csrc/utils/auto_gil.h"
 
 
 namespace torch  { namespace jit {
@@ -96,7 +98,10 @@ void initJITBindings(PyObject *module) {
    })
    .def("_jit_pass_onnx_block", BlockToONNX)
    .def("_jit_pass_fixup_onnx_loops", FixupONNXLoops)
-   .def("_jit_pass_decompose_addmm", DecomposeAddmm);
+   .def("_jit_pass_decompose_addmm", DecomposeAddmm)
+   .def("_jit_fusion_kernel_cache_stats", [] {
+     return sharedFusionCompiler().kernelCacheStats();
+   });
 
   py::class_<ArgumentSpec>(m, "ArgumentSpec")
       .def("__repr__", [](ArgumentSpec& self) {
@@ -127,6 +132,13 @@ void initJITBindings(PyObject *module) {
     .def_property_readonly("execution_plans", [](GraphExecutorState& s) {
       return s.execution_plans;
     })
+    .def_property_readonly("symbolic_execution_plans", [](GraphExecutorState& s) {
+      std::vector<ExecutionPlanState> plans;
+      for (auto & entry : s.symbolic_execution_plans) {
+        plans.push_back(entry.second);
+      }
+      return plans;
+    })
     .def_property_readonly("autograd_fallback", [](GraphExecutorState& s) {
       return s.autograd_fallback;
     })
@@ -163,7 +175,13 @@ void initJITBindings(PyObject *module) {
       })
       .def("__call__", [](GraphExecutor& ge, py::args args) -> py::object {
         auto inputs = createVariableTensorList(args);
-        auto outputs = ge.run(std::move(inputs));
+        variable_tensor_list outputs;
+        {
+          // let other threads run the same executor concurrently; PythonOps
+          // in the graph reacquire the GIL themselves
+          AutoNoGIL no_gil;
+          outputs = ge.run(std::move(inputs));
+        }
         // if we don't tell pybind these are variables it chokes on the
         // conversion.
         // TODO: fix conversions to be sane and make sure this works.
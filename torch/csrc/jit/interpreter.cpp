@@ -9,10 +9,12 @@
 #include "torch/csrc/jit/fusion_compiler.h"
 #include "torch/csrc/jit/graph_executor.h"
 #include "torch/csrc/jit/ir.h"
+#include "torch/csrc/jit/memory_planning.h"
 #include "torch/csrc/jit/tensor_conversions.h"
 #include "torch/csrc/variable_tensor_functions.h"
 #include "torch/csrc/autograd/generated/variable_factories.h"
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -427,8 +429,19 @@ struct UseList {
   ListHandle<bool> free_flags;
 };
 
+// How the interpreter runs an instruction. Only Call instructions invoke
+// their callback. Move instructions (Assign, Load and Store) just move values
+// between registers and the stack, and Drop instructions clear the registers
+// of their inputs without touching the stack.
+enum class InstructionKind : uint8_t {
+  Call,
+  Move,
+  Drop,
+};
+
 // one instruction plus meta-data
 struct Instruction {
+  InstructionKind kind = InstructionKind::Call;
   Operation callback;
   UseList inputs;
   ListHandle<int> outputs;
@@ -442,13 +455,29 @@ int relativeJump(int from_inst, int to_inst) {
 }
 
 struct CodeImpl {
-  CodeImpl(std::shared_ptr<Graph>& graph_)
+  CodeImpl(std::shared_ptr<Graph>& graph_, bool plan_memory)
       : preprocess(*graph_) {
     graph = preprocess.graph;
     //std::cout << "into code graph:\n" << *graph << "\n";
+    // a clone of a multi-stage state would share the arena of the original
+    if(plan_memory && preprocess.stage_input_types.size() == 1) {
+      usePlan(planMemory(*graph));
+    }
     insertNodesFromBlock(graph->block());
   }
 
+  // The tensors of the allocations of the plan are held in the first
+  // registers of every frame, which are never moved from or cleared. The node
+  // computing an allocated value gets its register as an extra input, and runs
+  // the _out variant of its op to write into it.
+  void usePlan(MemoryPlan plan) {
+    memory_plan = std::move(plan);
+    for(auto & a : memory_plan.allocations) {
+      planned_registers[a.value] = register_size++;
+    }
+    num_planned_registers = register_size;
+  }
+
   // jump when input is 0
   void createJumpZ(int from_inst, int to_inst) {
     auto & inst = instructions[from_inst];
@@ -569,15 +598,32 @@ struct CodeImpl {
   }
 
   size_t insertInstruction(Node * n) {
+    if(n->outputs().size() == 1 && planned_registers.count(n->output()) > 0) {
+      auto inst = insertInstruction(n->kind(), n->getSourceLocation(), n->inputs(), moveFlags(n), n->outputs(),
+                                    planned_registers.at(n->output()));
+      instructions[inst].callback = findTensorOutOp(n).value().op;
+      return inst;
+    }
     auto inst = insertInstruction(n->kind(), n->getSourceLocation(), n->inputs(), moveFlags(n) , n->outputs());
-    instructions[inst].callback = getOperation(n);
+    switch(n->kind()) {
+      case prim::Load:
+      case prim::Store:
+        instructions[inst].kind = InstructionKind::Move;
+        break;
+      case prim::Drop:
+        instructions[inst].kind = InstructionKind::Drop;
+        break;
+      default:
+        instructions[inst].callback = getOperation(n);
+    }
     return inst;
   }
   size_t insertInstruction(Symbol sym,
                            std::shared_ptr<SourceLocation> debug_location,
                                  ArrayRef<Value*> inputs,
                                  ArrayRef<uint8_t> move_flags,
-                                 ArrayRef<Value*> outputs) {
+                                 ArrayRef<Value*> outputs,
+                                 int planned_register = -1) {
     instructions.emplace_back();
     auto & inst = instructions.back();
     inst.debug_name = sym;
@@ -586,14 +632,21 @@ struct CodeImpl {
     for(auto input : inputs) {
       listInsert(inst.inputs.values, getOrAllocateRegister(input, true));
     }
+    if(planned_register >= 0) {
+      listInsert(inst.inputs.values, planned_register);
+    }
     listBegin(inst.inputs.free_flags);
     for(auto flag : move_flags) {
       listInsert(inst.inputs.free_flags, flag);
     }
+    if(planned_register >= 0) {
+      listInsert(inst.inputs.free_flags, false);
+    }
     listBegin(inst.outputs);
     for(auto output : outputs) {
       listInsert(inst.outputs, getOrAllocateRegister(output));
     }
+    max_stack_growth = std::max<size_t>(max_stack_growth, std::max(inst.inputs.values.size, inst.outputs.size));
     return instructions.size() - 1;
   }
   ArrayRef<uint8_t> moveFlags(Node * n) {
@@ -608,7 +661,7 @@ struct CodeImpl {
     // This node effectively forwards its inputs into different places in a register list.
     // We don't need to manipulate the stack in any way, because all inputs are also outputs,
     // and the interpreter will take care of putting them in correct places.
-    instructions[inst].callback = [](Stack& stack) { return 0; };
+    instructions[inst].kind = InstructionKind::Move;
     return inst;
   }
 
@@ -742,30 +795,7 @@ struct CodeImpl {
         stack.insert(stack.end(), toutputs.begin(), toutputs.end());
         return 0;
       };
-
-    // Load x, y
-    // loads values from registers onto the stack, the actual callback does
-    // nothing since the stack manipulation is already encoded in inst.inputs
-    // and inst.outputs
-    IR_ELSEIF(Load)
-      return [=](Stack& stack) {
-        return 0;
-      };
-
-    // x, y = Store
-    // stores values from stack into registers, the actual callback does
-    // nothing since the stack manipulation is already encoded in inst.inputs
-    // and inst.outputs
-    IR_ELSEIF(Store)
-      return [=](Stack& stack) {
-        return 0;
-      };
-    IR_ELSEIF(Drop)
-      auto N = value->inputs().size();
-      return [=](Stack& stack) {
-        drop(stack, N);
-        return 0;
-      };
+    // Load, Store and Drop have no callback, see InstructionKind
     IR_ELSE()
       switch (node->kind()) {
         case onnx::Reshape: {
@@ -808,6 +838,33 @@ struct CodeImpl {
     return graph_executors;
   }
 
+  // Register frames are kept for reuse by later runs of this Code, so that
+  // starting a run does not allocate. Frames are pooled with every register
+  // cleared, so that they do not keep tensors alive, except for the planned
+  // registers, so that every frame keeps its own arena.
+  std::vector<at::Tensor> acquireFrame() {
+    {
+      std::lock_guard<std::mutex> guard(frames_mutex);
+      if(!free_frames.empty()) {
+        auto frame = std::move(free_frames.back());
+        free_frames.pop_back();
+        return frame;
+      }
+    }
+    std::vector<at::Tensor> frame(register_size);
+    auto planned = allocateArena(memory_plan);
+    std::move(planned.begin(), planned.end(), frame.begin());
+    return frame;
+  }
+  void releaseFrame(std::vector<at::Tensor> frame) {
+    for(auto r = frame.begin() + num_planned_registers; r != frame.end(); ++r)
+      *r = at::Tensor();
+    std::lock_guard<std::mutex> guard(frames_mutex);
+    // enough for the concurrent runs of a typical inference server
+    if(free_frames.size() < 16)
+      free_frames.push_back(std::move(frame));
+  }
+
   void dumpInstruction(std::ostream & out, size_t pc) const {
     auto writeList = [&](const ListHandle<int> & list) {
       for(int i = 0; i < list.size; i++) {
@@ -851,10 +908,21 @@ struct CodeImpl {
 
   std::unordered_map<size_t, int> unique_to_reg; // map from unique of nodes to register in register table
 
+  MemoryPlan memory_plan;
+  // registers holding the tensors of memory_plan, by the value they hold
+  std::unordered_map<Value*, int> planned_registers;
+  int num_planned_registers = 0;
+
   friend struct InterpreterState;
   std::vector<Instruction> instructions;
   std::vector<size_t> stage_end; // each stage runs while(pc < stage_end[stage])
   int register_size = 0;
+  // the most values an instruction pushes onto the stack at once, so that
+  // the stack can be reserved before a stage runs
+  size_t max_stack_growth = 0;
+
+  std::mutex frames_mutex;
+  std::vector<std::vector<at::Tensor>> free_frames;
 
   // all memory ArrayRef<int> are slices of this, to make sure
   // the interpreter is mostly linearly scanning through memory
@@ -868,7 +936,20 @@ struct InterpreterStateImpl {
   : function(function_.pImpl),
     int_data(function->int_data.data()),
     bool_data(function->bool_data),
-    registers(function->register_size) {
+    registers(function->acquireFrame()) {
+  }
+  InterpreterStateImpl(const InterpreterStateImpl & other)
+  : current_stage(other.current_stage),
+    current_pc(other.current_pc),
+    function(other.function),
+    int_data(other.int_data),
+    bool_data(other.bool_data),
+    registers(function->acquireFrame()) {
+    auto first = function->num_planned_registers;
+    std::copy(other.registers.begin() + first, other.registers.end(), registers.begin() + first);
+  }
+  ~InterpreterStateImpl() {
+    function->releaseFrame(std::move(registers));
   }
   void runOneStage(Stack & stack) {
     // std::cout << "running stage: " << current_stage << " of " << function->stage_end.size() << "\n";
@@ -877,14 +958,23 @@ struct InterpreterStateImpl {
     size_t pc = current_pc;
     size_t last = function->stage_end[current_stage];
     auto & instructions = function->instructions;
+    // no instruction below needs to grow the stack's buffer
+    stack.reserve(stack.size() + function->max_stack_growth);
     while(pc < last) {
         // std::cout << "executing " << pc << ": ";
         // function->dumpInstruction(std::cout, pc);
         // std::cout << "\n";
         try {
           auto & inst = instructions[pc];
+          if(inst.kind == InstructionKind::Drop) {
+            dropRegisters(inst.inputs);
+            pc++;
+            continue;
+          }
           loadTensorsFromRegisters(inst.inputs, stack);
-          size_t new_pc = pc + 1 + inst.callback(stack);
+          size_t new_pc = pc + 1;
+          if(inst.kind == InstructionKind::Call)
+            new_pc += inst.callback(stack);
           for(int i = inst.outputs.size - 1; i >= 0; i--) {
             int reg = get(inst.outputs,i);
             registers[reg] = pop(stack);
@@ -922,6 +1012,13 @@ struct InterpreterStateImpl {
 
     }
   }
+  // what pushing the uses onto the stack and popping them again would do
+  void dropRegisters(const UseList & uses) {
+    for(int i = 0; i < uses.values.size; i++) {
+      if(get(uses.free_flags,i))
+        registers[get(uses.values,i)] = at::Tensor();
+    }
+  }
   size_t current_stage = 0;
   size_t current_pc = 0;
   std::shared_ptr<CodeImpl> function; // keep function alive
@@ -952,8 +1049,8 @@ std::ostream & operator<<(std::ostream & out, const Code & code) {
   return out;
 }
 
-Code::Code(std::shared_ptr<Graph>& graph)
-    : pImpl(new CodeImpl(graph)) {}
+Code::Code(std::shared_ptr<Graph>& graph, bool plan_memory)
+    : pImpl(new CodeImpl(graph, plan_memory)) {}
 Code::~Code() {}
 
 const std::vector<GraphExecutor*>& Code::executors() {
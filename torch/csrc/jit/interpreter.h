@@ -23,7 +23,10 @@ struct TensorType;
 struct Code {
   Code()
     : pImpl(nullptr) {}
-  Code(std::shared_ptr<Graph>& graph);
+  // With plan_memory, the outputs of ops are placed in a preallocated arena
+  // when the graph allows it, see memory_planning.h. The graph must then have
+  // complete types, which do not change between runs.
+  Code(std::shared_ptr<Graph>& graph, bool plan_memory = false);
   ~Code();
 
   // Returns pointers to GraphExecutors created to run GraphExecutor nodes in the given graph.
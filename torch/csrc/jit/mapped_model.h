@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace torch { namespace jit {
+
+// Layout of the files written by ExportMappedGraph and read by
+// ImportMappedIRGraph. Integers are in the byte order of the machine that
+// wrote the file.
+//
+//   MappedModelHeader
+//   the ModelProto of the graph, encoded as by ExportGraph with
+//     defer_weight_export, so its initializers carry dims but no data
+//   num_initializers MappedTensorEntry, in the order of the initializers
+//   the contiguous bytes of each initializer, at an offset that is a
+//     multiple of kMappedTensorAlignment
+//
+// The importer maps the whole file once and makes each initializer a view of
+// its bytes, so processes that load the same file share one copy of the
+// weights in the page cache. The alignment keeps every payload on pages of its
+// own; it is not needed for correctness on systems with larger pages.
+constexpr char kMappedModelMagic[8] = {'P', 'T', 'J', 'I', 'T', 'M', 'A', 'P'};
+constexpr uint64_t kMappedModelVersion = 1;
+constexpr uint64_t kMappedTensorAlignment = 4096;
+
+struct MappedModelHeader {
+  char magic[8];
+  uint64_t version;
+  uint64_t proto_offset;
+  uint64_t proto_size;
+  uint64_t table_offset;
+  uint64_t num_initializers;
+};
+
+struct MappedTensorEntry {
+  int64_t scalar_type; // an at::ScalarType
+  uint64_t offset;     // in bytes, from the start of the file
+  uint64_t nbytes;
+};
+
+}}
@@ -0,0 +1,212 @@
+#include "torch/csrc/jit/memory_planning.h"
+
+#include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/jit/aten_dispatch.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch { namespace jit {
+
+constexpr size_t MemoryPlan::kAlignment;
+
+namespace {
+
+size_t alignUp(size_t n) {
+  return (n + MemoryPlan::kAlignment - 1) / MemoryPlan::kAlignment * MemoryPlan::kAlignment;
+}
+
+// The number of bytes of v, or 0 if v cannot be placed in an arena.
+size_t plannedSize(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if(!type || type->device() != -1)
+    return 0;
+  if(type->strides() != type->contiguous()->strides())
+    return 0;
+  size_t numel = 1;
+  for(auto size : type->sizes())
+    numel *= size;
+  return numel * at::elementSize(type->scalarType());
+}
+
+// ops that may keep references to their inputs after they return
+bool mayKeepInputs(Node* n) {
+  switch(n->kind()) {
+    case prim::PythonOp:
+    case prim::CppOp:
+    case prim::GraphExecutor:
+    case prim::Load:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Values in one set may share memory. Outputs of ops that are not run with an
+// _out variant are put in the set of their inputs, since we do not know which
+// ops return views.
+struct AliasSets {
+  Value* find(Value* v) {
+    auto it = parent.find(v);
+    if(it == parent.end())
+      return v;
+    Value* root = find(it->second);
+    parent[v] = root;
+    return root;
+  }
+  void unite(Value* a, Value* b) {
+    a = find(a);
+    b = find(b);
+    if(a != b)
+      parent[a] = b;
+  }
+  std::unordered_map<Value*, Value*> parent;
+};
+
+struct Lifetime {
+  size_t begin = 0;
+  size_t end = 0;
+};
+
+bool overlaps(const Lifetime& a, const Lifetime& b) {
+  return a.begin <= b.end && b.begin <= a.end;
+}
+
+void addNestedUses(Block* b, std::vector<Value*>& uses) {
+  for(Node* n : b->nodes()) {
+    uses.insert(uses.end(), n->inputs().begin(), n->inputs().end());
+    for(Block* nested : n->blocks())
+      addNestedUses(nested, uses);
+  }
+  uses.insert(uses.end(), b->return_node()->inputs().begin(), b->return_node()->inputs().end());
+}
+
+} // anonymous namespace
+
+MemoryPlan planMemory(Graph& graph) {
+  // the sizes of the values change from run to run
+  for(Value* input : graph.inputs()) {
+    auto type = input->type()->cast<TensorType>();
+    if(type && type->hasSymbolicSizes())
+      return MemoryPlan();
+  }
+
+  AliasSets aliases;
+  std::unordered_map<Value*, size_t> defined_at;
+  std::unordered_map<Value*, size_t> last_used_at;
+  std::unordered_set<Value*> escaping;
+  std::vector<Value*> candidates;
+
+  size_t index = 0;
+  for(Node* n : graph.nodes()) {
+    for(Value* input : n->inputs()) {
+      last_used_at[input] = index;
+      if(mayKeepInputs(n))
+        escaping.insert(input);
+    }
+    // values used in a nested block may be aliased by its outputs, or be
+    // used many times by a loop
+    std::vector<Value*> nested_uses;
+    for(Block* b : n->blocks())
+      addNestedUses(b, nested_uses);
+    for(Value* v : nested_uses) {
+      last_used_at[v] = index;
+      escaping.insert(v);
+    }
+
+    bool planned = n->kind().is_aten() && n->blocks().empty() &&
+                   n->outputs().size() == 1 && plannedSize(n->output()) > 0 &&
+                   findTensorOutOp(n);
+    if(planned) {
+      candidates.push_back(n->output());
+    } else {
+      for(Value* output : n->outputs()) {
+        for(Value* input : n->inputs())
+          aliases.unite(output, input);
+      }
+    }
+    for(Value* output : n->outputs())
+      defined_at[output] = index;
+    index++;
+  }
+  for(Value* output : graph.outputs())
+    escaping.insert(output);
+
+  // the lifetime of a value ends with the last use of any value in its set
+  std::unordered_map<Value*, size_t> set_end;
+  std::unordered_set<Value*> escaping_sets;
+  for(auto & entry : last_used_at) {
+    auto & end = set_end[aliases.find(entry.first)];
+    end = std::max(end, entry.second);
+  }
+  for(Value* v : escaping)
+    escaping_sets.insert(aliases.find(v));
+
+  struct Candidate {
+    Value* value;
+    size_t size;
+    Lifetime lifetime;
+  };
+  std::vector<Candidate> placing;
+  for(Value* v : candidates) {
+    Value* set = aliases.find(v);
+    if(escaping_sets.count(set) > 0)
+      continue;
+    Lifetime lifetime;
+    lifetime.begin = defined_at.at(v);
+    lifetime.end = std::max(lifetime.begin, set_end[set]);
+    placing.push_back({v, plannedSize(v), lifetime});
+  }
+
+  // Greedy by size: larger values are placed first, each at the lowest offset
+  // where it does not overlap a placed value that is live at the same time.
+  std::stable_sort(placing.begin(), placing.end(), [](const Candidate& a, const Candidate& b) {
+    return a.size > b.size;
+  });
+  MemoryPlan plan;
+  std::vector<Lifetime> placed_lifetimes;
+  for(auto & c : placing) {
+    std::vector<size_t> live;
+    for(size_t i = 0; i < plan.allocations.size(); i++) {
+      if(overlaps(placed_lifetimes[i], c.lifetime))
+        live.push_back(i);
+    }
+    std::sort(live.begin(), live.end(), [&](size_t a, size_t b) {
+      return plan.allocations[a].offset < plan.allocations[b].offset;
+    });
+    size_t offset = 0;
+    for(size_t i : live) {
+      auto & a = plan.allocations[i];
+      if(a.offset >= offset + c.size)
+        break;
+      offset = std::max(offset, alignUp(a.offset + a.size));
+    }
+    plan.allocations.push_back({c.value, offset, c.size});
+    placed_lifetimes.push_back(c.lifetime);
+    plan.arena_size = std::max(plan.arena_size, alignUp(offset + c.size));
+  }
+  std::sort(plan.allocations.begin(), plan.allocations.end(),
+            [&](const MemoryPlan::Allocation& a, const MemoryPlan::Allocation& b) {
+    return defined_at.at(a.value) < defined_at.at(b.value);
+  });
+  return plan;
+}
+
+std::vector<at::Tensor> allocateArena(const MemoryPlan& plan) {
+  std::vector<at::Tensor> tensors;
+  if(plan.allocations.empty())
+    return tensors;
+  auto arena = at::CPU(at::kByte).tensor({static_cast<int64_t>(plan.arena_size)});
+  auto data = static_cast<uint8_t*>(arena.data_ptr());
+  tensors.reserve(plan.allocations.size());
+  for(auto & a : plan.allocations) {
+    auto type = a.value->type()->expect<TensorType>();
+    auto tensor = at::CPU(type->scalarType()).tensorFromBlob(
+        data + a.offset, type->sizes(), [arena](void*) {});
+    tensors.push_back(autograd::make_variable(tensor, /*requires_grad=*/false));
+  }
+  return tensors;
+}
+
+}}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "torch/csrc/jit/ir.h"
+
+#include <ATen/ATen.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace torch { namespace jit {
+
+// A static memory plan for a graph whose values have complete types, e.g. the
+// shape specialized graph of an ExecutionPlan. It places the outputs of ops
+// in one arena, which is allocated once and reused by every run, and the ops
+// write into their places through their _out variants (see findTensorOutOp).
+//
+// An output is placed when it is a CPU tensor with contiguous strides and
+// neither it nor any value that may alias it (e.g. a view of it) escapes: is
+// an output of the graph, is used inside a nested block, or is passed to an op
+// that may keep it, like a PythonOp. Places are found by interval coloring
+// over the lifetimes of the outputs: outputs that are live at the same time
+// get disjoint bytes of the arena, so the arena is about as large as the
+// most memory that is live at any point of the graph. Graphs with symbolic
+// sizes (see PropagateSymbolicInputShapes) get an empty plan.
+struct MemoryPlan {
+  struct Allocation {
+    Value* value;
+    size_t offset; // in bytes, a multiple of kAlignment
+    size_t size;   // in bytes
+  };
+  static constexpr size_t kAlignment = 64;
+
+  // in the order the values are computed
+  std::vector<Allocation> allocations;
+  size_t arena_size = 0;
+};
+
+// Plans the outputs of the nodes of the top-level block of graph. Values used
+// by the return node or by a prim::Load node are outputs of the graph, so
+// this works both before and after the interpreter flattens stages.
+MemoryPlan planMemory(Graph& graph);
+
+// Allocates an arena for plan, and returns a tensor for each of its
+// allocations that views its bytes of the arena, with the type of its value.
+// The tensors keep the arena alive.
+std::vector<at::Tensor> allocateArena(const MemoryPlan& plan);
+
+}}
@@ -103,6 +103,37 @@ bool isSimpleMap(Node *node) {
   return true;
 }
 
+// Can this node end a fusion group as a reduction over the innermost
+// dimension of the map (e.g. the sum in sum(x * y, -1))? The fusion compiler
+// reduces each row of the map in a single thread, which is only done for the
+// CPU.
+bool isInnermostReduction(Node * node) {
+  if (node->kind() != aten::sum && node->kind() != aten::mean)
+    return false;
+  // rules out the overloads that reduce all dimensions or take a dtype
+  if (node->inputs().size() != 1 || node->numAttributes() != 2 ||
+      !node->hasAttribute(attr::dim) || !node->hasAttribute(attr::keepdim))
+    return false;
+  TensorType* type = node->input()->type()->cast<TensorType>();
+  if (!type || type->device() != kCPUDevice)
+    return false;
+  int64_t ndim = type->sizes().size();
+  int64_t dim;
+  if (node->kindOf(attr::dim) == AttributeKind::is) {
+    auto dims = node->is(attr::dim);
+    if (dims.size() != 1)
+      return false;
+    dim = dims[0];
+  } else if (node->kindOf(attr::dim) == AttributeKind::i) {
+    dim = node->i(attr::dim);
+  } else {
+    return false;
+  }
+  if (dim < 0)
+    dim += ndim;
+  // the fused kernel cannot write 0-dim outputs
+  return dim == ndim - 1 && (ndim > 1 || node->i(attr::keepdim));
+}
 
 struct GraphFuser {
   Block * block;
@@ -207,10 +238,25 @@ struct GraphFuser {
     // otherwise they cannot partipate in the same map
     if(node->kind() == aten::cat && allOutputsHaveSameSize(node))
       return true;
+    // Reductions over the innermost dimension work the same way: the group
+    // computes the map row by row and sums each row as it goes, so the
+    // reduced input is never written to memory.
+    if(isInnermostReduction(node) && node->owningBlock() == block && allSupportedIO(node))
+      return true;
 
     return false;
   }
 
+  // Concats and reductions can only be outputs of a fusion group, so a group
+  // that produces one of them cannot be merged into a group that reads it.
+  bool isFusionGroupExit(Value * producer) {
+    Node * group = producer->node();
+    if(group->kind() != prim::FusionGroup)
+      return false;
+    Node * inner = getSubgraph(group).outputs().at(producer->offset())->node();
+    return inner->kind() == aten::cat || inner->kind() == aten::sum || inner->kind() == aten::mean;
+  }
+
   // necessary condition for fusion. If all of the uses of producer are consumer
   // then it is safe to merge producer into consumer, because it doesn't have any other uses
   // If there are other uses, but they occur _after_ consumer, then we can still merge in producer
@@ -245,6 +291,7 @@ struct GraphFuser {
     // but this requires better handling of merging fusion groups so it is not done now
     at::optional<int> consumer_device = getDevice(consumer);
     return isFusable(producer->node()) &&
+      !isFusionGroupExit(producer) &&
       allUsersAreThisConsumerOrOccurAfterIt(consumer, producer) &&
       consumer_device && consumer_device == getDevice(producer->node()) &&
       (*consumer_device != kCPUDevice || sharedFusionCompiler().canCompileOnCPU());
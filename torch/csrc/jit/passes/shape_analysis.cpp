@@ -10,6 +10,8 @@
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -33,7 +35,27 @@ at::Tensor representativeTensor(const TensorType * type) {
   return attype.tensor(type->sizes(), type->strides()).zero_();
 }
 
-void PropagateShapeOnBlock(Block * block, bool insert_expands=true);
+// Symbolic dimensions are found by propagating two bindings of the symbols to
+// example sizes at the same time. The types of the graph get the sizes of the
+// first binding, and alt_types holds the types under the second one. A
+// dimension of an output is static if it has the same size under both
+// bindings, and symbolic if its sizes are the examples of the same symbol.
+// Outputs whose sizes depend on symbols in any other way, e.g. 2 * N, get
+// DynamicType.
+struct SymbolicShapes {
+  // example size of a symbol in the first binding -> in the second one
+  std::unordered_map<int64_t, int64_t> alt_sizes;
+  // types under the second binding of values with symbolic dimensions
+  std::unordered_map<Value*, TypePtr> alt_types;
+
+  TypePtr altType(Value * v) const {
+    auto it = alt_types.find(v);
+    return it == alt_types.end() ? v->type() : it->second;
+  }
+};
+
+void PropagateShapeOnBlock(Block * block, bool insert_expands=true,
+                           SymbolicShapes * symbolic=nullptr);
 
 std::pair<std::vector<TensorType*>, bool> gatherTypes(at::ArrayRef<Value*> values) {
   std::vector<TensorType*> types;
@@ -63,21 +85,40 @@ bool mergeTypes(ArrayRef<Value*> lhs, ArrayRef<Value*> rhs, ArrayRef<Value*> out
   return changed;
 }
 
-void PropagateShapeOnNode(Node * node, bool insert_expands=true);
+void PropagateShapeOnNode(Node * node, bool insert_expands=true,
+                          SymbolicShapes * symbolic=nullptr);
+void PropagateSymbolicShapeOnNode(Node * node, bool insert_expands,
+                                  SymbolicShapes & symbolic);
 
-void broadcastPointwise(Node *node, std::vector<TensorType*>& types) {
+void broadcastPointwise(Node *node, std::vector<TensorType*>& types, SymbolicShapes * symbolic) {
   JIT_ASSERT(types.size() == 2);
   auto expected_size = at::infer_size(types[0]->sizes(), types[1]->sizes());
+  bool has_symbolic_sizes = types[0]->hasSymbolicSizes() || types[1]->hasSymbolicSizes();
   auto broadcast = [&](size_t input_idx) {
     TensorType* input_type = types.at(input_idx);
     if (input_type->sizes() == expected_size)
       return;
     auto graph = node->owningGraph();
-    Node *expand = graph->create(aten::expand, {node->inputs().at(input_idx)})
-                        ->is_(attr::size, expected_size)
-                        ->i_(attr::implicit, 0)
-                        ->insertBefore(node);
-    PropagateShapeOnNode(expand);
+    Node *expand;
+    if (!has_symbolic_sizes) {
+      expand = graph->create(aten::expand, {node->inputs().at(input_idx)})
+                    ->is_(attr::size, expected_size)
+                    ->i_(attr::implicit, 0)
+                    ->insertBefore(node);
+    } else {
+      // symbolic sizes are only known when the graph runs, so we can only
+      // expand to the size of the other input, when it is the size of the result
+      if (types.at(1 - input_idx)->sizes() != expected_size)
+        return;
+      expand = graph->create(aten::expand_as, {node->inputs().at(input_idx),
+                                               node->inputs().at(1 - input_idx)})
+                    ->insertBefore(node);
+    }
+    if (symbolic) {
+      PropagateSymbolicShapeOnNode(expand, /*insert_expands=*/true, *symbolic);
+    } else {
+      PropagateShapeOnNode(expand);
+    }
     node->replaceInput(input_idx, expand->output());
   };
   broadcast(0);
@@ -106,7 +147,7 @@ void PropagateShapeOnNodeByRunningIt(Node* node, const std::vector<TensorType*>&
   }
 }
 
-void PropagateShapeOnNode(Node * node, bool insert_expands) {
+void PropagateShapeOnNode(Node * node, bool insert_expands, SymbolicShapes * symbolic) {
   using AKind = AttributeKind;
   // These don't require the types and present flag. Return early after we
   // process them
@@ -189,7 +230,7 @@ void PropagateShapeOnNode(Node * node, bool insert_expands) {
     case aten::eq:
     case aten::ne: {
       if (node->inputs().size() == 2 && insert_expands) {
-        broadcastPointwise(node, types);
+        broadcastPointwise(node, types, symbolic);
       }
       // NB: we don't handle the nodes in any other way, because the type casting
       // logic in scalar cases is non-trivial. It's better to just run them.
@@ -309,6 +350,12 @@ void PropagateShapeOnNode(Node * node, bool insert_expands) {
         PropagateShapeOnNodeByRunningIt(node, types);
       }
     } break;
+    case aten::expand_as: {
+      if(check_overload(/*num_inputs=*/2, /*num_outputs=*/1, {})) {
+        // like expand, this is safe to run on integer tensors
+        PropagateShapeOnNodeByRunningIt(node, types);
+      }
+    } break;
     case aten::index_select: {
       if(check_overload(/*num_inputs=*/2, /*num_outputs=*/1,
                         {{AKind::i, attr::dim}})) {
@@ -385,12 +432,89 @@ void PropagateShapeOnNode(Node * node, bool insert_expands) {
   }
 }
 
-void PropagateShapeOnBlock(Block * block, bool insert_expands) {
+// contiguity[i] is true if dim i is contiguous with dim i + 1, like in
+// TensorDesc of the fusion compiler, and expanded[i] if its stride is 0
+std::pair<std::vector<bool>, std::vector<bool>> layoutOf(const TensorType * type) {
+  auto & sizes = type->sizes();
+  auto & strides = type->strides();
+  std::vector<bool> contiguity(sizes.size()), expanded(sizes.size());
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    int64_t expected_stride = (i + 1 < sizes.size()) ? sizes[i+1]*strides[i+1] : 1;
+    contiguity[i] = strides[i] == expected_stride;
+    expanded[i] = strides[i] == 0;
+  }
+  return std::make_pair(std::move(contiguity), std::move(expanded));
+}
+
+void PropagateSymbolicShapeOnNode(Node * node, bool insert_expands, SymbolicShapes & symbolic) {
+  bool has_symbolic_inputs = std::any_of(node->inputs().begin(), node->inputs().end(), [](Value * v) {
+    auto type = v->type()->cast<TensorType>();
+    return type && type->hasSymbolicSizes();
+  });
+  if (!has_symbolic_inputs) {
+    PropagateShapeOnNode(node, insert_expands, &symbolic);
+    return;
+  }
+
+  // the second binding. It must not change the graph, so it inserts no expands.
+  auto types = fmap(node->inputs(), [](Value * v) { return v->type(); });
+  for (Value * input : node->inputs()) {
+    input->setType(symbolic.altType(input));
+  }
+  std::vector<TypePtr> alt_types;
+  bool failed = false;
+  try {
+    PropagateShapeOnNode(node, /*insert_expands=*/false);
+    alt_types = fmap(node->outputs(), [](Value * v) { return v->type(); });
+  } catch(std::exception & e) {
+    // this may only fail for some sizes of the symbols
+    failed = true;
+  }
+  for (size_t i = 0; i < types.size(); ++i) {
+    node->inputs()[i]->setType(types[i]);
+  }
+  SHAPE_ASSERT(!failed);
+
+  PropagateShapeOnNode(node, insert_expands, &symbolic);
+  for (size_t i = 0; i < node->outputs().size(); ++i) {
+    Value * output = node->outputs()[i];
+    auto type = output->type()->cast<TensorType>();
+    auto alt_type = alt_types[i]->cast<TensorType>();
+    if (!type && !alt_type)
+      continue;
+    SHAPE_ASSERT(type && alt_type && type->sizes().size() == alt_type->sizes().size());
+    std::vector<bool> symbolic_dims(type->sizes().size());
+    for (size_t d = 0; d < symbolic_dims.size(); ++d) {
+      int64_t size = type->sizes()[d];
+      int64_t alt_size = alt_type->sizes()[d];
+      if (size == alt_size)
+        continue;
+      auto it = symbolic.alt_sizes.find(size);
+      SHAPE_ASSERT(it != symbolic.alt_sizes.end() && it->second == alt_size);
+      symbolic_dims[d] = true;
+    }
+    // the layout must not depend on the symbols either, because e.g. fused
+    // kernels are specialized to the contiguity of their inputs
+    SHAPE_ASSERT(layoutOf(type) == layoutOf(alt_type));
+    output->setType(type->withSymbolicDims(symbolic_dims));
+    symbolic.alt_types[output] = alt_type->withSymbolicDims(symbolic_dims);
+  }
+}
+
+void PropagateShapeOnBlock(Block * block, bool insert_expands, SymbolicShapes * symbolic) {
   for (Node * node : block->nodes()) {
     try {
-      PropagateShapeOnNode(node, insert_expands);
+      if (symbolic) {
+        PropagateSymbolicShapeOnNode(node, insert_expands, *symbolic);
+      } else {
+        PropagateShapeOnNode(node, insert_expands);
+      }
     } catch(propagation_error& e) {
       setDynamicType(node);
+      if (symbolic) {
+        for (Value * output : node->outputs())
+          symbolic->alt_types.erase(output);
+      }
     } catch(std::exception & e) {
       if(auto sl = node->getSourceLocation()) {
         sl->wrapAndRethrowException(e, "operation failed shape propagation");
@@ -410,4 +534,102 @@ void PropagateInputShapes(Graph & graph, const ArgumentSpec & spec) {
   PropagateShapeOnBlock(graph.block());
 }
 
+namespace {
+
+bool hasBlocks(Block * block) {
+  for(Node * n : block->nodes()) {
+    if(!n->blocks().empty())
+      return true;
+  }
+  return false;
+}
+
+// sizes that may be compared to the sizes of values in graph
+void addStaticSizes(Block * block, std::unordered_set<int64_t> & sizes) {
+  for(Node * n : block->nodes()) {
+    for(Symbol name : n->attributeNames()) {
+      switch(n->kindOf(name)) {
+        case AttributeKind::i:
+          sizes.insert(n->i(name));
+          break;
+        case AttributeKind::is:
+          sizes.insert(n->is(name).begin(), n->is(name).end());
+          break;
+        case AttributeKind::t:
+          sizes.insert(n->t(name).sizes().begin(), n->t(name).sizes().end());
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+} // anonymous namespace
+
+bool PropagateSymbolicInputShapes(Graph & graph, const SymbolicSpec & spec) {
+  JIT_ASSERT(graph.inputs().size() == spec.size());
+  if(hasBlocks(graph.block()))
+    return false;
+
+  // The example size of a symbol differs from the other symbols and from the
+  // static sizes of the inputs and attributes, so that passes which compare
+  // sizes, like the fuser, do not mistake it for another size.
+  std::unordered_set<int64_t> taken;
+  std::vector<int64_t> hints(spec.numSymbols(), 2);
+  for(size_t i = 0; i < spec.size(); ++i) {
+    auto & input = spec.input(i);
+    for(size_t d = 0; d < input.sizes.size(); ++d) {
+      if(input.symbols[d] == 0)
+        taken.insert(input.sizes[d]);
+      else
+        hints[input.symbols[d] - 1] = input.sizes[d];
+    }
+  }
+  addStaticSizes(graph.block(), taken);
+  auto pick = [&](int64_t hint) {
+    int64_t size = std::max<int64_t>(hint, 2);
+    while(taken.count(size) > 0)
+      size++;
+    taken.insert(size);
+    return size;
+  };
+  std::vector<int64_t> examples, alt_examples;
+  for(int64_t hint : hints)
+    examples.push_back(pick(hint));
+  for(int64_t example : examples)
+    alt_examples.push_back(pick(example + 1));
+
+  SymbolicShapes symbolic;
+  for(size_t s = 0; s < examples.size(); ++s)
+    symbolic.alt_sizes[examples[s]] = alt_examples[s];
+  for(size_t i = 0; i < spec.size(); ++i) {
+    auto & input = spec.input(i);
+    Value * value = graph.inputs()[i];
+    if(!input.defined) {
+      value->setType(DynamicType::get());
+      continue;
+    }
+    if(input.strides.empty() && !input.sizes.empty()) {
+      std::vector<int64_t> sizes = input.sizes, alt_sizes = input.sizes;
+      std::vector<bool> symbolic_dims(sizes.size());
+      for(size_t d = 0; d < sizes.size(); ++d) {
+        if(input.symbols[d] == 0)
+          continue;
+        sizes[d] = examples[input.symbols[d] - 1];
+        alt_sizes[d] = alt_examples[input.symbols[d] - 1];
+        symbolic_dims[d] = true;
+      }
+      auto type = std::make_shared<TensorType>(input.type, input.device, sizes);
+      auto alt_type = std::make_shared<TensorType>(input.type, input.device, alt_sizes);
+      value->setType(type->withSymbolicDims(symbolic_dims));
+      symbolic.alt_types[value] = alt_type->withSymbolicDims(symbolic_dims);
+    } else {
+      value->setType(std::make_shared<TensorType>(input.type, input.device, input.sizes, input.strides));
+    }
+  }
+  PropagateShapeOnBlock(graph.block(), /*insert_expands=*/true, &symbolic);
+  return true;
+}
+
 }}
@@ -3,6 +3,15 @@
 namespace torch { namespace jit {
 struct Graph;
 struct ArgumentSpec;
+struct SymbolicSpec;
 void PropagateInputShapes(Graph & graph, const ArgumentSpec & spec);
 
+// Like PropagateInputShapes, but the symbolic dimensions of spec get symbolic
+// sizes in the types of the graph (see TensorType::isSymbolic), so that the
+// graph can be optimized once for all inputs that spec matches. Values whose
+// sizes depend on the symbols in other ways than being one of them get
+// DynamicType. Returns false without changing the graph if it has control
+// flow, which is not supported yet.
+bool PropagateSymbolicInputShapes(Graph & graph, const SymbolicSpec & spec);
+
 }}
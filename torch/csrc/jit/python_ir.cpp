@@ -168,6 +168,15 @@ void initPythonIRBindings(PyObject * module_) {
        py::arg("onnx_opset_version")=0,
        py::arg("defer_weight_export")=false,
        py::arg("operator_export_type")=::torch::onnx::OperatorExportTypes::ONNX)
+    .def("export_mapped", [](const std::shared_ptr<Graph> g, const std::string& filename,
+                             const std::vector<at::Tensor>& initializers,
+                             int64_t onnx_opset_version,
+                             ::torch::onnx::OperatorExportTypes operator_export_type) {
+      ExportMappedGraph(filename, g, initializers, onnx_opset_version, operator_export_type);
+    }, py::arg("filename"),
+       py::arg("initializers"),
+       py::arg("onnx_opset_version")=0,
+       py::arg("operator_export_type")=::torch::onnx::OperatorExportTypes::ONNX)
     .def("prettyPrintExport", [](const std::shared_ptr<Graph> g, const std::vector<at::Tensor>& initializers,
                       int64_t onnx_opset_version, bool defer_weight_export,
                       ::torch::onnx::OperatorExportTypes operator_export_type) {
@@ -471,6 +480,17 @@ void initPythonIRBindings(PyObject * module_) {
     }
     return std::make_tuple(graph, variables);
   });
+  m.def("_jit_import_mapped_graph", [](const std::string& filename) {
+    std::vector<at::Tensor> initializers;
+    auto graph = ImportMappedIRGraph(filename, initializers);
+    std::vector<torch::autograd::Variable> variables;
+    variables.reserve(initializers.size());
+    for (auto& tensor : initializers) {
+      variables.push_back(torch::autograd::make_variable(
+          std::move(tensor), /*requires_grad=*/false));
+    }
+    return std::make_tuple(graph, variables);
+  });
   m.def("_jit_is_tracing", [](const autograd::Variable& var) {
     return tracer::isTracing(var);
   });
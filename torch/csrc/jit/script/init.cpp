@@ -6,6 +6,7 @@
 #include "torch/csrc/jit/script/compiler.h"
 #include "torch/csrc/jit/tensor_conversions.h"
 #include "torch/csrc/jit/python_tracer.h"
+#include "torch/csrc/utils/auto_gil.h"
 
 #include <torch/csrc/api/include/torch/detail/ordered_dict.h>
 
@@ -460,7 +461,11 @@ void initJitScriptBindings(PyObject* module) {
     })
     .def("__call__", [](Method& m, py::args args) -> py::object {
       auto inputs = createVariableTensorList(args);
-      auto outputs = m.run(std::move(inputs));
+      variable_tensor_list outputs;
+      {
+        AutoNoGIL no_gil;
+        outputs = m.run(std::move(inputs));
+      }
       return unpackVariableTensorList(std::move(outputs));
     })
     .def_property_readonly("graph", [](Method& m) {
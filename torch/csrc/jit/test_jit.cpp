@@ -15,6 +15,7 @@
 #include "torch/csrc/jit/attributes.h"
 #include "torch/csrc/jit/interned_strings.h"
 #include "torch/csrc/jit/interpreter.h"
+#include "torch/csrc/jit/memory_planning.h"
 #include "torch/csrc/jit/symbolic_variable.h"
 #include "torch/csrc/jit/autodiff.h"
 #include "torch/csrc/jit/passes/create_autodiff_subgraphs.h"
@@ -40,12 +41,15 @@
 #include <ATen/ATen.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -245,6 +249,161 @@ static void fusionTests() {
   testConcat(2);
 }
 
+// Runs on the in-process bytecode backend unless PYTORCH_FUSION_CPU_BACKEND
+// asks for the system compiler.
+static void cpuFusionTests() {
+  FusionCompiler comp;
+  if(!comp.canCompileOnCPU())
+    return;
+
+  auto testStrided = [&](int ti, int tj, int toi, int toj) {
+    Graph graph;
+    Var i0 = Var::asNewInput(graph);
+    Var i1 = Var::asNewInput(graph);
+    Var i2 = Var::asNewInput(graph);
+    auto o0 = i0.sigmoid() * i1.tanh() + i2;
+    auto o1 = (o0 * i0).tanh();
+    o0.addAsOutput();
+    o1.addAsOutput();
+
+    std::vector<at::Tensor> inputs;
+    std::vector<at::Tensor> outputs;
+    for(size_t i = 0; i < graph.inputs().size(); i++) {
+      std::vector<int64_t> dims = {17, 33, 9};
+      std::swap(dims[ti],dims[tj]);
+      inputs.push_back(at::randn(dims, at::kCPU).transpose(ti, tj));
+    }
+    for(size_t i = 0; i < graph.outputs().size(); i++) {
+      std::vector<int64_t> dims = {17, 33, 9};
+      std::swap(dims[toi],dims[toj]);
+      outputs.push_back(at::zeros(dims, at::kCPU).transpose(toi,toj));
+    }
+    auto out0 = inputs[0].sigmoid() * inputs[1].tanh() + inputs[2];
+    auto out1 = (out0 * inputs[0]).tanh();
+    comp.debugLaunchGraph(graph, kCPUDevice, inputs, outputs);
+    REQUIRE((outputs[0] - out0).abs().max().toCDouble() < 1e-6);
+    REQUIRE((outputs[1] - out1).abs().max().toCDouble() < 1e-6);
+  };
+  testStrided(0,0,0,0);
+  testStrided(0,1,0,0);
+  testStrided(1,2,0,2);
+  testStrided(0,2,1,2);
+
+  auto testConcat = [&](int dim) {
+    Graph graph;
+    Var i0 = Var::asNewInput(graph);
+    Var i1 = Var::asNewInput(graph);
+    auto o0 = i0 * i1;
+    o0.addAsOutput();
+    Var::cat({i0, o0}, dim).addAsOutput();
+
+    auto a = at::rand({3,4,5}, at::kCPU);
+    auto b = at::rand({4,3,5}, at::kCPU).transpose(0,1);
+    auto o = at::zeros({3,4,5}, at::kCPU);
+
+    auto o_r = a*b;
+    auto o2_r = at::cat({a, o_r}, dim);
+    auto o2 = at::zeros(o2_r.sizes(), at::kCPU);
+    comp.debugLaunchGraph(graph, kCPUDevice, {a,b}, {o, o2});
+
+    REQUIRE((o_r - o).abs().max().toCDouble() == 0);
+    REQUIRE((o2_r - o2).abs().max().toCDouble() == 0);
+  };
+  testConcat(0);
+  testConcat(1);
+  testConcat(2);
+
+  auto testReduction = [&](bool keepdim, bool transposed) {
+    Graph graph;
+    Var i0 = Var::asNewInput(graph);
+    Var i1 = Var::asNewInput(graph);
+    auto o0 = i0 * i1;
+    o0.addAsOutput();
+    (o0 + i0).sum(2, keepdim).addAsOutput();
+    o0.mean(2, keepdim).addAsOutput();
+
+    auto a = at::rand({3,4,300}, at::kCPU);
+    auto b = transposed ? at::rand({3,300,4}, at::kCPU).transpose(1,2)
+                        : at::rand({3,4,300}, at::kCPU);
+    auto o0_r = a*b;
+    auto o1_r = (o0_r + a).sum(2, keepdim);
+    auto o2_r = o0_r.mean(2, keepdim);
+    std::vector<at::Tensor> outputs = {
+      at::zeros(o0_r.sizes(), at::kCPU),
+      at::zeros(o1_r.sizes(), at::kCPU),
+      at::zeros(o2_r.sizes(), at::kCPU)};
+    comp.debugLaunchGraph(graph, kCPUDevice, {a,b}, outputs);
+
+    REQUIRE((o0_r - outputs[0]).abs().max().toCDouble() == 0);
+    REQUIRE((o1_r - outputs[1]).abs().max().toCDouble() < 1e-4);
+    REQUIRE((o2_r - outputs[2]).abs().max().toCDouble() < 1e-6);
+  };
+  testReduction(false, false);
+  testReduction(true, false);
+  testReduction(false, true);
+}
+
+// Sets an environment variable until the guard goes out of scope.
+struct EnvGuard {
+  EnvGuard(const char * name, const char * value) : name(name) {
+    const char * prev_value = getenv(name);
+    had_value = prev_value != nullptr;
+    if(had_value)
+      prev = prev_value;
+    set(value);
+  }
+  ~EnvGuard() {
+    if(had_value) {
+      set(prev.c_str());
+    } else {
+#ifdef _WIN32
+      _putenv_s(name.c_str(), "");
+#else
+      unsetenv(name.c_str());
+#endif
+    }
+  }
+  void set(const char * value) {
+#ifdef _WIN32
+    _putenv_s(name.c_str(), value);
+#else
+    setenv(name.c_str(), value, 1);
+#endif
+  }
+  std::string name;
+  std::string prev;
+  bool had_value;
+};
+
+// tanh in contiguous kernels compiled with the system compiler is
+// fused_tanhf from fusion_compiler.cpp rather than tanhf from libm.
+static void cxxFusionTanhTest() {
+  EnvGuard backend("PYTORCH_FUSION_CPU_BACKEND", "cxx");
+  EnvGuard cache("PYTORCH_FUSION_CACHE_DIR", "");
+  FusionCompiler comp;
+  if(!comp.canCompileOnCPU())
+    return;
+
+  Graph graph;
+  Var i0 = Var::asNewInput(graph);
+  i0.tanh().addAsOutput();
+
+  // tiny to large magnitudes, 10^-30 to 10^2, of both signs, and the values
+  // around 0.625, where fused_tanhf switches formulas
+  std::vector<float> edges = {0.f, 1e-30f, -1e-8f, 1e-3f, 0.0625f, -0.624f,
+                              0.625f, -0.626f, 3.f, -9.f, 20.f, -50.f, 100.f};
+  auto magnitudes = at::rand({4000}, at::kCPU).mul_(32).sub_(30).mul_(std::log(10.)).exp_();
+  auto a = at::cat({at::CPU(at::kFloat).tensorFromBlob(edges.data(), {(int64_t)edges.size()}),
+                    magnitudes.mul_(at::randn({4000}, at::kCPU).sign())}, 0);
+  auto expected = a.tanh();
+  std::vector<at::Tensor> outputs = {at::zeros(a.sizes(), at::kCPU)};
+  comp.debugLaunchGraph(graph, kCPUDevice, {a}, outputs);
+
+  // within a few ulp of at::tanh
+  auto error = (outputs[0] - expected).abs() - expected.abs().mul(1e-6);
+  REQUIRE(error.max().toCDouble() <= 0);
+}
+
 struct Attr : public Attributes<Attr> {
 };
 void attributesTest() {
@@ -815,6 +974,133 @@ void testGraphExecutor() {
   REQUIRE(almostEqual(Variable(outputs[1]).data(), r1));
 }
 
+void testGraphExecutorThreads() {
+  auto g = std::make_shared<Graph>();
+  auto a = Var::asNewInput(*g, "a");
+  auto b = Var::asNewInput(*g, "b");
+  g->registerOutput((a * b + a).value());
+  GraphExecutor executor(g);
+
+  // threads run inputs of different dimensions, so new plans are compiled
+  // and published while other threads are looking up existing ones
+  constexpr int num_threads = 4;
+  constexpr int iters = 50;
+  std::vector<int> ok(num_threads, 1);
+  std::vector<std::thread> threads;
+  for(int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for(int i = 0; i < iters; i++) {
+        std::vector<int64_t> sizes(1 + (t + i) % 3, 2);
+        auto x = at::randn(sizes, at::kFloat);
+        auto y = at::randn(sizes, at::kFloat);
+        std::vector<at::Tensor> inputs = {
+            autograd::make_variable(x, false), autograd::make_variable(y, false)};
+        auto outputs = executor.run(variable_tensor_list(std::move(inputs)));
+        if(!almostEqual(Variable(outputs[0]).data(), x * y + x))
+          ok[t] = 0;
+      }
+    });
+  }
+  for(auto & th : threads)
+    th.join();
+  for(int t = 0; t < num_threads; t++)
+    REQUIRE(ok[t]);
+  REQUIRE(executor.getDebugState().execution_plans.size() == 3);
+}
+
+// Executors compiling the same fusion group from several threads share
+// sharedFusionCompiler(), which has to serialize its kernel cache.
+void testFusionThreads() {
+  if(!sharedFusionCompiler().canCompileOnCPU())
+    return;
+  auto has_fusion_group = [](Graph * graph) {
+    for(auto n : graph->nodes())
+      if(n->kind() == prim::FusionGroup)
+        return true;
+    return false;
+  };
+  constexpr int num_threads = 4;
+  constexpr int iters = 20;
+  std::vector<int> ok(num_threads, 1);
+  std::vector<int> fused(num_threads, 0);
+  std::vector<std::thread> threads;
+  for(int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      auto g = std::make_shared<Graph>();
+      auto a = Var::asNewInput(*g, "a");
+      auto b = Var::asNewInput(*g, "b");
+      g->registerOutput((a.sigmoid() * b.tanh() + a).value());
+      GraphExecutor executor(g);
+      for(int i = 0; i < iters; i++) {
+        // transposed inputs compile a kernel of their own
+        auto x = at::randn({8, 16}, at::kFloat);
+        auto y = at::randn({16, 8}, at::kFloat).t();
+        if((t + i) % 2 == 0)
+          x = at::randn({16, 8}, at::kFloat).t();
+        std::vector<at::Tensor> inputs = {
+            autograd::make_variable(x, false), autograd::make_variable(y, false)};
+        auto outputs = executor.run(variable_tensor_list(std::move(inputs)));
+        if(!almostEqual(Variable(outputs[0]).data(), x.sigmoid() * y.tanh() + x))
+          ok[t] = 0;
+      }
+      auto state = executor.getDebugState();
+      for(auto & entry : state.execution_plans)
+        fused[t] |= has_fusion_group(entry.second.graph);
+      for(auto & entry : state.symbolic_execution_plans)
+        fused[t] |= has_fusion_group(entry.second.graph);
+    });
+  }
+  for(auto & th : threads)
+    th.join();
+  for(int t = 0; t < num_threads; t++) {
+    REQUIRE(ok[t]);
+    REQUIRE(fused[t]);
+  }
+}
+
+void testMemoryPlanning() {
+  auto v = [](at::Tensor t) { return autograd::make_variable(t, false); };
+  auto x = at::randn({4, 16}, at::kFloat);
+  auto y = at::randn({4, 16}, at::kFloat);
+
+  auto g = std::make_shared<Graph>();
+  auto a = Var::asNewInput(*g, "a");
+  auto b = Var::asNewInput(*g, "b");
+  auto c = a * b;
+  auto d = c + a;
+  auto e = d * d;
+  g->registerOutput((e + b).value());
+  PropagateInputShapes(*g, ArgumentSpec(false, createVarList({v(x), v(y)})));
+
+  // c, d and e take 256 bytes each, and c is dead by the time e is computed
+  auto plan = planMemory(*g);
+  REQUIRE(plan.allocations.size() == 3);
+  REQUIRE(plan.arena_size == 512);
+  REQUIRE(plan.allocations[0].value == c.value());
+  REQUIRE(plan.allocations[0].offset == plan.allocations[2].offset);
+  REQUIRE(plan.allocations[0].offset != plan.allocations[1].offset);
+
+  // later runs reuse the arena of the first one
+  Code code(g, /*plan_memory=*/true);
+  auto expected = (x * y + x) * (x * y + x) + y;
+  for(int i = 0; i < 3; i++) {
+    std::vector<at::Tensor> stack = {v(x), v(y)};
+    InterpreterState interp(code);
+    interp.runOneStage(stack);
+    REQUIRE(almostEqual(Variable(stack[0]).data(), expected));
+  }
+
+  // a value is not placed when a view of it is an output of the graph
+  auto g2 = std::make_shared<Graph>();
+  auto a2 = Var::asNewInput(*g2, "a");
+  auto b2 = Var::asNewInput(*g2, "b");
+  auto chunks = (a2 * b2).chunk(2, 0);
+  g2->registerOutput(chunks[0].value());
+  g2->registerOutput((chunks[1] + a2.narrow(0, 0, 2)).value());
+  PropagateInputShapes(*g2, ArgumentSpec(false, createVarList({v(x), v(y)})));
+  REQUIRE(planMemory(*g2).allocations.empty());
+}
+
 void testBlocks(std::ostream & out) {
   Graph g;
   auto a = Var::asNewInput(g, "a");
@@ -888,6 +1174,87 @@ void testControlFlow() {
   REQUIRE(2 == run_binary("if_one", 2, 3));
   REQUIRE(2 == run_binary("if_one", 3, 2));
   REQUIRE(256 == run_binary("while_test",2,0));
+
+  // later runs of the same Code reuse the register frames of earlier ones
+  auto graph = cu.get_method("while_test").graph();
+  Code code(graph);
+  for(int i = 0; i < 3; i++) {
+    std::vector<at::Tensor> stack = {L(2), L(0)};
+    InterpreterState interp(code);
+    interp.runOneStage(stack);
+    REQUIRE(256 == V(stack[0]));
+  }
+}
+
+void testSymbolicShapes() {
+  auto v = [](at::Tensor t) { return autograd::make_variable(t, false); };
+  auto spec = [&](std::vector<at::Tensor> inputs) {
+    return ArgumentSpec(false, createVarList(std::move(inputs)));
+  };
+  auto w = at::randn({16, 8}, at::kFloat);
+  auto b = at::randn({8}, at::kFloat);
+
+  // the batch sizes differ, and the weights do not
+  auto first = SymbolicSpec(spec({v(at::randn({4, 16}, at::kFloat)), v(w), v(b)}));
+  auto generalized = first.generalize(spec({v(at::randn({6, 16}, at::kFloat)), v(w), v(b)}));
+  REQUIRE(generalized);
+  REQUIRE(generalized->numSymbols() == 1);
+  REQUIRE(generalized->matches(spec({v(at::randn({9, 16}, at::kFloat)), v(w), v(b)})));
+  REQUIRE(!generalized->matches(spec({v(at::randn({1, 16}, at::kFloat)), v(w), v(b)})));
+  REQUIRE(!generalized->matches(spec({v(at::randn({9, 17}, at::kFloat)), v(w), v(b)})));
+  REQUIRE(!generalized->matches(spec({v(at::randn({16, 9}, at::kFloat).t()), v(w), v(b)})));
+  // sizes of 1 stay static, and so do other differences
+  REQUIRE(!first.generalize(spec({v(at::randn({1, 16}, at::kFloat)), v(w), v(b)})));
+  REQUIRE(!first.generalize(spec({v(at::randn({4, 16}, at::kDouble)), v(w), v(b)})));
+
+  auto build = [] {
+    auto g = std::make_shared<Graph>();
+    auto x = Var::asNewInput(*g, "x");
+    auto w = Var::asNewInput(*g, "w");
+    auto b = Var::asNewInput(*g, "b");
+    auto h = x.mm(w) + b;
+    g->registerOutput((h * h.sigmoid()).value());
+    g->registerOutput(Var::cat({h, h}, 0).value());
+    return g;
+  };
+  auto g = build();
+  REQUIRE(PropagateSymbolicInputShapes(*g, *generalized));
+  auto out = g->outputs()[0]->type()->expect<TensorType>();
+  REQUIRE(out->isSymbolic(0));
+  REQUIRE(!out->isSymbolic(1));
+  REQUIRE(out->sizes()[1] == 8);
+  // the example batch size is not a size of the weights
+  REQUIRE(out->sizes()[0] != 16);
+  REQUIRE(out->sizes()[0] != 8);
+  // the result of the cat is 2 * N rows long
+  REQUIRE(g->outputs()[1]->type()->kind() == TypeKind::DynamicType);
+  // the bias is broadcast to the size of the product, whatever it is
+  bool has_expand_as = false;
+  for(Node * n : g->nodes())
+    has_expand_as = has_expand_as || n->kind() == aten::expand_as;
+  REQUIRE(has_expand_as);
+
+  // the second batch size compiles a plan that the later ones reuse
+  GraphExecutor executor(build());
+  std::vector<std::shared_ptr<Graph>> graphs;
+  for(int64_t batch : {4, 6, 9, 1}) {
+    auto x = at::randn({batch, 16}, at::kFloat);
+    auto inputs = createVarList({v(x), v(w), v(b)});
+    auto outputs = executor.run(variable_tensor_list(inputs));
+    auto h = x.mm(w) + b;
+    REQUIRE(almostEqual(Variable(outputs[0]).data(), h * h.sigmoid()));
+    REQUIRE(almostEqual(Variable(outputs[1]).data(), at::cat({h, h}, 0)));
+    graphs.push_back(executor.graphFor(inputs));
+  }
+  REQUIRE(graphs[0] != graphs[1]);
+  REQUIRE(graphs[1] == graphs[2]);
+  REQUIRE(graphs[3] != graphs[1]);
+  auto state = executor.getDebugState();
+  REQUIRE(state.execution_plans.size() == 2);
+  // the shared plan has the batch size as its only symbol
+  REQUIRE(state.symbolic_execution_plans.size() == 1);
+  REQUIRE(state.symbolic_execution_plans[0].first.numSymbols() == 1);
+  REQUIRE(state.symbolic_execution_plans[0].second.graph == graphs[1].get());
 }
 
 void testProto() {
@@ -899,6 +1266,10 @@ std::string runJITCPPTests() {
   std::stringstream out;
   testControlFlow();
   testGraphExecutor();
+  testGraphExecutorThreads();
+  testFusionThreads();
+  testMemoryPlanning();
+  testSymbolicShapes();
   testBlocks(out);
   testCreateAutodiffSubgraphs(out);
   testDifferentiate(out);
@@ -908,6 +1279,8 @@ std::string runJITCPPTests() {
   interpStageTest();
   codeTemplateTest();
   fusionTests();
+  cpuFusionTests();
+  cxxFusionTanhTest();
   attributesTest();
   internedStringsTests();
   fromQualStringTests();
@@ -924,6 +1297,14 @@ TEST_CASE( "jit test CPU", "[cpu]" ) {
   std::stringstream out;
   SECTION( "control flow" )
     testControlFlow();
+  SECTION( "graph executor threads" )
+    testGraphExecutorThreads();
+  SECTION( "fusion threads" )
+    testFusionThreads();
+  SECTION( "memory planning" )
+    testMemoryPlanning();
+  SECTION( "symbolic shapes" )
+    testSymbolicShapes();
   SECTION( "blocks" )
     testBlocks(out);
   SECTION( "create autodiff subgraphs" )
@@ -936,6 +1317,10 @@ TEST_CASE( "jit test CPU", "[cpu]" ) {
     testADFormulas();
   SECTION( "code template" )
     codeTemplateTest();
+  SECTION( "cpu fusion" )
+    cpuFusionTests();
+  SECTION( "cxx fusion math" )
+    cxxFusionTanhTest();
   SECTION( "attributes" )
     attributesTest();
   SECTION( "interned strings" )
@@ -17,6 +17,9 @@ std::ostream& operator<<(std::ostream & out, const Type & t) {
       // TODO: figure out a good way to output strides, or
       // add a "debug" printing mode which adds the extra stuff
       out << sizes[i]; // << "%" << strides[i];
+      if (value->isSymbolic(i)) {
+        out << "?"; //mark symbolic
+      }
       int64_t expected = i + 1 < sizes.size() ? sizes[i+1]*strides[i+1] : 1;
       if (strides[i] != expected) {
         out << "!"; //mark non-contiguous
@@ -5,8 +5,10 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <memory>
 #include <iostream>
+#include <vector>
 
 namespace torch { namespace jit {
 
@@ -129,6 +131,27 @@ struct TensorType : public Type {
   const std::vector<int64_t>& sizes() const { return sizes_; }
   const std::vector<int64_t>& strides() const { return strides_; }
 
+  // A symbolic dimension has a size that is only known when the graph runs,
+  // e.g. the batch size of a graph that is run on batches of many sizes. Its
+  // entry in sizes() is an example size, which shape analysis chooses such
+  // that dimensions have equal example sizes only if they are known to have
+  // equal sizes (see PropagateSymbolicInputShapes).
+  bool isSymbolic(size_t dim) const {
+    return !symbolic_.empty() && symbolic_.at(dim);
+  }
+  bool hasSymbolicSizes() const {
+    return !symbolic_.empty();
+  }
+  TensorTypePtr withSymbolicDims(std::vector<bool> symbolic) const {
+    JIT_ASSERT(symbolic.size() == sizes_.size());
+    auto t = std::make_shared<TensorType>(*this);
+    bool any = std::find(symbolic.begin(), symbolic.end(), true) != symbolic.end();
+    t->symbolic_ = any ? std::move(symbolic) : std::vector<bool>();
+    return t;
+  }
+
+  // NB: the types returned by withSizesStrides and withSizes have no
+  // symbolic dimensions
   TypePtr withSizesStrides(at::IntList sizes, at::IntList strides) const {
     return std::make_shared<TensorType>(scalar_type_, device_, sizes, strides);
   }
@@ -156,7 +179,8 @@ struct TensorType : public Type {
     return scalarType() == rt->scalarType() &&
            sizes() == rt->sizes() &&
            strides() == rt->strides() &&
-           device() == rt->device();
+           device() == rt->device() &&
+           symbolic_ == rt->symbolic_;
   }
   virtual bool isSubtypeOf(const Type& rhs) const override {
     return *this == rhs || rhs.kind() == TypeKind::DynamicType;
@@ -184,6 +208,8 @@ private:
   int device_;
   std::vector<int64_t> sizes_;
   std::vector<int64_t> strides_;
+  // empty if no dimension is symbolic
+  std::vector<bool> symbolic_;
 };
 
 // This value represents an opaque handle to external state.
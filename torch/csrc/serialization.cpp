@@ -3,13 +3,17 @@
 
 #include "THP.h"
 #include "serialization.h"
+#include "torch/csrc/utils/auto_gil.h"
 
 static ssize_t doPythonReadBuffered(PyObject* fildes, void* buf, size_t nbytes);
 static ssize_t doPythonReadInto(PyObject* fildes, void* buf, size_t nbytes);
 static ssize_t doPythonWrite(PyObject* fildes, void* buf, size_t nbytes);
 
+// Reads and writes of file descriptors release the GIL, so that several
+// threads can load storages from their own descriptors at the same time.
 template <>
 ssize_t doRead<int>(int fildes, void* buf, size_t nbytes) {
+  AutoNoGIL no_gil;
   return read(fildes, buf, nbytes);
 }
 
@@ -26,6 +30,7 @@ ssize_t doRead<PyObject*>(PyObject* fildes, void* buf, size_t nbytes) {
 
 template <>
 ssize_t doWrite<int>(int fildes, void* buf, size_t nbytes) {
+  AutoNoGIL no_gil;
   return write(fildes, buf, nbytes);
 }
 
@@ -0,0 +1,44 @@
+#pragma once
+
+// A test-and-test-and-set lock for critical sections that are only a few
+// instructions long. Waiting threads spin on a relaxed load and yield after a
+// while instead of sleeping in the kernel like std::mutex does when contended.
+// Satisfies BasicLockable, so it works with std::lock_guard.
+
+#include "torch/csrc/utils/disallow_copy.h"
+
+#include <atomic>
+#include <thread>
+
+namespace torch {
+
+struct SpinLock {
+  SpinLock() : locked(false) {}
+  TH_DISALLOW_COPY_AND_ASSIGN(SpinLock);
+
+  void lock() {
+    int spins = 0;
+    while (locked.exchange(true, std::memory_order_acquire)) {
+      while (locked.load(std::memory_order_relaxed)) {
+        if (++spins > 64) {
+          std::this_thread::yield();
+          spins = 0;
+        }
+      }
+    }
+  }
+
+  bool try_lock() {
+    return !locked.load(std::memory_order_relaxed) &&
+           !locked.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() {
+    locked.store(false, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<bool> locked;
+};
+
+} // namespace torch
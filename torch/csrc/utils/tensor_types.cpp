@@ -20,6 +20,7 @@ static const char* backend_to_string(const at::Type& type) {
     case at::kCUDA: return "torch.cuda";
     case at::kSparseCPU: return "torch.sparse";
     case at::kSparseCUDA: return "torch.cuda.sparse";
+    case at::kSparseCsrCPU: return "torch.sparse_csr";
     default: throw std::runtime_error("Unimplemented backend");
   }
 }
@@ -14,6 +14,7 @@ class ExportTypes:
     ZIP_ARCHIVE = 2
     COMPRESSED_ZIP_ARCHIVE = 3
     DIRECTORY = 4
+    MAPPED_FILE = 5
 
 
 def _export(*args, **kwargs):
@@ -225,8 +225,14 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
                                                output_names, operator_export_type,
                                                example_outputs, propagate)
 
-    # TODO: Don't allocate a in-memory string for the protobuf
     from torch.onnx.symbolic import _onnx_opset_version
+    if export_type == ExportTypes.MAPPED_FILE:
+        # Page aligned weights that torch._C._jit_import_mapped_graph maps
+        # instead of reading
+        graph.export_mapped(f, params if export_params else [], _onnx_opset_version, operator_export_type)
+        return torch_out
+
+    # TODO: Don't allocate a in-memory string for the protobuf
     defer_weight_export = export_type is not ExportTypes.PROTOBUF_FILE
     if export_params:
         proto, export_map = graph.export(params, _onnx_opset_version, defer_weight_export, operator_export_type)
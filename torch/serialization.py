@@ -26,7 +26,11 @@ SHORT_SIZE = struct.Struct('=h').size
 
 MAGIC_NUMBER = 0x1950a86a20f9469cfc6c
 PROTOCOL_VERSION = 1001
+# files saved with layout='aligned'
+ALIGNED_PROTOCOL_VERSION = 1002
 STORAGE_KEY_SEPARATOR = ','
+# alignment of the storages of files saved with layout='aligned'
+STORAGE_ALIGNMENT = 4096
 
 
 class SourceChangeWarning(Warning):
@@ -179,7 +183,23 @@ def _check_seekable(f):
         raise_err_msg(["seek", "tell"], e)
 
 
-def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
+def _file_name(f):
+    """Returns the name of the file f is or has open, or None"""
+    if isinstance(f, str) or \
+            (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
+            (sys.version_info[0] == 3 and isinstance(f, pathlib.Path)):
+        return str(f)
+    name = getattr(f, 'name', None)
+    if isinstance(name, _string_classes) and _should_read_directly(f) and os.path.isfile(name):
+        return name
+    return None
+
+
+def _align(n, alignment):
+    return (n + alignment - 1) // alignment * alignment
+
+
+def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, layout='sequential'):
     """Saves an object to a disk file.
 
     See also: :ref:`recommend-saving-models`
@@ -190,6 +210,14 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
            containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        layout: ``'sequential'`` (default) writes the storages one after the
+           other after the pickled object. ``'aligned'`` writes an index of the
+           storages before the pickled object, and places the bytes of every
+           storage at an offset aligned to the page size, so that
+           :func:`torch.load` can map them from the file (``mmap=True``) or read
+           them with several threads. It needs a seekable ``f`` and a little
+           endian machine, and files saved with it cannot be loaded by older
+           versions of PyTorch.
 
     .. warning::
         If you are using Python 2, torch.save does NOT support StringIO.StringIO
@@ -205,11 +233,15 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
         >>> # Save to io.BytesIO buffer
         >>> buffer = io.BytesIO()
         >>> torch.save(x, buffer)
+        >>> # Save with storages that torch.load can map
+        >>> torch.save(x, 'tensor.pt', layout='aligned')
     """
-    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol))
+    if layout not in ('sequential', 'aligned'):
+        raise ValueError("layout must be 'sequential' or 'aligned', but got {}".format(layout))
+    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol, layout))
 
 
-def _save(obj, f, pickle_module, pickle_protocol):
+def _save(obj, f, pickle_module, pickle_protocol, layout='sequential', write_storages=None):
     if sys.version_info[0] == 2:
         import StringIO
         if isinstance(f, StringIO.StringIO):
@@ -272,6 +304,51 @@ def _save(obj, f, pickle_module, pickle_protocol):
         ),
     )
 
+    if layout == 'aligned':
+        if sys.byteorder != 'little':
+            raise RuntimeError("torch.save with layout='aligned' is only supported "
+                               "on little endian machines")
+        _check_seekable(f)
+        sys_info['storage_alignment'] = STORAGE_ALIGNMENT
+        pickled = io.BytesIO()
+        pickler = pickle_module.Pickler(pickled, protocol=pickle_protocol)
+        pickler.persistent_id = persistent_id
+        pickler.dump(obj)
+        pickled = pickled.getvalue()
+
+        # Every storage is written as by _write_file, its number of elements
+        # as an int64 followed by its bytes, so that its bytes start at an
+        # aligned offset. The offsets are relative to the first aligned offset
+        # after the pickled object.
+        storages = []
+        end = 0
+        for key in sorted(serialized_storages.keys()):
+            root = serialized_storages[key]
+            offset = _align(end + 8, STORAGE_ALIGNMENT)
+            storages.append((key, normalize_storage_type(type(root)), location_tag(root),
+                             root.size(), offset))
+            end = offset + root.size() * root.element_size()
+
+        pickle_module.dump(MAGIC_NUMBER, f, protocol=pickle_protocol)
+        pickle_module.dump(ALIGNED_PROTOCOL_VERSION, f, protocol=pickle_protocol)
+        pickle_module.dump(sys_info, f, protocol=pickle_protocol)
+        pickle_module.dump(dict(pickle_size=len(pickled), storages=storages), f, protocol=pickle_protocol)
+        f.write(pickled)
+        data_start = _align(f.tell(), STORAGE_ALIGNMENT)
+        if write_storages is not None:
+            # the storages are written by the caller, at these offsets of f
+            write_storages([(serialized_storages[key], data_start + offset)
+                            for key, _, _, _, offset in storages])
+            return
+        f.flush()
+        f_should_write_directly = _should_read_directly(f)
+        for key, _, _, _, offset in storages:
+            f.seek(data_start + offset - 8)
+            serialized_storages[key]._write_file(f, f_should_write_directly)
+        if storages:
+            f.seek(data_start + end)
+        return
+
     pickle_module.dump(MAGIC_NUMBER, f, protocol=pickle_protocol)
     pickle_module.dump(PROTOCOL_VERSION, f, protocol=pickle_protocol)
     pickle_module.dump(sys_info, f, protocol=pickle_protocol)
@@ -286,7 +363,99 @@ def _save(obj, f, pickle_module, pickle_protocol):
         serialized_storages[key]._write_file(f, _should_read_directly(f))
 
 
-def load(f, map_location=None, pickle_module=pickle):
+class AsyncCheckpointWriter(object):
+    """Saves objects to files on a background thread.
+
+    :meth:`save` writes the same file as ``torch.save(obj, filename,
+    layout='aligned')``, but only pickles ``obj`` and copies its storages to a
+    staging buffer before returning; a thread then writes the buffer to the
+    file. The buffer has a fixed size: when the storages do not fit in it,
+    :meth:`save` waits for the thread to write the earlier ones before copying
+    the rest, so it returns once all but at most ``staging_bytes`` of them are
+    on their way to disk. The storages can be modified as soon as
+    :meth:`save` returns.
+
+    A file is written to ``filename + '.tmp'`` and renamed to ``filename`` once
+    complete, so ``filename`` never holds a partial checkpoint. Files are
+    written in the order they are saved.
+
+    Args:
+        staging_bytes: size of the staging buffer in bytes
+        pin_memory: whether to allocate the staging buffer in pinned memory,
+           which makes copies of CUDA storages faster. Defaults to whether CUDA
+           is available.
+
+    Example:
+        >>> writer = torch.serialization.AsyncCheckpointWriter()
+        >>> future = writer.save(model.state_dict(), 'checkpoint.pt')
+        >>> # keep training, then
+        >>> future.wait()
+    """
+
+    def __init__(self, staging_bytes=256 * 1024 * 1024, pin_memory=None):
+        if pin_memory is None:
+            pin_memory = torch.cuda.is_available()
+        staging = torch.empty(staging_bytes, dtype=torch.uint8)
+        if pin_memory:
+            staging = staging.pin_memory()
+        self._writer = torch._C._CheckpointWriter(staging)
+        self._futures = []
+
+    def save(self, obj, filename, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, fsync=True):
+        """Starts saving obj to filename, and returns a future with a ``wait()``
+        method, which returns when the file is complete or raises the error
+        that stopped it, and a ``done()`` method.
+
+        Args:
+            obj: saved object
+            filename: name of the file
+            pickle_module: module used for pickling metadata and objects
+            pickle_protocol: can be specified to override the default protocol
+            fsync: whether the file is synced to disk before it is renamed to
+               filename
+        """
+        header = io.BytesIO()
+        storages = []
+        _save(obj, header, pickle_module, pickle_protocol, 'aligned', storages.extend)
+
+        # the blobs and tensors are written at their offsets of the file,
+        # every storage as by _write_file
+        blobs = [(0, header.getvalue())]
+        tensors = []
+        for storage, offset in storages:
+            blobs.append((offset - 8, struct.pack('<q', storage.size())))
+            if storage.size() > 0:
+                tensors.append((offset, _storage_as_tensor(storage)))
+
+        self._futures = [future for future in self._futures if not future.done()]
+        future = self._writer.write(str(filename), blobs, tensors, fsync)
+        self._futures.append(future)
+        return future
+
+    def wait(self):
+        """Waits until the files that were saved are complete, and raises the
+        error that stopped the first one that failed."""
+        futures, self._futures = self._futures, []
+        error = None
+        for future in futures:
+            try:
+                future.wait()
+            except Exception as e:
+                if error is None:
+                    error = e
+        if error is not None:
+            raise error
+
+
+def _storage_as_tensor(storage):
+    tensor_type = storage_to_tensor_type(storage)
+    if storage.is_cuda:
+        with torch.cuda.device(storage.get_device()):
+            return tensor_type().set_(storage)
+    return tensor_type().set_(storage)
+
+
+def load(f, map_location=None, pickle_module=pickle, mmap=False, num_threads=None):
     """Loads an object saved with :func:`torch.save` from a file.
 
     :meth:`torch.load` uses Python's unpickling facilities but treats storages,
@@ -325,6 +494,15 @@ def load(f, map_location=None, pickle_module=pickle):
             locations
         pickle_module: module used for unpickling metadata and objects (has to
             match the pickle_module used to serialize file)
+        mmap: for files saved with ``layout='aligned'``, map the storages from
+            the file instead of reading them. Mapped storages share the pages
+            of the file with every process that maps it, are copy-on-write, so
+            changing them does not change the file, and cannot be resized.
+            ``f`` has to be, or have open, a file with a name.
+        num_threads: the number of threads that read the storages of a file
+            saved with ``layout='aligned'``, when it is not mapped. Defaults to
+            :func:`torch.get_num_threads`. Reading with more than one thread
+            needs ``f`` to be, or have open, a file with a name.
 
     Example:
         >>> torch.load('tensors.pt')
@@ -340,6 +518,8 @@ def load(f, map_location=None, pickle_module=pickle):
         >>> with open('tensor.pt') as f:
                 buffer = io.BytesIO(f.read())
         >>> torch.load(buffer)
+        # Map the storages of a file saved with layout='aligned'
+        >>> torch.load('tensors.pt', mmap=True)
     """
     new_fd = False
     if isinstance(f, str) or \
@@ -348,13 +528,53 @@ def load(f, map_location=None, pickle_module=pickle):
         new_fd = True
         f = open(f, 'rb')
     try:
-        return _load(f, map_location, pickle_module)
+        return _load(f, map_location, pickle_module, mmap, num_threads)
     finally:
         if new_fd:
             f.close()
 
 
-def _load(f, map_location, pickle_module):
+def _read_storages(f, storages, num_threads):
+    """Fills the storages of a file saved with layout='aligned' from it.
+
+    storages is a list of (storage, offset), where offset is the position in
+    f of the bytes of storage. With more than one thread, the storages are
+    split into groups of about the same number of bytes, and every group is
+    read by a thread from its own file object: reads of file descriptors
+    release the GIL.
+    """
+    filename = _file_name(f)
+    if filename is None or num_threads <= 1 or len(storages) <= 1:
+        f_should_read_directly = _should_read_directly(f)
+        for storage, offset in storages:
+            if not f_should_read_directly:
+                f.seek(offset - 8)
+            storage._set_from_file(f, offset - 8 if f_should_read_directly else None,
+                                   f_should_read_directly)
+        return
+
+    groups = [[] for _ in range(min(num_threads, len(storages)))]
+    group_bytes = [0] * len(groups)
+    for storage, offset in sorted(storages, key=lambda s: -s[0].size() * s[0].element_size()):
+        i = group_bytes.index(min(group_bytes))
+        groups[i].append((storage, offset))
+        group_bytes[i] += storage.size() * storage.element_size()
+
+    def read_group(group):
+        with open(filename, 'rb', 0) as group_f:
+            for storage, offset in group:
+                storage._set_from_file(group_f, offset - 8, True)
+
+    from multiprocessing.pool import ThreadPool
+    pool = ThreadPool(len(groups))
+    try:
+        pool.map(read_group, groups)
+    finally:
+        pool.close()
+        pool.join()
+
+
+def _load(f, map_location, pickle_module, mmap=False, num_threads=None):
     deserialized_objects = {}
 
     if map_location is None:
@@ -513,14 +733,52 @@ def _load(f, map_location, pickle_module):
     if magic_number != MAGIC_NUMBER:
         raise RuntimeError("Invalid magic number; corrupt file?")
     protocol_version = pickle_module.load(f)
-    if protocol_version != PROTOCOL_VERSION:
+    if protocol_version not in (PROTOCOL_VERSION, ALIGNED_PROTOCOL_VERSION):
         raise RuntimeError("Invalid protocol version: %s" % protocol_version)
 
     _sys_info = pickle_module.load(f)
-    unpickler = pickle_module.Unpickler(f)
+
+    pickle_file = f
+    if protocol_version == ALIGNED_PROTOCOL_VERSION:
+        # The storages are loaded before the object, which finds them in
+        # deserialized_objects. The object is read first, since the storages
+        # may be read through the file descriptor of f.
+        if not _sys_info['little_endian'] or sys.byteorder != 'little':
+            raise RuntimeError("files saved with layout='aligned' can only be "
+                               "loaded on little endian machines")
+        index = pickle_module.load(f)
+        pickle_file = io.BytesIO(f.read(index['pickle_size']))
+        data_start = _align(f.tell(), _sys_info['storage_alignment'])
+        if mmap:
+            filename = _file_name(f)
+            if filename is None:
+                raise RuntimeError("torch.load with mmap=True needs a file name, "
+                                   "or a file object opened from one")
+            mapping = None
+            for key, storage_type, location, size, offset in index['storages']:
+                if mapping is None:
+                    mapping = torch.ByteStorage.from_file(filename, False, os.path.getsize(filename))
+                storage = storage_type._new_with_bytes(mapping, data_start + offset, size)
+                deserialized_objects[key] = restore_location(storage, location)
+        else:
+            storages = [(storage_type(size), data_start + offset)
+                        for _, storage_type, _, size, offset in index['storages']]
+            if num_threads is None:
+                num_threads = torch.get_num_threads()
+            _read_storages(f, storages, num_threads)
+            for (key, _, location, _, _), (storage, _) in zip(index['storages'], storages):
+                deserialized_objects[key] = restore_location(storage, location)
+    elif mmap:
+        raise RuntimeError("torch.load with mmap=True needs a file saved with "
+                           "torch.save(..., layout='aligned')")
+
+    unpickler = pickle_module.Unpickler(pickle_file)
     unpickler.persistent_load = persistent_load
     result = unpickler.load()
 
+    if protocol_version == ALIGNED_PROTOCOL_VERSION:
+        return result
+
     deserialized_storage_keys = pickle_module.load(f)
 
     offset = f.tell() if f_should_read_directly else None